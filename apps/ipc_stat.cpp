@@ -0,0 +1,157 @@
+#include <iostream>
+#include <csignal>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "stats_segment.h"
+#include "util.h"
+
+/**
+ * @brief Signal handler for Ctrl+C (SIGINT).
+ *
+ * Sets the `stop` flag to gracefully exit the main loop when Ctrl+C is pressed.
+ *
+ * @param signal The signal number (SIGINT).
+ */
+volatile sig_atomic_t stop = 0;
+void handle_signal(int /*signal*/) {
+    stop = 1;
+}
+
+/**
+ * @brief A stats segment being watched, with the counter values seen at the previous interval.
+ */
+struct Watched {
+    std::unique_ptr<StatsSegment> segment;
+    uint64_t previous[STAT_COUNT];
+};
+
+/**
+ * @brief Attaches to every stats segment whose process is still running.
+ *
+ * Segments already in `watched` are kept (so their previous values survive),
+ * new ones are added starting from their current values, and those whose
+ * process has exited, or that were removed, are dropped. Segments left behind
+ * by a process that was killed are skipped rather than removed; they belong
+ * to that process's owner.
+ *
+ * @param watched The segments being watched, keyed by name.
+ */
+void refresh_segments(std::map<std::string, Watched>& watched) {
+    const std::vector<std::string> names = StatsSegment::List();
+    std::map<std::string, Watched> current;
+    for (const std::string& name : names) {
+        auto existing = watched.find(name);
+        if (existing != watched.end()) {
+            if (existing->second.segment->Alive()) {
+                current.emplace(name, std::move(existing->second));
+            }
+            continue;
+        }
+
+        try {
+            Watched entry { std::make_unique<StatsSegment>(name, false), {} };
+            if (!entry.segment->Alive()) {
+                continue;
+            }
+            for (size_t i = 0; i < STAT_COUNT; ++i) {
+                entry.previous[i] = entry.segment->Get(static_cast<Stat>(i));
+            }
+            current.emplace(name, std::move(entry));
+        } catch (const std::exception&) {
+            // Being created or removed right now; pick it up next time round
+        }
+    }
+    watched.swap(current);
+}
+
+/**
+ * @brief Prints one line per segment with the rate of each counter that moved, and the gauges.
+ *
+ * @param watched The segments being watched; their previous values are updated.
+ * @param seconds Length of the interval the rates are over.
+ */
+void print_rates(std::map<std::string, Watched>& watched, double seconds) {
+    std::ostringstream oss;
+    oss << util::currentTimestamp().View() << '\n';
+    if (watched.empty()) {
+        oss << "  (no running main_tx or main_rx)\n";
+    }
+    for (auto& [name, entry] : watched) {
+        oss << "  " << entry.segment->Role() << '[' << entry.segment->Pid() << ']';
+        for (size_t i = 0; i < STAT_COUNT; ++i) {
+            const Stat stat = static_cast<Stat>(i);
+            const uint64_t value = entry.segment->Get(stat);
+            if (StatsSegment::IsGauge(stat)) {
+                if (entry.segment->Get(Stat::QueueCapacity) > 0) { // Only receivers sample their queues
+                    oss << ' ' << StatsSegment::Name(stat) << '=' << value;
+                }
+            } else if (value > 0) {
+                const double rate = static_cast<double>(value - entry.previous[i]) / seconds;
+                oss << ' ' << StatsSegment::Name(stat) << '=' << static_cast<uint64_t>(rate + 0.5) << "/s";
+            }
+            entry.previous[i] = value;
+        }
+        oss << '\n';
+    }
+    std::cout << oss.str() << std::flush;
+}
+
+/**
+ * @brief Prints the running totals of every segment once.
+ */
+void print_totals(const std::map<std::string, Watched>& watched) {
+    std::ostringstream oss;
+    for (const auto& [name, entry] : watched) {
+        oss << entry.segment->Role() << '[' << entry.segment->Pid() << ']';
+        for (size_t i = 0; i < STAT_COUNT; ++i) {
+            const Stat stat = static_cast<Stat>(i);
+            oss << ' ' << StatsSegment::Name(stat) << '=' << entry.segment->Get(stat);
+        }
+        oss << '\n';
+    }
+    std::cout << oss.str() << std::flush;
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, handle_signal);
+
+    std::map<std::string, Watched> watched;
+    refresh_segments(watched);
+
+    // --prometheus prints every counter once in the Prometheus text format (e.g. for node_exporter's textfile collector)
+    if (util::getOption(argc, argv, "--prometheus", "false") == "true") {
+        std::vector<const StatsSegment*> segments;
+        for (const auto& [name, entry] : watched) {
+            segments.push_back(entry.segment.get());
+        }
+        std::cout << FormatPrometheus(segments) << std::flush;
+        return 0;
+    }
+
+    // --once prints the running totals and exits
+    if (util::getOption(argc, argv, "--once", "false") == "true") {
+        print_totals(watched);
+        return 0;
+    }
+
+    // Otherwise print rates every --interval-s seconds until Ctrl+C
+    const double interval = std::stod(util::getOption(argc, argv, "--interval-s", "1"));
+    if (interval <= 0) {
+        std::cerr << "Error: --interval-s must be positive" << std::endl;
+        return 1;
+    }
+    auto last = std::chrono::steady_clock::now();
+    while (!stop) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        const auto now = std::chrono::steady_clock::now();
+        print_rates(watched, std::chrono::duration<double>(now - last).count());
+        last = now;
+        refresh_segments(watched);
+    }
+    return 0;
+}
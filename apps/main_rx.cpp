@@ -2,9 +2,32 @@
 #include <mqueue.h>
 #include <csignal>
 #include <cstring>
-#include <unistd.h> // For usleep
+#include <array>
+#include <chrono>
+#include <unistd.h> // For STDOUT_FILENO and close
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+#include <string_view>
+#include "batch_frame.h"
+#include "capture_file.h"
+#include "columnar_batch.h"
 #include "t_ipc_data.h"
 #include "constants.h"
+#include "control_segment.h"
+#include "latency_stats.h"
+#include "log_sink.h"
+#include "priority_lanes.h"
+#include "queue_provisioner.h"
+#include "receive_pool.h"
+#include "rpc.h"
+#include "sharded_sender.h"
+#include "slab_pool.h"
+#include "stats_segment.h"
+#include "string_dictionary.h"
+#include "transport.h"
 #include "util.h"
 
 /**
@@ -19,96 +42,949 @@ void handle_signal(int signal) {
     stop = 1; // Set stop flag when receiving SIGINT
 }
 
+/**
+ * @brief Output sink for everything main_rx prints to stdout.
+ * 
+ * Formatting happens on the receive thread into a fixed `LogLine`, and the
+ * sink's writer thread does the actual (coalesced) writes, so a slow terminal
+ * or pipe does not hold up receiving. Created in `main` from `--log-overflow`.
+ */
+std::unique_ptr<LogSink> log_sink;
+
 /**
  * @brief Displays a spinner animation in the console.
  * 
- * This method updates a spinner animation in the console every 100 ms
- * while waiting for messages. It uses terminal control sequences to
- * update the spinner in place.
+ * This method advances a spinner animation in the console at most once
+ * every `SPINNER_INTERVAL_MS` while waiting for messages. It uses terminal
+ * control sequences to update the spinner in place, so it does nothing
+ * when stdout is not a TTY (e.g. redirected to a file or pipe).
  */
+constexpr int SPINNER_INTERVAL_MS = 100;
 void show_dots_spinner() {
-    const std::string dots[] = {"⠙", "⠸", "⠴", "⠦", "⠧", "⠇", "⠋"};
+    const std::string_view dots[] = {"⠙", "⠸", "⠴", "⠦", "⠧", "⠇", "⠋"};
     static int position = 0;
+    static std::chrono::steady_clock::time_point lastTick;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!log_sink->IsTerminal() || now - lastTick < std::chrono::milliseconds(SPINNER_INTERVAL_MS)) {
+        return;
+    }
+    lastTick = now;
 
-    std::cout << "\r\r\033[32m" << dots[position++] << " \033[0m Waiting for messages... Ctrl+C to stop." << std::flush;
+    LogLine line;
+    line.Append("\r\r\033[32m").Append(dots[position++]).Append(" \033[0m Waiting for messages... Ctrl+C to stop.");
+    log_sink->Write(line);
     position %= sizeof(dots) / sizeof(dots[0]);
+}
+
+/**
+ * @brief Control segment through which main_rx publishes settings to main_tx.
+ * 
+ * Created in `main`; also used to ask senders to reset their string dictionaries.
+ */
+std::unique_ptr<ControlSegment> control_segment;
+
+/**
+ * @brief This receive thread's copy of the senders' string dictionaries (see `main_tx --dictionary`).
+ * 
+ * One per receive thread, since each shard is its own in-order stream. A
+ * record that refers to an unknown entry is reported as an error, and the
+ * senders are asked to start over.
+ */
+thread_local StringDictionaryDecoder string_dictionary([] {
+    if (control_segment) {
+        control_segment->RequestDictionaryReset();
+    }
+});
+
+/**
+ * @brief Slab pool that senders write records larger than `MAX_MESSAGE_SIZE` into.
+ * 
+ * Created at startup for every transport but the broadcast ring; records that
+ * arrive as slab descriptors are decoded straight from it and their slab is released.
+ */
+std::unique_ptr<SlabPool> slab_pool;
 
-    usleep(100000); // 100 ms delay
+/**
+ * @brief Capture file that every received frame is appended to (`--capture=PATH`).
+ * 
+ * Null unless capturing. `capture_mutex` serializes appends from shard threads.
+ */
+std::unique_ptr<CaptureWriter> capture;
+std::mutex capture_mutex;
+
+/**
+ * @brief Worker pool that decodes and prints records off the receive thread.
+ * 
+ * Only created with `--workers=N`; otherwise records are processed inline on
+ * the receive thread, in arrival order.
+ */
+std::unique_ptr<ReceivePool> receive_pool;
+
+/**
+ * @brief Columnar window aggregation (`--aggregate=N`).
+ * 
+ * With `aggregate_rows` set, records are decoded into the receiving thread's
+ * `aggregate_batch` instead of being printed, and one summary line is printed
+ * per `aggregate_rows` records, computed with `aggregate_level`'s kernels.
+ */
+size_t aggregate_rows = 0;
+SimdLevel aggregate_level = SimdLevel::Scalar;
+thread_local ColumnarBatch aggregate_batch;
+
+/**
+ * @brief Latency and sequence statistics for traced messages (see `main_tx --trace`).
+ * 
+ * `report_interval` is set from `--report-interval-s`; zero disables periodic reports.
+ * `stats_mutex` guards the histogram and trackers when records are processed on
+ * several threads. Each shard numbers its messages independently, so there is
+ * one sequence tracker per shard, selected by the receiving thread's `current_shard`.
+ * `lane_records` and `lane_latency` break the interval down by queue priority.
+ */
+std::mutex stats_mutex;
+LatencyHistogram latency_histogram;
+std::array<uint64_t, PRIORITY_LEVELS> lane_records {};
+std::array<LatencyHistogram, PRIORITY_LEVELS> lane_latency;
+std::vector<SequenceTracker> sequence_trackers(1);
+thread_local size_t current_shard = 0;
+std::chrono::seconds report_interval { 10 };
+std::chrono::steady_clock::time_point last_report = std::chrono::steady_clock::now();
+
+/**
+ * @brief Sizes and opens the receive queues (see `open_receive_queue`).
+ * 
+ * Planned in `main` from `--queue-rate`, `--queue-burst`, `--queue-stall-ms` and
+ * `--max-record-size`. With `keep_queues` (`--keep-queue`) the message queues
+ * are left in place on exit, so messages sent while the receiver restarts are
+ * kept, and so are the control segment and slab pool those messages depend on.
+ */
+std::unique_ptr<QueueProvisioner> queue_provisioner;
+bool keep_queues = false;
+
+/**
+ * @brief Live counters for `ipc_stat`, created in `main` as `/ipc_stats.rx.<pid>`.
+ * 
+ * The parsers count failures and enum rejections through `stats::Add`; the
+ * receive loops count messages and records. `receive_transports` and
+ * `receive_queues` (the RPC request queue) list the open channels whose depth
+ * `sample_queue_depth` publishes.
+ */
+std::unique_ptr<StatsSegment> stats_segment;
+std::vector<const Transport*> receive_transports;
+std::vector<mqd_t> receive_queues;
+constexpr std::chrono::milliseconds QUEUE_SAMPLE_INTERVAL { 100 };
+
+/**
+ * @brief Dispatches passed over before a waiting lower-priority lane is served (`--starvation-limit`).
+ */
+unsigned starvation_limit = 8;
+constexpr size_t PRIORITY_LANE_CAPACITY = 32; // Messages buffered per receive thread
+constexpr size_t PRIORITY_LANE_LOW_WATER = 8; // The lanes are topped up once no more than this many are buffered
+
+/**
+ * @brief Returns how long the receive loop may sleep between wakeups.
+ * 
+ * With a TTY the loop wakes every spinner interval to animate it; otherwise it
+ * wakes once a second for latency reports and to keep the queue-depth gauge
+ * in the stats segment current.
+ */
+int wait_timeout_ms() {
+    return log_sink->IsTerminal() ? SPINNER_INTERVAL_MS : 1000;
+}
+
+/**
+ * @brief Counts a record on its priority lane, and records transit latency and sequence position if it is traced.
+ * 
+ * @param data The received record.
+ * @param priority The queue priority of the message it arrived in.
+ */
+void record_latency(const T_IPCData& data, unsigned priority) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    ++lane_records[priority];
+    if (auto sendTimeNs = data.GetSendTimeNs()) {
+        const uint64_t now = util::monotonicNanoseconds();
+        const uint64_t latency = now > *sendTimeNs ? now - *sendTimeNs : 0;
+        latency_histogram.Record(latency);
+        lane_latency[priority].Record(latency);
+    }
+    if (auto sequence = data.GetSequence()) {
+        sequence_trackers[current_shard].Observe(*sequence);
+    }
+}
+
+/**
+ * @brief Prints per-priority counts and latency for the interval, then resets them. Caller holds `stats_mutex`.
+ * 
+ * Prints nothing unless records arrived at more than one priority.
+ */
+void report_lanes() {
+    size_t lanesUsed = 0;
+    for (uint64_t records : lane_records) {
+        lanesUsed += records > 0 ? 1 : 0;
+    }
+
+    const bool human = log_sink->Format() == LogFormat::Human;
+    for (unsigned priority = PRIORITY_LEVELS; lanesUsed > 1 && priority-- > 0;) {
+        if (lane_records[priority] == 0) {
+            continue;
+        }
+        const LatencyHistogram& latency = lane_latency[priority];
+        LogLine line;
+        line.Append(human ? "\nPriority " : "lane priority=").Append(static_cast<int>(priority))
+            .Append(human ? ": records=" : " records=").Append(lane_records[priority]);
+        if (latency.Count() > 0) {
+            line.Append(human ? " p50=" : " p50_ns=").Append(latency.Percentile(50))
+                .Append(human ? " p99=" : " p99_ns=").Append(latency.Percentile(99))
+                .Append(human ? " max=" : " max_ns=").Append(latency.Max());
+        }
+        line.Append('\n');
+        log_sink->Write(line);
+    }
+
+    lane_records.fill(0);
+    for (LatencyHistogram& latency : lane_latency) {
+        latency.Reset();
+    }
+}
+
+/**
+ * @brief Prints latency percentiles and sequence anomalies for the interval, then resets them.
+ * 
+ * When records arrived at more than one priority, a line per priority follows
+ * with its record count and, for traced records, its latency percentiles.
+ * 
+ * @param force Report even if the interval has not elapsed (used on exit).
+ */
+void report_latency(bool force = false) {
+    auto now = std::chrono::steady_clock::now();
+    if (!force && (report_interval.count() == 0 || now - last_report < report_interval)) {
+        return;
+    }
+    last_report = now;
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    report_lanes();
+    if (latency_histogram.Count() == 0) {
+        return; // Nothing traced this interval
+    }
+
+    uint64_t missing = 0, reordered = 0, duplicates = 0, restarts = 0;
+    for (SequenceTracker& tracker : sequence_trackers) {
+        missing += tracker.Missing();
+        reordered += tracker.Reordered();
+        duplicates += tracker.Duplicates();
+        restarts += tracker.Restarts();
+        tracker.ResetCounters();
+    }
+
+    LogLine line;
+    const bool human = log_sink->Format() == LogFormat::Human;
+    line.Append(human ? "\nLatency (ns) over " : "latency count=").Append(latency_histogram.Count())
+        .Append(human ? " traced messages: p50=" : " p50_ns=").Append(latency_histogram.Percentile(50))
+        .Append(human ? " p99=" : " p99_ns=").Append(latency_histogram.Percentile(99))
+        .Append(human ? " p99.9=" : " p999_ns=").Append(latency_histogram.Percentile(99.9))
+        .Append(human ? " max=" : " max_ns=").Append(latency_histogram.Max())
+        .Append(human ? " | missing=" : " missing=").Append(missing)
+        .Append(" reordered=").Append(reordered)
+        .Append(" duplicates=").Append(duplicates)
+        .Append(" restarts=").Append(restarts)
+        .Append('\n');
+    log_sink->Write(line);
+
+    latency_histogram.Reset();
+}
+
+/**
+ * @brief Appends a received frame to the capture file, if capturing.
+ * 
+ * A slab descriptor is captured as the record it points to, since the slab
+ * will have been reused by the time the capture is replayed.
+ * 
+ * @param data The frame as received.
+ * @param size The size of the frame in bytes.
+ * @param priority The frame's queue priority.
+ */
+void capture_frame(const char* data, size_t size, unsigned priority) {
+    if (!capture) {
+        return;
+    }
+    const uint64_t now = util::monotonicNanoseconds();
+
+    std::string_view frame(data, size);
+    if (slab_pool && IsSlabDescriptor(data, size)) {
+        try {
+            frame = slab_pool->Resolve(DecodeSlabDescriptor(data, size));
+        } catch (const std::exception&) {
+            // Capture the descriptor itself; processing will report the error
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    try {
+        capture->Append(frame.data(), frame.size(), priority, static_cast<uint16_t>(current_shard), now);
+    } catch (const std::exception& e) {
+        std::cerr << "\nError: " << e.what() << "; capture stopped" << std::endl;
+        capture.reset();
+    }
+}
+
+/**
+ * @brief Prints the aggregates of this thread's window of records, then starts a new window.
+ */
+void report_window() {
+    if (aggregate_batch.Empty()) {
+        return;
+    }
+    const BatchSummary summary = aggregate_batch.Summarize(aggregate_level);
+    aggregate_batch.Clear();
+
+    LogLine line;
+    const bool human = log_sink->Format() == LogFormat::Human;
+    line.Append(human ? "\nWindow of " : "window rows=").Append(static_cast<uint64_t>(summary.rows))
+        .Append(human ? " records: ints=" : " ints=").Append(summary.ints.count);
+    if (summary.ints.count > 0) {
+        line.Append(" int_sum=").Append(summary.ints.sum)
+            .Append(" int_min=").Append(static_cast<int64_t>(summary.ints.min))
+            .Append(" int_max=").Append(static_cast<int64_t>(summary.ints.max));
+    }
+    line.Append(human ? " | floats=" : " floats=").Append(summary.floats.count);
+    if (summary.floats.count > 0) {
+        line.Append(" float_sum=").Append(static_cast<float>(summary.floats.sum))
+            .Append(" float_min=").Append(summary.floats.min)
+            .Append(" float_max=").Append(summary.floats.max);
+    }
+    line.Append(human ? " | strings=" : " strings=").Append(summary.strings);
+    for (size_t type = 0; type < TYPE_COUNT; ++type) {
+        line.Append(type == 0 && human ? " | type" : " type").Append(static_cast<uint64_t>(type)).Append('=').Append(summary.types[type]);
+    }
+    line.Append('\n');
+    log_sink->Write(line);
+}
+
+/**
+ * @brief Writes the final latency report and waits for all queued output to reach stdout.
+ */
+void finish_output() {
+    if (receive_pool) {
+        receive_pool->Drain();
+    }
+    report_window();
+    report_latency(true);
+    if (capture) {
+        LogLine line;
+        line.Append("\nCaptured ").Append(capture->Frames()).Append(" frames (").Append(capture->Bytes()).Append(" bytes)\n");
+        log_sink->Write(line);
+        capture.reset();
+    }
+    log_sink->Flush();
+    if (log_sink->Dropped() > 0) {
+        std::cerr << "\n" << log_sink->Dropped() << " output lines dropped (--log-overflow=drop)" << std::endl;
+    }
+    std::cout << "\nExiting..." << std::endl;
+}
+
+/**
+ * @brief Handles one decoded record.
+ * 
+ * Records its latency and queues its content on the log sink: the multi-line
+ * layout on a terminal, one `key=value` line otherwise. Thread-safe, so pool
+ * workers call it directly.
+ * 
+ * @param data The received record.
+ * @param priority The queue priority of the message it arrived in.
+ */
+void handle_record(const T_IPCData& data, unsigned priority) {
+    stats::Add(Stat::RecordsReceived);
+    record_latency(data, priority);
+
+    // Format the deserialized message
+    LogLine line;
+    if (log_sink->Format() == LogFormat::Human) {
+        line.Append("\nReceived Message @ ").Append(util::currentTimestamp().View()).Append(":\n");
+        AppendRecord(line, data, LogFormat::Human);
+    } else {
+        line.Append("rx time=").AppendQuoted(util::currentTimestamp().View());
+        AppendRecord(line, data, LogFormat::Compact);
+    }
+    line.Append('\n');
+    log_sink->Write(line);
+}
+
+/**
+ * @brief Reports a record that could not be decoded or handled.
+ */
+void report_error(const std::exception& e) {
+    std::cerr << "\nError processing message: " << e.what() << std::endl;
+}
+
+/**
+ * @brief Decodes a single record into this thread's aggregation window, reporting the window once it is full.
+ * 
+ * @param record The serialized `IPCData` bytes of one record, or a slab descriptor.
+ */
+void aggregate_record(std::string_view record) {
+    try {
+        SlabRecord bytes(slab_pool.get(), record);
+        IPCDataView view(bytes.View());
+        string_dictionary.Resolve(view);
+        aggregate_batch.Append(view);
+        stats::Add(Stat::RecordsReceived);
+    } catch (const std::exception& e) {
+        report_error(e);
+    }
+    if (aggregate_batch.Rows() >= aggregate_rows) {
+        report_window();
+    }
+}
+
+/**
+ * @brief Processes a single record on the receive thread.
+ * 
+ * Deserializes the record into a `T_IPCData` object and handles it,
+ * resolving its string against the thread's string dictionary. A slab
+ * descriptor is deserialized from the slab it points to, which is released
+ * before the record is handled. If deserialization fails, logs the error.
+ * 
+ * @param record The serialized `IPCData` bytes of one record, or a slab descriptor.
+ * @param priority The queue priority of the message it arrived in.
+ */
+void process_record(std::string_view record, unsigned priority) {
+    if (aggregate_rows > 0) {
+        aggregate_record(record);
+        return;
+    }
+
+    try {
+        // Deserialize message into T_IPCData
+        T_IPCData data = [&] {
+            SlabRecord bytes(slab_pool.get(), record);
+            IPCDataView view(bytes.View());
+            string_dictionary.Resolve(view);
+            return T_IPCData { view };
+        }();
+        handle_record(data, priority);
+    } catch (const std::exception& e) {
+        // Print any errors encountered during processing
+        report_error(e);
+    }
 }
 
 /**
  * @brief Processes a single message received from the queue.
  * 
- * Deserializes the message into a `T_IPCData` object and prints its content.
- * If deserialization fails, logs the error.
+ * A message is either one serialized record or a batch envelope holding
+ * several length-prefixed records; each record is processed in order. With
+ * a worker pool the message is handed off instead, and this returns as soon
+ * as its records are queued.
  * 
  * @param buffer The raw message buffer received from the queue.
  * @param size The size of the received message in bytes.
+ * @param priority The message's queue priority (always 0 except on a message queue).
  */
-void process_message(const char* buffer, ssize_t size) {
-    std::cout << std::endl; // Ensure output starts on a new line
-    std::string serializedMessage(buffer, size);
+void process_message(const char* buffer, ssize_t size, unsigned priority = 0) {
+    if (receive_pool) {
+        receive_pool->Submit(buffer, size, priority);
+        return;
+    }
+
+    if (!IsBatchFrame(buffer, size)) {
+        process_record(std::string_view(buffer, size), priority);
+        return;
+    }
 
     try {
-        // Deserialize message into T_IPCData
-        T_IPCData data { serializedMessage };
-        // Print the deserialized message
-        std::cout << "Received Message @ " << util::getCurrentDateTimeWithMilliseconds() << ":\n" << data.ToString() << std::endl;
+        for (std::string_view record : BatchView(buffer, size)) {
+            process_record(record, priority);
+        }
     } catch (const std::exception& e) {
-        // Print any errors encountered during processing
-        std::cerr << "Error processing message: " << e.what() << std::endl;
+        // A malformed envelope drops the rest of the batch
+        std::cerr << "\nError processing batch: " << e.what() << std::endl;
     }
 }
 
-int main() {
-    // Catch SIGINT (Ctrl+C) for graceful shutdown
-    signal(SIGINT, handle_signal);
-
-    // Remove any leftover queue from previous runs
-    mq_unlink(QUEUE_NAME);
-
-    // Set up message queue attributes
-    struct mq_attr attr;
-    attr.mq_flags = O_NONBLOCK; // Non-blocking mode
-    attr.mq_maxmsg = 10;        // Max number of messages in queue
-    attr.mq_msgsize = MAX_MESSAGE_SIZE; // Max size of a single message
-    attr.mq_curmsgs = 0;        // Number of messages currently in the queue
-
-    // Open the message queue
-    // O_CREAT == Create the queue if it doesn't already exist
-    // O_RDONLY == Read only
-    // O_NONBLOCK == Open the queue in non-blocking mode (for mq_receive below)
-    mqd_t mq = mq_open(QUEUE_NAME, O_CREAT | O_RDONLY | O_NONBLOCK, QUEUE_PERMISSIONS, &attr);
-    if (mq == (mqd_t)-1) {
-        perror("mq_open");
+/**
+ * @brief Publishes the number of messages waiting in the receive queues, at most every `QUEUE_SAMPLE_INTERVAL`.
+ * 
+ * Called from the thread that owns the spinner, so `mq_getattr` stays off the
+ * receive threads in sharded mode. Only message queues report a depth.
+ */
+void sample_queue_depth() {
+    static std::chrono::steady_clock::time_point lastSample;
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastSample < QUEUE_SAMPLE_INTERVAL) {
+        return;
+    }
+    lastSample = now;
+
+    uint64_t depth = 0;
+    uint64_t capacity = 0;
+    for (const Transport* transport : receive_transports) {
+        uint64_t pending, size;
+        if (transport->Depth(pending, size)) {
+            depth += pending;
+            capacity += size;
+        }
+    }
+    for (mqd_t mq : receive_queues) {
+        struct mq_attr attr;
+        if (mq_getattr(mq, &attr) == 0) {
+            depth += static_cast<uint64_t>(attr.mq_curmsgs);
+            capacity += static_cast<uint64_t>(attr.mq_maxmsg);
+        }
+    }
+    stats::Set(Stat::QueueDepth, depth);
+    stats::Set(Stat::QueueCapacity, capacity);
+}
+
+/**
+ * @brief Opens the receiving end of a channel; a message queue is sized by `queue_provisioner`.
+ * 
+ * A message queue attaches to a compatible one left by a previous run. Reports
+ * how the channel was opened, and any kernel limit that capped a queue's size.
+ * 
+ * @param kind The transport.
+ * @param name The queue, ring or socket name; empty for the transport's default.
+ * @return The channel, or null after reporting the error.
+ */
+std::unique_ptr<Transport> open_receive_queue(TransportKind kind, const std::string& name = "") {
+    try {
+        std::unique_ptr<Transport> transport = OpenTransport(kind, name, TransportRole::Receiver, queue_provisioner.get());
+        log_sink->Write(transport->Describe() + "\n");
+        receive_transports.push_back(transport.get());
+        return transport;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Removes a channel's name on exit, unless it is a message queue kept with `--keep-queue`.
+ */
+void remove_receive_queue(Transport& transport) {
+    if (!keep_queues || transport.Kind() != TransportKind::MQueue) {
+        transport.Remove();
+    }
+}
+
+/**
+ * @brief Receives everything ready on `transport` and dispatches it in priority order.
+ * 
+ * Messages are received, one batch at a time, straight into free lane
+ * buffers. The lanes are topped up again whenever they fall to
+ * `PRIORITY_LANE_LOW_WATER` messages, so an urgent message that arrives while
+ * a backlog is being processed overtakes all but a few buffered messages,
+ * without a wasted receive per dispatch once the channel is empty. Returns
+ * once both the channel and the lanes are empty.
+ * 
+ * @param transport The receiving end of the channel.
+ * @param lanes The calling thread's priority lanes.
+ * @return False on an unexpected receive error.
+ */
+bool drain_queue(Transport& transport, PriorityLanes& lanes) {
+    std::array<char*, PRIORITY_LANE_CAPACITY> buffers;
+    std::array<ReceiveSlot, PRIORITY_LANE_CAPACITY> slots;
+    while (!stop) {
+        // Top up the lanes once they run low; a message queue hands out the most urgent message first
+        if (lanes.Buffered() <= PRIORITY_LANE_LOW_WATER) {
+            const size_t free = lanes.FreeBuffers(buffers.data(), buffers.size());
+            for (size_t i = 0; i < free; ++i) {
+                slots[i] = ReceiveSlot { buffers[i], MAX_MESSAGE_SIZE, 0, 0 };
+            }
+            size_t received;
+            try {
+                received = transport.ReceiveBatch(slots.data(), free);
+            } catch (const std::exception& e) {
+                std::cerr << "\nError receiving: " << e.what() << std::endl;
+                return false;
+            }
+            for (size_t i = 0; i < received; ++i) {
+                stats::Add(Stat::MessagesReceived);
+                stats::Add(Stat::BytesReceived, static_cast<uint64_t>(slots[i].size));
+                capture_frame(slots[i].buffer, slots[i].size, slots[i].priority);
+                lanes.Commit(slots[i].size, slots[i].priority);
+            }
+        }
+
+        if (!lanes.Dispatch(process_message)) {
+            return true; // Nothing left, go back to waiting
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Receive loop for one shard, run on its own thread.
+ * 
+ * Same wait-then-drain loop as the single-queue path, without the spinner or
+ * reports (the main thread owns those). It wakes every spinner interval to
+ * notice Ctrl+C, since only one thread receives the signal.
+ * 
+ * @param shard Index of the shard, used to pick its sequence tracker.
+ * @param queue The shard's queue.
+ */
+void receive_shard(size_t shard, Transport* queue) {
+    current_shard = shard;
+
+    PriorityLanes lanes(PRIORITY_LANE_CAPACITY, starvation_limit);
+    while (!stop) {
+        if (!queue->WaitForData(SPINNER_INTERVAL_MS)) {
+            continue; // Timed out or interrupted; re-check `stop`
+        }
+
+        // Drain everything that is queued before waiting again
+        if (!drain_queue(*queue, lanes)) {
+            stop = 1; // Fail hard on unexpected receive error
+        }
+    }
+
+    report_window();
+}
+
+/**
+ * @brief Answers requests on `RPC_QUEUE_NAME` instead of receiving fire-and-forget messages.
+ * 
+ * Every request is echoed back as its reply, so `main_tx --ping` measures the
+ * round trip of the IPC stack itself. Requests are counted but not printed,
+ * which would dominate the round trip. Runs until Ctrl+C is pressed.
+ * 
+ * @return The process exit code.
+ */
+int serve_rpc() {
+    try {
+        RpcServer server(RPC_QUEUE_NAME, *queue_provisioner);
+        receive_queues.push_back(server.RequestQueue());
+        log_sink->Write("Serving RPC requests on " RPC_QUEUE_NAME "\n");
+
+        while (!stop) {
+            show_dots_spinner();
+            sample_queue_depth();
+
+            std::optional<RpcRequest> request;
+            try {
+                request = server.Receive(std::chrono::milliseconds(wait_timeout_ms()));
+            } catch (const std::runtime_error& e) {
+                report_error(e); // A malformed request is dropped
+                continue;
+            }
+            if (request) {
+                stats::Add(Stat::RecordsReceived);
+                server.Reply(*request, request->data);
+            }
+        }
+        if (server.DroppedReplies() > 0) {
+            std::cerr << "\n" << server.DroppedReplies() << " replies dropped (client gone)" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    finish_output();
+    if (!keep_queues) {
+        mq_unlink(RPC_QUEUE_NAME);
+    }
+    return 0;
+}
+
+/**
+ * @brief Receives from `shardCount` sharded queues, each served by a thread pinned to its own core.
+ * 
+ * The shard count is published in the control segment so `main_tx` sends to
+ * the same set of queues. Runs until Ctrl+C is pressed.
+ * 
+ * @param control The control segment to publish the shard count in.
+ * @param shardCount Number of queues, `QUEUE_NAME.0` ... `QUEUE_NAME.N-1`.
+ * @return The process exit code.
+ */
+int receive_from_shards(ControlSegment& control, size_t shardCount) {
+    std::vector<std::unique_ptr<Transport>> queues;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        std::unique_ptr<Transport> queue = open_receive_queue(TransportKind::MQueue, ShardQueueName(QUEUE_NAME, shard));
+        if (!queue) {
+            return 1;
+        }
+        queues.push_back(std::move(queue));
+    }
+    sequence_trackers.resize(shardCount);
+    control.SetShardCount(static_cast<uint32_t>(shardCount));
+
+    // One receive thread per shard, pinned round-robin over the available cores
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        threads.emplace_back(receive_shard, shard, queues[shard].get());
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(shard % cores, &cpus);
+        pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpus), &cpus);
+    }
+
+    // The main thread only animates the spinner and prints reports
+    while (!stop) {
+        show_dots_spinner();
+        report_latency();
+        sample_queue_depth();
+        std::this_thread::sleep_for(std::chrono::milliseconds(SPINNER_INTERVAL_MS));
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    finish_output();
+
+    // Unlink the shard queues unless they should outlive this run; they are closed on return
+    for (std::unique_ptr<Transport>& queue : queues) {
+        remove_receive_queue(*queue);
+    }
+    receive_transports.clear();
+
+    return 0;
+}
+
+/**
+ * @brief Receives from a single channel of any transport until Ctrl+C is pressed.
+ * 
+ * Waits until the channel has data (or the spinner is due), then drains
+ * everything that is ready before waiting again.
+ * 
+ * @param kind The transport.
+ * @return The process exit code.
+ */
+int receive_from_transport(TransportKind kind) {
+    std::unique_ptr<Transport> transport = open_receive_queue(kind);
+    if (!transport) {
         return 1;
     }
 
-    char buffer[MAX_MESSAGE_SIZE];
+    PriorityLanes lanes(PRIORITY_LANE_CAPACITY, starvation_limit);
 
     // Wait for messages
     while (!stop) {
         show_dots_spinner();
+        report_latency();
+        sample_queue_depth();
 
-        ssize_t bytes_read = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+        if (!transport->WaitForData(wait_timeout_ms())) {
+            if (transport->Closed()) {
+                log_sink->Write("\nThe publisher has gone; restart this subscriber after it.\n");
+                break;
+            }
+            continue; // Timed out (spinner tick) or interrupted by Ctrl+C
+        }
 
-        /*
-            >= 0 rather than > 0 because a message with empty values is STILL a valid message,
-            but will come over blank.
-        */
-        if (bytes_read >= 0) {
-            process_message(buffer, bytes_read);
-        } else if (bytes_read == -1 && errno != EAGAIN) {
-            perror("\nmq_receive");
-            break; // Fail hard on unexpected mq_receive error
+        // Drain everything that is queued before waiting again
+        if (!drain_queue(*transport, lanes)) {
+            stop = 1; // Fail hard on unexpected receive error
         }
     }
 
-    std::cout << "\nExiting..." << std::endl;
+    if (transport->Lost() > 0) {
+        LogLine line;
+        line.Append("\nOverrun by the publisher: ").Append(transport->Lost()).Append(" messages lost\n");
+        log_sink->Write(line);
+    }
 
-    // Close and unlink the message queue
-    mq_close(mq);
-    mq_unlink(QUEUE_NAME);
+    finish_output();
+
+    // Unlink the channel unless it should outlive this run; it is closed on return
+    remove_receive_queue(*transport);
+    receive_transports.clear();
 
     return 0;
 }
+
+/**
+ * @brief Attaches to a shared-memory segment left by a previous run, or creates a fresh one.
+ * 
+ * @param name The segment name.
+ * @param reuse True to attach to a valid existing segment first (`--keep-queue`).
+ * @param attached Set to true if an existing segment was attached to.
+ * @throws std::runtime_error if a fresh segment cannot be created.
+ */
+template <typename Segment>
+std::unique_ptr<Segment> open_segment(const char* name, bool reuse, bool& attached) {
+    attached = false;
+    if (reuse) {
+        try {
+            std::unique_ptr<Segment> segment = std::make_unique<Segment>(name, false);
+            attached = true;
+            return segment;
+        } catch (const std::runtime_error&) {
+            // Nothing (valid) left behind; create it below
+        }
+    }
+    return std::make_unique<Segment>(name, true);
+}
+
+int main(int argc, char* argv[]) {
+    // Catch SIGINT (Ctrl+C) for graceful shutdown
+    // No SA_RESTART, so a blocked poll/futex wait returns EINTR and the loop sees `stop`
+    struct sigaction action {};
+    action.sa_handler = handle_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+
+    // --log-overflow=drop discards output lines instead of stalling the receive loop when stdout falls behind
+    const bool dropLogs = util::getOption(argc, argv, "--log-overflow", "block") == "drop";
+    log_sink = std::make_unique<LogSink>(STDOUT_FILENO, dropLogs ? LogOverflowPolicy::Drop : LogOverflowPolicy::Block);
+
+    // --starvation-limit=N serves a waiting lower-priority message after at most N more urgent ones (0 = strict priority)
+    starvation_limit = static_cast<unsigned>(std::stoul(util::getOption(argc, argv, "--starvation-limit", "8")));
+
+    // --report-interval-s=N prints latency percentiles for traced messages every N seconds (0 = only on exit)
+    report_interval = std::chrono::seconds(std::stoi(util::getOption(argc, argv, "--report-interval-s", "10")));
+
+    // Publish live counters for ipc_stat
+    const std::string statsName = StatsSegmentName("rx", getpid());
+    try {
+        stats_segment = std::make_unique<StatsSegment>(statsName, true, "rx");
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    stats::Publish(stats_segment.get());
+    struct StatsCleanup {
+        const std::string& name;
+        ~StatsCleanup() { StatsSegment::Unlink(name); }
+    } statsCleanup { statsName };
+
+    // --transport=mq|shm|seqpacket|uring|broadcast selects the channel; the default is the POSIX message queue
+    TransportKind transport;
+    try {
+        transport = ParseTransportKind(util::getOption(argc, argv, "--transport", "mq"));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // A broadcast subscriber is one of many, so it leaves the single-receiver control segment and slab pool alone
+    const bool ownsSegments = transport != TransportKind::Broadcast;
+
+    // --keep-queue leaves the message queues in place on exit; the control segment and slab pool are kept
+    // (and attached to again) with them, so slab descriptors still waiting in a kept queue stay valid
+    keep_queues = util::getOption(argc, argv, "--keep-queue", "false") == "true";
+    const bool keepSegments = ownsSegments && keep_queues && transport == TransportKind::MQueue;
+
+    // Publish settings for main_tx; a fresh segment starts at one shard
+    if (ownsSegments) {
+        try {
+            bool attached;
+            control_segment = open_segment<ControlSegment>(CONTROL_SEGMENT_NAME, keepSegments, attached);
+            if (attached) {
+                control_segment->RequestDictionaryReset(); // Senders still on it must not refer to the old run's entries
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    struct ControlCleanup {
+        bool owned;
+        ~ControlCleanup() { if (owned) ControlSegment::Unlink(CONTROL_SEGMENT_NAME); }
+    } controlCleanup { ownsSegments && !keepSegments };
+
+    // Records too large for one message arrive through the slab pool
+    if (ownsSegments) {
+        try {
+            bool attached;
+            slab_pool = open_segment<SlabPool>(SLAB_POOL_NAME, keepSegments, attached);
+            if (attached) {
+                log_sink->Write("Attached to slab pool " SLAB_POOL_NAME " (" + std::to_string(slab_pool->InUse()) + " slabs in flight)\n");
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    struct SlabPoolCleanup {
+        bool owned;
+        ~SlabPoolCleanup() { if (owned) SlabPool::Unlink(SLAB_POOL_NAME); }
+    } slabPoolCleanup { ownsSegments && !keepSegments };
+
+    // --capture=PATH appends every received frame, with its receive time, to PATH (replay with main_tx --replay=PATH)
+    const std::string capturePath = util::getOption(argc, argv, "--capture", "");
+    if (!capturePath.empty()) {
+        try {
+            capture = std::make_unique<CaptureWriter>(capturePath);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // --workers=N decodes and prints on a pool of N threads (0 = on the receive thread);
+    // --order-by=type keeps records of the same type in order across the pool
+    const int workers = std::stoi(util::getOption(argc, argv, "--workers", "0"));
+    if (workers > 0) {
+        ReceivePoolOptions options;
+        options.workers = static_cast<size_t>(workers);
+        options.slabs = slab_pool.get();
+        options.dictionary = &string_dictionary; // This (the receive) thread's copy
+        if (util::getOption(argc, argv, "--order-by", "none") == "type") {
+            options.ordering = RecordOrdering::ByType;
+        }
+        receive_pool = std::make_unique<ReceivePool>(handle_record, report_error, options);
+    }
+
+    // --aggregate=N decodes records into columns and prints one summary per N records instead of each record;
+    // --simd=auto|avx2|sse|scalar picks the aggregation kernels
+    aggregate_rows = std::stoul(util::getOption(argc, argv, "--aggregate", "0"));
+    if (aggregate_rows > 0) {
+        if (receive_pool) {
+            std::cerr << "Error: --aggregate and --workers cannot be combined" << std::endl;
+            return 1;
+        }
+        try {
+            aggregate_level = ParseSimdLevel(util::getOption(argc, argv, "--simd", "auto"));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        LogLine line;
+        line.Append("Aggregating windows of ").Append(static_cast<uint64_t>(aggregate_rows))
+            .Append(" records (").Append(SimdLevelName(aggregate_level)).Append(" kernels)\n");
+        log_sink->Write(line);
+    }
+
+    // --shards=N serves N queues (QUEUE_NAME.0 ... QUEUE_NAME.N-1), one pinned thread each
+    const int shards = std::stoi(util::getOption(argc, argv, "--shards", "1"));
+    if (shards < 1 || shards > MAX_SHARDS) {
+        std::cerr << "Error: --shards must be between 1 and " << MAX_SHARDS << std::endl;
+        return 1;
+    }
+
+    // Size the queues for the declared workload, within the kernel's mqueue limits
+    QueueWorkload workload;
+    workload.messagesPerSecond = std::stod(util::getOption(argc, argv, "--queue-rate", "0"));
+    workload.burstMessages = std::stoul(util::getOption(argc, argv, "--queue-burst", "0"));
+    workload.stallMs = std::stod(util::getOption(argc, argv, "--queue-stall-ms", "10"));
+    workload.maxRecordSize = std::stoul(util::getOption(argc, argv, "--max-record-size", std::to_string(MAX_MESSAGE_SIZE)));
+    workload.queueCount = static_cast<size_t>(shards);
+    try {
+        queue_provisioner = std::make_unique<QueueProvisioner>(workload);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // --rpc answers request/reply calls (main_tx --ping) on RPC_QUEUE_NAME instead
+    if (util::getOption(argc, argv, "--rpc", "false") == "true") {
+        return serve_rpc();
+    }
+
+    if (shards > 1) {
+        if (transport != TransportKind::MQueue) {
+            std::cerr << "Error: --shards needs --transport=mq" << std::endl;
+            return 1;
+        }
+        if (receive_pool) {
+            std::cerr << "Error: --shards and --workers cannot be combined" << std::endl;
+            return 1;
+        }
+        return receive_from_shards(*control_segment, static_cast<size_t>(shards));
+    }
+
+    return receive_from_transport(transport);
+}
@@ -1,12 +1,27 @@
+#include <algorithm>
 #include <iostream>
 #include <random>
 #include <csignal>
 #include <thread>
 #include <chrono>
+#include <memory>
+#include <unordered_map>
 #include "util.h"
 #include "t_ipc_data.h"
+#include "log_sink.h"
+#include "control_segment.h"
+#include "sharded_sender.h"
+#include "load_generator.h"
+#include "capture_file.h"
+#include "batch_frame.h"
+#include "flat_codec.h"
+#include "ipc_data_view.h"
+#include "slab_pool.h"
+#include "string_dictionary.h"
+#include "latency_stats.h"
+#include "rpc.h"
+#include "stats_segment.h"
 #include "../shared/constants.h"
-#include <mqueue.h> // POSIX message queue
 #include <iomanip>
 #include <sstream>
 
@@ -22,19 +37,57 @@ void handle_signal(int signal) {
     stop = 1;
 }
 
+/**
+ * @brief Output sink for everything main_tx prints to stdout.
+ * 
+ * Keeps terminal/pipe writes off the send loop; see `LogSink`.
+ */
+std::unique_ptr<LogSink> log_sink;
+
+/**
+ * @brief Live counters for `ipc_stat` (messages and bytes sent, full-queue retries, time blocked).
+ * 
+ * Created in `main` as `/ipc_stats.tx.<pid>` and published to the sender
+ * through `stats::Publish`; removed again on exit.
+ */
+std::unique_ptr<StatsSegment> stats_segment;
+
 /**
  * @brief Displays a spinner animation in the console.
  * 
  * This method updates a spinner animation in the console while generating data.
  * The spinner cycles through a sequence of characters to indicate progress.
+ * It uses terminal control sequences, so it does nothing when stdout is not a TTY.
  */
 void show_dots_spinner() {
-    const std::string dots[] = {"⠙", "⠸", "⠴", "⠦", "⠧", "⠇", "⠋"};
+    const std::string_view dots[] = {"⠙", "⠸", "⠴", "⠦", "⠧", "⠇", "⠋"};
     static int position = 0;
-    std::cout << "\r\r\033[95m" << dots[position++] << " \033[0m Generating data... Ctrl+C to stop." << std::flush;
+    if (!log_sink->IsTerminal()) {
+        return;
+    }
+
+    LogLine line;
+    line.Append("\r\r\033[95m").Append(dots[position++]).Append(" \033[0m Generating data... Ctrl+C to stop.");
+    log_sink->Write(line);
     position %= 7;
 }
 
+/**
+ * @brief Queues a sent record on the log sink in the sink's output format.
+ */
+void log_sent(const T_IPCData& data) {
+    LogLine line;
+    if (log_sink->Format() == LogFormat::Human) {
+        line.Append("\nMessage Sent:\n");
+        AppendRecord(line, data, LogFormat::Human);
+    } else {
+        line.Append("tx time=").AppendQuoted(util::currentTimestamp().View());
+        AppendRecord(line, data, LogFormat::Compact);
+        line.Append('\n');
+    }
+    log_sink->Write(line);
+}
+
 /**
  * @brief Generates a random T_IPCData object.
  * 
@@ -82,46 +135,520 @@ T_IPCData generate_random_data() {
 }
 
 /**
- * @brief Sends a message to the POSIX message queue.
+ * @brief Opens a sender on the receiver's queue(s) and configures it from the command-line options.
+ *
+ * Called once per producer thread, so every thread owns its channel and buffers.
+ *
+ * @param shardCount The number of shards the receiver published (1 if unsharded).
+ * @throws std::exception if the channel cannot be opened or an option is invalid.
+ */
+std::unique_ptr<ShardedSender> make_sender(int argc, char* argv[], size_t shardCount) {
+    // --transport=mq|shm|seqpacket|uring|broadcast selects the channel; the default is the POSIX message queue
+    const std::string transportName = util::getOption(argc, argv, "--transport", "mq");
+    const SenderTransport transport = ParseTransportKind(transportName);
+
+    // --partition=type|int hashes that field to pick a shard; the default is round-robin
+    const PartitionKey partitionKey = ParsePartitionKey(util::getOption(argc, argv, "--partition", "round-robin"));
+
+    // Open the channel(s) once and reuse them (and their serialization buffers) for every message
+    std::unique_ptr<ShardedSender> sender;
+    try {
+        sender = std::make_unique<ShardedSender>(transport, shardCount, MakePartitioner(partitionKey));
+    } catch (const std::exception& e) {
+        if (transport == SenderTransport::MQueue || transport == SenderTransport::Broadcast) {
+            throw; // These create the channel themselves rather than needing main_rx first
+        }
+        throw std::runtime_error(std::string(e.what()) + " (is main_rx running with --transport=" + transportName + "?)");
+    }
+
+    // --codec=flat sends fixed-layout flat frames instead of protobuf
+    if (util::getOption(argc, argv, "--codec", "protobuf") == "flat") {
+        sender->SetCodec(WireCodec::Flat);
+    }
+
+    // --trace stamps every record with a monotonic send time and sequence number for main_rx's latency report
+    if (util::getOption(argc, argv, "--trace", "false") == "true") {
+        sender->SetTracing(true);
+    }
+
+    // --dictionary sends repeated strings (and shared prefixes) of bulk records as small dictionary ids
+    if (util::getOption(argc, argv, "--dictionary", "false") == "true") {
+        if (transport == SenderTransport::Broadcast) {
+            // A subscriber that joins late would never see the definitions sent before it
+            throw std::invalid_argument("--dictionary cannot be used with --transport=broadcast");
+        }
+        sender->SetStringDictionary(true);
+    }
+
+    // --type-priorities=P1,P2,P3 sends TYPE1/TYPE2/TYPE3 records at those queue priorities (0 = bulk)
+    const std::string typePriorities = util::getOption(argc, argv, "--type-priorities", "");
+    if (!typePriorities.empty()) {
+        try {
+            std::istringstream levels(typePriorities);
+            std::string level;
+            for (int type = 0; type < IPCData::Type_ARRAYSIZE && std::getline(levels, level, ','); ++type) {
+                sender->SetTypePriority(static_cast<IPCData::Type>(type), static_cast<unsigned>(std::stoul(level)));
+            }
+        } catch (const std::exception& e) {
+            throw std::invalid_argument(std::string("invalid --type-priorities (") + e.what() + ")");
+        }
+    }
+
+    // --overflow=deadline|drop-oldest|drop-newest|coalesce stops sends from blocking on a full queue:
+    // up to --overflow-capacity messages are buffered, then the policy applies (coalesce keys on the_type)
+    const OverflowMode overflow = ParseOverflowMode(util::getOption(argc, argv, "--overflow", "block"));
+    if (overflow != OverflowMode::Block) {
+        OverflowPolicy policy;
+        policy.mode = overflow;
+        policy.capacity = std::stoul(util::getOption(argc, argv, "--overflow-capacity", "64"));
+        policy.deadline = std::chrono::milliseconds(std::stoi(util::getOption(argc, argv, "--send-deadline-ms", "10")));
+        policy.key = [](const T_IPCData& data) {
+            auto type = data.GetTheType();
+            return type ? static_cast<uint64_t>(*type) + 1 : 0;
+        };
+        sender->SetOverflowPolicy(policy);
+        sender->SetBackpressureHandler([](BackpressureEvent event, size_t) {
+            if (event == BackpressureEvent::Congested || event == BackpressureEvent::Relieved) {
+                LogLine line;
+                line.Append(event == BackpressureEvent::Congested ? "\nBackpressure: receiver is behind, buffering"
+                                                                  : "\nBackpressure: caught up")
+                    .Append('\n');
+                log_sink->Write(line);
+            }
+        });
+    }
+
+    // --batch packs records into batch messages, flushed when full or after --batch-delay-ms
+    if (util::getOption(argc, argv, "--batch", "false") == "true") {
+        BatchPolicy policy;
+        policy.maxDelay = std::chrono::milliseconds(std::stoi(util::getOption(argc, argv, "--batch-delay-ms", "1")));
+        sender->SetBatchPolicy(policy);
+    }
+
+    return sender;
+}
+
+/**
+ * @brief Builds the load profile from the `--rate` family of options.
+ *
+ * @throws std::invalid_argument (or std::out_of_range) if an option does not parse.
+ */
+LoadProfile parse_load_profile(int argc, char* argv[]) {
+    LoadProfile profile;
+    profile.rate = std::stod(util::getOption(argc, argv, "--rate", "1000"));
+
+    profile.arrivals = ParseArrivalPattern(util::getOption(argc, argv, "--arrivals", "uniform"));
+    profile.burstSize = std::stoul(util::getOption(argc, argv, "--burst", "16"));
+    profile.threads = std::stoul(util::getOption(argc, argv, "--threads", "1"));
+    profile.duration = std::chrono::milliseconds(
+        static_cast<int64_t>(std::stod(util::getOption(argc, argv, "--duration-s", "0")) * 1000));
+    profile.poolSize = std::stoul(util::getOption(argc, argv, "--pool", "4096"));
+
+    // --presence=int,float,string,type gives the chance (0..1) that each field is set
+    std::istringstream presence(util::getOption(argc, argv, "--presence", "1,1,1,1"));
+    std::string chance;
+    for (size_t field = 0; field < profile.presence.size() && std::getline(presence, chance, ','); ++field) {
+        profile.presence[field] = std::stod(chance);
+    }
+
+    // --string-length=MIN-MAX (or a single length)
+    const std::string lengths = util::getOption(argc, argv, "--string-length", "8-64");
+    const size_t dash = lengths.find('-');
+    profile.stringMin = std::stoul(lengths.substr(0, dash));
+    profile.stringMax = dash == std::string::npos ? profile.stringMin : std::stoul(lengths.substr(dash + 1));
+    return profile;
+}
+
+/**
+ * @brief Open-loop load mode: sends pregenerated records at `--rate` from `--threads` producers.
+ *
+ * Records are not logged. Prints the achieved rate, the send-latency
+ * percentiles (measured from each record's intended send time) and the
+ * error count when the run ends.
+ *
+ * @return The process exit code.
+ */
+int run_load(int argc, char* argv[], size_t shardCount) {
+    LoadProfile profile;
+    std::vector<std::unique_ptr<ShardedSender>> senders;
+    try {
+        profile = parse_load_profile(argc, argv);
+        const std::string transport = util::getOption(argc, argv, "--transport", "mq");
+        if (profile.threads > 1 && (transport == "shm" || transport == "broadcast")) {
+            throw std::invalid_argument("the shared-memory rings have a single producer; use --threads=1");
+        }
+        if (profile.threads > 1 && util::getOption(argc, argv, "--trace", "false") == "true") {
+            // Every producer numbers its records from 1, and main_rx tracks one sequence per queue
+            throw std::invalid_argument("--trace needs a single sequence per queue; use --threads=1");
+        }
+        for (size_t thread = 0; thread < profile.threads; ++thread) {
+            senders.push_back(make_sender(argc, argv, shardCount));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    const bool useBatching = util::getOption(argc, argv, "--batch", "false") == "true";
+
+    std::unique_ptr<LoadGenerator> generator;
+    try {
+        generator = std::make_unique<LoadGenerator>(profile);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    LogLine start;
+    start.Append("Offering ").Append(static_cast<uint64_t>(profile.rate)).Append(" records/s from ")
+        .Append(static_cast<uint64_t>(profile.threads)).Append(" thread(s). Press Ctrl+C to stop.\n");
+    log_sink->Write(start);
+
+    const LoadReport report = generator->Run(
+        [&](size_t thread, const T_IPCData& data) {
+            ShardedSender& sender = *senders[thread];
+            if (useBatching) {
+                sender.Enqueue(data);
+                sender.FlushIfDue();
+            } else {
+                sender.Send(data);
+            }
+        },
+        [] { return stop != 0; });
+
+    uint64_t flushErrors = 0;
+    for (auto& sender : senders) {
+        try {
+            sender->Flush();
+        } catch (const std::exception&) {
+            ++flushErrors;
+        }
+    }
+
+    LogLine line;
+    const bool human = log_sink->Format() == LogFormat::Human;
+    line.Append(human ? "\nLoad: sent " : "load sent=").Append(report.sent)
+        .Append(human ? " records in " : " seconds=").Append(static_cast<float>(report.seconds))
+        .Append(human ? " s (" : " rate=").Append(static_cast<float>(report.AchievedRate()))
+        .Append(human ? "/s)\nSend latency (ns): p50=" : " p50_ns=").Append(report.latency.Percentile(50))
+        .Append(human ? " p99=" : " p99_ns=").Append(report.latency.Percentile(99))
+        .Append(human ? " p99.9=" : " p999_ns=").Append(report.latency.Percentile(99.9))
+        .Append(human ? " max=" : " max_ns=").Append(report.latency.Max())
+        .Append(" errors=").Append(report.errors + flushErrors)
+        .Append('\n');
+    log_sink->Write(line);
+    log_sink->Flush();
+    std::cout << "\nTx process terminated.\n";
+    return 0;
+}
+
+/**
+ * @brief Rewrites the dictionary-coded records of a captured frame as plain records.
+ *
+ * The captured `dict_stream` ids belong to the sender that was recorded, so
+ * replaying them as they are could collide with a live sender's stream.
+ * Every definition is learned by `dictionary`, so the frames must be passed
+ * in capture order, including any that are skipped rather than sent.
+ *
+ * @param records Filled with the frame's records, dictionary-coded ones resolved.
+ * @return False if the frame holds no dictionary-coded record and can be sent as captured.
+ * @throws std::runtime_error if a record refers to an entry the capture never defined.
+ */
+bool resolve_captured_frame(StringDictionaryDecoder& dictionary, const CaptureFrame& frame, std::vector<std::string>& records) {
+    const char* data = frame.data.data();
+    const size_t size = frame.data.size();
+    if (IsSlabDescriptor(data, size) || flat::IsFlatFrame(data, size)) {
+        return false;
+    }
+
+    records.clear();
+    bool coded = false;
+    auto resolve = [&](std::string_view record) {
+        if (!flat::IsFlatFrame(record.data(), record.size())) {
+            IPCDataView view(record);
+            if (view.GetDictStream()) {
+                dictionary.Resolve(view);
+                records.push_back(T_IPCData(view).Serialize());
+                coded = true;
+                return;
+            }
+        }
+        records.emplace_back(record);
+    };
+    if (IsBatchFrame(data, size)) {
+        for (std::string_view record : BatchView(data, size)) {
+            resolve(record);
+        }
+    } else {
+        resolve(frame.data);
+    }
+    return coded;
+}
+
+/**
+ * @brief Replay mode: sends the frames of a `main_rx --capture` file back as they were received.
+ *
+ * Frames are sent straight from the read-only mapping with `SendRaw`, on the
+ * shard they were captured from. Dictionary-coded records are the exception:
+ * they are resolved and sent as plain records, one per message (see
+ * `resolve_captured_frame`). `--replay-speed` scales the original pacing
+ * (1 = as captured, 2 = twice as fast, 0 = as fast as possible), and
+ * `--replay-skip-s` starts that many seconds into the capture. Skipped frames
+ * are still read, since they may define dictionary entries later frames use.
+ *
+ * @return The process exit code.
+ */
+int run_replay(int argc, char* argv[], size_t shardCount) {
+    std::unique_ptr<CaptureReader> reader;
+    std::unique_ptr<ShardedSender> sender;
+    double speed;
+    uint64_t skipUntil = 0;
+    try {
+        reader = std::make_unique<CaptureReader>(util::getOption(argc, argv, "--replay", ""));
+        sender = make_sender(argc, argv, shardCount);
+        speed = std::stod(util::getOption(argc, argv, "--replay-speed", "1"));
+        const double skipSeconds = std::stod(util::getOption(argc, argv, "--replay-skip-s", "0"));
+        if (skipSeconds > 0) {
+            skipUntil = reader->FirstTimestamp() + static_cast<uint64_t>(skipSeconds * 1e9);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    LogLine start;
+    start.Append("Replaying ").Append(reader->Frames()).Append(" captured frames. Press Ctrl+C to stop.\n");
+    log_sink->Write(start);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point started = Clock::now();
+    uint64_t sent = 0, errors = 0, base = 0;
+    StringDictionaryDecoder dictionary;
+    std::vector<std::string> records;
+    CaptureFrame frame;
+    while (!stop && reader->Next(frame)) {
+        bool coded = false;
+        try {
+            coded = resolve_captured_frame(dictionary, frame, records);
+        } catch (const std::exception&) {
+            if (frame.timestampNs >= skipUntil) {
+                ++errors;
+            }
+            continue;
+        }
+        if (frame.timestampNs < skipUntil) {
+            continue;
+        }
+        if (sent + errors == 0) {
+            base = frame.timestampNs;
+        }
+        if (speed > 0) {
+            const auto due = started + std::chrono::nanoseconds(static_cast<int64_t>((frame.timestampNs - base) / speed));
+            while (!stop && Clock::now() < due) {
+                std::this_thread::sleep_until(std::min(due, Clock::now() + std::chrono::milliseconds(100)));
+            }
+        }
+
+        try {
+            if (!coded) {
+                sender->SendRaw(frame.data.data(), frame.data.size(), frame.priority, frame.shard);
+            } else {
+                for (const std::string& record : records) {
+                    sender->SendRaw(record.data(), record.size(), frame.priority, frame.shard);
+                }
+            }
+            ++sent;
+        } catch (const std::exception&) {
+            ++errors;
+        }
+    }
+    try {
+        sender->Flush();
+    } catch (const std::exception&) {
+        ++errors;
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    LogLine line;
+    const bool human = log_sink->Format() == LogFormat::Human;
+    line.Append(human ? "\nReplayed " : "replay sent=").Append(sent)
+        .Append(human ? " frames in " : " seconds=").Append(static_cast<float>(seconds))
+        .Append(human ? " s (" : " rate=").Append(static_cast<float>(seconds > 0 ? sent / seconds : 0.0))
+        .Append(human ? "/s), errors=" : " errors=").Append(errors)
+        .Append('\n');
+    log_sink->Write(line);
+    log_sink->Flush();
+    std::cout << "\nTx process terminated.\n";
+    return 0;
+}
+
+/**
+ * @brief Ping-pong mode (`--ping`): times request/reply round trips against `main_rx --rpc`.
  * 
- * Serializes a `T_IPCData` object and sends it to the designated message queue.
- * If the queue is full or inaccessible, an exception is thrown.
+ * Keeps up to `--pipeline=K` requests in flight (default 1, i.e. strict
+ * ping-pong) and records each round trip, from just before the request is sent
+ * to the moment its reply is matched, in a latency histogram. Requests not
+ * answered within `--ping-timeout-ms` (default 1000) are counted as timeouts.
+ * Runs for `--ping=N` round trips, or until Ctrl+C with `--ping=0`.
  * 
- * @param data A `T_IPCData` object containing the data to be sent.
- * @throws std::runtime_error if the message queue cannot be opened or the message cannot be sent.
+ * @return The process exit code.
  */
-void txMessage(const T_IPCData& data) {
-    // Open the message queue
-    // O_WRONLY == Write only
-    // O_CREAT == Create the queue if it doesn't already exist
-    mqd_t mq = mq_open(QUEUE_NAME, O_WRONLY | O_CREAT, QUEUE_PERMISSIONS, nullptr);
-    if (mq == (mqd_t)-1) {
-        throw std::runtime_error("Failed to open message queue");
+int run_ping(int argc, char* argv[]) {
+    std::unique_ptr<RpcClient> client;
+    uint64_t count, pipeline;
+    std::chrono::milliseconds timeout;
+    try {
+        const std::string pings = util::getOption(argc, argv, "--ping", "1000");
+        count = pings == "true" ? 1000 : std::stoull(pings);
+        pipeline = std::stoull(util::getOption(argc, argv, "--pipeline", "1"));
+        timeout = std::chrono::milliseconds(std::stoi(util::getOption(argc, argv, "--ping-timeout-ms", "1000")));
+        client = std::make_unique<RpcClient>(RPC_QUEUE_NAME);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << " (start main_rx --rpc first)\n";
+        return 1;
+    }
+    if (pipeline < 1 || pipeline > client->MaxInFlight()) {
+        pipeline = std::clamp<uint64_t>(pipeline, 1, client->MaxInFlight());
+        log_sink->Write("Pipeline depth limited to " + std::to_string(pipeline) + " by the reply queue depth.\n");
     }
 
-    // Serialize the message
-    std::string serializedMessage = data.Serialize();
+    T_IPCData request = T_IPCData::Builder().SetTheInt(0).SetTheFloat(1.5f).SetTheString("ping").SetTheType(IPCData::TYPE1).Build();
+    std::unordered_map<uint64_t, uint64_t> sentAt; // Correlation id -> send time (ns)
+    LatencyHistogram roundTrips;
+    uint64_t sent = 0, timeouts = 0, errors = 0;
+    const auto started = std::chrono::steady_clock::now();
 
-    // Send the serialized message
-    if (mq_send(mq, serializedMessage.c_str(), serializedMessage.size(), 0) == -1) {
-        mq_close(mq);
-        throw std::runtime_error("Failed to send message");
+    while (!stop && (count == 0 || roundTrips.Count() + timeouts + errors < count)) {
+        // Top up the pipeline
+        while (!stop && sentAt.size() < pipeline && (count == 0 || sent < count)) {
+            try {
+                const uint64_t now = util::monotonicNanoseconds();
+                sentAt[client->Send(request, timeout)] = now;
+            } catch (const std::exception&) {
+                ++errors;
+            }
+            ++sent;
+        }
+        if (sentAt.empty()) {
+            continue;
+        }
+
+        std::optional<RpcReply> reply = client->WaitAny(timeout);
+        if (reply) {
+            auto entry = sentAt.find(reply->id);
+            roundTrips.Record(util::monotonicNanoseconds() - entry->second);
+            sentAt.erase(entry);
+        } else if (!stop) {
+            // Nothing came back in time; give up on everything in flight that is still unanswered
+            for (const auto& [id, sentNs] : sentAt) {
+                if (client->Wait(id, std::chrono::milliseconds(0))) {
+                    roundTrips.Record(util::monotonicNanoseconds() - sentNs);
+                } else {
+                    ++timeouts;
+                }
+            }
+            sentAt.clear();
+        }
     }
 
-    mq_close(mq);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    LogLine line;
+    const bool human = log_sink->Format() == LogFormat::Human;
+    line.Append(human ? "\nPing: " : "ping round_trips=").Append(roundTrips.Count())
+        .Append(human ? " round trips with " : " pipeline=").Append(pipeline)
+        .Append(human ? " in flight, " : " seconds=").Append(static_cast<float>(seconds))
+        .Append(human ? " s (" : " rate=").Append(static_cast<float>(seconds > 0 ? roundTrips.Count() / seconds : 0.0))
+        .Append(human ? "/s)\nRound trip (ns): min=" : " min_ns=").Append(roundTrips.Min())
+        .Append(human ? " p50=" : " p50_ns=").Append(roundTrips.Percentile(50))
+        .Append(human ? " p90=" : " p90_ns=").Append(roundTrips.Percentile(90))
+        .Append(human ? " p99=" : " p99_ns=").Append(roundTrips.Percentile(99))
+        .Append(human ? " p99.9=" : " p999_ns=").Append(roundTrips.Percentile(99.9))
+        .Append(human ? " max=" : " max_ns=").Append(roundTrips.Max())
+        .Append(" timeouts=").Append(timeouts)
+        .Append(" errors=").Append(errors)
+        .Append('\n');
+    log_sink->Write(line);
+    log_sink->Flush();
+    std::cout << "\nTx process terminated.\n";
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::signal(SIGINT, handle_signal);
 
-    std::cout << "Starting Tx process. Press Ctrl+C to stop.\n";
+    // --log-overflow=drop discards output lines instead of stalling the send loop when stdout falls behind
+    const bool dropLogs = util::getOption(argc, argv, "--log-overflow", "block") == "drop";
+    log_sink = std::make_unique<LogSink>(STDOUT_FILENO, dropLogs ? LogOverflowPolicy::Drop : LogOverflowPolicy::Block);
+
+    // Publish live counters for ipc_stat
+    const std::string statsName = StatsSegmentName("tx", getpid());
+    try {
+        stats_segment = std::make_unique<StatsSegment>(statsName, true, "tx");
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    stats::Publish(stats_segment.get());
+    struct StatsCleanup {
+        const std::string& name;
+        ~StatsCleanup() { StatsSegment::Unlink(name); }
+    } statsCleanup { statsName };
+
+    // Follow the receiver's shard count when it has published one
+    size_t shardCount = 1;
+    try {
+        shardCount = ControlSegment(CONTROL_SEGMENT_NAME, false).ShardCount();
+    } catch (const std::exception&) {
+        // No receiver running yet; send unsharded
+    }
+    if (shardCount > 1) {
+        log_sink->Write("Sending on " + std::to_string(shardCount) + " shards.\n");
+    }
+
+    // --replay=PATH sends a main_rx --capture file instead of generated records; see run_replay
+    if (!util::getOption(argc, argv, "--replay", "").empty()) {
+        return run_replay(argc, argv, shardCount);
+    }
+
+    // --ping=N times N request/reply round trips against main_rx --rpc; see run_ping
+    if (!util::getOption(argc, argv, "--ping", "").empty()) {
+        return run_ping(argc, argv);
+    }
+
+    // --rate=N switches to open-loop load generation; see run_load
+    if (!util::getOption(argc, argv, "--rate", "").empty()) {
+        return run_load(argc, argv, shardCount);
+    }
+
+    std::unique_ptr<ShardedSender> sender;
+    try {
+        sender = make_sender(argc, argv, shardCount);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    const bool useBatching = util::getOption(argc, argv, "--batch", "false") == "true";
+    const std::string overflow = util::getOption(argc, argv, "--overflow", "block");
+
+    // --string-bytes=N pads every string to N bytes; records over MAX_MESSAGE_SIZE go through main_rx's slab pool
+    const size_t stringBytes = std::stoul(util::getOption(argc, argv, "--string-bytes", "0"));
+
+    log_sink->Write("Starting Tx process. Press Ctrl+C to stop.\n");
 
     while (!stop) {
         T_IPCData data = generate_random_data();
+        if (stringBytes > 0 && data.GetTheString()) {
+            std::string padded(*data.GetTheString());
+            padded.resize(stringBytes, '.');
+            data = T_IPCData { data.GetTheInt(), data.GetTheFloat(), std::move(padded), data.GetTheType() };
+        }
 
         try {
-            txMessage(data);
-            std::cout << "\nMessage Sent:\n" << data.ToString();
+            if (useBatching) {
+                sender->Enqueue(data);
+            } else {
+                sender->Send(data);
+            }
+            log_sent(data);
         } catch (const std::exception& e) {
             std::cerr << "\nError: " << e.what() << "\n";
         }
@@ -129,9 +656,36 @@ int main() {
         for (int i = 0; i < 20 && !stop; ++i) {
             show_dots_spinner();
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            // Don't let a partial batch wait for the next record
+            try {
+                sender->FlushIfDue();
+            } catch (const std::exception& e) {
+                std::cerr << "\nError: " << e.what() << "\n";
+            }
         }
     }
 
+    try {
+        sender->Flush();
+    } catch (const std::exception& e) {
+        std::cerr << "\nError: " << e.what() << "\n";
+    }
+
+    if (overflow != "block") {
+        const SenderStats stats = sender->Stats();
+        LogLine line;
+        line.Append("\nSend stats: sent=").Append(stats.sent)
+            .Append(" buffered=").Append(stats.buffered)
+            .Append(" peak_buffered=").Append(stats.peakBuffered)
+            .Append(" dropped=").Append(stats.dropped)
+            .Append(" coalesced=").Append(stats.coalesced)
+            .Append(" deadline_misses=").Append(stats.deadlineMisses)
+            .Append('\n');
+        log_sink->Write(line);
+    }
+
+    log_sink->Flush();
     std::cout << "\nTx process terminated.\n";
 
     return 0;
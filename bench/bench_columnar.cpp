@@ -0,0 +1,79 @@
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "bench_fixtures.h"
+#include "columnar_batch.h"
+#include "t_ipc_data.h"
+
+/*
+    Window aggregation over received records: one decoded object at a time
+    versus columnar decoding plus vector kernels at each SIMD level.
+*/
+
+namespace {
+    constexpr size_t WINDOW_ROWS = 4096;
+
+    std::vector<std::string> MakeWindow() {
+        const int64_t mask = bench::HAS_INT | bench::HAS_FLOAT | bench::HAS_STRING | bench::HAS_TYPE;
+        std::vector<std::string> window;
+        for (size_t row = 0; row < WINDOW_ROWS; ++row) {
+            window.push_back(bench::MakeRecord(row % 4 == 0 ? bench::HAS_INT : mask, 16).Serialize());
+        }
+        return window;
+    }
+}
+
+/**
+ * @brief Baseline: decode every record into a `T_IPCData` and aggregate through its getters.
+ */
+static void BM_AggregatePerObject(benchmark::State& state) {
+    const std::vector<std::string> window = MakeWindow();
+    for (auto _ : state) {
+        int64_t sum = 0;
+        double floatSum = 0.0;
+        for (const std::string& record : window) {
+            T_IPCData data { record };
+            sum += data.GetTheInt().value_or(0);
+            floatSum += data.GetTheFloat().value_or(0.0f);
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(floatSum);
+    }
+    state.SetItemsProcessed(state.iterations() * WINDOW_ROWS);
+}
+BENCHMARK(BM_AggregatePerObject);
+
+/**
+ * @brief Decode the window into columns; the cost paid once per window before the kernels run.
+ */
+static void BM_ColumnarDecode(benchmark::State& state) {
+    const std::vector<std::string> window = MakeWindow();
+    ColumnarBatch batch(WINDOW_ROWS);
+    for (auto _ : state) {
+        batch.Clear();
+        for (const std::string& record : window) {
+            batch.AppendMessage(record.data(), record.size());
+        }
+        benchmark::DoNotOptimize(batch.Rows());
+    }
+    state.SetItemsProcessed(state.iterations() * WINDOW_ROWS);
+}
+BENCHMARK(BM_ColumnarDecode);
+
+/**
+ * @brief Aggregate an already-decoded window; argument 0 is the `SimdLevel`.
+ */
+static void BM_ColumnarSummarize(benchmark::State& state) {
+    const std::vector<std::string> window = MakeWindow();
+    ColumnarBatch batch(WINDOW_ROWS);
+    for (const std::string& record : window) {
+        batch.AppendMessage(record.data(), record.size());
+    }
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(batch.Summarize(level));
+    }
+    state.SetItemsProcessed(state.iterations() * WINDOW_ROWS);
+    state.SetLabel(SimdLevelName(level));
+}
+BENCHMARK(BM_ColumnarSummarize)->ArgName("simd")->DenseRange(0, 2);
@@ -0,0 +1,49 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "t_ipc_data.h"
+
+/*
+    Shared inputs for the bench_ipc suite.
+
+    Serialization benchmarks are parameterized over two arguments:
+      - a field-presence mask (bit 0 = the_int, 1 = the_float, 2 = the_string, 3 = the_type)
+      - the length of the_string when it is present
+*/
+namespace bench {
+    constexpr int64_t HAS_INT    = 1 << 0;
+    constexpr int64_t HAS_FLOAT  = 1 << 1;
+    constexpr int64_t HAS_STRING = 1 << 2;
+    constexpr int64_t HAS_TYPE   = 1 << 3;
+
+    /**
+     * @brief Builds a record with the given fields present and string length.
+     */
+    inline T_IPCData MakeRecord(int64_t presenceMask, int64_t stringLength) {
+        return T_IPCData {
+            (presenceMask & HAS_INT)    ? std::optional<int>(48151623)                                 : std::nullopt,
+            (presenceMask & HAS_FLOAT)  ? std::optional<float>(1701.0f)                                : std::nullopt,
+            (presenceMask & HAS_STRING) ? std::optional<std::string>(std::string(stringLength, 's'))   : std::nullopt,
+            (presenceMask & HAS_TYPE)   ? std::optional<IPCData::Type>(IPCData::TYPE2)                 : std::nullopt
+        };
+    }
+
+    /**
+     * @brief Applies the standard presence-mix x string-length argument grid.
+     *
+     * Masks cover: empty, int only, the three-field mix main_tx generates, and all fields.
+     */
+    inline void PresenceAndStringLengths(benchmark::internal::Benchmark* b) {
+        b->ArgNames({ "fields", "strlen" });
+        b->ArgsProduct({
+            { 0, HAS_INT, HAS_INT | HAS_FLOAT | HAS_STRING, HAS_INT | HAS_FLOAT | HAS_STRING | HAS_TYPE },
+            { 0, 16, 64, 256 }
+        });
+    }
+}
+
+#endif // BENCH_FIXTURES_H
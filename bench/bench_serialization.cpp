@@ -0,0 +1,101 @@
+#include <string>
+#include <benchmark/benchmark.h>
+#include "bench_fixtures.h"
+#include "constants.h"
+#include "flat_codec.h"
+#include "ipc_data_view.h"
+#include "t_ipc_data.h"
+#include "util.h"
+
+/*
+    Micro-benchmarks for the per-record hot paths: encoding, decoding,
+    formatting and timestamping.
+*/
+
+static void BM_Serialize(benchmark::State& state) {
+    const T_IPCData data = bench::MakeRecord(state.range(0), state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data.Serialize());
+    }
+}
+BENCHMARK(BM_Serialize)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_SerializeFlat(benchmark::State& state) {
+    const T_IPCData data = bench::MakeRecord(state.range(0), state.range(1));
+    char buffer[MAX_MESSAGE_SIZE];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(flat::Encode(data, buffer, sizeof(buffer)));
+    }
+}
+BENCHMARK(BM_SerializeFlat)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_ParseFromString(benchmark::State& state) {
+    const std::string serializedMessage = bench::MakeRecord(state.range(0), state.range(1)).Serialize();
+    for (auto _ : state) {
+        T_IPCData data { serializedMessage };
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetBytesProcessed(state.iterations() * serializedMessage.size());
+}
+BENCHMARK(BM_ParseFromString)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_ParseFlat(benchmark::State& state) {
+    const std::string serializedMessage = bench::MakeRecord(state.range(0), state.range(1)).SerializeFlat();
+    for (auto _ : state) {
+        T_IPCData data { serializedMessage };
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetBytesProcessed(state.iterations() * serializedMessage.size());
+}
+BENCHMARK(BM_ParseFlat)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_ParseView(benchmark::State& state) {
+    const std::string serializedMessage = bench::MakeRecord(state.range(0), state.range(1)).Serialize();
+    IPCDataView view;
+    for (auto _ : state) {
+        view.Parse(serializedMessage.data(), serializedMessage.size());
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * serializedMessage.size());
+}
+BENCHMARK(BM_ParseView)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_ParseFlatView(benchmark::State& state) {
+    const std::string serializedMessage = bench::MakeRecord(state.range(0), state.range(1)).SerializeFlat();
+    IPCDataView view;
+    for (auto _ : state) {
+        view.Parse(serializedMessage.data(), serializedMessage.size());
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * serializedMessage.size());
+}
+BENCHMARK(BM_ParseFlatView)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_ToString(benchmark::State& state) {
+    const T_IPCData data = bench::MakeRecord(state.range(0), state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data.ToString());
+    }
+}
+BENCHMARK(BM_ToString)->Apply(bench::PresenceAndStringLengths);
+
+static void BM_GetCurrentDateTimeWithMilliseconds(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(util::getCurrentDateTimeWithMilliseconds());
+    }
+}
+BENCHMARK(BM_GetCurrentDateTimeWithMilliseconds);
+
+/**
+ * @brief Cached formatter; argument 0 is the precision (0 = ms, 1 = us, 2 = ns), argument 1 selects the coarse clock.
+ */
+static void BM_CurrentTimestamp(benchmark::State& state) {
+    const auto precision = static_cast<util::TimestampPrecision>(state.range(0));
+    const auto clock = state.range(1) ? util::TimestampClock::RealtimeCoarse : util::TimestampClock::Realtime;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(util::currentTimestamp(precision, clock));
+    }
+}
+BENCHMARK(BM_CurrentTimestamp)
+    ->ArgNames({ "precision", "coarse" })
+    ->ArgsProduct({ { 0, 1, 2 }, { 0, 1 } });
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <mqueue.h>
+#include "batch_frame.h"
+#include "bench_fixtures.h"
+#include "broadcast_ring.h"
+#include "constants.h"
+#include "ipc_data_view.h"
+#include "receive_pool.h"
+#include "rpc.h"
+#include "sender.h"
+#include "shm_ring.h"
+#include "transport.h"
+
+/*
+    In-process end-to-end benchmarks over the real transports.
+
+    Latency is a ping-pong: the benchmark thread sends a serialized record, an
+    echo thread sends it straight back, and each round trip is timed manually
+    (p50/p99 of the round trip are reported as counters). Throughput streams
+    records through a Sender while a consumer thread receives and decodes them.
+    The BM_Transport* pair runs both through every `Transport` backend
+    (kind 0 = mqueue, 1 = shm ring, 2 = SEQPACKET socket, 3 = io_uring).
+*/
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RECEIVE_POLL_MS = 10;
+
+    /**
+     * @brief A message queue created for the benchmark and removed afterwards.
+     */
+    class BenchQueue {
+    public:
+        explicit BenchQueue(const std::string& name) : name_(name) {
+            mq_unlink(name_.c_str());
+            struct mq_attr attr {};
+            attr.mq_maxmsg = 10;
+            attr.mq_msgsize = MAX_MESSAGE_SIZE;
+            mq_ = mq_open(name_.c_str(), O_CREAT | O_RDWR, QUEUE_PERMISSIONS, &attr);
+            if (mq_ == (mqd_t)-1) {
+                throw std::runtime_error("Failed to open message queue " + name_);
+            }
+        }
+        ~BenchQueue() {
+            mq_close(mq_);
+            mq_unlink(name_.c_str());
+        }
+
+        const std::string& Name() const { return name_; }
+
+        void Send(const char* data, size_t size) { mq_send(mq_, data, size, 0); }
+        ssize_t Receive(char* buffer) { return mq_receive(mq_, buffer, MAX_MESSAGE_SIZE, nullptr); }
+        ssize_t ReceiveFor(char* buffer, int timeoutMs) {
+            timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += timeoutMs * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            return mq_timedreceive(mq_, buffer, MAX_MESSAGE_SIZE, nullptr, &deadline);
+        }
+
+    private:
+        std::string name_;
+        mqd_t mq_;
+    };
+
+    /**
+     * @brief A shared-memory ring created for the benchmark and removed afterwards.
+     */
+    class BenchRing {
+    public:
+        explicit BenchRing(const std::string& name) : name_(name), reader_(name, true) { }
+        ~BenchRing() { ShmRing::Unlink(name_); }
+
+        const std::string& Name() const { return name_; }
+
+        ssize_t Receive(char* buffer) {
+            ssize_t size;
+            while ((size = reader_.TryPop(buffer, MAX_MESSAGE_SIZE)) < 0) {
+                reader_.WaitForData(-1);
+            }
+            return size;
+        }
+        ssize_t ReceiveFor(char* buffer, int timeoutMs) {
+            ssize_t size = reader_.TryPop(buffer, MAX_MESSAGE_SIZE);
+            if (size < 0 && reader_.WaitForData(timeoutMs)) {
+                size = reader_.TryPop(buffer, MAX_MESSAGE_SIZE);
+            }
+            return size;
+        }
+
+    private:
+        std::string name_;
+        ShmRing reader_;
+    };
+
+    void ReportRoundTrips(benchmark::State& state, std::vector<double>& roundTripsNs) {
+        if (roundTripsNs.empty()) {
+            return;
+        }
+        std::sort(roundTripsNs.begin(), roundTripsNs.end());
+        auto at = [&](double q) { return roundTripsNs[static_cast<size_t>(q * (roundTripsNs.size() - 1))]; };
+        state.counters["rtt_p50_ns"] = at(0.50);
+        state.counters["rtt_p99_ns"] = at(0.99);
+        state.counters["rtt_max_ns"] = roundTripsNs.back();
+    }
+
+    /**
+     * @brief Counts every record in a received message (single record or batch), decoding each.
+     */
+    size_t DecodeMessage(const char* buffer, ssize_t size, IPCDataView& view) {
+        if (!IsBatchFrame(buffer, size)) {
+            view.Parse(buffer, size);
+            return 1;
+        }
+        size_t records = 0;
+        for (std::string_view record : BatchView(buffer, size)) {
+            view.Parse(record.data(), record.size());
+            ++records;
+        }
+        return records;
+    }
+}
+
+static void BM_MQueuePingPong(benchmark::State& state) {
+    BenchQueue ping("/ipc_bench_ping"), pong("/ipc_bench_pong");
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    std::atomic<bool> done { false };
+
+    std::thread echo([&] {
+        char buffer[MAX_MESSAGE_SIZE];
+        while (!done.load(std::memory_order_relaxed)) {
+            ssize_t size = ping.ReceiveFor(buffer, RECEIVE_POLL_MS);
+            if (size >= 0) {
+                pong.Send(buffer, size);
+            }
+        }
+    });
+
+    std::vector<double> samples;
+    char buffer[MAX_MESSAGE_SIZE];
+    for (auto _ : state) {
+        auto start = Clock::now();
+        ping.Send(message.data(), message.size());
+        pong.Receive(buffer);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        state.SetIterationTime(ns / 1e9);
+        samples.push_back(ns);
+    }
+    done = true;
+    echo.join();
+
+    ReportRoundTrips(state, samples);
+}
+BENCHMARK(BM_MQueuePingPong)->UseManualTime();
+
+static void BM_ShmRingPingPong(benchmark::State& state) {
+    BenchRing ping("/ipc_bench_ring_ping"), pong("/ipc_bench_ring_pong");
+    ShmRing pingWriter(ping.Name(), false), pongWriter(pong.Name(), false);
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    std::atomic<bool> done { false };
+
+    std::thread echo([&] {
+        char buffer[MAX_MESSAGE_SIZE];
+        while (!done.load(std::memory_order_relaxed)) {
+            ssize_t size = ping.ReceiveFor(buffer, RECEIVE_POLL_MS);
+            if (size >= 0) {
+                pongWriter.Push(buffer, size);
+            }
+        }
+    });
+
+    std::vector<double> samples;
+    char buffer[MAX_MESSAGE_SIZE];
+    for (auto _ : state) {
+        auto start = Clock::now();
+        pingWriter.Push(message.data(), message.size());
+        pong.Receive(buffer);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        state.SetIterationTime(ns / 1e9);
+        samples.push_back(ns);
+    }
+    done = true;
+    echo.join();
+
+    ReportRoundTrips(state, samples);
+}
+BENCHMARK(BM_ShmRingPingPong)->UseManualTime();
+
+/**
+ * @brief Receives one message from a Transport, waiting up to `RECEIVE_POLL_MS` at a time until it arrives or `done` is set.
+ */
+static bool ReceiveOne(Transport& transport, ReceiveSlot& slot, const std::atomic<bool>& done) {
+    while (!done.load(std::memory_order_relaxed)) {
+        if (transport.ReceiveBatch(&slot, 1) == 1) {
+            return true;
+        }
+        transport.WaitForData(RECEIVE_POLL_MS);
+    }
+    return false;
+}
+
+/**
+ * @brief Ping-pong round trips over each Transport backend, comparable with BM_MQueuePingPong.
+ *
+ * Argument 0 is the `TransportKind`. Each direction is its own channel.
+ */
+static void BM_TransportPingPong(benchmark::State& state) {
+    const TransportKind kind = static_cast<TransportKind>(state.range(0));
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    const std::string name = std::string("/ipc_bench_transport.") + TransportKindName(kind);
+    std::unique_ptr<Transport> pingReceiver = OpenTransport(kind, name + ".ping", TransportRole::Receiver);
+    std::unique_ptr<Transport> pongReceiver = OpenTransport(kind, name + ".pong", TransportRole::Receiver);
+    std::unique_ptr<Transport> pingSender = OpenTransport(kind, name + ".ping", TransportRole::Sender);
+    std::unique_ptr<Transport> pongSender = OpenTransport(kind, name + ".pong", TransportRole::Sender);
+    std::atomic<bool> done { false };
+
+    std::thread echo([&] {
+        char buffer[MAX_MESSAGE_SIZE];
+        ReceiveSlot slot { buffer, sizeof(buffer), 0, 0 };
+        while (ReceiveOne(*pingReceiver, slot, done)) {
+            pongSender->Send(slot.buffer, slot.size, 0, nullptr);
+        }
+    });
+
+    char buffer[MAX_MESSAGE_SIZE];
+    ReceiveSlot slot { buffer, sizeof(buffer), 0, 0 };
+    std::vector<double> samples;
+    for (auto _ : state) {
+        auto start = Clock::now();
+        pingSender->Send(message.data(), message.size(), 0, nullptr);
+        ReceiveOne(*pongReceiver, slot, done);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        state.SetIterationTime(ns / 1e9);
+        samples.push_back(ns);
+    }
+    done = true;
+    echo.join();
+    pingReceiver->Remove();
+    pongReceiver->Remove();
+
+    ReportRoundTrips(state, samples);
+}
+BENCHMARK(BM_TransportPingPong)
+    ->ArgName("kind")
+    ->DenseRange(static_cast<int>(TransportKind::MQueue), static_cast<int>(TransportKind::IoUring))
+    ->UseManualTime();
+
+/**
+ * @brief Streams serialized records through each Transport backend into a consumer thread, in batches.
+ *
+ * Argument 0 is the `TransportKind`; argument 1 is the number of messages
+ * handed to each SendBatch (the consumer always receives up to 64 at a time).
+ * Timing includes draining everything that was sent.
+ */
+static void BM_TransportThroughput(benchmark::State& state) {
+    constexpr size_t RECEIVE_BATCH = 64;
+    const TransportKind kind = static_cast<TransportKind>(state.range(0));
+    const size_t batchSize = static_cast<size_t>(state.range(1));
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    const std::string name = std::string("/ipc_bench_transport_stream.") + TransportKindName(kind);
+    std::unique_ptr<Transport> receiver = OpenTransport(kind, name, TransportRole::Receiver);
+    std::unique_ptr<Transport> sender = OpenTransport(kind, name, TransportRole::Sender);
+    const std::vector<OutgoingMessage> batch(batchSize, OutgoingMessage { message.data(), message.size(), 0 });
+
+    std::atomic<bool> done { false };
+    std::atomic<size_t> received { 0 };
+    std::thread consumer([&] {
+        std::vector<char> buffers(RECEIVE_BATCH * MAX_MESSAGE_SIZE);
+        ReceiveSlot slots[RECEIVE_BATCH];
+        for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+            slots[i] = ReceiveSlot { buffers.data() + i * MAX_MESSAGE_SIZE, MAX_MESSAGE_SIZE, 0, 0 };
+        }
+        while (!done.load(std::memory_order_relaxed)) {
+            const size_t count = receiver->ReceiveBatch(slots, RECEIVE_BATCH);
+            if (count == 0) {
+                receiver->WaitForData(RECEIVE_POLL_MS);
+            }
+            received.fetch_add(count, std::memory_order_relaxed);
+        }
+    });
+
+    // Send each batch in full, retrying the remainder whenever the channel fills up
+    size_t sent = 0;
+    for (auto _ : state) {
+        size_t offset = 0;
+        while (offset < batchSize) {
+            offset += sender->SendBatch(batch.data() + offset, batchSize - offset);
+            if (offset < batchSize && sender->Send(message.data(), message.size(), 0, nullptr)) {
+                ++offset; // Waited for room
+            }
+        }
+        sent += batchSize;
+    }
+    while (received.load(std::memory_order_relaxed) < sent) {
+        std::this_thread::yield();
+    }
+    done = true;
+    consumer.join();
+    receiver->Remove();
+
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+BENCHMARK(BM_TransportThroughput)
+    ->ArgNames({ "kind", "batch" })
+    ->ArgsProduct({ { 0, 1, 2, 3 }, { 1, 16 } })
+    ->UseRealTime();
+
+/**
+ * @brief Publishes serialized records into a BroadcastRing read by a varying number of subscriber threads.
+ *
+ * The publisher's rate should stay flat as subscribers are added, since it
+ * never looks at them. Subscribers that fall behind are overrun rather than
+ * slowing it down; the "lost" counter reports how many messages they skipped.
+ */
+static void BM_BroadcastFanOut(benchmark::State& state) {
+    const size_t subscriberCount = static_cast<size_t>(state.range(0));
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    const std::string name = "/ipc_bench_broadcast";
+    BroadcastRing publisher(name, true);
+
+    std::atomic<bool> done { false };
+    std::atomic<uint64_t> lost { 0 };
+    std::vector<std::thread> subscribers;
+    for (size_t i = 0; i < subscriberCount; ++i) {
+        subscribers.emplace_back([&] {
+            BroadcastRing subscriber(name, false);
+            char buffer[MAX_MESSAGE_SIZE];
+            while (!done.load(std::memory_order_relaxed)) {
+                if (subscriber.TryRead(buffer, sizeof(buffer)) < 0) {
+                    subscriber.WaitForData(RECEIVE_POLL_MS);
+                }
+            }
+            lost.fetch_add(subscriber.Lost(), std::memory_order_relaxed);
+        });
+    }
+
+    for (auto _ : state) {
+        publisher.Publish(message.data(), message.size());
+    }
+    done = true;
+    for (std::thread& subscriber : subscribers) {
+        subscriber.join();
+    }
+    BroadcastRing::Unlink(name);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["lost"] = static_cast<double>(lost.load());
+}
+BENCHMARK(BM_BroadcastFanOut)->ArgName("subscribers")->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/**
+ * @brief Request/reply round trips through RpcClient::Call, against an echoing RpcServer thread.
+ *
+ * Compared with BM_MQueuePingPong this adds the envelope, the protobuf
+ * encode/decode on both sides and the correlation bookkeeping.
+ */
+static void BM_RpcCall(benchmark::State& state) {
+    const std::string name = "/ipc_bench_rpc";
+    mq_unlink(name.c_str());
+    RpcServer server(name, QueueProvisioner { QueueWorkload() });
+    RpcClient client(name);
+    const T_IPCData request = bench::MakeRecord(0b1111, 23);
+    std::atomic<bool> done { false };
+
+    std::thread echo([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            if (std::optional<RpcRequest> received = server.Receive(std::chrono::milliseconds(RECEIVE_POLL_MS))) {
+                server.Reply(*received, received->data);
+            }
+        }
+    });
+
+    std::vector<double> samples;
+    for (auto _ : state) {
+        auto start = Clock::now();
+        benchmark::DoNotOptimize(client.Call(request, std::chrono::seconds(1)));
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        state.SetIterationTime(ns / 1e9);
+        samples.push_back(ns);
+    }
+    done = true;
+    echo.join();
+    mq_unlink(name.c_str());
+
+    ReportRoundTrips(state, samples);
+}
+BENCHMARK(BM_RpcCall)->UseManualTime();
+
+/**
+ * @brief Streams records through a Sender into a decoding consumer thread.
+ *
+ * Argument 0 selects the transport (0 = mqueue, 1 = shm ring); argument 1
+ * enables batching. Timing includes draining everything that was sent.
+ */
+static void BM_SenderThroughput(benchmark::State& state) {
+    const bool useShmRing = state.range(0) == 1;
+    const bool useBatching = state.range(1) == 1;
+    const T_IPCData record = bench::MakeRecord(0b1111, 23);
+
+    std::unique_ptr<BenchQueue> queue;
+    std::unique_ptr<BenchRing> ring;
+    if (useShmRing) {
+        ring = std::make_unique<BenchRing>("/ipc_bench_ring_stream");
+    } else {
+        queue = std::make_unique<BenchQueue>("/ipc_bench_stream");
+    }
+    Sender sender(useShmRing ? SenderTransport::ShmRing : SenderTransport::MQueue,
+                  useShmRing ? ring->Name() : queue->Name());
+
+    std::atomic<bool> done { false };
+    std::atomic<size_t> received { 0 };
+    std::thread consumer([&] {
+        char buffer[MAX_MESSAGE_SIZE];
+        IPCDataView view;
+        while (!done.load(std::memory_order_relaxed)) {
+            ssize_t size = useShmRing ? ring->ReceiveFor(buffer, RECEIVE_POLL_MS) : queue->ReceiveFor(buffer, RECEIVE_POLL_MS);
+            if (size >= 0) {
+                received.fetch_add(DecodeMessage(buffer, size, view), std::memory_order_relaxed);
+            }
+        }
+    });
+
+    size_t sent = 0;
+    for (auto _ : state) {
+        if (useBatching) {
+            sender.Enqueue(record);
+        } else {
+            sender.Send(record);
+        }
+        ++sent;
+    }
+    sender.Flush();
+    while (received.load(std::memory_order_relaxed) < sent) {
+        std::this_thread::yield();
+    }
+    done = true;
+    consumer.join();
+
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+BENCHMARK(BM_SenderThroughput)
+    ->ArgNames({ "shm", "batch" })
+    ->ArgsProduct({ { 0, 1 }, { 0, 1 } })
+    ->UseRealTime();
+
+/**
+ * @brief Feeds serialized records through a ReceivePool whose handler decodes and formats each one.
+ *
+ * Argument 0 is the worker count. Timing includes waiting for the pool to drain,
+ * so this is end-to-end processing throughput as seen by the receive thread.
+ */
+static void BM_ReceivePoolThroughput(benchmark::State& state) {
+    const std::string message = bench::MakeRecord(0b1111, 23).Serialize();
+    ReceivePoolOptions options;
+    options.workers = static_cast<size_t>(state.range(0));
+    ReceivePool pool([](const T_IPCData& data, unsigned) { benchmark::DoNotOptimize(data.ToString()); }, nullptr, options);
+
+    for (auto _ : state) {
+        pool.Submit(message.data(), message.size());
+    }
+    pool.Drain();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReceivePoolThroughput)->ArgName("workers")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
@@ -0,0 +1,148 @@
+#include <cstring>
+#include <stdexcept>
+#include "batch_frame.h"
+
+namespace {
+    // Worst-case size of a varint-encoded uint32 length prefix
+    constexpr size_t MAX_VARINT32_SIZE = 5;
+
+    size_t VarintSize(uint32_t value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    char* WriteVarint(uint32_t value, char* out) {
+        while (value >= 0x80) {
+            *out++ = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<char>(value);
+        return out;
+    }
+}
+
+/* -----------------------------------------
+   BatchEncoder
+   ----------------------------------------- */
+
+/**
+ * @brief Constructor.
+ *
+ * Preallocates the whole batch buffer and writes the marker byte once.
+ *
+ * @param capacity Maximum size of a batch message in bytes (normally `MAX_MESSAGE_SIZE`).
+ */
+BatchEncoder::BatchEncoder(size_t capacity)
+    : buffer_(capacity), size_(1), count_(0) {
+    buffer_[0] = static_cast<char>(BATCH_FRAME_MARKER);
+}
+
+/**
+ * @brief Checks whether a record of the given size still fits in the current batch.
+ */
+bool BatchEncoder::Fits(size_t recordSize) const {
+    return size_ + VarintSize(static_cast<uint32_t>(recordSize)) + recordSize <= buffer_.size();
+}
+
+/**
+ * @brief Writes the length prefix for a record and returns where its bytes go.
+ *
+ * Lets the caller serialize straight into the batch buffer without an
+ * intermediate copy. The caller must write exactly `recordSize` bytes.
+ *
+ * @param recordSize Size of the record in bytes.
+ * @return Pointer to the first byte of the reserved record space.
+ * @throws std::length_error if the record does not fit (check `Fits` first).
+ */
+char* BatchEncoder::Reserve(size_t recordSize) {
+    if (!Fits(recordSize)) {
+        throw std::length_error("Record does not fit in the batch frame.");
+    }
+
+    char* record = WriteVarint(static_cast<uint32_t>(recordSize), buffer_.data() + size_);
+    size_ = static_cast<size_t>(record - buffer_.data()) + recordSize;
+    ++count_;
+
+    return record;
+}
+
+/**
+ * @brief Copies an already serialized record into the batch.
+ *
+ * @throws std::length_error if the record does not fit (check `Fits` first).
+ */
+void BatchEncoder::Append(const char* record, size_t recordSize) {
+    std::memcpy(Reserve(recordSize), record, recordSize);
+}
+
+/**
+ * @brief Empties the batch, keeping the buffer and marker byte.
+ */
+void BatchEncoder::Clear() {
+    size_ = 1;
+    count_ = 0;
+}
+
+/* -----------------------------------------
+   BatchView
+   ----------------------------------------- */
+
+/**
+ * @brief Constructor.
+ *
+ * @param buffer A received message for which `IsBatchFrame` is true.
+ * @param size Size of the message in bytes.
+ * @throws std::runtime_error if the message is not a batch envelope.
+ */
+BatchView::BatchView(const char* buffer, size_t size)
+    : begin_(buffer + 1), end_(buffer + size) {
+    if (!IsBatchFrame(buffer, size)) {
+        throw std::runtime_error("Message is not a batch frame.");
+    }
+}
+
+BatchView::Iterator::Iterator(const char* position, const char* end)
+    : position_(position), next_(position), end_(end) {
+    Decode();
+}
+
+BatchView::Iterator& BatchView::Iterator::operator++() {
+    position_ = next_;
+    Decode();
+    return *this;
+}
+
+/**
+ * @brief Decodes the length prefix at the current position.
+ *
+ * @throws std::runtime_error if the length prefix or record is truncated.
+ */
+void BatchView::Iterator::Decode() {
+    if (position_ == end_) {
+        return;
+    }
+
+    uint32_t length = 0;
+    const char* cursor = position_;
+    for (size_t shift = 0; ; shift += 7) {
+        if (cursor == end_ || shift >= 7 * MAX_VARINT32_SIZE) {
+            throw std::runtime_error("Malformed batch frame length prefix.");
+        }
+        uint8_t byte = static_cast<uint8_t>(*cursor++);
+        length |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    if (length > static_cast<size_t>(end_ - cursor)) {
+        throw std::runtime_error("Batch frame record is truncated.");
+    }
+
+    record_ = std::string_view(cursor, length);
+    next_ = cursor + length;
+}
@@ -0,0 +1,99 @@
+#ifndef BATCH_FRAME_H
+#define BATCH_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include "constants.h"
+
+/*
+    Batch envelope: many serialized IPCData records in one queue message.
+
+        [BATCH_FRAME_MARKER][varint len][record bytes][varint len][record bytes]...
+
+    Protobuf has no wire type 7, so a plain serialized IPCData can never start
+    with the marker byte and the receiver can tell the two apart from byte 0.
+*/
+constexpr uint8_t BATCH_FRAME_MARKER = 0x07;
+
+/**
+ * @brief Returns true if a received message is a batch envelope rather than a single record.
+ */
+inline bool IsBatchFrame(const char* buffer, size_t size) {
+    return size > 0 && static_cast<uint8_t>(buffer[0]) == BATCH_FRAME_MARKER;
+}
+
+/**
+ * @brief Accumulates length-prefixed records into a single batch message.
+ */
+class BatchEncoder {
+public:
+    // Constructors
+    explicit BatchEncoder(size_t capacity = MAX_MESSAGE_SIZE);
+
+    // Methods
+    bool Fits(size_t recordSize) const;
+    char* Reserve(size_t recordSize);
+    void Append(const char* record, size_t recordSize);
+    void Clear();
+
+    // Getters
+    const char* Data() const { return buffer_.data(); }
+    size_t Size() const { return size_; }
+    size_t Count() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+
+private:
+    // Members
+    std::vector<char> buffer_;
+    size_t size_;
+    size_t count_;
+};
+
+/**
+ * @brief Read-only view that iterates the records of a batch message in place.
+ *
+ * Each record is yielded as a `std::string_view` into the receive buffer, so
+ * the buffer must outlive the iteration.
+ */
+class BatchView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        Iterator(const char* position, const char* end);
+
+        reference operator*() const { return record_; }
+        pointer operator->() const { return &record_; }
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return position_ == other.position_; }
+        bool operator!=(const Iterator& other) const { return position_ != other.position_; }
+
+    private:
+        const char* position_; // Start of the current record's length prefix (== end_ when done)
+        const char* next_;     // Start of the following record's length prefix
+        const char* end_;
+        std::string_view record_;
+
+        void Decode();
+    };
+
+    // Constructors
+    BatchView(const char* buffer, size_t size);
+
+    Iterator begin() const { return Iterator(begin_, end_); }
+    Iterator end() const { return Iterator(end_, end_); }
+
+private:
+    const char* begin_;
+    const char* end_;
+};
+
+#endif // BATCH_FRAME_H
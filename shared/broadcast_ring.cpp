@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "broadcast_ring.h"
+
+namespace {
+    // Marks a segment whose header has been fully initialized by the publisher
+    constexpr uint32_t BROADCAST_RING_MAGIC = 0x49504342; // "IPCB"
+
+    long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+        // Not FUTEX_PRIVATE_FLAG: the word lives in memory shared between processes
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+    }
+}
+
+/**
+ * @brief Constructor that maps (and, for the publisher, creates) the ring segment.
+ *
+ * The publisher removes any leftover segment and sizes a fresh one for
+ * `BROADCAST_RING_SLOTS` slots. A subscriber attaches to the existing
+ * segment, validates it, and starts with the next message to be published.
+ *
+ * @param name POSIX shared-memory name, e.g. `BROADCAST_RING_NAME`.
+ * @param create True for the publisher, false for a subscriber.
+ * @throws std::runtime_error if the segment cannot be opened, sized, mapped or validated.
+ */
+BroadcastRing::BroadcastRing(const std::string& name, bool create)
+    : header_(nullptr), slots_(nullptr), mappedSize_(0), fd_(-1), next_(0), lost_(0), overruns_(0) {
+    if (create) {
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, QUEUE_PERMISSIONS);
+    } else {
+        fd_ = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd_ == -1) {
+        throw std::runtime_error(create ? "Failed to create broadcast ring" : "No broadcast ring to subscribe to");
+    }
+
+    if (create) {
+        mappedSize_ = sizeof(Header) + BROADCAST_RING_SLOTS * sizeof(Slot);
+        if (ftruncate(fd_, static_cast<off_t>(mappedSize_)) == -1) {
+            close(fd_);
+            throw std::runtime_error("Failed to size broadcast ring");
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            close(fd_);
+            throw std::runtime_error("Broadcast ring is not initialized");
+        }
+        mappedSize_ = static_cast<size_t>(st.st_size);
+    }
+
+    void* addr = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map broadcast ring");
+    }
+
+    header_ = static_cast<Header*>(addr);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(addr) + sizeof(Header));
+
+    if (create) {
+        // ftruncate zero-fills, so the head, the parking fields and every slot's sequence start at 0
+        header_->slotCount = BROADCAST_RING_SLOTS;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = BROADCAST_RING_MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->magic != BROADCAST_RING_MAGIC || header_->slotCount == 0 ||
+            mappedSize_ < sizeof(Header) + header_->slotCount * sizeof(Slot)) {
+            munmap(addr, mappedSize_);
+            close(fd_);
+            throw std::runtime_error("Broadcast ring is not initialized");
+        }
+        next_ = header_->head.load(std::memory_order_acquire);
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the segment. The segment itself persists until `Unlink` is called.
+ */
+BroadcastRing::~BroadcastRing() {
+    munmap(header_, mappedSize_);
+    close(fd_);
+}
+
+/**
+ * @brief Writes one message into the next slot, overwriting the oldest, and wakes any parked subscribers.
+ *
+ * Never waits: the work per message does not depend on how many subscribers
+ * there are or how far behind they are.
+ *
+ * @param data Pointer to the serialized message.
+ * @param size Size of the message in bytes (at most `MAX_MESSAGE_SIZE`).
+ * @throws std::length_error if the message does not fit in a slot.
+ */
+void BroadcastRing::Publish(const char* data, size_t size) {
+    if (size > MAX_MESSAGE_SIZE) {
+        throw std::length_error("Message exceeds broadcast ring slot size.");
+    }
+
+    const uint64_t message = header_->head.load(std::memory_order_relaxed);
+    Slot& slot = slots_[message % header_->slotCount];
+
+    // Mark the slot as being written before any of its bytes change, then publish it whole
+    slot.sequence.store(2 * message + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.size = static_cast<uint32_t>(size);
+    std::memcpy(slot.data, data, size);
+    slot.sequence.store(2 * message + 2, std::memory_order_release);
+    header_->head.store(message + 1, std::memory_order_release);
+
+    Wake();
+}
+
+/**
+ * @brief Copies this subscriber's next message out of the ring without blocking.
+ *
+ * The copy is validated against the slot's sequence number after it is
+ * taken, so a message the publisher overwrote mid-copy is never returned.
+ * If the subscriber has been overrun, it first skips to the oldest message
+ * still in the ring and adds what it skipped to `Lost`.
+ *
+ * @param buffer Destination buffer.
+ * @param capacity Size of the destination buffer in bytes.
+ * @return The message size in bytes, or -1 if there is no new message.
+ * @throws std::length_error if the message does not fit in the buffer (the message is skipped).
+ */
+ssize_t BroadcastRing::TryRead(char* buffer, size_t capacity) {
+    const uint64_t slotCount = header_->slotCount;
+    for (;;) {
+        const uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (next_ == head) {
+            return -1;
+        }
+        if (head - next_ > slotCount) {
+            SkipTo(head - slotCount);
+        }
+
+        const Slot& slot = slots_[next_ % slotCount];
+        const uint64_t expected = 2 * next_ + 2;
+        if (slot.sequence.load(std::memory_order_acquire) == expected) {
+            const size_t size = std::min<size_t>(slot.size, MAX_MESSAGE_SIZE);
+            std::memcpy(buffer, slot.data, std::min(size, capacity));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                ++next_;
+                if (size > capacity) {
+                    throw std::length_error("Receive buffer is smaller than the broadcast ring message.");
+                }
+                return static_cast<ssize_t>(size);
+            }
+        }
+
+        // Overwritten before or while it was copied: the publisher has lapped this subscriber
+        const uint64_t latest = header_->head.load(std::memory_order_acquire);
+        SkipTo(std::max(next_ + 1, latest > slotCount ? latest - slotCount + 1 : 0));
+    }
+}
+
+/**
+ * @brief Waits until this subscriber has a new message.
+ *
+ * Returns immediately when one is available; otherwise parks on the ring's
+ * futex, which the publisher only signals while a subscriber is parked.
+ *
+ * @param timeoutMs Maximum time to wait, or -1 to wait indefinitely.
+ * @return True if a message is available.
+ */
+bool BroadcastRing::WaitForData(int timeoutMs) {
+    if (next_ != header_->head.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    // Raise the flag before re-checking, so the publisher either sees it or this subscriber sees the
+    // new message; a wake that happens in between changes the futex word and the wait returns at once
+    const uint32_t sequence = header_->futexWord.load(std::memory_order_acquire);
+    header_->parked.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (next_ == header_->head.load(std::memory_order_acquire)) {
+        timespec timeout { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+        futex(&header_->futexWord, FUTEX_WAIT, sequence, timeoutMs < 0 ? nullptr : &timeout);
+    }
+
+    return next_ != header_->head.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Returns true if this ring's name has been removed, i.e. its publisher has exited or been replaced.
+ *
+ * No new message can arrive after that, so a subscriber should stop. Costs an
+ * `fstat`, so check it after a wait times out rather than on every message.
+ */
+bool BroadcastRing::Orphaned() const {
+    struct stat st;
+    return fstat(fd_, &st) == 0 && st.st_nlink == 0;
+}
+
+/**
+ * @brief Removes the named ring segment from the system.
+ */
+void BroadcastRing::Unlink(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Moves this subscriber forward to `message`, counting everything in between as lost.
+ */
+void BroadcastRing::SkipTo(uint64_t message) {
+    lost_ += message - next_;
+    ++overruns_;
+    next_ = message;
+}
+
+/**
+ * @brief Wakes every parked subscriber, but only if one has parked since the last wake.
+ *
+ * Clearing the flag means a burst of publishes costs one `FUTEX_WAKE`, not one
+ * per message while the woken subscribers are still getting back on a CPU.
+ */
+void BroadcastRing::Wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->parked.load(std::memory_order_relaxed) != 0 && header_->parked.exchange(0, std::memory_order_relaxed) != 0) {
+        header_->futexWord.fetch_add(1, std::memory_order_release);
+        futex(&header_->futexWord, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include "constants.h"
+
+/**
+ * @brief Single-writer, many-reader broadcast ring in POSIX shared memory.
+ *
+ * The publisher writes every message once into the next slot and never
+ * waits: it does not know how many subscribers there are, so its cost per
+ * message is the same for one subscriber as for fifty. Each subscriber keeps
+ * its own read position and copies messages out independently.
+ *
+ * Slots are guarded seqlock-style by a per-slot sequence number, odd while
+ * the publisher is writing the slot and `2 * n + 2` once it holds message
+ * `n`. A subscriber that falls more than a ring's worth behind finds its next
+ * slot overwritten, skips ahead to the oldest message still in the ring, and
+ * counts what it missed in `Lost` instead of slowing the publisher down.
+ *
+ * A publisher removes the ring's name when it exits and replaces any ring
+ * it finds when it starts, so a subscriber still mapping the old ring would
+ * wait forever; `Orphaned` tells it the ring has been removed.
+ */
+class BroadcastRing {
+public:
+    // Constructors
+    BroadcastRing(const std::string& name, bool create);
+    ~BroadcastRing();
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Methods
+    void Publish(const char* data, size_t size);     // Publisher only
+    ssize_t TryRead(char* buffer, size_t capacity);
+    bool WaitForData(int timeoutMs);
+
+    // Getters
+    uint64_t Published() const { return header_->head.load(std::memory_order_acquire); }
+    uint64_t Lost() const { return lost_; }         // Messages this subscriber skipped after being overrun
+    uint64_t Overruns() const { return overruns_; } // Times this subscriber was overrun
+    bool Orphaned() const;
+    size_t SlotCount() const { return header_->slotCount; }
+
+    static void Unlink(const std::string& name);
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> sequence; // Odd while being written; 2 * n + 2 once it holds message n
+        uint32_t size;
+        char data[MAX_MESSAGE_SIZE];
+    };
+
+    // Layout of the mapped segment; subscribers only ever write the parking fields
+    struct Header {
+        uint32_t magic;
+        uint32_t slotCount;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head; // Number of messages published
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> parked; // Set by a subscriber about to sleep, cleared by the wake
+        std::atomic<uint32_t> futexWord;
+    };
+
+    // Members
+    Header* header_;
+    Slot* slots_;
+    size_t mappedSize_;
+    int fd_;
+
+    // Subscriber state, private to this process
+    uint64_t next_;     // Number of the next message to read
+    uint64_t lost_;
+    uint64_t overruns_;
+
+    // Helper methods
+    void SkipTo(uint64_t message);
+    void Wake();
+};
+
+#endif // BROADCAST_RING_H
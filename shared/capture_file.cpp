@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "capture_file.h"
+
+namespace {
+    constexpr char CAPTURE_MAGIC[8] = { 'I', 'P', 'C', 'C', 'A', 'P', '0', '1' };
+    constexpr uint32_t CAPTURE_VERSION = 1;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t indexInterval;
+        std::atomic<uint64_t> end;    // Offset just past the last complete frame
+        std::atomic<uint64_t> frames;
+    };
+
+    struct FrameHeader {
+        uint64_t timestampNs;
+        uint32_t size;
+        uint8_t priority;
+        uint8_t reserved;
+        uint16_t shard;
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(FrameHeader) % 8 == 0, "Capture headers must keep frames 8-byte aligned");
+
+    size_t alignUp(size_t size) {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    std::string indexPath(const std::string& path) {
+        return path + ".idx";
+    }
+}
+
+/**
+ * @brief Constructor that creates (or truncates) the capture file and its index.
+ *
+ * @param path File to write; `<path>.idx` receives the sparse index.
+ * @param chunkSize How much the file grows by when it is full.
+ * @throws std::runtime_error if the files cannot be created, sized or mapped.
+ */
+CaptureWriter::CaptureWriter(const std::string& path, size_t chunkSize)
+    : fd_(-1), indexFd_(-1), base_(nullptr), mapped_(0), chunkSize_(std::max(alignUp(chunkSize), sizeof(FileHeader))),
+      end_(sizeof(FileHeader)), frames_(0) {
+    fd_ = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    indexFd_ = open(indexPath(path).c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_APPEND, 0644);
+    if (fd_ == -1 || indexFd_ == -1 || ftruncate(fd_, static_cast<off_t>(chunkSize_)) == -1) {
+        if (fd_ != -1) close(fd_);
+        if (indexFd_ != -1) close(indexFd_);
+        throw std::runtime_error("Failed to create capture file " + path);
+    }
+
+    void* addr = mmap(nullptr, chunkSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        close(indexFd_);
+        throw std::runtime_error("Failed to map capture file " + path);
+    }
+    base_ = static_cast<char*>(addr);
+    mapped_ = chunkSize_;
+
+    auto* header = reinterpret_cast<FileHeader*>(base_);
+    std::memcpy(header->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    header->version = CAPTURE_VERSION;
+    header->indexInterval = static_cast<uint32_t>(CAPTURE_INDEX_INTERVAL);
+    header->frames.store(0, std::memory_order_relaxed);
+    header->end.store(end_, std::memory_order_release);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Trims the file to the committed frames and unmaps it.
+ */
+CaptureWriter::~CaptureWriter() {
+    munmap(base_, mapped_);
+    if (ftruncate(fd_, static_cast<off_t>(end_)) == -1) {
+        // The header's end offset still marks the valid data
+    }
+    close(fd_);
+    close(indexFd_);
+}
+
+/**
+ * @brief Appends one frame.
+ *
+ * @param data The frame bytes, exactly as received.
+ * @param size Number of bytes.
+ * @param priority The queue priority it arrived with.
+ * @param shard The shard queue it arrived on.
+ * @param timestampNs `CLOCK_MONOTONIC` receive time in nanoseconds.
+ * @throws std::runtime_error if the file cannot grow.
+ */
+void CaptureWriter::Append(const char* data, size_t size, unsigned priority, uint16_t shard, uint64_t timestampNs) {
+    const size_t recordSize = sizeof(FrameHeader) + alignUp(size);
+    if (end_ + recordSize > mapped_) {
+        Grow(recordSize);
+    }
+
+    // Index the first frame of every interval
+    if (frames_ % CAPTURE_INDEX_INTERVAL == 0) {
+        const CaptureIndexEntry entry { frames_, timestampNs, end_ };
+        if (write(indexFd_, &entry, sizeof(entry)) != static_cast<ssize_t>(sizeof(entry))) {
+            // A missing index entry only makes seeking slower
+        }
+    }
+
+    FrameHeader frame {};
+    frame.timestampNs = timestampNs;
+    frame.size = static_cast<uint32_t>(size);
+    frame.priority = static_cast<uint8_t>(priority);
+    frame.shard = shard;
+    std::memcpy(base_ + end_, &frame, sizeof(frame));
+    std::memcpy(base_ + end_ + sizeof(frame), data, size);
+
+    end_ += recordSize;
+    ++frames_;
+    auto* header = reinterpret_cast<FileHeader*>(base_);
+    header->frames.store(frames_, std::memory_order_relaxed);
+    header->end.store(end_, std::memory_order_release);
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Extends the file and its mapping by at least `needed` bytes (one chunk or more).
+ */
+void CaptureWriter::Grow(size_t needed) {
+    const size_t newSize = mapped_ + std::max(chunkSize_, alignUp(needed));
+    if (ftruncate(fd_, static_cast<off_t>(newSize)) == -1) {
+        throw std::runtime_error("Failed to grow capture file");
+    }
+    void* addr = mremap(base_, mapped_, newSize, MREMAP_MAYMOVE);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to remap capture file");
+    }
+    base_ = static_cast<char*>(addr);
+    mapped_ = newSize;
+}
+
+/**
+ * @brief Constructor that maps a capture file read-only and loads its index.
+ *
+ * A missing or short `<path>.idx` is not an error; `Seek` then scans.
+ *
+ * @param path The capture file.
+ * @throws std::runtime_error if the file cannot be opened or mapped, or is not a capture.
+ */
+CaptureReader::CaptureReader(const std::string& path)
+    : base_(nullptr), size_(0), end_(0), cursor_(sizeof(FileHeader)), frames_(0), firstTimestampNs_(0) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd == -1 || fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        if (fd != -1) close(fd);
+        throw std::runtime_error("Failed to open capture file " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map capture file " + path);
+    }
+    base_ = static_cast<const char*>(addr);
+    madvise(addr, size_, MADV_SEQUENTIAL);
+
+    const auto* header = reinterpret_cast<const FileHeader*>(base_);
+    end_ = header->end.load(std::memory_order_acquire);
+    if (std::memcmp(header->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 || header->version != CAPTURE_VERSION ||
+        end_ < sizeof(FileHeader) || end_ > size_) {
+        munmap(addr, size_);
+        throw std::runtime_error("Not a valid capture file: " + path);
+    }
+    frames_ = header->frames.load(std::memory_order_relaxed);
+
+    CaptureFrame first;
+    uint64_t next;
+    if (Peek(cursor_, first, next)) {
+        firstTimestampNs_ = first.timestampNs;
+    }
+
+    const int indexFd = open(indexPath(path).c_str(), O_RDONLY);
+    if (indexFd != -1) {
+        CaptureIndexEntry entry;
+        while (read(indexFd, &entry, sizeof(entry)) == static_cast<ssize_t>(sizeof(entry)) && entry.offset < end_) {
+            index_.push_back(entry);
+        }
+        close(indexFd);
+    }
+}
+
+CaptureReader::~CaptureReader() {
+    munmap(const_cast<char*>(base_), size_);
+}
+
+/**
+ * @brief Returns the next frame, or false at the end of the capture.
+ *
+ * @throws std::runtime_error if a frame header points past the committed data.
+ */
+bool CaptureReader::Next(CaptureFrame& frame) {
+    uint64_t next;
+    if (!Peek(cursor_, frame, next)) {
+        return false;
+    }
+    cursor_ = next;
+    return true;
+}
+
+/**
+ * @brief Positions the reader at the first frame received at or after `timestampNs`.
+ *
+ * Jumps to the last index entry before the target, then scans at most one
+ * index interval of frames.
+ */
+void CaptureReader::Seek(uint64_t timestampNs) {
+    auto after = std::upper_bound(index_.begin(), index_.end(), timestampNs,
+                                  [](uint64_t target, const CaptureIndexEntry& entry) { return target < entry.timestampNs; });
+    cursor_ = after == index_.begin() ? sizeof(FileHeader) : std::prev(after)->offset;
+
+    CaptureFrame frame;
+    uint64_t next;
+    while (Peek(cursor_, frame, next) && frame.timestampNs < timestampNs) {
+        cursor_ = next;
+    }
+}
+
+void CaptureReader::Rewind() {
+    cursor_ = sizeof(FileHeader);
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+bool CaptureReader::Peek(uint64_t offset, CaptureFrame& frame, uint64_t& next) const {
+    if (offset + sizeof(FrameHeader) > end_) {
+        return false;
+    }
+    FrameHeader header;
+    std::memcpy(&header, base_ + offset, sizeof(header));
+    next = offset + sizeof(FrameHeader) + alignUp(header.size);
+    if (next > end_) {
+        throw std::runtime_error("Capture frame runs past the end of the capture.");
+    }
+
+    frame.timestampNs = header.timestampNs;
+    frame.priority = header.priority;
+    frame.shard = header.shard;
+    frame.data = std::string_view(base_ + offset + sizeof(FrameHeader), header.size);
+    return true;
+}
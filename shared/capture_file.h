@@ -0,0 +1,116 @@
+#ifndef CAPTURE_FILE_H
+#define CAPTURE_FILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    Capture file: an append-only log of raw received frames.
+
+        [FileHeader][FrameHeader][frame bytes][pad to 8]...[FrameHeader][frame bytes][pad to 8]
+
+    `FileHeader::end` is advanced only after a frame is completely written, so
+    a reader (or a capture cut short by a crash) never sees a partial frame.
+    A sparse index of `{frame, timestamp, offset}` entries, one every
+    `CAPTURE_INDEX_INTERVAL` frames, is appended to `<path>.idx` so a reader
+    can seek by time without scanning the whole capture.
+*/
+constexpr size_t CAPTURE_INDEX_INTERVAL = 1024;
+
+// One captured frame, pointing into the reader's mapping
+struct CaptureFrame {
+    uint64_t timestampNs = 0; // CLOCK_MONOTONIC when the frame was received
+    unsigned priority = 0;    // Queue priority it arrived with
+    uint16_t shard = 0;       // Shard queue it arrived on
+    std::string_view data;    // The frame exactly as received
+};
+
+struct CaptureIndexEntry {
+    uint64_t frame;
+    uint64_t timestampNs;
+    uint64_t offset;          // Byte offset of the frame's header in the capture file
+};
+
+/**
+ * @brief Appends frames to a capture file through a shared mapping.
+ *
+ * The file grows in `chunkSize` steps (`ftruncate` + `mremap`), so an append
+ * is normally a single `memcpy` into the page cache and no syscall. On
+ * destruction the file is trimmed to the data actually written.
+ *
+ * Not thread-safe; serialize `Append` calls from several receive threads.
+ */
+class CaptureWriter {
+public:
+    // Constructors
+    explicit CaptureWriter(const std::string& path, size_t chunkSize = 64 * 1024 * 1024);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    // Methods
+    void Append(const char* data, size_t size, unsigned priority, uint16_t shard, uint64_t timestampNs);
+
+    // Getters
+    uint64_t Frames() const { return frames_; }
+    uint64_t Bytes() const { return end_; }
+
+private:
+    // Members
+    int fd_;
+    int indexFd_;
+    char* base_;
+    size_t mapped_;
+    size_t chunkSize_;
+    uint64_t end_;    // Committed length of the file
+    uint64_t frames_;
+
+    // Helper methods
+    void Grow(size_t needed);
+};
+
+/**
+ * @brief Reads a capture file in place from a read-only mapping.
+ *
+ * Frames are returned as views into the mapping, so replaying them costs no
+ * copy; the reader must outlive the frames it returns.
+ */
+class CaptureReader {
+public:
+    // Constructors
+    explicit CaptureReader(const std::string& path);
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    // Methods
+    bool Next(CaptureFrame& frame);
+    void Seek(uint64_t timestampNs);
+    void Rewind();
+
+    // Getters
+    uint64_t Frames() const { return frames_; }
+    uint64_t FirstTimestamp() const { return firstTimestampNs_; }
+    const std::vector<CaptureIndexEntry>& Index() const { return index_; }
+
+private:
+    // Members
+    const char* base_;
+    size_t size_;
+    uint64_t end_;
+    uint64_t cursor_; // Offset of the next frame header
+    uint64_t frames_;
+    uint64_t firstTimestampNs_;
+    std::vector<CaptureIndexEntry> index_;
+
+    // Helper methods
+    bool Peek(uint64_t offset, CaptureFrame& frame, uint64_t& next) const;
+};
+
+#endif // CAPTURE_FILE_H
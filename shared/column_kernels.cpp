@@ -0,0 +1,352 @@
+#include "column_kernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLUMN_KERNELS_X86 1
+#endif
+
+namespace {
+    bool IsPresent(const uint64_t* presence, size_t row) {
+        return (presence[row / 64] >> (row % 64)) & 1;
+    }
+
+    // Presence bits for `width` rows starting at `row` (a multiple of `width`, which divides 64)
+    uint64_t PresenceBits(const uint64_t* presence, size_t row, size_t width) {
+        const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        return (presence[row / 64] >> (row % 64)) & mask;
+    }
+
+    /* --- Scalar kernels, also used for the tail of every vector loop --- */
+
+    void ScalarInts(const int32_t* values, const uint64_t* presence, size_t begin, size_t end, IntSummary& summary) {
+        for (size_t row = begin; row < end; ++row) {
+            if (!IsPresent(presence, row)) {
+                continue;
+            }
+            ++summary.count;
+            summary.sum += values[row];
+            summary.min = std::min(summary.min, values[row]);
+            summary.max = std::max(summary.max, values[row]);
+        }
+    }
+
+    void ScalarFloats(const float* values, const uint64_t* presence, size_t begin, size_t end, FloatSummary& summary) {
+        for (size_t row = begin; row < end; ++row) {
+            if (!IsPresent(presence, row)) {
+                continue;
+            }
+            ++summary.count;
+            summary.sum += values[row];
+            summary.min = values[row] < summary.min ? values[row] : summary.min; // NaN never wins, matching minps
+            summary.max = values[row] > summary.max ? values[row] : summary.max;
+        }
+    }
+
+    void ScalarCounts(const uint8_t* values, const uint64_t* presence, size_t begin, size_t end, uint64_t* bins, size_t binCount) {
+        for (size_t row = begin; row < end; ++row) {
+            if (IsPresent(presence, row) && values[row] < binCount) {
+                ++bins[values[row]];
+            }
+        }
+    }
+
+#ifdef COLUMN_KERNELS_X86
+    /* --- SSE4.1: four rows per step --- */
+
+    __attribute__((target("sse4.1")))
+    IntSummary SseInts(const int32_t* values, const uint64_t* presence, size_t rows) {
+        const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128i highest = _mm_set1_epi32(std::numeric_limits<int32_t>::max());
+        const __m128i lowest = _mm_set1_epi32(std::numeric_limits<int32_t>::min());
+        __m128i sum = _mm_setzero_si128(), min = highest, max = lowest;
+
+        IntSummary summary;
+        size_t row = 0;
+        for (; row + 4 <= rows; row += 4) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 4));
+            if (present == 0) {
+                continue;
+            }
+            summary.count += __builtin_popcount(present);
+            const __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(present), bits), bits);
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + row));
+            const __m128i kept = _mm_and_si128(v, mask);
+            sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(kept));
+            sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(_mm_srli_si128(kept, 8)));
+            min = _mm_min_epi32(min, _mm_blendv_epi8(highest, v, mask));
+            max = _mm_max_epi32(max, _mm_blendv_epi8(lowest, v, mask));
+        }
+
+        alignas(16) int64_t sums[2];
+        alignas(16) int32_t mins[4], maxs[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(sums), sum);
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), min);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), max);
+        summary.sum = sums[0] + sums[1];
+        summary.min = *std::min_element(mins, mins + 4);
+        summary.max = *std::max_element(maxs, maxs + 4);
+
+        ScalarInts(values, presence, row, rows, summary);
+        return summary;
+    }
+
+    __attribute__((target("sse4.1")))
+    FloatSummary SseFloats(const float* values, const uint64_t* presence, size_t rows) {
+        const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128 highest = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        const __m128 lowest = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+        __m128d sum = _mm_setzero_pd();
+        __m128 min = highest, max = lowest;
+
+        FloatSummary summary;
+        size_t row = 0;
+        for (; row + 4 <= rows; row += 4) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 4));
+            if (present == 0) {
+                continue;
+            }
+            summary.count += __builtin_popcount(present);
+            const __m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(present), bits), bits));
+            const __m128 v = _mm_loadu_ps(values + row);
+            const __m128 kept = _mm_and_ps(v, mask);
+            sum = _mm_add_pd(sum, _mm_cvtps_pd(kept));
+            sum = _mm_add_pd(sum, _mm_cvtps_pd(_mm_movehl_ps(kept, kept)));
+            min = _mm_min_ps(_mm_blendv_ps(highest, v, mask), min);
+            max = _mm_max_ps(_mm_blendv_ps(lowest, v, mask), max);
+        }
+
+        alignas(16) double sums[2];
+        alignas(16) float mins[4], maxs[4];
+        _mm_store_pd(sums, sum);
+        _mm_store_ps(mins, min);
+        _mm_store_ps(maxs, max);
+        summary.sum = sums[0] + sums[1];
+        for (int lane = 0; lane < 4; ++lane) {
+            summary.min = mins[lane] < summary.min ? mins[lane] : summary.min;
+            summary.max = maxs[lane] > summary.max ? maxs[lane] : summary.max;
+        }
+
+        ScalarFloats(values, presence, row, rows, summary);
+        return summary;
+    }
+
+    __attribute__((target("sse4.1")))
+    void SseCounts(const uint8_t* values, const uint64_t* presence, size_t rows, uint64_t* bins, size_t binCount) {
+        size_t row = 0;
+        for (; row + 16 <= rows; row += 16) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 16));
+            if (present == 0) {
+                continue;
+            }
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + row));
+            for (size_t bin = 0; bin < binCount; ++bin) {
+                const uint32_t match = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(bin)))));
+                bins[bin] += __builtin_popcount(match & present);
+            }
+        }
+        ScalarCounts(values, presence, row, rows, bins, binCount);
+    }
+
+    /* --- AVX2: eight rows per step (32 for counts) --- */
+
+    __attribute__((target("avx2")))
+    IntSummary Avx2Ints(const int32_t* values, const uint64_t* presence, size_t rows) {
+        const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m256i highest = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+        const __m256i lowest = _mm256_set1_epi32(std::numeric_limits<int32_t>::min());
+        __m256i sum = _mm256_setzero_si256(), min = highest, max = lowest;
+
+        IntSummary summary;
+        size_t row = 0;
+        for (; row + 8 <= rows; row += 8) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 8));
+            if (present == 0) {
+                continue;
+            }
+            summary.count += __builtin_popcount(present);
+            const __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(present), bits), bits);
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + row));
+            const __m256i kept = _mm256_and_si256(v, mask);
+            sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(kept)));
+            sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(kept, 1)));
+            min = _mm256_min_epi32(min, _mm256_blendv_epi8(highest, v, mask));
+            max = _mm256_max_epi32(max, _mm256_blendv_epi8(lowest, v, mask));
+        }
+
+        alignas(32) int64_t sums[4];
+        alignas(32) int32_t mins[8], maxs[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), sum);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(mins), min);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), max);
+        summary.sum = sums[0] + sums[1] + sums[2] + sums[3];
+        summary.min = *std::min_element(mins, mins + 8);
+        summary.max = *std::max_element(maxs, maxs + 8);
+
+        ScalarInts(values, presence, row, rows, summary);
+        return summary;
+    }
+
+    __attribute__((target("avx2")))
+    FloatSummary Avx2Floats(const float* values, const uint64_t* presence, size_t rows) {
+        const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m256 highest = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        const __m256 lowest = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+        __m256d sum = _mm256_setzero_pd();
+        __m256 min = highest, max = lowest;
+
+        FloatSummary summary;
+        size_t row = 0;
+        for (; row + 8 <= rows; row += 8) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 8));
+            if (present == 0) {
+                continue;
+            }
+            summary.count += __builtin_popcount(present);
+            const __m256 mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(present), bits), bits));
+            const __m256 v = _mm256_loadu_ps(values + row);
+            const __m256 kept = _mm256_and_ps(v, mask);
+            sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_castps256_ps128(kept)));
+            sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_extractf128_ps(kept, 1)));
+            min = _mm256_min_ps(_mm256_blendv_ps(highest, v, mask), min);
+            max = _mm256_max_ps(_mm256_blendv_ps(lowest, v, mask), max);
+        }
+
+        alignas(32) double sums[4];
+        alignas(32) float mins[8], maxs[8];
+        _mm256_store_pd(sums, sum);
+        _mm256_store_ps(mins, min);
+        _mm256_store_ps(maxs, max);
+        summary.sum = sums[0] + sums[1] + sums[2] + sums[3];
+        for (int lane = 0; lane < 8; ++lane) {
+            summary.min = mins[lane] < summary.min ? mins[lane] : summary.min;
+            summary.max = maxs[lane] > summary.max ? maxs[lane] : summary.max;
+        }
+
+        ScalarFloats(values, presence, row, rows, summary);
+        return summary;
+    }
+
+    __attribute__((target("avx2")))
+    void Avx2Counts(const uint8_t* values, const uint64_t* presence, size_t rows, uint64_t* bins, size_t binCount) {
+        size_t row = 0;
+        for (; row + 32 <= rows; row += 32) {
+            const uint32_t present = static_cast<uint32_t>(PresenceBits(presence, row, 32));
+            if (present == 0) {
+                continue;
+            }
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + row));
+            for (size_t bin = 0; bin < binCount; ++bin) {
+                const uint32_t match = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(bin)))));
+                bins[bin] += __builtin_popcount(match & present);
+            }
+        }
+        ScalarCounts(values, presence, row, rows, bins, binCount);
+    }
+#endif
+
+    // Falls back to the best level this CPU actually has
+    SimdLevel Usable(SimdLevel level) {
+        return std::min(level, DetectSimdLevel());
+    }
+}
+
+/**
+ * @brief Returns the widest instruction set the running CPU supports.
+ */
+SimdLevel DetectSimdLevel() {
+#ifdef COLUMN_KERNELS_X86
+    static const SimdLevel detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return SimdLevel::SSE;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE:  return "sse";
+    default:              return "scalar";
+    }
+}
+
+/**
+ * @brief Parses a level name as printed by `SimdLevelName`; "auto" detects it.
+ *
+ * @throws std::invalid_argument for an unknown name.
+ */
+SimdLevel ParseSimdLevel(const std::string& name) {
+    if (name == "auto")   return DetectSimdLevel();
+    if (name == "avx2")   return SimdLevel::AVX2;
+    if (name == "sse")    return SimdLevel::SSE;
+    if (name == "scalar") return SimdLevel::Scalar;
+    throw std::invalid_argument("Unknown SIMD level '" + name + "' (expected auto, avx2, sse or scalar).");
+}
+
+/**
+ * @brief Counts, sums and finds the range of the present values of an int column.
+ *
+ * @param values The column, one value per row.
+ * @param presence The column's presence bitmap.
+ * @param rows Number of rows.
+ * @param level Instruction set to use; capped at what the CPU supports.
+ */
+IntSummary SummarizeInts(const int32_t* values, const uint64_t* presence, size_t rows, SimdLevel level) {
+#ifdef COLUMN_KERNELS_X86
+    switch (Usable(level)) {
+    case SimdLevel::AVX2: return Avx2Ints(values, presence, rows);
+    case SimdLevel::SSE:  return SseInts(values, presence, rows);
+    default: break;
+    }
+#endif
+    IntSummary summary;
+    ScalarInts(values, presence, 0, rows, summary);
+    return summary;
+}
+
+/**
+ * @brief Counts, sums and finds the range of the present values of a float column.
+ *
+ * Vector levels add in a different order than the scalar loop, so sums may
+ * differ from it in the last bits. NaNs propagate into the sum but never
+ * become the minimum or maximum.
+ */
+FloatSummary SummarizeFloats(const float* values, const uint64_t* presence, size_t rows, SimdLevel level) {
+#ifdef COLUMN_KERNELS_X86
+    switch (Usable(level)) {
+    case SimdLevel::AVX2: return Avx2Floats(values, presence, rows);
+    case SimdLevel::SSE:  return SseFloats(values, presence, rows);
+    default: break;
+    }
+#endif
+    FloatSummary summary;
+    ScalarFloats(values, presence, 0, rows, summary);
+    return summary;
+}
+
+/**
+ * @brief Adds the number of present rows holding each value to `bins` (a histogram, e.g. by type).
+ *
+ * @param bins `binCount` counters, indexed by value; values of `binCount` or more are not counted.
+ */
+void CountByValue(const uint8_t* values, const uint64_t* presence, size_t rows, uint64_t* bins, size_t binCount, SimdLevel level) {
+#ifdef COLUMN_KERNELS_X86
+    switch (Usable(level)) {
+    case SimdLevel::AVX2: Avx2Counts(values, presence, rows, bins, binCount); return;
+    case SimdLevel::SSE:  SseCounts(values, presence, rows, bins, binCount); return;
+    default: break;
+    }
+#endif
+    ScalarCounts(values, presence, 0, rows, bins, binCount);
+}
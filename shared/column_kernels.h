@@ -0,0 +1,49 @@
+#ifndef COLUMN_KERNELS_H
+#define COLUMN_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+/*
+    Aggregation kernels over the columns of a ColumnarBatch.
+
+    Every kernel takes a presence bitmap alongside its column: bit `row % 64`
+    of word `row / 64` is set when the row holds a value. Rows whose bit is
+    clear are skipped, whatever the column holds for them.
+
+    The SSE (SSE4.1) and AVX2 versions are compiled with per-function target
+    attributes, so the binary still runs on CPUs without them; pick the level
+    at runtime with `DetectSimdLevel`.
+*/
+
+enum class SimdLevel {
+    Scalar,
+    SSE,    // SSE4.1
+    AVX2
+};
+
+struct IntSummary {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t min = std::numeric_limits<int32_t>::max();
+    int32_t max = std::numeric_limits<int32_t>::min();
+};
+
+struct FloatSummary {
+    uint64_t count = 0;
+    double sum = 0.0;           // Accumulated in double so long windows keep their precision
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+};
+
+SimdLevel DetectSimdLevel();
+const char* SimdLevelName(SimdLevel level);
+SimdLevel ParseSimdLevel(const std::string& name);
+
+IntSummary SummarizeInts(const int32_t* values, const uint64_t* presence, size_t rows, SimdLevel level);
+FloatSummary SummarizeFloats(const float* values, const uint64_t* presence, size_t rows, SimdLevel level);
+void CountByValue(const uint8_t* values, const uint64_t* presence, size_t rows, uint64_t* bins, size_t binCount, SimdLevel level);
+
+#endif // COLUMN_KERNELS_H
@@ -0,0 +1,150 @@
+#include "columnar_batch.h"
+#include <stdexcept>
+#include "batch_frame.h"
+#include "slab_pool.h"
+
+/**
+ * @brief Constructor that reserves room for a window of rows.
+ *
+ * @param expectedRows Rows to reserve up front; the columns grow past it if needed.
+ */
+ColumnarBatch::ColumnarBatch(size_t expectedRows) : rows_(0) {
+    ints_.reserve(expectedRows);
+    floats_.reserve(expectedRows);
+    types_.reserve(expectedRows);
+    stringOffsets_.reserve(expectedRows + 1);
+    stringOffsets_.push_back(0);
+    for (auto& bitmap : presence_) {
+        bitmap.reserve((expectedRows + 63) / 64);
+    }
+}
+
+/**
+ * @brief Appends one parsed record as a new row.
+ *
+ * Absent fields store zero in their column and leave their presence bit clear.
+ *
+ * @param view A parsed record; its string is copied into the arena.
+ * @throws std::runtime_error if the view still refers to an unresolved string dictionary entry.
+ */
+void ColumnarBatch::Append(const IPCDataView& view) {
+    if (view.GetStringRef()) {
+        throw std::runtime_error("IPCData message refers to a string dictionary entry; resolve it with a StringDictionaryDecoder.");
+    }
+
+    const size_t row = rows_;
+    if (row % 64 == 0) {
+        for (auto& bitmap : presence_) {
+            bitmap.push_back(0);
+        }
+    }
+
+    auto theInt = view.GetTheInt();
+    auto theFloat = view.GetTheFloat();
+    auto theString = view.GetTheString();
+    auto theType = view.GetTheType();
+
+    ints_.push_back(theInt.value_or(0));
+    floats_.push_back(theFloat.value_or(0.0f));
+    types_.push_back(static_cast<uint8_t>(theType.value_or(IPCData::Type())));
+    if (theString) {
+        arena_.insert(arena_.end(), theString->begin(), theString->end());
+    }
+    stringOffsets_.push_back(static_cast<uint32_t>(arena_.size()));
+
+    if (theInt)    MarkPresent(Column::Int, row);
+    if (theFloat)  MarkPresent(Column::Float, row);
+    if (theString) MarkPresent(Column::String, row);
+    if (theType)   MarkPresent(Column::Type, row);
+    ++rows_;
+}
+
+/**
+ * @brief Decodes a received message, single record or batch envelope, and appends its records.
+ *
+ * For messages that need no further resolution (no slab descriptors or
+ * dictionary references); otherwise resolve each record and use `Append`.
+ *
+ * @return The number of rows appended.
+ * @throws std::runtime_error if a record is malformed or needs resolving; rows
+ *         decoded before it are kept.
+ */
+size_t ColumnarBatch::AppendMessage(const char* message, size_t size) {
+    const size_t before = rows_;
+    auto appendRecord = [&](const char* record, size_t recordSize) {
+        if (IsSlabDescriptor(record, recordSize)) {
+            throw std::runtime_error("Slab descriptors must be resolved before columnar decoding.");
+        }
+        Append(IPCDataView(record, recordSize));
+    };
+
+    if (!IsBatchFrame(message, size)) {
+        appendRecord(message, size);
+    } else {
+        for (std::string_view record : BatchView(message, size)) {
+            appendRecord(record.data(), record.size());
+        }
+    }
+    return rows_ - before;
+}
+
+/**
+ * @brief Removes every row, keeping the columns' capacity.
+ */
+void ColumnarBatch::Clear() {
+    rows_ = 0;
+    ints_.clear();
+    floats_.clear();
+    types_.clear();
+    stringOffsets_.resize(1);
+    arena_.clear();
+    for (auto& bitmap : presence_) {
+        bitmap.clear();
+    }
+}
+
+/**
+ * @brief Aggregates every column over all rows.
+ *
+ * @param level Instruction set for the kernels; defaults to the best the CPU supports.
+ */
+BatchSummary ColumnarBatch::Summarize(SimdLevel level) const {
+    BatchSummary summary;
+    summary.rows = rows_;
+    if (rows_ == 0) {
+        return summary;
+    }
+
+    summary.ints = SummarizeInts(Ints(), Presence(Column::Int), rows_, level);
+    summary.floats = SummarizeFloats(Floats(), Presence(Column::Float), rows_, level);
+    CountByValue(Types(), Presence(Column::Type), rows_, summary.types.data(), TYPE_COUNT, level);
+    for (uint64_t word : presence_[static_cast<size_t>(Column::String)]) {
+        summary.strings += __builtin_popcountll(word);
+    }
+    return summary;
+}
+
+/**
+ * @brief Returns true if `row` has a value in `column`.
+ */
+bool ColumnarBatch::Has(Column column, size_t row) const {
+    return (presence_[static_cast<size_t>(column)][row / 64] >> (row % 64)) & 1;
+}
+
+/**
+ * @brief Returns a row's string as a view into the arena, valid until the next `Append` or `Clear`.
+ */
+std::optional<std::string_view> ColumnarBatch::String(size_t row) const {
+    if (!Has(Column::String, row)) {
+        return std::nullopt;
+    }
+    return std::string_view(arena_.data() + stringOffsets_[row], stringOffsets_[row + 1] - stringOffsets_[row]);
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+void ColumnarBatch::MarkPresent(Column column, size_t row) {
+    presence_[static_cast<size_t>(column)][row / 64] |= uint64_t(1) << (row % 64);
+}
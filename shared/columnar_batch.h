@@ -0,0 +1,76 @@
+#ifndef COLUMNAR_BATCH_H
+#define COLUMNAR_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "column_kernels.h"
+#include "ipc_data_view.h"
+
+// Number of IPCData::Type values, i.e. bins in a type histogram
+constexpr size_t TYPE_COUNT = IPCData::Type_ARRAYSIZE;
+
+// Aggregates over every row of a ColumnarBatch
+struct BatchSummary {
+    size_t rows = 0;
+    IntSummary ints;
+    FloatSummary floats;
+    uint64_t strings = 0;                      // Rows with a string
+    std::array<uint64_t, TYPE_COUNT> types {}; // Rows per type
+};
+
+/**
+ * @brief Decodes received records into columns (struct of arrays) for aggregation.
+ *
+ * Each `IPCData` field becomes one contiguous column, with a presence bitmap
+ * per column instead of an `std::optional` per value, and all strings are
+ * packed into one shared arena addressed by offsets. Aggregates then run as
+ * vector kernels (see `column_kernels.h`) over whole columns rather than
+ * once per decoded object.
+ *
+ * Columns only grow; `Clear` keeps their capacity, so a batch reused for
+ * window after window stops allocating once it has seen its largest window.
+ */
+class ColumnarBatch {
+public:
+    enum class Column { Int, Float, String, Type };
+
+    // Constructors
+    explicit ColumnarBatch(size_t expectedRows = 4096);
+
+    // Methods
+    void Append(const IPCDataView& view);
+    size_t AppendMessage(const char* message, size_t size);
+    void Clear();
+    BatchSummary Summarize(SimdLevel level = DetectSimdLevel()) const;
+
+    // Getters
+    size_t Rows() const { return rows_; }
+    bool Empty() const { return rows_ == 0; }
+    const int32_t* Ints() const { return ints_.data(); }
+    const float* Floats() const { return floats_.data(); }
+    const uint8_t* Types() const { return types_.data(); }
+    const uint64_t* Presence(Column column) const { return presence_[static_cast<size_t>(column)].data(); }
+    bool Has(Column column, size_t row) const;
+    std::optional<std::string_view> String(size_t row) const;
+
+private:
+    static constexpr size_t COLUMN_COUNT = 4;
+
+    // Members
+    size_t rows_;
+    std::vector<int32_t> ints_;
+    std::vector<float> floats_;
+    std::vector<uint8_t> types_;
+    std::vector<uint32_t> stringOffsets_; // Row i's string is arena_[offsets[i], offsets[i + 1])
+    std::vector<char> arena_;
+    std::array<std::vector<uint64_t>, COLUMN_COUNT> presence_;
+
+    // Helper methods
+    void MarkPresent(Column column, size_t row);
+};
+
+#endif // COLUMNAR_BATCH_H
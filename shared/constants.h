@@ -10,9 +10,73 @@
 // This defines the maximum size (in bytes) of a single message that can be sent or received.
 #define MAX_MESSAGE_SIZE 1024
 
+// Smallest depth (in messages) a message queue is created with
+// Deeper queues are sized from the declared workload and the kernel's limits (see queue_provisioner.h).
+#define QUEUE_MIN_DEPTH 10
+
 // Permissions for the message queue
 // These are UNIX file system-style permissions (octal format) for the queue:
 // - 0660: Read and write permissions for the owner and group, but no access for others.
 #define QUEUE_PERMISSIONS 0660
 
+// Number of message priority levels used on the queue (0 = bulk ... PRIORITY_LEVELS - 1 = most urgent)
+// The kernel delivers higher-priority messages first; the receiver keeps per-level statistics.
+#define PRIORITY_LEVELS 4
+
+// Name of the POSIX shared-memory segment backing the SPSC ring transport
+// Used instead of QUEUE_NAME when both apps are started with --transport=shm.
+#define SHM_RING_NAME "/ipc_ring"
+
+// Number of message slots in the shared-memory ring
+// Each slot holds one message of up to MAX_MESSAGE_SIZE bytes.
+#define SHM_RING_SLOTS 1024
+
+// Name of the POSIX shared-memory segment backing the broadcast ring
+// Used when main_tx publishes to any number of main_rx subscribers with --transport=broadcast.
+#define BROADCAST_RING_NAME "/ipc_broadcast"
+
+// Number of message slots in the broadcast ring
+// A subscriber more than this many messages behind the publisher loses the oldest ones.
+#define BROADCAST_RING_SLOTS 4096
+
+// Name of the POSIX shared-memory control segment
+// Created by the receiver so both sides agree on run-time settings such as the shard count.
+#define CONTROL_SEGMENT_NAME "/ipc_control"
+
+// Maximum number of sharded queues (QUEUE_NAME.0 ... QUEUE_NAME.N-1)
+#define MAX_SHARDS 64
+
+// Name of the POSIX shared-memory slab pool for records larger than MAX_MESSAGE_SIZE
+// Created by the receiver; senders write large records into a slab and queue a small descriptor instead.
+#define SLAB_POOL_NAME "/ipc_slabs"
+
+// Size (in bytes) of one slab, and therefore of the largest record that can be sent
+#define SLAB_SIZE (64 * 1024)
+
+// Number of slabs in the pool, i.e. how many large records can be in flight at once
+#define SLAB_COUNT 64
+
+// Entries in each sender's string dictionary, and in the receiver's copy of it
+// An entry can be referenced until this many newer strings have been added after it.
+#define STRING_DICTIONARY_ENTRIES 256
+
+// Longest string (in bytes) the dictionary stores; longer strings are always sent in full
+#define STRING_DICTIONARY_MAX_LENGTH 128
+
+// Highest string dictionary stream id; ids stay below 2^14 so they fit in a two-byte varint
+#define STRING_DICTIONARY_MAX_STREAM 16383
+
+// Prefix of the per-process POSIX shared-memory stats segments (PREFIX.<role>.<pid>)
+// Each app publishes live counters there; ipc_stat finds the segments by this prefix.
+#define STATS_SEGMENT_PREFIX "/ipc_stats"
+
+// Name of the POSIX message queue carrying requests in request/reply mode (main_rx --rpc)
+#define RPC_QUEUE_NAME "/ipc_rpc"
+
+// Prefix of each RPC client's reply queue (PREFIX.<client id in hex>)
+#define RPC_REPLY_QUEUE_PREFIX "/ipc_rpc_reply"
+
+// Most requests one RPC client may have in flight; also capped by the depth its reply queue gets
+#define RPC_MAX_PIPELINE 64
+
 #endif // CONSTANTS_H
\ No newline at end of file
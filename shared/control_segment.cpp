@@ -0,0 +1,127 @@
+#include <stdexcept>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "constants.h"
+#include "control_segment.h"
+
+namespace {
+    // Marks a segment whose block has been fully initialized by the creator
+    constexpr uint32_t CONTROL_MAGIC = 0x49504343; // "IPCC"
+    constexpr uint32_t CONTROL_VERSION = 3;
+}
+
+/**
+ * @brief Constructor that maps (and optionally creates) the control segment.
+ *
+ * A new segment starts with one shard and gets a fresh receiver id, so
+ * senders that still map a previous receiver's segment can tell it was replaced.
+ *
+ * @param name POSIX shared-memory name, e.g. `CONTROL_SEGMENT_NAME`.
+ * @param create True to create a fresh segment, false to attach to an existing one.
+ * @throws std::runtime_error if the segment cannot be opened, sized, mapped or validated.
+ */
+ControlSegment::ControlSegment(const std::string& name, bool create) : block_(nullptr), fd_(-1) {
+    if (create) {
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, QUEUE_PERMISSIONS);
+    } else {
+        fd_ = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd_ == -1) {
+        throw std::runtime_error("Failed to open control segment");
+    }
+
+    struct stat st;
+    if ((create && ftruncate(fd_, sizeof(Block)) == -1) ||
+        (!create && (fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Block)))) {
+        close(fd_);
+        throw std::runtime_error("Control segment is not initialized");
+    }
+
+    void* addr = mmap(nullptr, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map control segment");
+    }
+    block_ = static_cast<Block*>(addr);
+
+    if (create) {
+        block_->version = CONTROL_VERSION;
+        block_->shardCount.store(1, std::memory_order_relaxed);
+        block_->dictionaryResets.store(0, std::memory_order_relaxed);
+        block_->dictionaryStreams.store(0, std::memory_order_relaxed);
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        block_->receiverId = (static_cast<uint64_t>(getpid()) << 32) ^ static_cast<uint64_t>(now.tv_sec * 1000000000LL + now.tv_nsec);
+        std::atomic_thread_fence(std::memory_order_release);
+        block_->magic = CONTROL_MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block_->magic != CONTROL_MAGIC || block_->version != CONTROL_VERSION) {
+            munmap(addr, sizeof(Block));
+            close(fd_);
+            throw std::runtime_error("Control segment is not initialized");
+        }
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the segment (the segment itself is left in place; see `Unlink`).
+ */
+ControlSegment::~ControlSegment() {
+    munmap(block_, sizeof(Block));
+    close(fd_);
+}
+
+/**
+ * @brief Publishes the number of sharded queues the receiver is serving.
+ *
+ * @param shardCount Number of shards, between 1 and `MAX_SHARDS`.
+ * @throws std::out_of_range if `shardCount` is outside that range.
+ */
+void ControlSegment::SetShardCount(uint32_t shardCount) {
+    if (shardCount < 1 || shardCount > MAX_SHARDS) {
+        throw std::out_of_range("Shard count must be between 1 and MAX_SHARDS.");
+    }
+    block_->shardCount.store(shardCount, std::memory_order_release);
+}
+
+uint32_t ControlSegment::ShardCount() const {
+    return block_->shardCount.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Asks every sender to clear its string dictionary and start a new epoch.
+ *
+ * Called by the receiver when a record refers to an entry it does not have,
+ * e.g. after the message that defined it was dropped.
+ */
+void ControlSegment::RequestDictionaryReset() {
+    block_->dictionaryResets.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Hands out a string dictionary stream id that no other sender of this receiver holds.
+ *
+ * Ids run from 1 to `STRING_DICTIONARY_MAX_STREAM` and only repeat after that
+ * many senders; the decoder rejects the conflicting definitions if they do.
+ */
+uint32_t ControlSegment::AllocateDictionaryStream() {
+    return block_->dictionaryStreams.fetch_add(1, std::memory_order_relaxed) % STRING_DICTIONARY_MAX_STREAM + 1;
+}
+
+uint32_t ControlSegment::DictionaryResets() const {
+    return block_->dictionaryResets.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Removes the named segment. Processes that still have it mapped keep working.
+ */
+void ControlSegment::Unlink(const std::string& name) {
+    shm_unlink(name.c_str());
+}
@@ -0,0 +1,53 @@
+#ifndef CONTROL_SEGMENT_H
+#define CONTROL_SEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Small shared-memory segment through which the receiver publishes run-time settings.
+ *
+ * `main_rx` creates it at startup (replacing any leftover) and removes it on
+ * exit; `main_tx` attaches read-only-by-convention and adopts the settings,
+ * so the two processes cannot disagree on e.g. the number of shards.
+ * It also carries the receiver's requests for senders to clear their string
+ * dictionaries (see `string_dictionary.h`).
+ */
+class ControlSegment {
+public:
+    // Constructors
+    ControlSegment(const std::string& name, bool create);
+    ~ControlSegment();
+
+    ControlSegment(const ControlSegment&) = delete;
+    ControlSegment& operator=(const ControlSegment&) = delete;
+
+    // Methods
+    void SetShardCount(uint32_t shardCount);
+    void RequestDictionaryReset();
+    uint32_t AllocateDictionaryStream();
+    static void Unlink(const std::string& name);
+
+    // Getters
+    uint32_t ShardCount() const;
+    uint32_t DictionaryResets() const;
+    uint64_t ReceiverId() const { return block_->receiverId; }
+
+private:
+    // Layout of the mapped segment
+    struct Block {
+        uint32_t magic;
+        uint32_t version;
+        std::atomic<uint32_t> shardCount;
+        std::atomic<uint32_t> dictionaryResets; // Bumped by the receiver when it cannot resolve a dictionary entry
+        std::atomic<uint32_t> dictionaryStreams; // String dictionary stream ids handed out to senders so far
+        uint64_t receiverId;                    // Differs for every segment the receiver creates
+    };
+
+    Block* block_;
+    int fd_;
+};
+
+#endif // CONTROL_SEGMENT_H
@@ -0,0 +1,69 @@
+#include "flat_codec.h"
+
+namespace flat {
+    /**
+     * @brief Returns the number of bytes `Encode` will write for an object.
+     */
+    size_t EncodedSize(const T_IPCData& data) {
+        size_t size = FIXED_SIZE;
+        std::apply([&](auto... fields) {
+            ([&](auto field) {
+                using F = decltype(field);
+                if constexpr (std::is_same_v<typename F::wire_type, std::string_view>) {
+                    if (auto value = (data.*F::get)()) {
+                        size += value->size();
+                    }
+                }
+            }(fields), ...);
+        }, Schema{});
+        return size;
+    }
+
+    /**
+     * @brief Encodes an object as a flat frame.
+     *
+     * Unset slots are zero-filled so frames are deterministic byte-for-byte.
+     *
+     * @param data The object to encode.
+     * @param buffer Destination buffer.
+     * @param capacity Size of the destination buffer in bytes.
+     * @return The number of bytes written.
+     * @throws std::length_error if the frame does not fit in the buffer.
+     */
+    size_t Encode(const T_IPCData& data, char* buffer, size_t capacity) {
+        const size_t size = EncodedSize(data);
+        if (size > capacity) {
+            throw std::length_error("Flat IPCData frame exceeds the buffer size.");
+        }
+
+        std::memset(buffer, 0, FIXED_SIZE);
+        buffer[0] = static_cast<char>(FLAT_FRAME_MARKER);
+
+        uint8_t presence = 0;
+        size_t stringOffset = FIXED_SIZE;
+        std::apply([&](auto... fields) {
+            ([&](auto field) {
+                using F = decltype(field);
+                using Wire = typename F::wire_type;
+                auto value = (data.*F::get)();
+                if (!value) {
+                    return;
+                }
+                presence |= F::presenceBit;
+
+                if constexpr (std::is_same_v<Wire, std::string_view>) {
+                    const uint32_t length = static_cast<uint32_t>(value->size());
+                    std::memcpy(buffer + OFFSET<F>, &length, sizeof(length));
+                    std::memcpy(buffer + stringOffset, value->data(), length);
+                    stringOffset += length;
+                } else {
+                    const Wire wire = static_cast<Wire>(*value);
+                    std::memcpy(buffer + OFFSET<F>, &wire, sizeof(wire));
+                }
+            }(fields), ...);
+        }, Schema{});
+
+        buffer[1] = static_cast<char>(presence);
+        return size;
+    }
+}
@@ -0,0 +1,190 @@
+#ifndef FLAT_CODEC_H
+#define FLAT_CODEC_H
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "ipc_data.pb.h"
+#include "t_ipc_data.h"
+
+/*
+    "Flat" wire format: a fixed-layout alternative to protobuf for IPCData.
+
+        [FLAT_FRAME_MARKER][presence bitmask][fixed-offset slots...][string bytes]
+
+    Every field has a fixed-size slot at a fixed offset (strings get a uint32
+    length slot, with the bytes appended after the last slot), so encoding and
+    decoding are plain memcpys with no varints, tags or per-field branching.
+    Values are stored in host byte order, since both ends share a machine.
+
+    The layout is generated from `Schema` below. Each entry is tied to the
+    generated protobuf code by field number and by the type its accessor
+    returns, so `ipc_data.proto` and this format cannot drift apart silently.
+*/
+namespace flat {
+    // First byte of a flat frame. This is protobuf field 1 with wire type 7, which
+    // does not exist, so a serialized IPCData can never start with it.
+    constexpr uint8_t FLAT_FRAME_MARKER = 0x0F;
+
+    // Marker byte + presence bitmask
+    constexpr size_t HEADER_SIZE = 2;
+
+    // Maps a protobuf accessor's return type to the type stored in its flat slot
+    template <typename ProtoType, typename = void>
+    struct WireTypeOf;
+    template <> struct WireTypeOf<int32_t> { using type = int32_t; };
+    template <> struct WireTypeOf<uint64_t> { using type = uint64_t; };
+    template <> struct WireTypeOf<float> { using type = float; };
+    template <> struct WireTypeOf<std::string> { using type = std::string_view; };
+    template <typename Enum>
+    struct WireTypeOf<Enum, std::enable_if_t<std::is_enum_v<Enum>>> { using type = uint8_t; };
+
+    /**
+     * @brief Compile-time description of one flat field.
+     *
+     * @tparam Number The protobuf field number (also selects the presence bit).
+     * @tparam ProtoGetter The generated protobuf accessor, e.g. `&IPCData::the_int`.
+     * @tparam Getter The matching `T_IPCData` getter used by the encoder.
+     */
+    template <int Number, auto ProtoGetter, auto Getter>
+    struct Field {
+        using proto_type = std::decay_t<decltype((std::declval<const IPCData&>().*ProtoGetter)())>;
+        using wire_type = typename WireTypeOf<proto_type>::type;
+
+        static constexpr int number = Number;
+        static constexpr uint8_t presenceBit = static_cast<uint8_t>(1u << (Number - 1));
+        static constexpr size_t size = std::is_same_v<wire_type, std::string_view> ? sizeof(uint32_t) : sizeof(wire_type);
+        static constexpr auto get = Getter;
+    };
+
+    // One descriptor per IPCData field
+    using TheIntField    = Field<IPCData::kTheIntFieldNumber,    &IPCData::the_int,      &T_IPCData::GetTheInt>;
+    using TheFloatField  = Field<IPCData::kTheFloatFieldNumber,  &IPCData::the_float,    &T_IPCData::GetTheFloat>;
+    using TheStringField = Field<IPCData::kTheStringFieldNumber, &IPCData::the_string,   &T_IPCData::GetTheString>;
+    using TheTypeField   = Field<IPCData::kTheTypeFieldNumber,   &IPCData::the_type,     &T_IPCData::GetTheType>;
+    using SendTimeField  = Field<IPCData::kSendTimeNsFieldNumber, &IPCData::send_time_ns, &T_IPCData::GetSendTimeNs>;
+    using SequenceField  = Field<IPCData::kSequenceFieldNumber,  &IPCData::sequence,     &T_IPCData::GetSequence>;
+
+    // The flat schema, in protobuf field-number order
+    using Schema = std::tuple<TheIntField, TheFloatField, TheStringField, TheTypeField, SendTimeField, SequenceField>;
+
+    constexpr size_t FIELD_COUNT = std::tuple_size_v<Schema>;
+
+    template <size_t... I>
+    constexpr bool NumberedInOrder(std::index_sequence<I...>) {
+        return ((std::tuple_element_t<I, Schema>::number == static_cast<int>(I) + 1) && ...);
+    }
+    static_assert(NumberedInOrder(std::make_index_sequence<FIELD_COUNT>{}),
+                  "Flat schema must list IPCData fields 1..N in field-number order");
+    static_assert(FIELD_COUNT <= 8, "Presence bitmask is a single byte");
+
+    // IPCData fields from here on only exist on the protobuf wire (the string
+    // dictionary coding, see string_dictionary.h); flat frames always carry the full string
+    constexpr int FIRST_PROTOBUF_ONLY_FIELD = IPCData::kStringRefFieldNumber;
+    static_assert(FIRST_PROTOBUF_ONLY_FIELD == static_cast<int>(FIELD_COUNT) + 1,
+                  "Flat schema must cover every IPCData record field");
+
+    // Offset of the slot for field `number` (or of the string bytes, for a number past the end)
+    template <size_t... I>
+    constexpr size_t SlotOffset(int number, std::index_sequence<I...>) {
+        return HEADER_SIZE + ((std::tuple_element_t<I, Schema>::number < number ? std::tuple_element_t<I, Schema>::size : 0) + ... + 0);
+    }
+
+    template <typename F>
+    constexpr size_t OFFSET = SlotOffset(F::number, std::make_index_sequence<FIELD_COUNT>{});
+
+    // Size of a frame with no string bytes; string bytes start here
+    constexpr size_t FIXED_SIZE = SlotOffset(INT_MAX, std::make_index_sequence<FIELD_COUNT>{});
+
+    // All presence bits defined by the schema
+    constexpr uint8_t PRESENCE_MASK = static_cast<uint8_t>((1u << FIELD_COUNT) - 1);
+
+    /**
+     * @brief Returns true if a message uses the flat wire format rather than protobuf.
+     */
+    inline bool IsFlatFrame(const char* buffer, size_t size) {
+        return size > 0 && static_cast<uint8_t>(buffer[0]) == FLAT_FRAME_MARKER;
+    }
+
+    size_t EncodedSize(const T_IPCData& data);
+    size_t Encode(const T_IPCData& data, char* buffer, size_t capacity);
+
+    /**
+     * @brief Overwrites one fixed-size slot of an encoded frame in place and marks it present.
+     *
+     * Lets a sender stamp per-send values (e.g. tracing fields) after encoding.
+     */
+    template <typename F>
+    void SetSlot(char* frame, typename F::wire_type value) {
+        static_assert(!std::is_same_v<typename F::wire_type, std::string_view>, "String slots cannot be patched in place");
+        std::memcpy(frame + OFFSET<F>, &value, sizeof(value));
+        frame[1] = static_cast<char>(static_cast<uint8_t>(frame[1]) | F::presenceBit);
+    }
+
+    /**
+     * @brief Decodes a flat frame in place, reporting each present field to a visitor.
+     *
+     * The visitor is called as `visit(FieldDescriptor{}, value)` where `value` is an
+     * `int`, `float`, `IPCData::Type` or a `std::string_view` into `buffer`.
+     *
+     * @throws std::runtime_error if the frame is malformed.
+     * @throws std::out_of_range if the enum slot holds an unknown value.
+     */
+    template <typename Visitor>
+    void Decode(const char* buffer, size_t size, Visitor&& visit) {
+        if (!IsFlatFrame(buffer, size) || size < FIXED_SIZE) {
+            throw std::runtime_error("Failed to parse flat IPCData frame.");
+        }
+
+        const uint8_t presence = static_cast<uint8_t>(buffer[1]);
+        if (presence & ~PRESENCE_MASK) {
+            throw std::runtime_error("Flat IPCData frame has unknown fields.");
+        }
+
+        size_t stringOffset = FIXED_SIZE;
+        std::apply([&](auto... fields) {
+            ([&](auto field) {
+                using F = decltype(field);
+                using Wire = typename F::wire_type;
+                if (!(presence & F::presenceBit)) {
+                    return;
+                }
+
+                if constexpr (std::is_same_v<Wire, std::string_view>) {
+                    uint32_t length;
+                    std::memcpy(&length, buffer + OFFSET<F>, sizeof(length));
+                    if (length > size - stringOffset) {
+                        throw std::runtime_error("Flat IPCData frame string is truncated.");
+                    }
+                    visit(field, std::string_view(buffer + stringOffset, length));
+                    stringOffset += length;
+                } else {
+                    Wire value;
+                    std::memcpy(&value, buffer + OFFSET<F>, sizeof(value));
+                    if constexpr (std::is_enum_v<typename F::proto_type>) {
+                        if (!IPCData::Type_IsValid(value)) {
+                            throw std::out_of_range("Enum value for 'theType' in IPCData is out of range.");
+                        }
+                        visit(field, static_cast<typename F::proto_type>(value));
+                    } else {
+                        visit(field, value);
+                    }
+                }
+            }(fields), ...);
+        }, Schema{});
+
+        if (stringOffset != size) {
+            throw std::runtime_error("Flat IPCData frame has trailing bytes.");
+        }
+    }
+}
+
+#endif // FLAT_CODEC_H
@@ -0,0 +1,415 @@
+#include "io_uring_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include "seqpacket_transport.h"
+#include "stats_segment.h"
+
+namespace {
+    // Submission queue size; also the most sends chained in one submission
+    constexpr unsigned SUBMISSION_ENTRIES = 64;
+
+    // Completion queue size; covers a completion for every provided buffer plus accepts and re-arms
+    constexpr unsigned COMPLETION_ENTRIES = 1024;
+
+    // Provided buffers of MAX_MESSAGE_SIZE bytes the kernel receives into (a power of two)
+    constexpr unsigned BUFFER_COUNT = 256;
+    constexpr uint16_t BUFFER_GROUP = 0;
+
+    // user_data tags: the accept, or a connection's recv with its descriptor in the low 32 bits
+    constexpr uint64_t ACCEPT_TAG = 1ULL << 32;
+    constexpr uint64_t RECEIVE_TAG = 2ULL << 32;
+
+    // Multishot receive (IORING_RECV_MULTISHOT) needs Linux 6.0; older kernels fail the recv only once it completes
+    constexpr int MULTISHOT_RECEIVE_MAJOR = 6;
+    constexpr int MULTISHOT_RECEIVE_MINOR = 0;
+
+    std::string errorText(const char* call, int error = errno) {
+        return std::string(call) + ": " + std::strerror(error);
+    }
+
+    int enter(int ring, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    bool kernelAtLeast(int major, int minor) {
+        struct utsname system;
+        int running[2];
+        if (uname(&system) != 0 || std::sscanf(system.release, "%d.%d", &running[0], &running[1]) != 2) {
+            return false;
+        }
+        return running[0] > major || (running[0] == major && running[1] >= minor);
+    }
+
+    void* mapRing(int ring, size_t size, off_t offset) {
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, offset);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error(errorText("mmap io_uring"));
+        }
+        return mapped;
+    }
+}
+
+/**
+ * @brief Constructor: sets up the ring and connects (sender) or listens (receiver) on the socket.
+ *
+ * A receiver also registers its provided buffers and arms the multishot accept.
+ *
+ * @throws std::runtime_error if io_uring is unavailable, a receiver runs on a
+ *         kernel older than Linux 6.0 (multishot receive), or the socket
+ *         cannot be connected or bound.
+ */
+IoUringTransport::IoUringTransport(const std::string& name, TransportRole role)
+    : name_(name), role_(role), socket_(-1), ring_(-1), sqRing_(nullptr), sqRingSize_(0), cqRing_(nullptr), cqRingSize_(0),
+      sqes_(nullptr), sqesSize_(0), sqeTail_(0), buffers_(nullptr), buffersSize_(0), bufferTail_(0) {
+    try {
+        io_uring_params params {};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = COMPLETION_ENTRIES;
+        ring_ = static_cast<int>(syscall(__NR_io_uring_setup, SUBMISSION_ENTRIES, &params));
+        if (ring_ < 0) {
+            throw std::runtime_error(errorText("io_uring_setup"));
+        }
+
+        // Map the rings; recent kernels share one mapping between the two
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = mapRing(ring_, sqRingSize_, IORING_OFF_SQ_RING);
+        cqRing_ = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing_ : mapRing(ring_, cqRingSize_, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mapRing(ring_, sqesSize_, IORING_OFF_SQES));
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+        sqFlags_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+        sqArray_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        sqMask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sqEntries_ = params.sq_entries;
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqeTail_ = *sqTail_;
+
+        // Submission entries are always used in ring order, so the indirection array is the identity
+        for (uint32_t i = 0; i < sqEntries_; ++i) {
+            sqArray_[i] = i;
+        }
+
+        if (role == TransportRole::Sender) {
+            socket_ = ConnectSeqPacket(name_);
+            return;
+        }
+        if (!kernelAtLeast(MULTISHOT_RECEIVE_MAJOR, MULTISHOT_RECEIVE_MINOR)) {
+            throw std::runtime_error("The uring receiver needs Linux 6.0 or later for multishot receives; use --transport=seqpacket");
+        }
+        socket_ = ListenSeqPacket(name_);
+        RegisterBuffers();
+        ArmAccept();
+        Submit(0);
+    } catch (...) {
+        Release();
+        throw;
+    }
+}
+
+IoUringTransport::~IoUringTransport() {
+    Release();
+}
+
+/**
+ * @brief Sends one message as a single submission, waiting for room until the deadline.
+ *
+ * The send itself goes through the ring; waiting for room while the socket
+ * buffer is full is a poll(2) on the socket, as io_uring has no cheaper way
+ * to wait for a non-blocking send to become possible.
+ *
+ * @param deadline As for `Transport::Send`.
+ * @return False if the socket buffer stayed full until the deadline.
+ * @throws std::runtime_error on any other failure, e.g. the receiver has gone.
+ */
+bool IoUringTransport::Send(const char* data, size_t size, unsigned /*priority*/, const timespec* deadline) {
+    const OutgoingMessage message { data, size, 0 };
+    while (SendBatch(&message, 1) == 0) {
+        if (!WaitSeqPacketWritable(socket_, deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sends the messages as chains of linked non-blocking sends, one submission per chain.
+ *
+ * A send that finds the socket buffer full fails, cancelling the rest of its
+ * chain, so exactly the messages before it were sent.
+ *
+ * @throws std::runtime_error if a send fails for any reason other than a full buffer.
+ */
+size_t IoUringTransport::SendBatch(const OutgoingMessage* messages, size_t count) {
+    size_t sent = 0;
+    while (sent < count) {
+        const size_t chunk = std::min<size_t>(count - sent, sqEntries_);
+        for (size_t i = 0; i < chunk; ++i) {
+            const OutgoingMessage& message = messages[sent + i];
+            io_uring_sqe* sqe = NextSqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = socket_;
+            sqe->addr = reinterpret_cast<uintptr_t>(message.size ? message.data : &SEQPACKET_EMPTY_MESSAGE);
+            sqe->len = static_cast<uint32_t>(message.size ? message.size : 1);
+            sqe->msg_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+            sqe->flags = i + 1 < chunk ? IOSQE_IO_LINK : 0;
+            sqe->user_data = i;
+        }
+
+        // Reap the whole chain; completions may arrive in any order
+        size_t completed = 0;
+        size_t firstFailed = chunk;
+        int error = 0;
+        Submit(static_cast<unsigned>(chunk));
+        while (completed < chunk) {
+            uint32_t head = *cqHead_;
+            const uint32_t tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                Submit(static_cast<unsigned>(chunk - completed));
+                continue;
+            }
+            for (; head != tail; ++head, ++completed) {
+                const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                if (cqe.res < 0) {
+                    firstFailed = std::min<size_t>(firstFailed, cqe.user_data);
+                    if (cqe.res != -EAGAIN && cqe.res != -ECANCELED && error == 0) {
+                        error = -cqe.res;
+                    }
+                }
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        }
+
+        sent += firstFailed;
+        if (error != 0) {
+            throw std::runtime_error("Failed to send message (" + errorText("send", error) + ")");
+        }
+        if (firstFailed < chunk) {
+            break;
+        }
+    }
+    return sent;
+}
+
+bool IoUringTransport::WaitForData(int timeoutMs) {
+    if (*cqHead_ != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+        return true;
+    }
+    // The ring descriptor is readable while completions are waiting
+    struct pollfd ready { ring_, POLLIN, 0 };
+    return poll(&ready, 1, timeoutMs) > 0;
+}
+
+/**
+ * @brief Reaps completions into the slots: new connections get a recv armed, received buffers are copied out and recycled.
+ *
+ * A message that does not fit its slot is dropped and counted as `Stat::MessagesTruncated`.
+ */
+size_t IoUringTransport::ReceiveBatch(ReceiveSlot* slots, size_t count) {
+    if (role_ != TransportRole::Receiver) {
+        return 0;
+    }
+
+    size_t received = 0;
+    uint32_t head = *cqHead_;
+    const uint32_t tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    for (; head != tail && received < count; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        const bool more = cqe.flags & IORING_CQE_F_MORE;
+        if (cqe.user_data == ACCEPT_TAG) {
+            if (cqe.res >= 0) {
+                connections_.push_back(cqe.res);
+                ArmReceive(cqe.res);
+            }
+            if (!more) {
+                ArmAccept();
+            }
+            continue;
+        }
+
+        const int connection = static_cast<int>(cqe.user_data & 0xFFFFFFFF);
+        if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+            const uint16_t id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            const char* data = bufferData_.data() + static_cast<size_t>(id) * MAX_MESSAGE_SIZE;
+            ReceiveSlot& slot = slots[received];
+            const size_t size = static_cast<size_t>(cqe.res);
+            if (size > slot.capacity) {
+                stats::Add(Stat::MessagesTruncated);
+            } else {
+                std::memcpy(slot.buffer, data, size);
+                slot.size = size == 1 && data[0] == SEQPACKET_EMPTY_MESSAGE ? 0 : size;
+                slot.priority = 0;
+                ++received;
+            }
+            RecycleBuffer(id);
+            if (!more) {
+                ArmReceive(connection);
+            }
+        } else if (cqe.res == -ENOBUFS) {
+            // Every buffer was in use; the message is still in the socket, so receive again once they are recycled below
+            ArmReceive(connection);
+        } else if (!more) {
+            Close(connection); // Zero bytes: the sender has gone
+        }
+    }
+
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    __atomic_store_n(&buffers_->tail, bufferTail_, __ATOMIC_RELEASE);
+    Submit(0);
+    return received;
+}
+
+std::string IoUringTransport::Describe() const {
+    return "io_uring on SEQPACKET socket @" + name_;
+}
+
+
+
+/* --- Private Helper Methods --- */
+
+/**
+ * @brief Returns a cleared submission entry, submitting what is queued first if the ring is full.
+ */
+io_uring_sqe* IoUringTransport::NextSqe() {
+    if (sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+        Submit(0);
+    }
+    io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    ++sqeTail_;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/**
+ * @brief Publishes the queued submission entries and hands them to the kernel.
+ *
+ * @param waitFor Completions to wait for; also flushes completions held back by an overflowed completion queue.
+ * @throws std::runtime_error if the kernel rejects the submission.
+ */
+void IoUringTransport::Submit(unsigned waitFor) {
+    __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+    for (;;) {
+        const uint32_t toSubmit = sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        const bool overflowed = __atomic_load_n(sqFlags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW;
+        if (toSubmit == 0 && waitFor == 0 && !overflowed) {
+            return;
+        }
+        if (enter(ring_, toSubmit, waitFor, waitFor || overflowed ? IORING_ENTER_GETEVENTS : 0) >= 0) {
+            return;
+        }
+        if (errno == EAGAIN || errno == EBUSY) {
+            return; // The completion queue is full; reaping it makes room, and the entries stay queued
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error(errorText("io_uring_enter"));
+        }
+    }
+}
+
+/**
+ * @brief Registers the provided-buffer ring the multishot receives take their buffers from.
+ */
+void IoUringTransport::RegisterBuffers() {
+    buffersSize_ = BUFFER_COUNT * sizeof(io_uring_buf);
+    void* mapped = mmap(nullptr, buffersSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error(errorText("mmap buffer ring"));
+    }
+    buffers_ = static_cast<io_uring_buf_ring*>(mapped);
+    bufferData_.resize(BUFFER_COUNT * MAX_MESSAGE_SIZE);
+
+    io_uring_buf_reg registration {};
+    registration.ring_addr = reinterpret_cast<uintptr_t>(buffers_);
+    registration.ring_entries = BUFFER_COUNT;
+    registration.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ring_, IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+        throw std::runtime_error(errorText("io_uring_register(PBUF_RING)"));
+    }
+
+    for (unsigned id = 0; id < BUFFER_COUNT; ++id) {
+        RecycleBuffer(static_cast<uint16_t>(id));
+    }
+    __atomic_store_n(&buffers_->tail, bufferTail_, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Hands a buffer back to the kernel; it becomes visible at the next publish of the ring's tail.
+ */
+void IoUringTransport::RecycleBuffer(uint16_t id) {
+    io_uring_buf& buffer = reinterpret_cast<io_uring_buf*>(buffers_)[bufferTail_ & (BUFFER_COUNT - 1)];
+    buffer.addr = reinterpret_cast<uintptr_t>(bufferData_.data() + static_cast<size_t>(id) * MAX_MESSAGE_SIZE);
+    buffer.len = MAX_MESSAGE_SIZE;
+    buffer.bid = id;
+    ++bufferTail_;
+}
+
+void IoUringTransport::ArmAccept() {
+    io_uring_sqe* sqe = NextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = socket_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = ACCEPT_TAG;
+}
+
+void IoUringTransport::ArmReceive(int connection) {
+    io_uring_sqe* sqe = NextSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = RECEIVE_TAG | static_cast<uint32_t>(connection);
+}
+
+void IoUringTransport::Close(int connection) {
+    close(connection);
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), connection), connections_.end());
+}
+
+/**
+ * @brief Closes the connections, the socket and the ring (cancelling anything armed), and unmaps the rings.
+ */
+void IoUringTransport::Release() {
+    for (int connection : connections_) {
+        close(connection);
+    }
+    connections_.clear();
+    if (socket_ >= 0) {
+        close(socket_);
+    }
+    if (ring_ >= 0) {
+        close(ring_);
+    }
+    if (sqes_) {
+        munmap(sqes_, sqesSize_);
+    }
+    if (cqRing_ && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_) {
+        munmap(sqRing_, sqRingSize_);
+    }
+    if (buffers_) {
+        munmap(buffers_, buffersSize_);
+    }
+}
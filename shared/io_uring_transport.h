@@ -0,0 +1,84 @@
+#ifndef IO_URING_TRANSPORT_H
+#define IO_URING_TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <linux/io_uring.h>
+#include "transport.h"
+
+/**
+ * @brief SEQPACKET socket backend driven through io_uring.
+ *
+ * Speaks the same protocol as `SeqPacketTransport` (a sender of one kind can
+ * feed a receiver of the other), but a batch is sent as one chain of linked
+ * sends in a single `io_uring_enter`, and the receiver never calls recv: one
+ * multishot accept and one multishot recv per connection stay armed, filling
+ * buffers from a ring registered with the kernel, so a busy receiver only
+ * reaps completions from shared memory.
+ *
+ * Message queue descriptors cannot be read or written through io_uring,
+ * which is why this rides on the socket rather than on the queue.
+ */
+class IoUringTransport : public Transport {
+public:
+    // Constructors
+    IoUringTransport(const std::string& name, TransportRole role);
+    ~IoUringTransport() override;
+
+    IoUringTransport(const IoUringTransport&) = delete;
+    IoUringTransport& operator=(const IoUringTransport&) = delete;
+
+    // Methods
+    bool Send(const char* data, size_t size, unsigned priority, const timespec* deadline) override;
+    size_t SendBatch(const OutgoingMessage* messages, size_t count) override;
+    bool WaitForData(int timeoutMs) override;
+    size_t ReceiveBatch(ReceiveSlot* slots, size_t count) override;
+
+    // Getters
+    TransportKind Kind() const override { return TransportKind::IoUring; }
+    std::string Describe() const override;
+
+private:
+    // Members
+    std::string name_;
+    TransportRole role_;
+    int socket_;    // Connected socket (sender) or listening socket (receiver)
+    int ring_;      // io_uring instance
+    void* sqRing_;  // Mapped submission and completion rings, and the submission entries
+    size_t sqRingSize_;
+    void* cqRing_;
+    size_t cqRingSize_;
+    io_uring_sqe* sqes_;
+    size_t sqesSize_;
+    uint32_t* sqHead_;
+    uint32_t* sqTail_;
+    uint32_t* sqFlags_;
+    uint32_t* sqArray_;
+    uint32_t sqMask_;
+    uint32_t sqEntries_;
+    uint32_t* cqHead_;
+    uint32_t* cqTail_;
+    uint32_t cqMask_;
+    io_uring_cqe* cqes_;
+    uint32_t sqeTail_;    // Next submission entry to fill; ahead of *sqTail_ until submitted
+    io_uring_buf_ring* buffers_; // Receiver only: provided-buffer ring and the buffers it hands out
+    size_t buffersSize_;
+    std::vector<char> bufferData_;
+    uint16_t bufferTail_;
+    std::vector<int> connections_;
+
+    // Helper methods
+    io_uring_sqe* NextSqe();
+    void Submit(unsigned waitFor);
+    void RegisterBuffers();
+    void RecycleBuffer(uint16_t id);
+    void ArmAccept();
+    void ArmReceive(int connection);
+    void Close(int connection);
+    void Release();
+};
+
+#endif // IO_URING_TRANSPORT_H
@@ -0,0 +1,213 @@
+#include <stdexcept>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include "ipc_data_view.h"
+#include "flat_codec.h"
+#include "stats_segment.h"
+
+using google::protobuf::internal::WireFormatLite;
+
+/**
+ * @brief Default constructor.
+ *
+ * Initializes all fields to unset.
+ */
+IPCDataView::IPCDataView()
+    : present_(0), theInt_(0), theFloat_(0.0f), theType_(0), sendTimeNs_(0), sequence_(0),
+      stringRef_(0), stringPrefix_(0), stringDefine_(0), dictStream_(0), dictEpoch_(0) { }
+
+/**
+ * @brief Constructor that parses a serialized message in place.
+ *
+ * @param data Pointer to the serialized bytes; must outlive the view.
+ * @param size Number of serialized bytes.
+ * @throws std::runtime_error if parsing fails.
+ * @throws std::out_of_range if `the_type` holds an unknown enum value.
+ */
+IPCDataView::IPCDataView(const char* data, size_t size)
+    : IPCDataView() {
+    Parse(data, size);
+}
+
+IPCDataView::IPCDataView(std::string_view serializedMessage)
+    : IPCDataView(serializedMessage.data(), serializedMessage.size()) { }
+
+/**
+ * @brief Re-points the view at a new serialized message.
+ *
+ * Lets a receive loop reuse one view for every message. Fields that are not
+ * present in the new message become unset. Both protobuf and flat frames are
+ * accepted; for protobuf, the last occurrence of a field wins and unknown
+ * fields are skipped.
+ *
+ * @param data Pointer to the serialized bytes; must outlive the view.
+ * @param size Number of serialized bytes.
+ * @throws std::runtime_error if parsing fails.
+ * @throws std::out_of_range if `the_type` holds an unknown enum value.
+ */
+void IPCDataView::Parse(const char* data, size_t size) {
+    present_ = 0;
+
+    if (flat::IsFlatFrame(data, size)) {
+        ParseFlat(data, size);
+        return;
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    google::protobuf::io::CodedInputStream input(bytes, static_cast<int>(size));
+
+    while (uint32_t tag = input.ReadTag()) {
+        const int fieldNumber = WireFormatLite::GetTagFieldNumber(tag);
+        const WireFormatLite::WireType wireType = WireFormatLite::GetTagWireType(tag);
+
+        if (fieldNumber == IPCData::kTheIntFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            uint64_t value;
+            if (!input.ReadVarint64(&value)) break;
+            theInt_ = static_cast<int32_t>(value);
+            present_ |= HAS_INT;
+        } else if (fieldNumber == IPCData::kTheFloatFieldNumber && wireType == WireFormatLite::WIRETYPE_FIXED32) {
+            uint32_t value;
+            if (!input.ReadLittleEndian32(&value)) break;
+            theFloat_ = WireFormatLite::DecodeFloat(value);
+            present_ |= HAS_FLOAT;
+        } else if (fieldNumber == IPCData::kTheStringFieldNumber && wireType == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            uint32_t length;
+            if (!input.ReadVarint32(&length)) break;
+            const size_t offset = static_cast<size_t>(input.CurrentPosition());
+            if (length > size - offset || !input.Skip(static_cast<int>(length))) break;
+            theString_ = std::string_view(data + offset, length);
+            present_ |= HAS_STRING;
+        } else if (fieldNumber == IPCData::kTheTypeFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            uint64_t value;
+            if (!input.ReadVarint64(&value)) break;
+            theType_ = static_cast<int32_t>(value);
+            present_ |= HAS_TYPE;
+        } else if (fieldNumber == IPCData::kSendTimeNsFieldNumber && wireType == WireFormatLite::WIRETYPE_FIXED64) {
+            if (!input.ReadLittleEndian64(&sendTimeNs_)) break;
+            present_ |= HAS_SEND_TIME;
+        } else if (fieldNumber == IPCData::kSequenceFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint64(&sequence_)) break;
+            present_ |= HAS_SEQUENCE;
+        } else if (fieldNumber == IPCData::kStringRefFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint32(&stringRef_)) break;
+            present_ |= HAS_STRING_REF;
+        } else if (fieldNumber == IPCData::kStringPrefixFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint32(&stringPrefix_)) break;
+            present_ |= HAS_STRING_PREFIX;
+        } else if (fieldNumber == IPCData::kStringDefineFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint32(&stringDefine_)) break;
+            present_ |= HAS_STRING_DEFINE;
+        } else if (fieldNumber == IPCData::kDictStreamFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint32(&dictStream_)) break;
+            present_ |= HAS_DICT_STREAM;
+        } else if (fieldNumber == IPCData::kDictEpochFieldNumber && wireType == WireFormatLite::WIRETYPE_VARINT) {
+            if (!input.ReadVarint32(&dictEpoch_)) break;
+            present_ |= HAS_DICT_EPOCH;
+        } else if (!WireFormatLite::SkipField(&input, tag)) {
+            break;
+        }
+    }
+
+    if (!input.ConsumedEntireMessage()) {
+        present_ = 0;
+        stats::Add(Stat::ParseFailures);
+        throw std::runtime_error("Failed to parse IPCData message.");
+    }
+
+    // Validate enum field
+    if ((present_ & HAS_TYPE) && !IPCData::Type_IsValid(theType_)) {
+        present_ = 0;
+        stats::Add(Stat::EnumRejections);
+        throw std::out_of_range("Enum value for 'theType' in IPCData is out of range.");
+    }
+}
+
+/**
+ * @brief Replaces the string the view exposes and marks any dictionary reference as resolved.
+ *
+ * Used by `StringDictionaryDecoder` to point the view at the text it rebuilt;
+ * like the parsed buffer, `text` must outlive the view.
+ */
+void IPCDataView::SetTheString(std::string_view text) {
+    theString_ = text;
+    present_ |= HAS_STRING;
+    present_ &= ~(HAS_STRING_REF | HAS_STRING_PREFIX);
+}
+
+// Getters
+std::optional<int> IPCDataView::GetTheInt() const {
+    return (present_ & HAS_INT) ? std::optional<int>(theInt_) : std::nullopt;
+}
+std::optional<float> IPCDataView::GetTheFloat() const {
+    return (present_ & HAS_FLOAT) ? std::optional<float>(theFloat_) : std::nullopt;
+}
+std::optional<std::string_view> IPCDataView::GetTheString() const {
+    return (present_ & HAS_STRING) ? std::optional<std::string_view>(theString_) : std::nullopt;
+}
+std::optional<IPCData::Type> IPCDataView::GetTheType() const {
+    return (present_ & HAS_TYPE) ? std::optional<IPCData::Type>(static_cast<IPCData::Type>(theType_)) : std::nullopt;
+}
+std::optional<uint64_t> IPCDataView::GetSendTimeNs() const {
+    return (present_ & HAS_SEND_TIME) ? std::optional<uint64_t>(sendTimeNs_) : std::nullopt;
+}
+std::optional<uint64_t> IPCDataView::GetSequence() const {
+    return (present_ & HAS_SEQUENCE) ? std::optional<uint64_t>(sequence_) : std::nullopt;
+}
+std::optional<uint32_t> IPCDataView::GetStringRef() const {
+    return (present_ & HAS_STRING_REF) ? std::optional<uint32_t>(stringRef_) : std::nullopt;
+}
+std::optional<uint32_t> IPCDataView::GetStringPrefix() const {
+    return (present_ & HAS_STRING_PREFIX) ? std::optional<uint32_t>(stringPrefix_) : std::nullopt;
+}
+std::optional<uint32_t> IPCDataView::GetStringDefine() const {
+    return (present_ & HAS_STRING_DEFINE) ? std::optional<uint32_t>(stringDefine_) : std::nullopt;
+}
+std::optional<uint32_t> IPCDataView::GetDictStream() const {
+    return (present_ & HAS_DICT_STREAM) ? std::optional<uint32_t>(dictStream_) : std::nullopt;
+}
+std::optional<uint32_t> IPCDataView::GetDictEpoch() const {
+    return (present_ & HAS_DICT_EPOCH) ? std::optional<uint32_t>(dictEpoch_) : std::nullopt;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+void IPCDataView::ParseFlat(const char* data, size_t size) {
+    try {
+        DecodeFlatFields(data, size);
+    } catch (const std::out_of_range&) {
+        present_ = 0;
+        stats::Add(Stat::EnumRejections);
+        throw;
+    } catch (...) {
+        present_ = 0;
+        stats::Add(Stat::ParseFailures);
+        throw;
+    }
+}
+
+void IPCDataView::DecodeFlatFields(const char* data, size_t size) {
+    flat::Decode(data, size, [this](auto field, auto value) {
+        constexpr int number = decltype(field)::number;
+        if constexpr (number == IPCData::kTheIntFieldNumber) {
+            theInt_ = value;
+            present_ |= HAS_INT;
+        } else if constexpr (number == IPCData::kTheFloatFieldNumber) {
+            theFloat_ = value;
+            present_ |= HAS_FLOAT;
+        } else if constexpr (number == IPCData::kTheStringFieldNumber) {
+            theString_ = value;
+            present_ |= HAS_STRING;
+        } else if constexpr (number == IPCData::kTheTypeFieldNumber) {
+            theType_ = value;
+            present_ |= HAS_TYPE;
+        } else if constexpr (number == IPCData::kSendTimeNsFieldNumber) {
+            sendTimeNs_ = value;
+            present_ |= HAS_SEND_TIME;
+        } else if constexpr (number == IPCData::kSequenceFieldNumber) {
+            sequence_ = value;
+            present_ |= HAS_SEQUENCE;
+        }
+    });
+}
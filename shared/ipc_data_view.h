@@ -0,0 +1,77 @@
+#ifndef IPC_DATA_VIEW_H
+#define IPC_DATA_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "ipc_data.pb.h"
+
+/**
+ * @brief Allocation-free, read-only view of a serialized `IPCData` message.
+ *
+ * Decodes the protobuf (or flat) wire format in place: scalar fields are
+ * copied out and `the_string` is exposed as a `std::string_view` into the
+ * parsed buffer, so the buffer must outlive the view. Field numbers come from the generated
+ * `IPCData` class, and validation matches `T_IPCData`'s constructor.
+ */
+class IPCDataView {
+public:
+    // Constructors
+    IPCDataView();
+    IPCDataView(const char* data, size_t size);
+    explicit IPCDataView(std::string_view serializedMessage);
+
+    // Methods
+    void Parse(const char* data, size_t size);
+    void SetTheString(std::string_view text);
+
+    // Getters
+    std::optional<int> GetTheInt() const;
+    std::optional<float> GetTheFloat() const;
+    std::optional<std::string_view> GetTheString() const;
+    std::optional<IPCData::Type> GetTheType() const;
+    std::optional<uint64_t> GetSendTimeNs() const;
+    std::optional<uint64_t> GetSequence() const;
+
+    // String dictionary fields (see string_dictionary.h)
+    std::optional<uint32_t> GetStringRef() const;
+    std::optional<uint32_t> GetStringPrefix() const;
+    std::optional<uint32_t> GetStringDefine() const;
+    std::optional<uint32_t> GetDictStream() const;
+    std::optional<uint32_t> GetDictEpoch() const;
+
+private:
+    // Presence bits
+    static constexpr uint16_t HAS_INT           = 1 << 0;
+    static constexpr uint16_t HAS_FLOAT         = 1 << 1;
+    static constexpr uint16_t HAS_STRING        = 1 << 2;
+    static constexpr uint16_t HAS_TYPE          = 1 << 3;
+    static constexpr uint16_t HAS_SEND_TIME     = 1 << 4;
+    static constexpr uint16_t HAS_SEQUENCE      = 1 << 5;
+    static constexpr uint16_t HAS_STRING_REF    = 1 << 6;
+    static constexpr uint16_t HAS_STRING_PREFIX = 1 << 7;
+    static constexpr uint16_t HAS_STRING_DEFINE = 1 << 8;
+    static constexpr uint16_t HAS_DICT_STREAM   = 1 << 9;
+    static constexpr uint16_t HAS_DICT_EPOCH    = 1 << 10;
+
+    // Members
+    uint16_t present_;
+    int32_t theInt_;
+    float theFloat_;
+    int32_t theType_;
+    uint64_t sendTimeNs_;
+    uint64_t sequence_;
+    uint32_t stringRef_;
+    uint32_t stringPrefix_;
+    uint32_t stringDefine_;
+    uint32_t dictStream_;
+    uint32_t dictEpoch_;
+    std::string_view theString_;
+
+    // Helper methods
+    void ParseFlat(const char* data, size_t size);
+    void DecodeFlatFields(const char* data, size_t size);
+};
+
+#endif // IPC_DATA_VIEW_H
@@ -0,0 +1,162 @@
+#include "latency_stats.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructor for an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+/**
+ * @brief Records one value.
+ *
+ * @param value The value to record, typically a latency in nanoseconds.
+ */
+void LatencyHistogram::Record(uint64_t value) {
+    ++counts_[BucketIndex(value)];
+    ++count_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+/**
+ * @brief Adds every value recorded in another histogram to this one.
+ */
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+/**
+ * @brief Discards all recorded values.
+ */
+void LatencyHistogram::Reset() {
+    counts_.fill(0);
+    count_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+/**
+ * @brief Returns the value below which the given percentage of recorded values fall.
+ *
+ * The result is the upper bound of the bucket holding that rank, capped at
+ * the exact maximum, so it never understates the latency.
+ *
+ * @param percentile Percentage in [0, 100], e.g. 99.9.
+ * @return The percentile value, or 0 if nothing has been recorded.
+ */
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::min(BucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+/**
+ * @brief Maps a value to its bucket.
+ *
+ * Values below `SUB_BUCKET_COUNT` get a bucket each. Above that, the top
+ * `SUB_BUCKET_BITS + 1` significant bits select the bucket.
+ */
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+
+    const int exponent = 63 - __builtin_clzll(value);
+    const int shift = exponent - SUB_BUCKET_BITS;
+    const size_t subBucket = static_cast<size_t>(value >> shift) - SUB_BUCKET_COUNT;
+    return static_cast<size_t>(shift + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+/**
+ * @brief Returns the largest value that maps to a bucket.
+ */
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    const int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+/**
+ * @brief Constructor for a tracker that has not seen any sequence numbers.
+ */
+SequenceTracker::SequenceTracker()
+    : started_(false), highest_(0), seen_(0), missing_(0), reordered_(0), duplicates_(0), restarts_(0) { }
+
+/**
+ * @brief Accounts for one received sequence number.
+ *
+ * A jump forward counts the skipped numbers as missing; one of those
+ * arriving later is counted as reordered and no longer missing.
+ */
+void SequenceTracker::Observe(uint64_t sequence) {
+    if (!started_) {
+        started_ = true;
+        highest_ = sequence;
+        seen_ = 1;
+        return;
+    }
+
+    if (sequence > highest_) {
+        const uint64_t distance = sequence - highest_;
+        missing_ += distance - 1;
+        seen_ = distance >= WINDOW ? 1 : (seen_ << distance) | 1;
+        highest_ = sequence;
+        return;
+    }
+
+    const uint64_t distance = highest_ - sequence;
+    if (distance >= WINDOW) {
+        // Too old to be a late arrival; the sender started a new sequence
+        ++restarts_;
+        highest_ = sequence;
+        seen_ = 1;
+        return;
+    }
+
+    const uint64_t bit = uint64_t(1) << distance;
+    if (seen_ & bit) {
+        ++duplicates_;
+        return;
+    }
+    seen_ |= bit;
+    ++reordered_;
+    if (missing_ > 0) {
+        --missing_;
+    }
+}
+
+/**
+ * @brief Zeroes the counters while keeping the position in the sequence.
+ *
+ * Used between periodic reports so each report covers only its own interval.
+ */
+void SequenceTracker::ResetCounters() {
+    missing_ = 0;
+    reordered_ = 0;
+    duplicates_ = 0;
+    restarts_ = 0;
+}
@@ -0,0 +1,84 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-size log-linear latency histogram (HdrHistogram-style).
+ *
+ * Values are bucketed by power of two, and each power of two is split into
+ * `2^SUB_BUCKET_BITS` linear sub-buckets, so any recorded value is reported
+ * within ~3% of its true value across the whole `uint64_t` range. All storage
+ * is inline; `Record` never allocates and costs a handful of instructions.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    // Constructors
+    LatencyHistogram();
+
+    // Methods
+    void Record(uint64_t value);
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    // Getters
+    uint64_t Percentile(double percentile) const;
+    uint64_t Count() const { return count_; }
+    uint64_t Min() const { return count_ ? min_ : 0; }
+    uint64_t Max() const { return max_; }
+
+    // Bucket mapping, exposed for tests
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    // Members
+    std::array<uint64_t, BUCKET_COUNT> counts_;
+    uint64_t count_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+/**
+ * @brief Detects lost, reordered and duplicated messages from one sender's sequence numbers.
+ *
+ * Remembers which of the last `WINDOW` sequence numbers have been seen, so a
+ * late arrival can be told apart from a duplicate. A number older than the
+ * window is taken to mean the sender restarted, and tracking starts over.
+ * Tracks a single sequence; records from several senders need one tracker each.
+ */
+class SequenceTracker {
+public:
+    static constexpr uint64_t WINDOW = 64;
+
+    // Constructors
+    SequenceTracker();
+
+    // Methods
+    void Observe(uint64_t sequence);
+    void ResetCounters();
+
+    // Getters
+    uint64_t Missing() const { return missing_; }       // Sequence numbers skipped and not (yet) seen
+    uint64_t Reordered() const { return reordered_; }   // Arrivals that filled an earlier gap
+    uint64_t Duplicates() const { return duplicates_; } // Arrivals already seen
+    uint64_t Restarts() const { return restarts_; }     // Times the sequence jumped backwards past the window
+
+private:
+    // Members
+    bool started_;
+    uint64_t highest_;
+    uint64_t seen_; // Bit i set == highest_ - i has been seen
+    uint64_t missing_;
+    uint64_t reordered_;
+    uint64_t duplicates_;
+    uint64_t restarts_;
+};
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "load_generator.h"
+
+namespace {
+    // Longest a producer sleeps at once, so a stop request is noticed promptly at low rates
+    constexpr std::chrono::milliseconds MAX_SLEEP { 100 };
+}
+
+/**
+ * @brief Parses an `--arrivals` value: "uniform", "poisson" or "burst".
+ *
+ * @throws std::invalid_argument for any other value.
+ */
+ArrivalPattern ParseArrivalPattern(const std::string& name) {
+    if (name == "uniform") return ArrivalPattern::Uniform;
+    if (name == "poisson") return ArrivalPattern::Poisson;
+    if (name == "burst")   return ArrivalPattern::Burst;
+    throw std::invalid_argument("Unknown arrival pattern '" + name + "' (expected uniform, poisson or burst)");
+}
+
+/**
+ * @brief Pregenerates the records a load run cycles through.
+ *
+ * Each field is set independently with its `presence` probability; values are
+ * drawn like `main_tx`'s random data, and strings are lowercase letters with
+ * a length uniform in `[stringMin, stringMax]`.
+ *
+ * @throws std::invalid_argument if the pool is empty or the string range is inverted.
+ */
+std::vector<T_IPCData> MakeRecordPool(const LoadProfile& profile) {
+    if (profile.poolSize == 0 || profile.stringMin > profile.stringMax) {
+        throw std::invalid_argument("Load profile needs a non-empty pool and stringMin <= stringMax.");
+    }
+
+    std::mt19937_64 gen(profile.seed);
+    std::uniform_int_distribution<int>    int_dist    (0, 100);
+    std::uniform_real_distribution<float> float_dist  (0.0f, 100.0f);
+    std::uniform_int_distribution<int>    enum_dist   (0, IPCData::Type_ARRAYSIZE - 1);
+    std::uniform_int_distribution<size_t> length_dist (profile.stringMin, profile.stringMax);
+    std::uniform_int_distribution<int>    letter_dist ('a', 'z');
+    std::uniform_real_distribution<double> chance     (0.0, 1.0);
+
+    std::vector<T_IPCData> pool;
+    pool.reserve(profile.poolSize);
+    for (size_t i = 0; i < profile.poolSize; ++i) {
+        std::optional<int> theInt;
+        std::optional<float> theFloat;
+        std::optional<std::string> theString;
+        std::optional<IPCData::Type> theType;
+
+        if (chance(gen) < profile.presence[0]) theInt = int_dist(gen);
+        if (chance(gen) < profile.presence[1]) theFloat = float_dist(gen);
+        if (chance(gen) < profile.presence[2]) {
+            std::string text(length_dist(gen), ' ');
+            std::generate(text.begin(), text.end(), [&] { return static_cast<char>(letter_dist(gen)); });
+            theString = std::move(text);
+        }
+        if (chance(gen) < profile.presence[3]) theType = static_cast<IPCData::Type>(enum_dist(gen));
+
+        pool.emplace_back(theInt, theFloat, theString, theType);
+    }
+    return pool;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param rate Records per second for this producer.
+ * @param pattern How arrivals are spaced.
+ * @param burstSize Records per group with `ArrivalPattern::Burst`.
+ * @param seed Seed for Poisson gaps.
+ * @throws std::invalid_argument if `rate` is not positive or `burstSize` is zero.
+ */
+ArrivalSchedule::ArrivalSchedule(double rate, ArrivalPattern pattern, size_t burstSize, uint64_t seed)
+    : intervalNs_(1e9 / rate), pattern_(pattern), burstSize_(burstSize), state_(seed | 1), nextNs_(0.0), index_(0) {
+    if (!(rate > 0.0) || burstSize == 0) {
+        throw std::invalid_argument("Arrival rate and burst size must be positive.");
+    }
+}
+
+/**
+ * @brief Returns the intended send time of the next record, relative to the start of the run.
+ */
+std::chrono::nanoseconds ArrivalSchedule::Next() {
+    double due;
+    switch (pattern_) {
+    case ArrivalPattern::Poisson: {
+        due = nextNs_;
+        // xorshift64*, mapped to (0, 1]
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        const double uniform = static_cast<double>((state_ * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+        nextNs_ += -std::log(1.0 - uniform) * intervalNs_;
+        break;
+    }
+    case ArrivalPattern::Burst:
+        due = static_cast<double>(index_ / burstSize_) * static_cast<double>(burstSize_) * intervalNs_;
+        break;
+    case ArrivalPattern::Uniform:
+    default:
+        due = static_cast<double>(index_) * intervalNs_;
+        break;
+    }
+    ++index_;
+    return std::chrono::nanoseconds(static_cast<int64_t>(due));
+}
+
+/**
+ * @brief Constructor that pregenerates the record pool.
+ *
+ * @throws std::invalid_argument if the profile is invalid.
+ */
+LoadGenerator::LoadGenerator(const LoadProfile& profile) : profile_(profile), pool_(MakeRecordPool(profile)) {
+    if (!(profile.rate > 0.0) || profile.threads == 0) {
+        throw std::invalid_argument("Load profile needs a positive rate and at least one thread.");
+    }
+}
+
+/**
+ * @brief Runs the load until the profile's duration elapses or `stopRequested` returns true.
+ *
+ * Every thread sends `rate / threads` records per second, starting at a
+ * different point in the pool. Sends that throw are counted as errors and the
+ * run continues.
+ *
+ * @param send Sends one record; called concurrently with a different `thread` index per producer.
+ * @param stopRequested Polled between sends (and during long sleeps) on every thread.
+ * @return The merged results of all threads.
+ */
+LoadReport LoadGenerator::Run(const SendFunction& send, const std::function<bool()>& stopRequested) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point end = profile_.duration.count() > 0 ? start + profile_.duration : Clock::time_point::max();
+
+    std::vector<LoadReport> reports(profile_.threads);
+    auto produce = [&](size_t thread) {
+        LoadReport& report = reports[thread];
+        ArrivalSchedule schedule(profile_.rate / static_cast<double>(profile_.threads), profile_.arrivals,
+                                 profile_.burstSize, profile_.seed + thread);
+        size_t next = thread * pool_.size() / profile_.threads;
+
+        while (!stopRequested()) {
+            const Clock::time_point intended = start + schedule.Next();
+            if (intended >= end) {
+                break;
+            }
+            // Open loop: sleep only if ahead of schedule; a late record goes out immediately
+            for (Clock::time_point now = Clock::now(); now < intended && !stopRequested(); now = Clock::now()) {
+                std::this_thread::sleep_until(std::min(intended, now + MAX_SLEEP));
+            }
+            if (stopRequested()) {
+                break;
+            }
+
+            try {
+                send(thread, pool_[next]);
+                ++report.sent;
+            } catch (const std::exception&) {
+                ++report.errors;
+            }
+            report.latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - intended).count()));
+            next = (next + 1) % pool_.size();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 1; thread < profile_.threads; ++thread) {
+        threads.emplace_back(produce, thread);
+    }
+    produce(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    LoadReport total;
+    for (const LoadReport& report : reports) {
+        total.sent += report.sent;
+        total.errors += report.errors;
+        total.latency.Merge(report.latency);
+    }
+    total.seconds = std::chrono::duration<double>(std::min(Clock::now(), end) - start).count();
+    return total;
+}
@@ -0,0 +1,99 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "latency_stats.h"
+#include "t_ipc_data.h"
+
+// When an open-loop producer intends to send each record
+enum class ArrivalPattern {
+    Uniform, // Evenly spaced at the target rate
+    Poisson, // Exponentially distributed gaps with the target rate as the mean
+    Burst    // Groups of `burstSize` records due at once, groups spaced to keep the target rate
+};
+
+struct LoadProfile {
+    double rate = 1000.0;                            // Target records per second, across all threads
+    ArrivalPattern arrivals = ArrivalPattern::Uniform;
+    size_t burstSize = 16;                           // Records per group with ArrivalPattern::Burst
+    size_t threads = 1;                              // Producer threads, each sending rate / threads
+    std::chrono::milliseconds duration { 0 };        // How long to run; 0 = until stopped
+    std::array<double, 4> presence { 1.0, 1.0, 1.0, 1.0 }; // Chance each field (int, float, string, type) is set
+    size_t stringMin = 8;                            // String lengths are uniform in [stringMin, stringMax]
+    size_t stringMax = 64;
+    size_t poolSize = 4096;                          // Pregenerated records, cycled through by every thread
+    uint64_t seed = 1;
+};
+
+struct LoadReport {
+    uint64_t sent = 0;
+    uint64_t errors = 0;              // Sends that threw
+    double seconds = 0.0;             // Wall time from the first intended send to the end of the run
+    LatencyHistogram latency;         // Completion time minus intended send time, in nanoseconds
+
+    double AchievedRate() const { return seconds > 0 ? static_cast<double>(sent) / seconds : 0.0; }
+};
+
+ArrivalPattern ParseArrivalPattern(const std::string& name);
+std::vector<T_IPCData> MakeRecordPool(const LoadProfile& profile);
+
+/**
+ * @brief Intended send times for one producer, as offsets from the start of the run.
+ *
+ * Deterministic for a given seed, so runs are repeatable.
+ */
+class ArrivalSchedule {
+public:
+    // Constructors
+    ArrivalSchedule(double rate, ArrivalPattern pattern, size_t burstSize, uint64_t seed);
+
+    // Methods
+    std::chrono::nanoseconds Next();
+
+private:
+    // Members
+    double intervalNs_;   // Mean gap between records
+    ArrivalPattern pattern_;
+    size_t burstSize_;
+    uint64_t state_;      // xorshift state for Poisson gaps
+    double nextNs_;
+    uint64_t index_;
+};
+
+/**
+ * @brief Open-loop load generator: sends pregenerated records at a target rate from N threads.
+ *
+ * Each thread follows its own `ArrivalSchedule` and never waits for a slow
+ * send to "catch up" on the schedule: a late record is sent as soon as the
+ * previous one completes, and its latency is measured from when it *should*
+ * have been sent. A stall in the transport therefore shows up in the
+ * percentiles instead of silently lowering the offered load (coordinated
+ * omission).
+ */
+class LoadGenerator {
+public:
+    // Called on producer thread `thread` for every record; must not be shared between threads
+    using SendFunction = std::function<void(size_t thread, const T_IPCData& data)>;
+
+    // Constructors
+    explicit LoadGenerator(const LoadProfile& profile);
+
+    // Methods
+    LoadReport Run(const SendFunction& send, const std::function<bool()>& stopRequested);
+
+    // Getters
+    const std::vector<T_IPCData>& Pool() const { return pool_; }
+
+private:
+    // Members
+    LoadProfile profile_;
+    std::vector<T_IPCData> pool_;
+};
+
+#endif // LOAD_GENERATOR_H
@@ -0,0 +1,260 @@
+#include "log_sink.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <sys/uio.h>
+
+/**
+ * @brief Appends text, truncating at the line capacity.
+ */
+LogLine& LogLine::Append(std::string_view text) {
+    const size_t count = std::min(text.size(), CAPACITY - size_);
+    std::memcpy(buffer_.data() + size_, text.data(), count);
+    size_ += count;
+    truncated_ |= count < text.size();
+    return *this;
+}
+
+LogLine& LogLine::Append(char c) {
+    return Append(std::string_view(&c, 1));
+}
+
+LogLine& LogLine::Append(int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    return Append(std::string_view(digits, result.ptr - digits));
+}
+
+LogLine& LogLine::Append(uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    return Append(std::string_view(digits, result.ptr - digits));
+}
+
+/**
+ * @brief Appends a float with six decimals, matching `std::to_string`.
+ */
+LogLine& LogLine::Append(float value) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6);
+    if (result.ec != std::errc()) {
+        return Append(std::string_view("nan"));
+    }
+    return Append(std::string_view(digits, result.ptr - digits));
+}
+
+/**
+ * @brief Appends text in double quotes, escaping quotes, backslashes and line breaks
+ * so a compact line always stays one line.
+ */
+LogLine& LogLine::AppendQuoted(std::string_view text) {
+    Append('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            Append('\\').Append(c);
+        } else if (c == '\n') {
+            Append(std::string_view("\\n"));
+        } else if (c == '\r') {
+            Append(std::string_view("\\r"));
+        } else {
+            Append(c);
+        }
+    }
+    return Append('"');
+}
+
+/**
+ * @brief Constructor that allocates the ring and starts the writer thread.
+ *
+ * The output format is chosen once from the descriptor: `LogFormat::Human`
+ * for a terminal, `LogFormat::Compact` otherwise.
+ *
+ * @param fd Descriptor to write to (not closed by the sink).
+ * @param policy What `Write` does when the ring is full.
+ * @param capacity Ring size in bytes; a single line must fit in it.
+ */
+LogSink::LogSink(int fd, LogOverflowPolicy policy, size_t capacity)
+    : fd_(fd), policy_(policy), format_(isatty(fd) ? LogFormat::Human : LogFormat::Compact), ring_(capacity),
+      head_(0), tail_(0), dropped_(0), writerIdle_(false), stopping_(false) {
+    writer_ = std::thread(&LogSink::Run, this);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Writes out everything still queued, then stops the writer thread.
+ */
+LogSink::~LogSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    dataReady_.notify_one();
+    writer_.join();
+}
+
+/**
+ * @brief Queues one line (or any run of bytes) for output.
+ *
+ * @param line The bytes to write; include the trailing newline.
+ * @return True if the line was queued, false if it was dropped.
+ */
+bool LogSink::Write(std::string_view line) {
+    if (line.empty()) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (line.size() > ring_.size()) {
+        ++dropped_; // Could never fit, even with an empty ring
+        return false;
+    }
+
+    while (ring_.size() - (head_ - tail_) < line.size()) {
+        if (policy_ == LogOverflowPolicy::Drop) {
+            ++dropped_;
+            return false;
+        }
+        spaceReady_.wait(lock);
+    }
+
+    // Copy in, wrapping around the end of the ring
+    const size_t offset = head_ % ring_.size();
+    const size_t firstPart = std::min(line.size(), ring_.size() - offset);
+    std::memcpy(ring_.data() + offset, line.data(), firstPart);
+    std::memcpy(ring_.data(), line.data() + firstPart, line.size() - firstPart);
+    head_ += line.size();
+
+    // Only pay for a wakeup when the writer is actually asleep
+    const bool wake = writerIdle_;
+    writerIdle_ = false;
+    lock.unlock();
+    if (wake) {
+        dataReady_.notify_one();
+    }
+    return true;
+}
+
+/**
+ * @brief Blocks until every line queued before the call has been written out.
+ */
+void LogSink::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target = head_;
+    if (writerIdle_ && tail_ < target) {
+        writerIdle_ = false;
+        dataReady_.notify_one();
+    }
+    spaceReady_.wait(lock, [&] { return tail_ >= target; });
+}
+
+/**
+ * @brief Returns how many lines the Drop policy has discarded.
+ */
+uint64_t LogSink::Dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Writer thread: drains the ring in as few `writev` calls as possible.
+ *
+ * The lock is only held to snapshot and advance the indices; the write itself
+ * runs unlocked so producers keep appending while it is in progress.
+ */
+void LogSink::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (head_ == tail_) {
+            if (stopping_) {
+                return;
+            }
+            writerIdle_ = true;
+            dataReady_.wait(lock, [&] { return head_ != tail_ || stopping_; });
+            writerIdle_ = false;
+            continue;
+        }
+
+        const uint64_t end = head_;
+        const size_t offset = tail_ % ring_.size();
+        const size_t pending = static_cast<size_t>(end - tail_);
+        const size_t firstPart = std::min(pending, ring_.size() - offset);
+        lock.unlock();
+
+        WriteAll(ring_.data() + offset, firstPart, ring_.data(), pending - firstPart);
+
+        lock.lock();
+        tail_ = end;
+        spaceReady_.notify_all();
+    }
+}
+
+/**
+ * @brief Writes one or two ring regions completely, retrying short writes and EINTR.
+ *
+ * On any other error the remaining bytes are discarded; there is nowhere to report it.
+ */
+void LogSink::WriteAll(const char* first, size_t firstSize, const char* second, size_t secondSize) {
+    iovec regions[2] = {
+        { const_cast<char*>(first), firstSize },
+        { const_cast<char*>(second), secondSize }
+    };
+    iovec* next = regions;
+    int count = secondSize > 0 ? 2 : 1;
+
+    while (count > 0) {
+        ssize_t written = writev(fd_, next, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        // Skip past what was written
+        while (count > 0 && static_cast<size_t>(written) >= next->iov_len) {
+            written -= static_cast<ssize_t>(next->iov_len);
+            ++next;
+            --count;
+        }
+        if (count > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + written;
+            next->iov_len -= static_cast<size_t>(written);
+        }
+    }
+}
+
+/**
+ * @brief Renders a record into a log line.
+ *
+ * `LogFormat::Human` reproduces `T_IPCData::ToString`. `LogFormat::Compact`
+ * writes `key=value` pairs for the fields that are set, without a trailing
+ * newline, so callers can prefix or suffix their own fields.
+ */
+void AppendRecord(LogLine& line, const T_IPCData& data, LogFormat format) {
+    if (format == LogFormat::Compact) {
+        if (auto value = data.GetTheInt())        line.Append(" int=").Append(*value);
+        if (auto value = data.GetTheFloat())      line.Append(" float=").Append(*value);
+        if (auto value = data.GetTheString())     line.Append(" string=").AppendQuoted(*value);
+        if (auto value = data.GetTheType())       line.Append(" type=").Append(static_cast<int>(*value));
+        if (auto value = data.GetSequence())      line.Append(" seq=").Append(*value);
+        return;
+    }
+
+    const std::string_view unset = "Not set";
+    line.Append("  Int:    ");
+    if (auto value = data.GetTheInt()) line.Append(*value); else line.Append(unset);
+    line.Append("\n  Float:  ");
+    if (auto value = data.GetTheFloat()) line.Append(*value); else line.Append(unset);
+    line.Append("\n  String: ");
+    if (auto value = data.GetTheString()) line.Append(*value); else line.Append(unset);
+    line.Append("\n  Type:   ");
+    if (auto value = data.GetTheType()) line.Append(static_cast<int>(*value)); else line.Append(unset);
+    line.Append('\n');
+    if (auto value = data.GetSequence()) line.Append("  Seq:    ").Append(*value).Append('\n');
+}
@@ -0,0 +1,117 @@
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "t_ipc_data.h"
+
+// Size of the byte ring between the logging threads and the writer thread
+#define LOG_SINK_CAPACITY (256 * 1024)
+
+// What LogSink::Write does when the ring has no room for a line
+enum class LogOverflowPolicy {
+    Block, // Wait for the writer thread to make room (no output is lost)
+    Drop   // Discard the line and count it, so the caller never waits on the output device
+};
+
+// How records are rendered for the output
+enum class LogFormat {
+    Human,  // Multi-line layout matching T_IPCData::ToString, for terminals
+    Compact // One key=value line per record, for pipes and files
+};
+
+/**
+ * @brief Fixed-capacity line buffer for formatting log output without allocating.
+ *
+ * Appends past the capacity are truncated and flagged rather than growing.
+ */
+class LogLine {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    // Constructors
+    LogLine() : size_(0), truncated_(false) { }
+
+    // Methods
+    LogLine& Append(std::string_view text);
+    LogLine& Append(char c);
+    LogLine& Append(int64_t value);
+    LogLine& Append(uint64_t value);
+    LogLine& Append(int value) { return Append(static_cast<int64_t>(value)); }
+    LogLine& Append(float value);
+    LogLine& AppendQuoted(std::string_view text);
+    void Clear() { size_ = 0; truncated_ = false; }
+
+    // Getters
+    const char* Data() const { return buffer_.data(); }
+    size_t Size() const { return size_; }
+    bool Truncated() const { return truncated_; }
+    std::string_view View() const { return std::string_view(buffer_.data(), size_); }
+
+private:
+    std::array<char, CAPACITY> buffer_;
+    size_t size_;
+    bool truncated_;
+};
+
+/**
+ * @brief Asynchronous output sink that moves terminal/pipe I/O off the calling thread.
+ *
+ * `Write` copies a finished line into a preallocated byte ring and returns;
+ * a background thread drains everything queued so far with a single
+ * `writev(2)`, so many lines share one syscall and a slow output device only
+ * stalls callers when the ring is full (and never with `LogOverflowPolicy::Drop`).
+ * Lines are copied whole, so output from several threads never interleaves mid-line.
+ */
+class LogSink {
+public:
+    // Constructors
+    explicit LogSink(int fd = STDOUT_FILENO, LogOverflowPolicy policy = LogOverflowPolicy::Block,
+                     size_t capacity = LOG_SINK_CAPACITY);
+    ~LogSink();
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    // Methods
+    bool Write(std::string_view line);
+    bool Write(const LogLine& line) { return Write(line.View()); }
+    void Flush();
+
+    // Getters
+    LogFormat Format() const { return format_; }
+    bool IsTerminal() const { return format_ == LogFormat::Human; }
+    uint64_t Dropped() const;
+
+private:
+    // Members
+    int fd_;
+    LogOverflowPolicy policy_;
+    LogFormat format_;
+    std::vector<char> ring_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable dataReady_;  // Writer waits here for lines
+    std::condition_variable spaceReady_; // Blocked producers and Flush wait here
+    uint64_t head_;                      // Total bytes queued
+    uint64_t tail_;                      // Total bytes written out
+    uint64_t dropped_;                   // Lines discarded by the Drop policy
+    bool writerIdle_;
+    bool stopping_;
+    std::thread writer_;
+
+    // Helper methods
+    void Run();
+    void WriteAll(const char* first, size_t firstSize, const char* second, size_t secondSize);
+};
+
+void AppendRecord(LogLine& line, const T_IPCData& data, LogFormat format);
+
+#endif // LOG_SINK_H
@@ -0,0 +1,122 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer queue (Vyukov's design).
+ *
+ * Each slot carries a sequence number that tells producers and consumers
+ * whether it is free or full for their lap of the ring, so a push or pop is
+ * one CAS on the shared index plus an uncontended release store on the slot.
+ * Elements are filled and read in place through callbacks, so large slot
+ * types (such as a whole receive buffer) are never copied as a unit.
+ *
+ * @tparam T Slot type; default-constructed once for every slot up front.
+ */
+template <typename T>
+class MpmcQueue {
+public:
+    /**
+     * @brief Constructor that preallocates every slot.
+     *
+     * @param capacity Number of slots; must be a power of two.
+     * @throws std::invalid_argument if `capacity` is not a power of two.
+     */
+    explicit MpmcQueue(size_t capacity)
+        : mask_(capacity - 1), slots_(new Slot[capacity]), enqueuePos_(0), dequeuePos_(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("MpmcQueue capacity must be a power of two.");
+        }
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Claims a free slot and fills it with `fill(T&)`.
+     *
+     * @return False (without calling `fill`) if the queue is full.
+     */
+    template <typename Fill>
+    bool TryPush(Fill&& fill) {
+        size_t position = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position & mask_];
+            const intptr_t diff = static_cast<intptr_t>(slot->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // The slot still holds last lap's element
+            } else {
+                position = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(slot->value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Claims the oldest full slot and hands it to `consume(T&)` before freeing it.
+     *
+     * @return False (without calling `consume`) if the queue is empty.
+     */
+    template <typename Consume>
+    bool TryPop(Consume&& consume) {
+        size_t position = dequeuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position & mask_];
+            const intptr_t diff = static_cast<intptr_t>(slot->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Nothing published in this slot yet
+            } else {
+                position = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        consume(slot->value);
+        slot->sequence.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns true if the queue looked empty at the time of the call.
+     */
+    bool Empty() const {
+        return dequeuePos_.load(std::memory_order_acquire) >= enqueuePos_.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos_;
+};
+
+#endif // MPMC_QUEUE_H
@@ -0,0 +1,65 @@
+#include <cstring>
+#include <stdexcept>
+#include "overflow_buffer.h"
+
+/**
+ * @brief Constructor that preallocates room for `capacity` messages.
+ */
+OverflowBuffer::OverflowBuffer(size_t capacity)
+    : entries_(capacity), data_(capacity * MAX_MESSAGE_SIZE), head_(0), count_(0) { }
+
+/**
+ * @brief Appends a copy of a message.
+ *
+ * @throws std::length_error if the buffer is full or the message exceeds `MAX_MESSAGE_SIZE`.
+ */
+void OverflowBuffer::Push(const char* data, size_t size, const Entry& entry) {
+    if (Full() || size > MAX_MESSAGE_SIZE) {
+        throw std::length_error("Message does not fit in the overflow buffer.");
+    }
+    const size_t index = (head_ + count_) % entries_.size();
+    entries_[index] = entry;
+    entries_[index].size = static_cast<uint32_t>(size);
+    std::memcpy(Data(index), data, size);
+    ++count_;
+}
+
+/**
+ * @brief Removes the oldest message and returns its metadata.
+ *
+ * The message bytes remain readable through `FrontData` only until the next call.
+ */
+OverflowBuffer::Entry OverflowBuffer::PopFront() {
+    Entry entry = entries_[head_];
+    head_ = (head_ + 1) % entries_.size();
+    --count_;
+    return entry;
+}
+
+/**
+ * @brief Returns the buffered message with this coalescing key, or null if there is none.
+ */
+OverflowBuffer::Entry* OverflowBuffer::Find(uint64_t key) {
+    for (size_t i = 0; i < count_; ++i) {
+        Entry& entry = entries_[(head_ + i) % entries_.size()];
+        if (entry.key == key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Replaces a buffered message in place, keeping its position in the FIFO.
+ *
+ * @param target An entry returned by `Find`.
+ */
+void OverflowBuffer::Overwrite(Entry& target, const char* data, size_t size, const Entry& entry) {
+    if (size > MAX_MESSAGE_SIZE) {
+        throw std::length_error("Message does not fit in the overflow buffer.");
+    }
+    const size_t index = static_cast<size_t>(&target - entries_.data());
+    target = entry;
+    target.size = static_cast<uint32_t>(size);
+    std::memcpy(Data(index), data, size);
+}
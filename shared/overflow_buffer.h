@@ -0,0 +1,62 @@
+#ifndef OVERFLOW_BUFFER_H
+#define OVERFLOW_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "constants.h"
+#include "slab_pool.h"
+
+/**
+ * @brief Bounded FIFO of encoded messages waiting for room in the queue or ring.
+ *
+ * All storage is allocated up front (`capacity` messages of up to
+ * `MAX_MESSAGE_SIZE` bytes), so buffering never allocates. Each message keeps
+ * its queue priority, an optional coalescing key, and the slab it refers to
+ * (if it is a slab descriptor) so a dropped message can release its slab.
+ */
+class OverflowBuffer {
+public:
+    struct Entry {
+        uint32_t size = 0;
+        unsigned priority = 0;
+        std::optional<uint64_t> key;
+        std::optional<SlabDescriptor> slab;
+        bool coded = false;   // Refers to or defines string dictionary entries
+        bool defines = false; // Defines entries that messages buffered after it may refer to
+    };
+
+    // Constructors
+    explicit OverflowBuffer(size_t capacity = 0);
+
+    // Methods
+    void Push(const char* data, size_t size, const Entry& entry);
+    Entry PopFront();
+    Entry* Find(uint64_t key);
+    void Overwrite(Entry& target, const char* data, size_t size, const Entry& entry);
+
+    // Getters
+    const Entry& Front() const { return entries_[head_]; }
+    const char* FrontData() const { return Data(head_); }
+    const Entry& At(size_t i) const { return entries_[(head_ + i) % entries_.size()]; } // i-th oldest
+    Entry& At(size_t i) { return entries_[(head_ + i) % entries_.size()]; }
+    const char* DataAt(size_t i) const { return Data((head_ + i) % entries_.size()); }
+    size_t Size() const { return count_; }
+    size_t Capacity() const { return entries_.size(); }
+    bool Empty() const { return count_ == 0; }
+    bool Full() const { return count_ == entries_.size(); }
+
+private:
+    // Members
+    std::vector<Entry> entries_;
+    std::vector<char> data_;   // MAX_MESSAGE_SIZE bytes per entry
+    size_t head_;
+    size_t count_;
+
+    // Helper methods
+    char* Data(size_t index) { return data_.data() + index * MAX_MESSAGE_SIZE; }
+    const char* Data(size_t index) const { return data_.data() + index * MAX_MESSAGE_SIZE; }
+};
+
+#endif // OVERFLOW_BUFFER_H
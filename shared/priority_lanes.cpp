@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <stdexcept>
+#include "priority_lanes.h"
+
+/**
+ * @brief Constructor that preallocates every buffer.
+ *
+ * @param capacity Messages buffered across all lanes before the caller stops reading.
+ * @param starvationLimit Times a waiting lane may be passed over before it is served; 0 means strict priority.
+ * @throws std::invalid_argument if `capacity` is zero.
+ */
+PriorityLanes::PriorityLanes(size_t capacity, unsigned starvationLimit)
+    : buffers_(capacity * MAX_MESSAGE_SIZE), sizes_(capacity), starvationLimit_(starvationLimit), promoted_(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("PriorityLanes capacity must be positive.");
+    }
+    for (uint32_t slot = 0; slot < capacity; ++slot) {
+        free_.push_back(static_cast<uint32_t>(capacity - 1 - slot));
+    }
+    for (Lane& lane : lanes_) {
+        lane.slots.resize(capacity);
+    }
+}
+
+/**
+ * @brief Returns a free buffer of `MAX_MESSAGE_SIZE` bytes to receive into, or null if all are in use.
+ *
+ * The buffer stays free until `Commit` is called.
+ */
+char* PriorityLanes::FreeBuffer() {
+    if (free_.empty()) {
+        return nullptr;
+    }
+    return buffers_.data() + static_cast<size_t>(free_.back()) * MAX_MESSAGE_SIZE;
+}
+
+/**
+ * @brief Lists up to `max` free buffers, in the order successive `Commit` calls will take them.
+ *
+ * Lets a caller receive a whole batch at once and then commit its messages in order.
+ *
+ * @return The number of buffers listed.
+ */
+size_t PriorityLanes::FreeBuffers(char** buffers, size_t max) {
+    const size_t count = std::min(max, free_.size());
+    for (size_t i = 0; i < count; ++i) {
+        buffers[i] = buffers_.data() + static_cast<size_t>(free_[free_.size() - 1 - i]) * MAX_MESSAGE_SIZE;
+    }
+    return count;
+}
+
+/**
+ * @brief Queues the message just received into the buffer from `FreeBuffer`.
+ *
+ * @param size The message size in bytes.
+ * @param priority The message priority; values above the top lane go to the top lane.
+ */
+void PriorityLanes::Commit(size_t size, unsigned priority) {
+    const uint32_t slot = free_.back();
+    free_.pop_back();
+    sizes_[slot] = size;
+
+    Lane& lane = lanes_[std::min(priority, static_cast<unsigned>(PRIORITY_LEVELS - 1))];
+    lane.slots[(lane.head + lane.count) % lane.slots.size()] = slot;
+    ++lane.count;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Chooses the lane to serve next and updates the starvation counters.
+ *
+ * @return The lane index, or -1 if every lane is empty.
+ */
+int PriorityLanes::Pick() {
+    int chosen = -1;
+    for (int lane = PRIORITY_LEVELS - 1; lane >= 0; --lane) {
+        if (lanes_[lane].count > 0) {
+            chosen = lane;
+            break;
+        }
+    }
+    if (chosen < 0) {
+        return -1;
+    }
+
+    // A lower lane that has waited long enough takes this turn (lowest first)
+    if (starvationLimit_ > 0) {
+        for (int lane = 0; lane < chosen; ++lane) {
+            if (lanes_[lane].count > 0 && lanes_[lane].skipped >= starvationLimit_) {
+                chosen = lane;
+                ++promoted_;
+                break;
+            }
+        }
+    }
+
+    for (int lane = 0; lane < PRIORITY_LEVELS; ++lane) {
+        if (lane != chosen && lanes_[lane].count > 0) {
+            ++lanes_[lane].skipped;
+        }
+    }
+    lanes_[chosen].skipped = 0;
+    return chosen;
+}
+
+uint32_t PriorityLanes::Take(unsigned index) {
+    Lane& lane = lanes_[index];
+    const uint32_t slot = lane.slots[lane.head];
+    lane.head = (lane.head + 1) % lane.slots.size();
+    --lane.count;
+    ++lane.dispatched;
+    return slot;
+}
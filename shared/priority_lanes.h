@@ -0,0 +1,90 @@
+#ifndef PRIORITY_LANES_H
+#define PRIORITY_LANES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "constants.h"
+
+/**
+ * @brief Receive-side buffer that dispatches messages by priority without starving bulk traffic.
+ *
+ * The receive loop reads messages from the queue straight into free lane
+ * buffers (the kernel already hands out the most urgent message first) and
+ * then dispatches one at a time, topping the lanes up whenever they run low
+ * so a newly arrived urgent message overtakes most of what is buffered. The
+ * highest non-empty lane is normally served, but a lane that has been passed
+ * over `starvationLimit` times in a row gets the next turn, which guarantees
+ * every lane holding a message at least one dispatch in `starvationLimit + 1`.
+ *
+ * That guarantee only covers messages already in the lanes. A message queue
+ * always hands over its most urgent message, so while more urgent messages
+ * keep arriving faster than they are handled, a bulk message still in the
+ * queue never reaches a lane and waits until the urgent backlog clears.
+ */
+class PriorityLanes {
+public:
+    // Constructors
+    explicit PriorityLanes(size_t capacity = 32, unsigned starvationLimit = 8);
+
+    PriorityLanes(const PriorityLanes&) = delete;
+    PriorityLanes& operator=(const PriorityLanes&) = delete;
+
+    // Methods
+    char* FreeBuffer();
+    size_t FreeBuffers(char** buffers, size_t max);
+    void Commit(size_t size, unsigned priority);
+
+    /**
+     * @brief Dispatches the next message to `handler(const char* data, size_t size, unsigned priority)`.
+     *
+     * The buffer is returned to the free list after the handler returns, even if it throws.
+     *
+     * @return False if every lane is empty.
+     */
+    template <typename Handler>
+    bool Dispatch(Handler&& handler) {
+        const int lane = Pick();
+        if (lane < 0) {
+            return false;
+        }
+        const uint32_t slot = Take(static_cast<unsigned>(lane));
+        struct Recycle {
+            PriorityLanes& lanes;
+            uint32_t slot;
+            ~Recycle() { lanes.free_.push_back(slot); }
+        } recycle { *this, slot };
+        handler(buffers_.data() + static_cast<size_t>(slot) * MAX_MESSAGE_SIZE, sizes_[slot], static_cast<unsigned>(lane));
+        return true;
+    }
+
+    // Getters
+    bool Empty() const { return free_.size() == sizes_.size(); }
+    size_t Buffered() const { return sizes_.size() - free_.size(); }
+    uint64_t Dispatched(unsigned priority) const { return lanes_[priority].dispatched; }
+    uint64_t Promoted() const { return promoted_; }
+
+private:
+    struct Lane {
+        std::vector<uint32_t> slots; // Ring of buffer indices, in arrival order
+        size_t head = 0;
+        size_t count = 0;
+        unsigned skipped = 0;        // Dispatches that passed this lane over while it was waiting
+        uint64_t dispatched = 0;
+    };
+
+    // Members
+    std::vector<char> buffers_;    // `capacity` buffers of MAX_MESSAGE_SIZE bytes
+    std::vector<size_t> sizes_;
+    std::vector<uint32_t> free_;   // Indices of unused buffers
+    std::array<Lane, PRIORITY_LEVELS> lanes_;
+    unsigned starvationLimit_;
+    uint64_t promoted_;            // Dispatches given to a lower lane by the starvation limit
+
+    // Helper methods
+    int Pick();
+    uint32_t Take(unsigned lane);
+};
+
+#endif // PRIORITY_LANES_H
@@ -0,0 +1,202 @@
+#include "queue_provisioner.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+#include "slab_pool.h"
+
+namespace {
+    // Kernel ceilings that CAP_SYS_RESOURCE may go up to (HARD_MSGMAX, HARD_MSGSIZEMAX)
+    constexpr long HARD_MAX_DEPTH = 65536;
+    constexpr long HARD_MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+    // Bytes the kernel charges to RLIMIT_MSGQUEUE per message slot on top of the
+    // payload: a `struct msg_msg` header plus a priority-tree node, 48 bytes each on 64-bit
+    constexpr uint64_t MESSAGE_OVERHEAD = 96;
+
+    constexpr int CAP_SYS_RESOURCE_BIT = 24;
+
+    long ReadLong(const std::string& path, long fallback) {
+        std::ifstream file(path);
+        long value;
+        return (file >> value) ? value : fallback;
+    }
+
+    bool HasSysResourceCapability() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("CapEff:", 0) == 0) {
+                const unsigned long long capabilities = std::stoull(line.substr(7), nullptr, 16);
+                return (capabilities >> CAP_SYS_RESOURCE_BIT) & 1;
+            }
+        }
+        return false;
+    }
+
+    std::string FormatLimit(uint64_t bytes) {
+        return bytes == UINT64_MAX ? "unlimited" : std::to_string(bytes) + " bytes";
+    }
+}
+
+/**
+ * @brief Reads the message queue limits that apply to this process.
+ *
+ * @param procDirectory Where the `fs.mqueue` sysctls live (overridable for tests).
+ */
+MqueueLimits MqueueLimits::Read(const std::string& procDirectory) {
+    MqueueLimits limits;
+    limits.privileged = HasSysResourceCapability();
+    if (limits.privileged) {
+        limits.maxDepth = HARD_MAX_DEPTH;
+        limits.maxMessageSize = HARD_MAX_MESSAGE_SIZE;
+    } else {
+        limits.maxDepth = ReadLong(procDirectory + "/msg_max", QUEUE_MIN_DEPTH);
+        limits.maxMessageSize = ReadLong(procDirectory + "/msgsize_max", MAX_MESSAGE_SIZE);
+    }
+
+    struct rlimit rlimit;
+    if (getrlimit(RLIMIT_MSGQUEUE, &rlimit) == 0 && rlimit.rlim_cur != RLIM_INFINITY) {
+        limits.byteBudget = static_cast<uint64_t>(rlimit.rlim_cur);
+    }
+    return limits;
+}
+
+/**
+ * @brief Constructor that plans the queue size for a workload.
+ *
+ * @param workload What the queue has to absorb.
+ * @param limits The kernel's limits; read from `/proc` and `getrlimit` by default.
+ * @throws std::runtime_error if the limits leave no room for even one message.
+ */
+QueueProvisioner::QueueProvisioner(const QueueWorkload& workload, const MqueueLimits& limits) : limits_(limits) {
+    const double stalled = std::ceil(workload.messagesPerSecond * workload.stallMs / 1000.0);
+    requestedDepth_ = std::max<long>({ QUEUE_MIN_DEPTH, static_cast<long>(workload.burstMessages), static_cast<long>(stalled) });
+    // Every message must hold at least a slab descriptor, which is what a larger record is sent as
+    requestedMessageSize_ = static_cast<long>(std::clamp<size_t>(workload.maxRecordSize, SLAB_DESCRIPTOR_SIZE, MAX_MESSAGE_SIZE));
+
+    messageSize_ = requestedMessageSize_;
+    if (messageSize_ > limits_.maxMessageSize) {
+        messageSize_ = limits_.maxMessageSize;
+        sizeLimit_ = "fs.mqueue.msgsize_max";
+    }
+
+    depth_ = requestedDepth_;
+    if (depth_ > limits_.maxDepth) {
+        depth_ = limits_.maxDepth;
+        depthLimit_ = limits_.privileged ? "the kernel maximum" : "fs.mqueue.msg_max";
+    }
+    if (limits_.byteBudget != UINT64_MAX) {
+        const uint64_t perQueue = limits_.byteBudget / std::max<size_t>(workload.queueCount, 1);
+        const long affordable = static_cast<long>(perQueue / (static_cast<uint64_t>(messageSize_) + MESSAGE_OVERHEAD));
+        if (depth_ > affordable) {
+            depth_ = affordable;
+            depthLimit_ = "RLIMIT_MSGQUEUE";
+        }
+    }
+    if (depth_ < 1 || messageSize_ < 1) {
+        throw std::runtime_error("Message queue limits leave no room for a queue: " + Describe());
+    }
+}
+
+/**
+ * @brief Opens a queue sized by the plan, or attaches to the one that already exists.
+ *
+ * An existing queue is never unlinked, since another process (a sender that
+ * started first, or a receiver still draining it) may have it open; it is
+ * attached to as it is, even if it is smaller than planned, and `result.attr`
+ * reports its actual depth and message size. Only a queue whose messages
+ * would not fit the receiver's buffer is refused.
+ *
+ * @param name The queue name.
+ * @param flags `mq_open` flags, e.g. `O_RDONLY | O_NONBLOCK`; `O_CREAT` is added as needed.
+ * @param receiveBufferSize Size of the buffer the caller passes to `mq_receive`.
+ * @throws std::runtime_error if the queue cannot be opened or created, or an
+ *         existing queue's messages are larger than `receiveBufferSize`.
+ */
+QueueOpenResult QueueProvisioner::Open(const std::string& name, int flags, size_t receiveBufferSize) const {
+    flags &= ~(O_CREAT | O_EXCL);
+    QueueOpenResult result {};
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        result.mq = mq_open(name.c_str(), flags);
+        if (result.mq != (mqd_t)-1) {
+            mq_getattr(result.mq, &result.attr);
+            if (result.attr.mq_msgsize > static_cast<long>(receiveBufferSize)) {
+                mq_close(result.mq);
+                throw std::runtime_error("Message queue " + name + " already exists with " + std::to_string(result.attr.mq_msgsize) +
+                                         "-byte messages, more than the " + std::to_string(receiveBufferSize) +
+                                         "-byte receive buffer; remove it (rm /dev/mqueue" + name + ") once nothing uses it");
+            }
+            result.origin = QueueOrigin::Attached;
+            return result;
+        }
+        if (errno != ENOENT) {
+            throw std::runtime_error("Failed to open message queue " + name + ": " + std::strerror(errno));
+        }
+
+        struct mq_attr attr {};
+        attr.mq_maxmsg = depth_;
+        attr.mq_msgsize = messageSize_;
+        result.mq = mq_open(name.c_str(), flags | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, &attr);
+        if (result.mq != (mqd_t)-1) {
+            mq_getattr(result.mq, &result.attr);
+            result.origin = QueueOrigin::Created;
+            return result;
+        }
+        if (errno == EMFILE || errno == ENOMEM || errno == EINVAL) {
+            throw std::runtime_error("Failed to create message queue " + name + " (" + Describe() + "): " + std::strerror(errno) +
+                                     "; other queues of this user may be using up RLIMIT_MSGQUEUE or fs.mqueue.queues_max");
+        }
+        if (errno != EEXIST) {
+            throw std::runtime_error("Failed to create message queue " + name + ": " + std::strerror(errno));
+        }
+        // Another process created it first; go round and attach to it
+    }
+    throw std::runtime_error("Failed to open message queue " + name + ": it keeps being removed and recreated");
+}
+
+/**
+ * @brief Describes the plan, naming the limit that capped it if any.
+ */
+std::string QueueProvisioner::Describe() const {
+    std::ostringstream oss;
+    oss << "depth " << depth_ << " x " << messageSize_ << "-byte messages";
+    if (!depthLimit_.empty()) {
+        oss << "; requested depth " << requestedDepth_ << " capped by " << depthLimit_;
+    }
+    if (!sizeLimit_.empty()) {
+        oss << "; requested message size " << requestedMessageSize_ << " capped by " << sizeLimit_;
+    }
+    if (Capped()) {
+        oss << " (msg_max=" << limits_.maxDepth << ", msgsize_max=" << limits_.maxMessageSize
+            << ", RLIMIT_MSGQUEUE=" << FormatLimit(limits_.byteBudget) << ")";
+    }
+    return oss.str();
+}
+
+/**
+ * @brief Describes how a queue was opened and, if it differs from the plan, how.
+ */
+std::string QueueProvisioner::Describe(const std::string& name, const QueueOpenResult& result) const {
+    std::ostringstream oss;
+    oss << "Queue " << name << ": ";
+    switch (result.origin) {
+    case QueueOrigin::Created:
+        oss << "created, " << Describe();
+        break;
+    case QueueOrigin::Attached:
+        oss << "attached with " << result.attr.mq_curmsgs << " pending messages, depth "
+            << result.attr.mq_maxmsg << " x " << result.attr.mq_msgsize << "-byte messages";
+        if (result.attr.mq_maxmsg < depth_ || result.attr.mq_msgsize < messageSize_) {
+            oss << " (smaller than the planned " << Describe() << "; kept, since other processes may have it open)";
+        }
+        break;
+    }
+    return oss.str();
+}
@@ -0,0 +1,87 @@
+#ifndef QUEUE_PROVISIONER_H
+#define QUEUE_PROVISIONER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mqueue.h>
+#include <string>
+#include "constants.h"
+
+/**
+ * @brief The kernel's ceilings on POSIX message queues for this process.
+ */
+struct MqueueLimits {
+    long maxDepth = QUEUE_MIN_DEPTH;          // fs.mqueue.msg_max (the hard maximum with CAP_SYS_RESOURCE)
+    long maxMessageSize = MAX_MESSAGE_SIZE;   // fs.mqueue.msgsize_max (likewise)
+    uint64_t byteBudget = UINT64_MAX;         // RLIMIT_MSGQUEUE soft limit, shared by all of this user's queues
+    bool privileged = false;                  // CAP_SYS_RESOURCE lifts the two sysctls, but not the rlimit
+
+    static MqueueLimits Read(const std::string& procDirectory = "/proc/sys/fs/mqueue");
+};
+
+/**
+ * @brief What a queue has to absorb, from which its depth and message size are derived.
+ */
+struct QueueWorkload {
+    double messagesPerSecond = 0.0;         // Expected steady send rate
+    size_t burstMessages = 0;               // Largest burst that may arrive at once
+    double stallMs = 10.0;                  // How long the receiver may stop draining at the steady rate
+    size_t maxRecordSize = MAX_MESSAGE_SIZE; // Largest message; bigger records go through the slab pool anyway
+    size_t queueCount = 1;                  // Queues sharing the RLIMIT_MSGQUEUE budget (e.g. one per shard)
+};
+
+// How an opened queue came to be
+enum class QueueOrigin {
+    Created,  // No queue existed
+    Attached  // An existing queue was reused as it is, with any messages still in it
+};
+
+struct QueueOpenResult {
+    mqd_t mq;
+    QueueOrigin origin;
+    struct mq_attr attr;     // Attributes of the queue actually opened
+};
+
+/**
+ * @brief Sizes POSIX message queues from a declared workload and the kernel's limits, and opens them.
+ *
+ * The requested depth covers both the largest burst and what arrives at the
+ * steady rate while the receiver stalls, and is then capped by
+ * `fs.mqueue.msg_max` and by each queue's share of `RLIMIT_MSGQUEUE`. The
+ * plan records which limit, if any, capped it.
+ *
+ * `Open` attaches to an existing queue instead of unlinking it, since
+ * another process may have it open: a restarted receiver picks up messages
+ * still in flight, and a sender that created the queue first keeps talking
+ * to the same queue as the receiver.
+ */
+class QueueProvisioner {
+public:
+    // Constructors
+    explicit QueueProvisioner(const QueueWorkload& workload, const MqueueLimits& limits = MqueueLimits::Read());
+
+    // Methods
+    QueueOpenResult Open(const std::string& name, int flags, size_t receiveBufferSize = MAX_MESSAGE_SIZE) const;
+    std::string Describe() const;
+    std::string Describe(const std::string& name, const QueueOpenResult& result) const;
+
+    // Getters
+    long Depth() const { return depth_; }
+    long MessageSize() const { return messageSize_; }
+    long RequestedDepth() const { return requestedDepth_; }
+    long RequestedMessageSize() const { return requestedMessageSize_; }
+    bool Capped() const { return !depthLimit_.empty() || !sizeLimit_.empty(); }
+    const MqueueLimits& Limits() const { return limits_; }
+
+private:
+    // Members
+    MqueueLimits limits_;
+    long requestedDepth_;
+    long requestedMessageSize_;
+    long depth_;
+    long messageSize_;
+    std::string depthLimit_;  // Name of the limit that capped the depth, if any
+    std::string sizeLimit_;   // Name of the limit that capped the message size, if any
+};
+
+#endif // QUEUE_PROVISIONER_H
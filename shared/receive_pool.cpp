@@ -0,0 +1,291 @@
+#include "receive_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "batch_frame.h"
+#include "flat_codec.h"
+#include "ipc_data_view.h"
+
+namespace {
+    // Failed attempts to find work before a worker parks
+    constexpr int SPIN_LIMIT = 64;
+}
+
+/**
+ * @brief Constructor that starts the worker threads.
+ *
+ * @param onRecord Called on a worker thread for every decoded record; must be thread-safe.
+ * @param onError Called on a worker thread when a record fails to decode or
+ *                `onRecord` throws (and on the submitting thread for a malformed batch). May be empty.
+ * @param options Pool size, queue depth, ordering, and the slab pool and string dictionary to resolve records with.
+ * @throws std::invalid_argument if `options.queueDepth` is not a power of two.
+ */
+ReceivePool::ReceivePool(RecordHandler onRecord, ErrorHandler onError, const ReceivePoolOptions& options)
+    : onRecord_(std::move(onRecord)), onError_(std::move(onError)), ordering_(options.ordering), slabs_(options.slabs),
+      dictionary_(options.dictionary), queued_(0), submitted_(0), completed_(0), stolen_(0), stopping_(false), nextWorker_(0) {
+    size_t count = options.workers;
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Every queue must exist before any worker starts stealing from it
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(options.queueDepth));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers_[i]->thread = std::thread(&ReceivePool::Run, this, i);
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Processes every record already submitted, then stops the workers.
+ */
+ReceivePool::~ReceivePool() {
+    Drain();
+    stopping_.store(true);
+    for (auto& worker : workers_) {
+        Wake(*worker);
+    }
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+/**
+ * @brief Hands one received message to the pool.
+ *
+ * A batch envelope is split into its records. Blocks while the chosen
+ * worker's queue (or, without ordering, every queue) is full, so a slow pool
+ * pushes back on the receive loop instead of dropping records.
+ *
+ * @param message The raw message as received from the queue or ring.
+ * @param size The size of the message in bytes.
+ * @param priority The message's queue priority, passed on to the record handler.
+ */
+void ReceivePool::Submit(const char* message, size_t size, unsigned priority) {
+    if (!IsBatchFrame(message, size)) {
+        SubmitResolved(message, size, priority);
+        return;
+    }
+
+    try {
+        for (std::string_view record : BatchView(message, size)) {
+            SubmitResolved(record.data(), record.size(), priority);
+        }
+    } catch (const std::exception& e) {
+        // A malformed envelope drops the rest of the batch
+        if (onError_) {
+            onError_(e);
+        }
+    }
+}
+
+/**
+ * @brief Waits until every submitted record has been processed.
+ *
+ * Must be called from the submitting thread.
+ */
+void ReceivePool::Drain() {
+    while (completed_.load(std::memory_order_acquire) < submitted_.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+    }
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Queues one record, first resolving it against the string dictionary if it is dictionary-coded.
+ *
+ * A record that cannot be resolved is reported to the error handler and not queued.
+ */
+void ReceivePool::SubmitResolved(const char* record, size_t size, unsigned priority) {
+    if (dictionary_ && !IsSlabDescriptor(record, size) && !flat::IsFlatFrame(record, size)) {
+        try {
+            IPCDataView view(record, size);
+            if (view.GetDictStream()) {
+                dictionary_->Resolve(view);
+                resolved_ = T_IPCData(view).Serialize();
+                SubmitRecord(resolved_.data(), resolved_.size(), priority);
+                return;
+            }
+        } catch (const std::exception& e) {
+            if (onError_) {
+                onError_(e);
+            }
+            return;
+        }
+    }
+    SubmitRecord(record, size, priority);
+}
+
+void ReceivePool::SubmitRecord(const char* record, size_t size, unsigned priority) {
+    const size_t target = Route(record, size);
+    auto fill = [&](Item& item) {
+        item.size = static_cast<uint32_t>(size);
+        item.priority = priority;
+        std::memcpy(item.data, record, size);
+    };
+
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    while (true) {
+        // Prefer the routed worker; without ordering, any worker with room will do
+        for (size_t attempt = 0; attempt < workers_.size(); ++attempt) {
+            const size_t index = (target + attempt) % workers_.size();
+            if (workers_[index]->queue.TryPush(fill)) {
+                workers_[index]->depth.fetch_add(1);
+                queued_.fetch_add(1);
+                WakeFor(index);
+                return;
+            }
+            if (ordering_ == RecordOrdering::ByType) {
+                break;
+            }
+        }
+        std::this_thread::yield(); // Everything is full; let the workers catch up
+    }
+}
+
+/**
+ * @brief Picks the worker for a record.
+ *
+ * With `RecordOrdering::ByType` the type is read with an `IPCDataView` (no
+ * allocation), looking through a slab descriptor to the record in its slab;
+ * records without a type, or that fail to parse, share a key.
+ */
+size_t ReceivePool::Route(const char* record, size_t size) {
+    if (ordering_ == RecordOrdering::None) {
+        return nextWorker_++ % workers_.size();
+    }
+
+    size_t key = 0;
+    try {
+        std::string_view bytes(record, size);
+        if (IsSlabDescriptor(record, size) && slabs_) {
+            // Peek only; the worker that decodes it releases the slab
+            bytes = slabs_->Resolve(DecodeSlabDescriptor(record, size));
+        }
+        IPCDataView view(bytes.data(), bytes.size());
+        if (auto type = view.GetTheType()) {
+            key = static_cast<size_t>(*type) + 1;
+        }
+    } catch (const std::exception&) {
+        // The worker that decodes it will report the error
+    }
+    return key % workers_.size();
+}
+
+/**
+ * @brief Takes a record from the worker's own queue, or steals one if stealing is allowed.
+ */
+bool ReceivePool::TryTake(size_t index, Item& item) {
+    auto consume = [&](Item& slot) {
+        item.size = slot.size;
+        item.priority = slot.priority;
+        std::memcpy(item.data, slot.data, slot.size);
+    };
+
+    for (size_t attempt = 0; attempt < workers_.size(); ++attempt) {
+        Worker& victim = *workers_[(index + attempt) % workers_.size()];
+        if (victim.queue.TryPop(consume)) {
+            victim.depth.fetch_sub(1);
+            queued_.fetch_sub(1);
+            if (attempt > 0) {
+                stolen_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        if (ordering_ == RecordOrdering::ByType) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Worker thread: takes and processes records, parking when there is nothing to do.
+ *
+ * `parked` is set before re-checking for work and the submitter bumps the
+ * counters before checking `parked` (both sequentially consistent), so a
+ * record submitted while a worker is going to sleep always wakes it.
+ */
+void ReceivePool::Run(size_t index) {
+    Worker& self = *workers_[index];
+    auto item = std::make_unique<Item>();
+    auto hasWork = [&] {
+        return ordering_ == RecordOrdering::ByType ? self.depth.load() > 0 : queued_.load() > 0;
+    };
+
+    int idle = 0;
+    while (true) {
+        if (TryTake(index, *item)) {
+            Process(*item);
+            completed_.fetch_add(1, std::memory_order_release);
+            idle = 0;
+            continue;
+        }
+
+        if (stopping_.load() && !hasWork()) {
+            return;
+        }
+        if (++idle < SPIN_LIMIT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(self.mutex);
+        self.parked.store(true);
+        self.wake.wait(lock, [&] { return hasWork() || stopping_.load(); });
+        self.parked.store(false);
+        idle = 0;
+    }
+}
+
+/**
+ * @brief Decodes one record and runs the record handler, reporting any failure.
+ *
+ * A record in a slab is decoded in place and its slab released before the handler runs.
+ */
+void ReceivePool::Process(const Item& item) {
+    try {
+        T_IPCData data = [&] {
+            SlabRecord record(slabs_, std::string_view(item.data, item.size));
+            return T_IPCData { record.View().data(), record.View().size() };
+        }();
+        onRecord_(data, item.priority);
+    } catch (const std::exception& e) {
+        if (onError_) {
+            onError_(e);
+        }
+    }
+}
+
+/**
+ * @brief Wakes the worker a record was queued for, or an idle worker that can steal it.
+ */
+void ReceivePool::WakeFor(size_t index) {
+    if (workers_[index]->parked.load()) {
+        Wake(*workers_[index]);
+        return;
+    }
+    if (ordering_ == RecordOrdering::ByType) {
+        return; // The owner is awake and will get to it
+    }
+
+    // The owner is busy; let a parked worker steal the record instead of waiting
+    for (size_t attempt = 1; attempt < workers_.size(); ++attempt) {
+        Worker& other = *workers_[(index + attempt) % workers_.size()];
+        if (other.parked.load()) {
+            Wake(other);
+            return;
+        }
+    }
+}
+
+void ReceivePool::Wake(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.wake.notify_one();
+}
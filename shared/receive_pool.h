@@ -0,0 +1,115 @@
+#ifndef RECEIVE_POOL_H
+#define RECEIVE_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "constants.h"
+#include "mpmc_queue.h"
+#include "slab_pool.h"
+#include "string_dictionary.h"
+#include "t_ipc_data.h"
+
+// How a ReceivePool assigns records to workers
+enum class RecordOrdering {
+    None,  // Round-robin with work stealing; records may be processed out of order
+    ByType // All records with the same `the_type` go to one worker, in order; no stealing
+};
+
+struct ReceivePoolOptions {
+    size_t workers = 0;                        // Worker threads; 0 = one per core
+    size_t queueDepth = 256;                   // Records buffered per worker (power of two)
+    RecordOrdering ordering = RecordOrdering::None;
+    SlabPool* slabs = nullptr;                 // Resolves slab descriptors; null rejects them
+    StringDictionaryDecoder* dictionary = nullptr; // Resolves dictionary-coded records on the submitting thread; null rejects them
+};
+
+/**
+ * @brief Decodes and processes received records on a pool of worker threads.
+ *
+ * The receive (I/O) thread calls `Submit` with each raw message; batch
+ * envelopes are split into records, and every record is copied into one
+ * worker's lock-free queue. Workers decode it into a `T_IPCData` and call the
+ * record handler. An idle worker steals from the other queues, so a burst
+ * that lands on one worker is spread over the pool; with
+ * `RecordOrdering::ByType` records are routed by `the_type` instead and never
+ * stolen, so each type is handled in arrival order.
+ *
+ * Dictionary-coded records depend on every earlier record of their stream, so
+ * they are resolved in arrival order on the submitting thread and queued as
+ * plain records; only those records pay for the extra encode.
+ */
+class ReceivePool {
+public:
+    using RecordHandler = std::function<void(const T_IPCData& record, unsigned priority)>;
+    using ErrorHandler = std::function<void(const std::exception& error)>;
+
+    // Constructors
+    ReceivePool(RecordHandler onRecord, ErrorHandler onError, const ReceivePoolOptions& options = ReceivePoolOptions());
+    ~ReceivePool();
+
+    ReceivePool(const ReceivePool&) = delete;
+    ReceivePool& operator=(const ReceivePool&) = delete;
+
+    // Methods
+    void Submit(const char* message, size_t size, unsigned priority = 0);
+    void Drain();
+
+    // Getters
+    size_t WorkerCount() const { return workers_.size(); }
+    uint64_t Stolen() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+    struct Item {
+        uint32_t size;
+        uint32_t priority;     // Queue priority of the message the record arrived in
+        char data[MAX_MESSAGE_SIZE];
+    };
+
+    // Per-worker state, allocated separately so workers do not share cache lines
+    struct Worker {
+        explicit Worker(size_t queueDepth) : queue(queueDepth), depth(0), parked(false) { }
+
+        MpmcQueue<Item> queue;
+        std::atomic<int64_t> depth; // Records queued here and not yet taken (briefly negative while a push is being counted)
+        std::atomic<bool> parked;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread thread;
+    };
+
+    // Members
+    RecordHandler onRecord_;
+    ErrorHandler onError_;
+    RecordOrdering ordering_;
+    SlabPool* slabs_;
+    StringDictionaryDecoder* dictionary_;
+    std::string resolved_;        // Re-encoded dictionary-coded record, only touched by the submitting thread
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<int64_t> queued_;  // Records queued across all workers
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> completed_;
+    std::atomic<uint64_t> stolen_;
+    std::atomic<bool> stopping_;
+    size_t nextWorker_;           // Round-robin cursor, only touched by the submitting thread
+
+    // Helper methods
+    void SubmitResolved(const char* record, size_t size, unsigned priority);
+    void SubmitRecord(const char* record, size_t size, unsigned priority);
+    size_t Route(const char* record, size_t size);
+    bool TryTake(size_t index, Item& item);
+    void Run(size_t index);
+    void Process(const Item& item);
+    void WakeFor(size_t index);
+    static void Wake(Worker& worker);
+};
+
+#endif // RECEIVE_POOL_H
@@ -0,0 +1,398 @@
+#include "rpc.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include "constants.h"
+#include "stats_segment.h"
+
+namespace {
+    // Reply queues the server keeps open at once; beyond that they are all closed and reopened as needed
+    constexpr size_t REPLY_QUEUE_CACHE_LIMIT = 64;
+
+    timespec deadlineAfter(std::chrono::milliseconds timeout) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count() + deadline.tv_nsec;
+        deadline.tv_sec += static_cast<time_t>(nanoseconds / 1000000000);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+        return deadline;
+    }
+
+    /**
+     * @brief Writes the envelope header and serializes `data` behind it.
+     *
+     * @return The size of the envelope.
+     * @throws std::length_error if the record does not fit in one message.
+     */
+    size_t Encode(char* out, size_t capacity, uint8_t marker, uint64_t clientId, uint64_t id, const T_IPCData& data, IPCData& proto) {
+        proto.Clear();
+        data.FillProtobuf(proto);
+        const size_t size = proto.ByteSizeLong();
+        if (RPC_HEADER_SIZE + size > capacity) {
+            throw std::length_error("RPC record exceeds the maximum message size.");
+        }
+        out[0] = static_cast<char>(marker);
+        std::memcpy(out + 1, &clientId, sizeof(clientId));
+        std::memcpy(out + 1 + sizeof(clientId), &id, sizeof(id));
+        proto.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(out + RPC_HEADER_SIZE));
+        return RPC_HEADER_SIZE + size;
+    }
+
+    /**
+     * @brief Reads the envelope header of a received message.
+     *
+     * @throws std::runtime_error if the message is not an envelope of the expected kind.
+     */
+    void DecodeHeader(const char* data, size_t size, uint8_t marker, uint64_t& clientId, uint64_t& id) {
+        if (size < RPC_HEADER_SIZE || static_cast<uint8_t>(data[0]) != marker) {
+            throw std::runtime_error(marker == RPC_REQUEST_MARKER ? "Message is not an RPC request." : "Message is not an RPC reply.");
+        }
+        std::memcpy(&clientId, data + 1, sizeof(clientId));
+        std::memcpy(&id, data + 1 + sizeof(clientId), sizeof(id));
+    }
+
+    /**
+     * @brief Returns an id no other live client on this host has: the pid above a per-process counter.
+     */
+    uint64_t NewClientId() {
+        static std::atomic<uint32_t> counter { 0 };
+        return (static_cast<uint64_t>(getpid()) << 32) | counter.fetch_add(1);
+    }
+}
+
+/**
+ * @brief Returns the name of a client's reply queue, e.g. "/ipc_rpc_reply.0000303900000000".
+ */
+std::string RpcReplyQueueName(uint64_t clientId) {
+    char suffix[20];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx", static_cast<unsigned long long>(clientId));
+    return std::string(RPC_REPLY_QUEUE_PREFIX) + suffix;
+}
+
+/* --- RpcClient --- */
+
+/**
+ * @brief Constructor that creates the client's reply queue and connects to the server's request queue.
+ *
+ * The reply queue is sized for `RPC_MAX_PIPELINE` replies, within the kernel's
+ * mqueue limits; `MaxInFlight` reports the depth it got. A queue left under
+ * the same name is removed first: its id embeds this process's pid, so it was
+ * left by an earlier process that had the pid, and no live client uses it.
+ *
+ * @param requestQueueName The server's request queue, e.g. `RPC_QUEUE_NAME`.
+ * @throws std::runtime_error if the reply queue cannot be created or no server has created the request queue.
+ */
+RpcClient::RpcClient(const std::string& requestQueueName)
+    : clientId_(NewClientId()), replyQueueName_(RpcReplyQueueName(clientId_)), requests_((mqd_t)-1),
+      replies_((mqd_t)-1), maxInFlight_(0), nextId_(1), lateReplies_(0), buffer_(MAX_MESSAGE_SIZE) {
+    QueueWorkload workload;
+    workload.burstMessages = RPC_MAX_PIPELINE;
+    const QueueProvisioner plan(workload);
+    struct mq_attr attr {};
+    attr.mq_maxmsg = plan.Depth();
+    attr.mq_msgsize = plan.MessageSize();
+    mq_unlink(replyQueueName_.c_str());
+    replies_ = mq_open(replyQueueName_.c_str(), O_RDONLY | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, &attr);
+    if (replies_ == (mqd_t)-1) {
+        throw std::runtime_error("Failed to create RPC reply queue " + replyQueueName_ + " (" + plan.Describe() + "): " + std::strerror(errno));
+    }
+    maxInFlight_ = static_cast<size_t>(plan.Depth());
+
+    requests_ = mq_open(requestQueueName.c_str(), O_WRONLY);
+    if (requests_ == (mqd_t)-1) {
+        mq_close(replies_);
+        mq_unlink(replyQueueName_.c_str());
+        throw std::runtime_error("No RPC server is listening on " + requestQueueName);
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Closes both queues and removes the reply queue; replies still on their way are lost.
+ */
+RpcClient::~RpcClient() {
+    mq_close(requests_);
+    mq_close(replies_);
+    mq_unlink(replyQueueName_.c_str());
+}
+
+/**
+ * @brief Sends a request and waits for its reply.
+ *
+ * @param request The request record.
+ * @param timeout How long to wait for room in the request queue and for the reply, in total.
+ * @return The reply.
+ * @throws std::runtime_error if no reply arrives in time; see `Send` for the other errors.
+ */
+T_IPCData RpcClient::Call(const T_IPCData& request, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const uint64_t id = Send(request, timeout);
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    std::optional<T_IPCData> reply = Wait(id, std::max(remaining, std::chrono::milliseconds(0)));
+    if (!reply) {
+        throw std::runtime_error("RPC call timed out");
+    }
+    return std::move(*reply);
+}
+
+/**
+ * @brief Sends a request without waiting for its reply, so several can be in flight.
+ *
+ * @param request The request record.
+ * @param timeout How long to wait for room in the request queue.
+ * @return The request's correlation id, to pass to `Wait`.
+ * @throws std::length_error if `MaxInFlight` requests are already in flight, or the record does not fit in one message.
+ * @throws std::runtime_error if the request queue stays full until the timeout, or on any other send failure.
+ */
+uint64_t RpcClient::Send(const T_IPCData& request, std::chrono::milliseconds timeout) {
+    if (InFlight() >= maxInFlight_) {
+        throw std::length_error("Too many RPC requests in flight; wait for some replies first");
+    }
+
+    const uint64_t id = nextId_++;
+    const size_t size = Encode(buffer_.data(), buffer_.size(), RPC_REQUEST_MARKER, clientId_, id, request, proto_);
+    const timespec deadline = deadlineAfter(timeout);
+    if (mq_timedsend(requests_, buffer_.data(), size, 0, &deadline) == -1) {
+        throw std::runtime_error(errno == ETIMEDOUT ? "Timed out sending RPC request: the request queue is full"
+                                                    : "Failed to send RPC request");
+    }
+    stats::Add(Stat::MessagesSent);
+    stats::Add(Stat::BytesSent, size);
+    inFlight_.insert(id);
+    return id;
+}
+
+/**
+ * @brief Waits for the reply to one request.
+ *
+ * Replies to other requests that arrive meanwhile are kept for later. If the
+ * reply does not arrive in time the request is forgotten, and the reply is
+ * discarded (counted in `LateReplies`) should it still arrive.
+ *
+ * @param id A correlation id returned by `Send`.
+ * @param timeout How long to wait.
+ * @return The reply, or `std::nullopt` on timeout or if interrupted by a signal.
+ * @throws std::invalid_argument if `id` is not in flight.
+ */
+std::optional<T_IPCData> RpcClient::Wait(uint64_t id, std::chrono::milliseconds timeout) {
+    const timespec deadline = deadlineAfter(timeout);
+    while (true) {
+        auto completed = completed_.find(id);
+        if (completed != completed_.end()) {
+            T_IPCData reply = std::move(completed->second);
+            completed_.erase(completed);
+            return reply;
+        }
+        if (inFlight_.count(id) == 0) {
+            throw std::invalid_argument("No RPC request in flight with id " + std::to_string(id));
+        }
+        if (!ReceiveReply(deadline)) {
+            Forget(id);
+            return std::nullopt;
+        }
+    }
+}
+
+/**
+ * @brief Waits for the reply to whichever request in flight is answered first.
+ *
+ * Unlike `Wait`, a timeout forgets nothing; the requests stay in flight.
+ *
+ * @param timeout How long to wait.
+ * @return The reply and the id of the request it answers, or `std::nullopt`
+ *         on timeout, if interrupted by a signal, or if nothing is in flight.
+ */
+std::optional<RpcReply> RpcClient::WaitAny(std::chrono::milliseconds timeout) {
+    const timespec deadline = deadlineAfter(timeout);
+    while (completed_.empty()) {
+        if (inFlight_.empty() || !ReceiveReply(deadline)) {
+            return std::nullopt;
+        }
+    }
+    auto completed = completed_.begin();
+    RpcReply reply { completed->first, std::move(completed->second) };
+    completed_.erase(completed);
+    return reply;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+bool RpcClient::ReceiveReply(const timespec& deadline) {
+    const ssize_t size = mq_timedreceive(replies_, buffer_.data(), buffer_.size(), nullptr, &deadline);
+    if (size < 0) {
+        if (errno == ETIMEDOUT || errno == EINTR) {
+            return false;
+        }
+        throw std::runtime_error("Failed to receive RPC reply");
+    }
+    stats::Add(Stat::MessagesReceived);
+    stats::Add(Stat::BytesReceived, static_cast<uint64_t>(size));
+
+    uint64_t clientId, id;
+    DecodeHeader(buffer_.data(), static_cast<size_t>(size), RPC_REPLY_MARKER, clientId, id);
+    if (inFlight_.erase(id) == 0) {
+        ++lateReplies_;
+        return true;
+    }
+    completed_.emplace(id, T_IPCData(buffer_.data() + RPC_HEADER_SIZE, static_cast<size_t>(size) - RPC_HEADER_SIZE));
+    return true;
+}
+
+void RpcClient::Forget(uint64_t id) {
+    inFlight_.erase(id);
+}
+
+/* --- RpcServer --- */
+
+/**
+ * @brief Constructor that opens (or creates) the request queue.
+ *
+ * @param requestQueueName The request queue, e.g. `RPC_QUEUE_NAME`.
+ * @param provisioner Sizes the request queue; an existing compatible queue is attached to.
+ * @throws std::runtime_error if the queue cannot be opened.
+ */
+RpcServer::RpcServer(const std::string& requestQueueName, const QueueProvisioner& provisioner)
+    : requestQueueName_(requestQueueName), droppedReplies_(0), buffer_(MAX_MESSAGE_SIZE) {
+    requests_ = provisioner.Open(requestQueueName_, O_RDONLY).mq;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Closes the queues; the request queue is left in place for the caller to unlink.
+ */
+RpcServer::~RpcServer() {
+    for (auto& [clientId, mq] : replyQueues_) {
+        mq_close(mq);
+    }
+    mq_close(requests_);
+}
+
+/**
+ * @brief Takes the next request off the request queue and enters it in the outstanding-request table.
+ *
+ * Retries undelivered replies first (see `Flush`).
+ *
+ * @param timeout How long to wait for a request.
+ * @return The request, or `std::nullopt` on timeout or if interrupted by a signal.
+ * @throws std::runtime_error if the message is not a well-formed request (it is consumed), or on a receive failure.
+ */
+std::optional<RpcRequest> RpcServer::Receive(std::chrono::milliseconds timeout) {
+    Flush();
+
+    const timespec deadline = deadlineAfter(timeout);
+    const ssize_t size = mq_timedreceive(requests_, buffer_.data(), buffer_.size(), nullptr, &deadline);
+    if (size < 0) {
+        if (errno == ETIMEDOUT || errno == EINTR) {
+            return std::nullopt;
+        }
+        throw std::runtime_error("Failed to receive RPC request");
+    }
+    stats::Add(Stat::MessagesReceived);
+    stats::Add(Stat::BytesReceived, static_cast<uint64_t>(size));
+
+    RpcRequest request {};
+    DecodeHeader(buffer_.data(), static_cast<size_t>(size), RPC_REQUEST_MARKER, request.clientId, request.id);
+    request.data = T_IPCData(buffer_.data() + RPC_HEADER_SIZE, static_cast<size_t>(size) - RPC_HEADER_SIZE);
+    outstanding_[Key(request.clientId, request.id)].reply.clear();
+    return request;
+}
+
+/**
+ * @brief Answers an outstanding request.
+ *
+ * The reply is sent without waiting. If the client's reply queue is full it is
+ * kept in the outstanding-request table and retried by `Receive` and `Flush`.
+ *
+ * @param request A request returned by `Receive` and not yet answered.
+ * @param reply The reply record.
+ * @throws std::invalid_argument if the request is not outstanding.
+ * @throws std::length_error if the reply does not fit in one message.
+ */
+void RpcServer::Reply(const RpcRequest& request, const T_IPCData& reply) {
+    auto entry = outstanding_.find(Key(request.clientId, request.id));
+    if (entry == outstanding_.end() || !entry->second.reply.empty()) {
+        throw std::invalid_argument("No outstanding RPC request with id " + std::to_string(request.id));
+    }
+
+    const size_t size = Encode(buffer_.data(), buffer_.size(), RPC_REPLY_MARKER, request.clientId, request.id, reply, proto_);
+    if (Deliver(request.clientId, buffer_.data(), size)) {
+        outstanding_.erase(entry);
+    } else {
+        entry->second.reply.assign(buffer_.data(), size);
+    }
+}
+
+/**
+ * @brief Retries the replies that found their client's reply queue full.
+ *
+ * @return The number of replies still waiting for room.
+ */
+size_t RpcServer::Flush() {
+    size_t waiting = 0;
+    for (auto entry = outstanding_.begin(); entry != outstanding_.end();) {
+        const std::string& reply = entry->second.reply;
+        if (!reply.empty() && Deliver(entry->first.first, reply.data(), reply.size())) {
+            entry = outstanding_.erase(entry);
+            continue;
+        }
+        waiting += reply.empty() ? 0 : 1;
+        ++entry;
+    }
+    return waiting;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Sends one reply to a client's reply queue without waiting.
+ *
+ * A full queue is closed again, so the next attempt reopens it by name: a
+ * client that exited has removed its queue, and its replies are then dropped
+ * instead of being retried forever against the orphaned queue.
+ *
+ * @return False if the reply queue is full; true once the reply was sent or dropped.
+ */
+bool RpcServer::Deliver(uint64_t clientId, const char* data, size_t size) {
+    auto cached = replyQueues_.find(clientId);
+    if (cached == replyQueues_.end()) {
+        if (replyQueues_.size() >= REPLY_QUEUE_CACHE_LIMIT) {
+            for (auto& [id, mq] : replyQueues_) {
+                mq_close(mq);
+            }
+            replyQueues_.clear();
+        }
+        const mqd_t mq = mq_open(RpcReplyQueueName(clientId).c_str(), O_WRONLY | O_NONBLOCK);
+        if (mq == (mqd_t)-1) {
+            ++droppedReplies_; // The client has gone away
+            return true;
+        }
+        cached = replyQueues_.emplace(clientId, mq).first;
+    }
+
+    if (mq_send(cached->second, data, size, 0) == 0) {
+        stats::Add(Stat::MessagesSent);
+        stats::Add(Stat::BytesSent, size);
+        return true;
+    }
+    const bool full = errno == EAGAIN;
+    mq_close(cached->second);
+    replyQueues_.erase(cached);
+    if (full) {
+        stats::Add(Stat::SendFull);
+        return false;
+    }
+    ++droppedReplies_;
+    return true;
+}
@@ -0,0 +1,156 @@
+#ifndef RPC_H
+#define RPC_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mqueue.h>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "ipc_data.pb.h"
+#include "queue_provisioner.h"
+#include "t_ipc_data.h"
+
+/*
+    Request/reply envelope: one serialized IPCData record behind a fixed header.
+
+        [RPC_REQUEST_MARKER or RPC_REPLY_MARKER][u64 client id][u64 correlation id][record bytes]
+
+    Requests from every client share one queue; each client receives its
+    replies on its own queue, named from its client id (see RpcReplyQueueName).
+    Like the batch, flat and slab markers, 0x1F and 0x27 are protobuf tags with
+    wire type 7, so neither can be mistaken for a plain record.
+*/
+constexpr uint8_t RPC_REQUEST_MARKER = 0x1F;
+constexpr uint8_t RPC_REPLY_MARKER = 0x27;
+constexpr size_t RPC_HEADER_SIZE = 1 + 8 + 8;
+
+std::string RpcReplyQueueName(uint64_t clientId);
+
+/**
+ * @brief A request taken off the request queue, to be answered with `RpcServer::Reply`.
+ */
+struct RpcRequest {
+    uint64_t clientId;
+    uint64_t id;        // Correlation id, unique per client
+    T_IPCData data;
+};
+
+/**
+ * @brief A reply matched to the request it answers.
+ */
+struct RpcReply {
+    uint64_t id;
+    T_IPCData data;
+};
+
+/**
+ * @brief Client side of the request/reply layer.
+ *
+ * Creates its own reply queue and sends requests, tagged with a correlation
+ * id, to the server's request queue. Requests can be pipelined: `Send` any
+ * number up to `MaxInFlight` (the reply queue's depth, so the server can
+ * always deliver), then collect the replies with `Wait` or `WaitAny` in any
+ * order. Replies that arrive while waiting for another one are kept until
+ * asked for. A request that times out is forgotten, and its reply discarded
+ * if it arrives later.
+ *
+ * Not thread-safe; use one client per thread.
+ */
+class RpcClient {
+public:
+    // Constructors
+    explicit RpcClient(const std::string& requestQueueName);
+    ~RpcClient();
+
+    RpcClient(const RpcClient&) = delete;
+    RpcClient& operator=(const RpcClient&) = delete;
+
+    // Methods
+    T_IPCData Call(const T_IPCData& request, std::chrono::milliseconds timeout);
+    uint64_t Send(const T_IPCData& request, std::chrono::milliseconds timeout);
+    std::optional<T_IPCData> Wait(uint64_t id, std::chrono::milliseconds timeout);
+    std::optional<RpcReply> WaitAny(std::chrono::milliseconds timeout);
+
+    // Getters
+    uint64_t ClientId() const { return clientId_; }
+    size_t InFlight() const { return inFlight_.size() + completed_.size(); }
+    size_t MaxInFlight() const { return maxInFlight_; }
+    uint64_t LateReplies() const { return lateReplies_; }
+
+private:
+    // Members
+    uint64_t clientId_;
+    std::string replyQueueName_;
+    mqd_t requests_;
+    mqd_t replies_;
+    size_t maxInFlight_;
+    uint64_t nextId_;
+    std::unordered_set<uint64_t> inFlight_;              // Sent, reply not yet received
+    std::unordered_map<uint64_t, T_IPCData> completed_; // Reply received, not yet collected
+    uint64_t lateReplies_;                              // Replies to requests that had timed out
+    IPCData proto_;
+    std::vector<char> buffer_;
+
+    // Helper methods
+    bool ReceiveReply(const timespec& deadline);
+    void Forget(uint64_t id);
+};
+
+/**
+ * @brief Server side of the request/reply layer.
+ *
+ * Owns the request queue. Every request taken off it by `Receive` enters the
+ * outstanding-request table until `Reply` has delivered its answer, so
+ * requests can be answered out of order (e.g. from a worker) and a reply
+ * that does not fit in a full reply queue is kept and retried on the next
+ * `Receive` or `Flush` instead of blocking the server. Replies to a client
+ * whose reply queue has gone away are dropped and counted.
+ *
+ * Not thread-safe.
+ */
+class RpcServer {
+public:
+    // Constructors
+    RpcServer(const std::string& requestQueueName, const QueueProvisioner& provisioner);
+    ~RpcServer();
+
+    RpcServer(const RpcServer&) = delete;
+    RpcServer& operator=(const RpcServer&) = delete;
+
+    // Methods
+    std::optional<RpcRequest> Receive(std::chrono::milliseconds timeout);
+    void Reply(const RpcRequest& request, const T_IPCData& reply);
+    size_t Flush();
+
+    // Getters
+    mqd_t RequestQueue() const { return requests_; }
+    size_t Outstanding() const { return outstanding_.size(); }
+    uint64_t DroppedReplies() const { return droppedReplies_; }
+
+private:
+    // An entry of the outstanding-request table
+    struct PendingRequest {
+        std::string reply; // Encoded reply once answered but not yet delivered; empty while being handled
+    };
+    using Key = std::pair<uint64_t, uint64_t>; // Client id, correlation id
+
+    // Members
+    std::string requestQueueName_;
+    mqd_t requests_;
+    std::map<Key, PendingRequest> outstanding_;
+    std::unordered_map<uint64_t, mqd_t> replyQueues_; // Client id -> its reply queue, opened on first reply
+    uint64_t droppedReplies_;
+    IPCData proto_;
+    std::vector<char> buffer_;
+
+    // Helper methods
+    bool Deliver(uint64_t clientId, const char* data, size_t size);
+};
+
+#endif // RPC_H
@@ -0,0 +1,853 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <thread>
+#include "sender.h"
+#include "flat_codec.h"
+#include "queue_provisioner.h"
+#include "stats_segment.h"
+#include "util.h"
+
+namespace {
+    // How long a large record waits for the receiver to free a slab before the send fails
+    constexpr std::chrono::seconds SLAB_WAIT_LIMIT { 1 };
+
+    // How often a sender re-attaches to the control segment (string dictionary) or slab pool to notice a restarted receiver
+    constexpr std::chrono::milliseconds CONTROL_RECHECK_INTERVAL { 250 };
+
+    // An already-expired deadline: mq_timedsend fails at once with ETIMEDOUT instead of blocking
+    constexpr timespec EXPIRED { 0, 0 };
+
+    // Most buffered messages handed to the transport in one SendBatch when draining without waiting
+    constexpr size_t DRAIN_BATCH = 16;
+
+    timespec deadlineAfter(std::chrono::milliseconds timeout) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count() + deadline.tv_nsec;
+        deadline.tv_sec += static_cast<time_t>(nanoseconds / 1000000000);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+        return deadline;
+    }
+
+}
+
+/**
+ * @brief Parses an `--overflow` value: "block", "deadline", "drop-oldest", "drop-newest" or "coalesce".
+ *
+ * @throws std::invalid_argument for any other value.
+ */
+OverflowMode ParseOverflowMode(const std::string& name) {
+    if (name == "block")       return OverflowMode::Block;
+    if (name == "deadline")    return OverflowMode::BlockWithDeadline;
+    if (name == "drop-oldest") return OverflowMode::DropOldest;
+    if (name == "drop-newest") return OverflowMode::DropNewest;
+    if (name == "coalesce")    return OverflowMode::CoalesceByKey;
+    throw std::invalid_argument("Unknown overflow mode '" + name + "' (expected block, deadline, drop-oldest, drop-newest or coalesce)");
+}
+
+/**
+ * @brief Constructor that opens the underlying channel once.
+ *
+ * For the message queue, the queue is created if it does not exist yet.
+ * For the shared-memory ring and the sockets, the receiver must already be running.
+ *
+ * @param transport Which channel to send on.
+ * @param name Queue, segment or socket name; empty selects `QUEUE_NAME` / `SHM_RING_NAME`.
+ * @throws std::runtime_error if the channel cannot be opened.
+ */
+Sender::Sender(SenderTransport transport, const std::string& name)
+    : transport_(OpenTransport(transport, name, TransportRole::Sender)), slabPoolName_(SLAB_POOL_NAME), codec_(WireCodec::Protobuf),
+      buffer_(MAX_MESSAGE_SIZE), batch_(MAX_MESSAGE_SIZE), batchPriority_(0), batchCoded_(false), batchDefines_(false),
+      typePriorities_{}, tracing_(false), sequence_(0), receiverId_(0), dictionaryResets_(0), measuredCoded_(false),
+      measuredDefines_(false) {
+    // The receiver may have provisioned smaller messages; anything larger goes through the slab pool
+    if (transport_->MessageSize() < buffer_.size()) {
+        buffer_.resize(transport_->MessageSize());
+        batch_ = BatchEncoder(buffer_.size());
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Sends whatever is still buffered if the channel has room, releases the
+ * slabs of anything it has to discard, and closes the channel (a message
+ * queue itself is left in place).
+ */
+Sender::~Sender() {
+    try {
+        DrainPending(&EXPIRED);
+    } catch (const std::exception&) {
+        // Nothing to report to; fall through and discard the rest
+    }
+    while (!pending_.Empty()) {
+        OverflowBuffer::Entry entry = pending_.PopFront();
+        if (entry.slab && slabs_) {
+            slabs_->Release(*entry.slab);
+        }
+    }
+}
+
+/**
+ * @brief Serializes and sends a single message at the priority mapped from its type.
+ *
+ * See the explicit-priority overload.
+ */
+void Sender::Send(const T_IPCData& data) {
+    Send(data, PriorityOf(data));
+}
+
+/**
+ * @brief Serializes and sends a single message.
+ *
+ * The message is copied into the recycled protobuf message, sized with
+ * `ByteSizeLong` and serialized straight into the preallocated buffer
+ * (or encoded directly as a flat frame). A record larger than `MAX_MESSAGE_SIZE`
+ * is encoded straight into a slab of the receiver's pool instead, and only a
+ * slab descriptor is sent.
+ *
+ * @param data A `T_IPCData` object containing the data to be sent.
+ * @param priority Queue priority, 0 (bulk) to `PRIORITY_LEVELS - 1` (most urgent).
+ *                 The shared-memory ring has no priorities and ignores it.
+ * @throws std::out_of_range if `priority` is not below `PRIORITY_LEVELS`.
+ * @throws std::length_error if the record exceeds `MAX_MESSAGE_SIZE` and there is
+ *         no slab pool, or it exceeds `SLAB_SIZE`.
+ * @throws std::runtime_error if the message cannot be sent.
+ */
+void Sender::Send(const T_IPCData& data, unsigned priority) {
+    if (priority >= PRIORITY_LEVELS) {
+        throw std::out_of_range("Priority must be below PRIORITY_LEVELS.");
+    }
+
+    // Keep ordering with any records still waiting in a batch
+    Flush();
+    SendNow(data, priority);
+}
+
+/**
+ * @brief Sends an already-encoded message as-is, e.g. a frame replayed from a capture.
+ *
+ * The bytes are not parsed or re-serialized, so tracing and the string
+ * dictionary do not apply. A message larger than `MAX_MESSAGE_SIZE` is
+ * copied into a slab and sent as a slab descriptor, like a large record.
+ *
+ * @param data The message bytes: a record, batch envelope or flat frame.
+ * @param size Number of bytes.
+ * @param priority Queue priority, 0 (bulk) to `PRIORITY_LEVELS - 1` (most urgent).
+ * @throws std::out_of_range if `priority` is not below `PRIORITY_LEVELS`.
+ * @throws std::length_error if the message is too large for the slab pool, or there is none.
+ * @throws std::runtime_error if the message cannot be sent.
+ */
+void Sender::SendRaw(const char* data, size_t size, unsigned priority) {
+    if (priority >= PRIORITY_LEVELS) {
+        throw std::out_of_range("Priority must be below PRIORITY_LEVELS.");
+    }
+    Flush();
+
+    OverflowBuffer::Entry entry;
+    entry.priority = priority;
+    if (size <= buffer_.size()) {
+        SendSerialized(data, size, entry);
+        return;
+    }
+
+    SlabDescriptor descriptor;
+    std::memcpy(AcquireSlab(size, descriptor), data, size);
+    SendSlab(descriptor, entry);
+}
+
+/**
+ * @brief Selects the wire format for subsequent records.
+ *
+ * Any records already queued are flushed first. Receivers detect the format
+ * per record, so switching does not need coordination.
+ */
+void Sender::SetCodec(WireCodec codec) {
+    Flush();
+    codec_ = codec;
+}
+
+/**
+ * @brief Selects the slab pool used for records larger than one message.
+ *
+ * The pool is attached on the first such record; the default is `SLAB_POOL_NAME`.
+ */
+void Sender::SetSlabPoolName(const std::string& name) {
+    slabPoolName_ = name;
+    slabs_.reset();
+}
+
+/**
+ * @brief Sets what sends do when the queue or ring is full.
+ *
+ * Any pending batch is flushed and any buffered messages are sent first
+ * (waiting for room if necessary), so the new policy starts with an empty buffer.
+ *
+ * @throws std::invalid_argument if a buffering mode has zero capacity, or
+ *         `CoalesceByKey` has no key function.
+ */
+void Sender::SetOverflowPolicy(const OverflowPolicy& policy) {
+    if (policy.mode != OverflowMode::Block && policy.capacity == 0) {
+        throw std::invalid_argument("Overflow buffer capacity must be positive.");
+    }
+    if (policy.mode == OverflowMode::CoalesceByKey && !policy.key) {
+        throw std::invalid_argument("CoalesceByKey requires a key function.");
+    }
+
+    Flush();
+    DrainPending(nullptr);
+    overflow_ = policy;
+    pending_ = OverflowBuffer(policy.mode == OverflowMode::Block ? 0 : policy.capacity);
+}
+
+/**
+ * @brief Sets the callback told when sends start buffering, drain, drop or coalesce.
+ *
+ * Called on the sending thread with the number of messages buffered after the
+ * event, so a producer can shed or slow its own load while the receiver lags.
+ */
+void Sender::SetBackpressureHandler(BackpressureHandler handler) {
+    onBackpressure_ = std::move(handler);
+}
+
+/**
+ * @brief Sets the priority that `Send(data)` and `Enqueue(data)` use for records of one type.
+ *
+ * Every type starts at priority 0, as do records without a type.
+ *
+ * @throws std::out_of_range if `priority` is not below `PRIORITY_LEVELS`.
+ */
+void Sender::SetTypePriority(IPCData::Type type, unsigned priority) {
+    if (priority >= PRIORITY_LEVELS) {
+        throw std::out_of_range("Priority must be below PRIORITY_LEVELS.");
+    }
+    typePriorities_.at(static_cast<size_t>(type)) = priority;
+}
+
+/**
+ * @brief Returns the priority mapped from a record's type (0 for records without one).
+ */
+unsigned Sender::PriorityOf(const T_IPCData& data) const {
+    auto type = data.GetTheType();
+    return type ? typePriorities_[static_cast<size_t>(*type)] : 0;
+}
+
+/**
+ * @brief Enables stamping each record with a send time and sequence number.
+ *
+ * When enabled, every record sent or queued carries `CLOCK_MONOTONIC` nanoseconds
+ * taken as it is encoded plus a per-sender sequence number starting at 1, so the
+ * receiver can measure transit latency and detect lost or reordered messages.
+ * Any values already set on the record are overwritten on the wire.
+ */
+void Sender::SetTracing(bool enabled) {
+    tracing_ = enabled;
+}
+
+/**
+ * @brief Enables or disables the string dictionary for subsequent records.
+ *
+ * Only bulk (priority 0) protobuf records are coded, because only they are
+ * guaranteed to reach the receiver in order. The sender follows the
+ * receiver's reset requests in the control segment, and starts a new epoch
+ * itself whenever a message is dropped or fails to send. Its stream id comes
+ * from the control segment, so senders of one receiver never share one. Any
+ * records already queued are flushed first.
+ *
+ * @param enabled True to code repeated strings as dictionary entries.
+ * @param controlName The receiver's control segment; the dictionary still works
+ *                    without one, but cannot recover from a receiver restart.
+ */
+void Sender::SetStringDictionary(bool enabled, const std::string& controlName) {
+    Flush();
+    control_.reset();
+    dictionary_.reset();
+    if (enabled) {
+        controlName_ = controlName;
+        try {
+            control_ = std::make_unique<ControlSegment>(controlName_, false);
+            receiverId_ = control_->ReceiverId();
+            dictionaryResets_ = control_->DictionaryResets();
+        } catch (const std::runtime_error&) {
+            // No receiver running yet; a random stream id until one appears
+        }
+        dictionary_ = std::make_unique<StringDictionaryEncoder>(control_ ? control_->AllocateDictionaryStream() : 0);
+        controlChecked_ = std::chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief Sets when queued records are flushed.
+ *
+ * Any records already queued are flushed first so they are not held to the new policy.
+ *
+ * @param policy Size and deadline limits; `maxBytes` is capped at the queue's message size.
+ */
+void Sender::SetBatchPolicy(const BatchPolicy& policy) {
+    Flush();
+    batchPolicy_ = policy;
+    batch_ = BatchEncoder(std::min(policy.maxBytes, buffer_.size()));
+}
+
+/**
+ * @brief Queues a record into the current batch at the priority mapped from its type.
+ *
+ * See the explicit-priority overload.
+ */
+void Sender::Enqueue(const T_IPCData& data) {
+    Enqueue(data, PriorityOf(data));
+}
+
+/**
+ * @brief Queues a record into the current batch, sending the batch when it is full or due.
+ *
+ * The record is serialized straight into the batch buffer. The batch is sent
+ * before this record if the record would not fit, and after it if the oldest
+ * queued record has waited longer than `BatchPolicy::maxDelay`. A record that
+ * does not fit in a batch on its own is sent through the slab pool, after the
+ * current batch so ordering is kept.
+ *
+ * A batch is sent at a single priority. A record more urgent than the current
+ * batch is sent on its own right away, ahead of the batch; a less urgent one
+ * sends the batch and starts a new one.
+ *
+ * @param data A `T_IPCData` object containing the data to be sent.
+ * @param priority Queue priority, 0 (bulk) to `PRIORITY_LEVELS - 1` (most urgent).
+ * @throws std::out_of_range if `priority` is not below `PRIORITY_LEVELS`.
+ * @throws std::length_error if the record does not fit in a batch and cannot go through the slab pool.
+ * @throws std::runtime_error if a batch cannot be sent.
+ */
+void Sender::Enqueue(const T_IPCData& data, unsigned priority) {
+    if (priority >= PRIORITY_LEVELS) {
+        throw std::out_of_range("Priority must be below PRIORITY_LEVELS.");
+    }
+    if (!batch_.Empty() && priority != batchPriority_) {
+        if (priority > batchPriority_) {
+            SendNow(data, priority);
+            return;
+        }
+        Flush();
+    }
+
+    const size_t size = Measure(data, priority);
+
+    if (!batch_.Fits(size)) {
+        Flush();
+        if (!batch_.Fits(size)) {
+            SendLarge(data, size, priority);
+            return;
+        }
+    }
+
+    if (batch_.Empty()) {
+        batchStarted_ = std::chrono::steady_clock::now();
+        batchPriority_ = priority;
+    }
+    EncodeMeasured(data, batch_.Reserve(size), size);
+    batchCoded_ |= measuredCoded_;
+    batchDefines_ |= measuredDefines_;
+
+    FlushIfDue();
+}
+
+/**
+ * @brief Sends the current batch if its oldest record has exceeded the delay limit,
+ * and retries any messages waiting in the overflow buffer.
+ *
+ * Producers that go idle should call this periodically so a partial batch or
+ * buffered messages are not held indefinitely.
+ *
+ * @return True if a batch or a buffered message was sent.
+ */
+bool Sender::FlushIfDue() {
+    const uint64_t sentBefore = stats_.sent;
+    DrainPending(&EXPIRED);
+
+    if (batch_.Empty() || std::chrono::steady_clock::now() - batchStarted_ < batchPolicy_.maxDelay) {
+        return stats_.sent > sentBefore;
+    }
+    Flush();
+    return true;
+}
+
+/**
+ * @brief Sends the current batch as one message, if it holds any records.
+ *
+ * @throws std::runtime_error if the batch cannot be sent (the batch is dropped).
+ */
+void Sender::Flush() {
+    if (batch_.Empty()) {
+        return;
+    }
+
+    // Clear before sending so a failed send does not resend the same records forever
+    const size_t size = batch_.Size();
+    batch_.Clear();
+    OverflowBuffer::Entry entry;
+    entry.priority = batchPriority_;
+    entry.coded = batchCoded_;
+    entry.defines = batchDefines_;
+    batchCoded_ = batchDefines_ = false;
+    SendSerialized(batch_.Data(), size, entry);
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Returns the encoded size of a record in the current codec.
+ *
+ * For protobuf this also loads the record into the recycled message (coding
+ * its string against the dictionary, if enabled) and caches its field sizes
+ * for `EncodeMeasured`. The dictionary counts the record as sent, so it must
+ * be encoded next.
+ */
+size_t Sender::Measure(const T_IPCData& data, unsigned priority) {
+    measuredCoded_ = measuredDefines_ = false;
+    if (codec_ == WireCodec::Flat) {
+        // Tracing slots are fixed-size, so stamping them later does not change the size
+        return flat::EncodedSize(data);
+    }
+    data.FillProtobuf(proto_);
+    if (dictionary_ && priority == 0 && proto_.has_the_string()) {
+        EncodeString();
+    }
+    if (tracing_) {
+        proto_.set_sequence(++sequence_);
+        proto_.set_send_time_ns(util::monotonicNanoseconds());
+    }
+    return proto_.ByteSizeLong();
+}
+
+/**
+ * @brief Encodes the record last passed to `Measure` into `size` bytes at `out`.
+ */
+void Sender::EncodeMeasured(const T_IPCData& data, char* out, size_t size) {
+    if (codec_ == WireCodec::Flat) {
+        flat::Encode(data, out, size);
+        if (tracing_) {
+            flat::SetSlot<flat::SequenceField>(out, ++sequence_);
+            flat::SetSlot<flat::SendTimeField>(out, util::monotonicNanoseconds());
+        }
+        return;
+    }
+    // ByteSizeLong cached the field sizes, so serialize without measuring again
+    proto_.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(out));
+}
+
+/**
+ * @brief Replaces `the_string` in the recycled message with its dictionary coding.
+ */
+void Sender::EncodeString() {
+    CheckDictionaryReset();
+
+    const StringCoding coding = dictionary_->Encode(proto_.the_string());
+    if (coding.ref) {
+        // The literal is always a suffix of the string, so trim it in place
+        if (coding.prefix > 0) {
+            proto_.mutable_the_string()->erase(0, coding.prefix);
+            proto_.set_string_prefix(coding.prefix);
+        } else {
+            proto_.clear_the_string();
+        }
+        proto_.set_string_ref(*coding.ref);
+    }
+    if (coding.define) {
+        proto_.set_string_define(*coding.define);
+    }
+    if (coding.ref || coding.define) {
+        proto_.set_dict_stream(dictionary_->Stream());
+        proto_.set_dict_epoch(dictionary_->Epoch());
+        measuredCoded_ = true;
+    }
+    measuredDefines_ = coding.define.has_value();
+}
+
+/**
+ * @brief Starts a new dictionary epoch if the receiver asked for one or was replaced.
+ *
+ * The reset counter is one shared-memory load per record; re-attaching by
+ * name (to find a restarted receiver's new segment) happens only every
+ * `CONTROL_RECHECK_INTERVAL`.
+ */
+void Sender::CheckDictionaryReset() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - controlChecked_ >= CONTROL_RECHECK_INTERVAL) {
+        controlChecked_ = now;
+        try {
+            auto control = std::make_unique<ControlSegment>(controlName_, false);
+            if (!control_ || control->ReceiverId() != receiverId_) {
+                // A new receiver has an empty dictionary, and hands out stream ids afresh
+                dictionary_ = std::make_unique<StringDictionaryEncoder>(control->AllocateDictionaryStream());
+                receiverId_ = control->ReceiverId();
+                dictionaryResets_ = control->DictionaryResets();
+                control_ = std::move(control);
+            }
+        } catch (const std::runtime_error&) {
+            // No receiver running; keep using the current mapping, if any
+        }
+    }
+
+    if (control_ && control_->DictionaryResets() != dictionaryResets_) {
+        dictionaryResets_ = control_->DictionaryResets();
+        dictionary_->Reset();
+    }
+}
+
+/**
+ * @brief Starts a new dictionary epoch after a message was lost, since it may have defined entries.
+ */
+void Sender::ForgetDictionary() {
+    if (dictionary_) {
+        dictionary_->Reset();
+    }
+}
+
+/**
+ * @brief Encodes and sends one record as its own message, bypassing the batch.
+ */
+void Sender::SendNow(const T_IPCData& data, unsigned priority) {
+    const size_t size = Measure(data, priority);
+    if (size > buffer_.size()) {
+        SendLarge(data, size, priority);
+        return;
+    }
+
+    EncodeMeasured(data, buffer_.data(), size);
+
+    OverflowBuffer::Entry entry;
+    entry.priority = priority;
+    entry.key = CoalescingKey(data);
+    entry.coded = measuredCoded_;
+    entry.defines = measuredDefines_;
+    SendSerialized(buffer_.data(), size, entry);
+}
+
+/**
+ * @brief Encodes the record last passed to `Measure` into a free slab and sends its descriptor.
+ */
+void Sender::SendLarge(const T_IPCData& data, size_t size, unsigned priority) {
+    SlabDescriptor descriptor;
+    try {
+        EncodeMeasured(data, AcquireSlab(size, descriptor), size);
+    } catch (...) {
+        ForgetDictionary(); // `Measure` already counted the record's definitions as sent
+        throw;
+    }
+
+    OverflowBuffer::Entry entry;
+    entry.priority = priority;
+    entry.key = CoalescingKey(data);
+    entry.coded = measuredCoded_;
+    entry.defines = measuredDefines_;
+    SendSlab(descriptor, entry);
+}
+
+/**
+ * @brief Claims a free slab for `size` bytes and returns where to write them.
+ *
+ * Maps the slab pool on first use, and maps it again (at most every
+ * `CONTROL_RECHECK_INTERVAL`, or when every slab is claimed) if a restarted
+ * receiver has replaced it. When every slab is in flight this waits (up to
+ * `SLAB_WAIT_LIMIT`) for the receiver to release one, much as a blocking
+ * `mq_send` waits for room in the queue.
+ *
+ * @throws std::length_error on the broadcast transport, whose subscribers have no slab pool.
+ */
+char* Sender::AcquireSlab(size_t size, SlabDescriptor& descriptor) {
+    if (transport_->Kind() == TransportKind::Broadcast) {
+        throw std::length_error("Serialized message exceeds MAX_MESSAGE_SIZE and the broadcast transport has no slab pool.");
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!slabs_ || now - slabsChecked_ >= CONTROL_RECHECK_INTERVAL) {
+        slabsChecked_ = now;
+        if (!ReattachSlabs() && !slabs_) {
+            throw std::length_error("Serialized message exceeds MAX_MESSAGE_SIZE and no slab pool is available.");
+        }
+    }
+
+    char* slab = slabs_->TryAcquire(size, descriptor);
+    if (!slab && ReattachSlabs()) {
+        slab = slabs_->TryAcquire(size, descriptor); // The old pool was full of slabs nobody will release
+    }
+    const auto deadline = now + SLAB_WAIT_LIMIT;
+    while (!slab) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Failed to send message: slab pool exhausted");
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        slab = slabs_->TryAcquire(size, descriptor);
+    }
+    return slab;
+}
+
+/**
+ * @brief Maps the slab pool by name if it is not mapped yet or the mapped one has been replaced.
+ *
+ * Buffered descriptors that point into a replaced pool can never be resolved,
+ * so they are detached from it rather than released into the new one.
+ *
+ * @return True if a (new) pool was mapped.
+ */
+bool Sender::ReattachSlabs() {
+    if (slabs_ && !slabs_->Replaced(slabPoolName_)) {
+        return false;
+    }
+    std::unique_ptr<SlabPool> pool;
+    try {
+        pool = std::make_unique<SlabPool>(slabPoolName_, false);
+    } catch (const std::runtime_error&) {
+        return false; // No receiver running; keep using the current mapping, if any
+    }
+    for (size_t i = 0; i < pending_.Size(); ++i) {
+        pending_.At(i).slab.reset();
+    }
+    slabs_ = std::move(pool);
+    return true;
+}
+
+/**
+ * @brief Sends the descriptor of a filled slab, releasing the slab if the send fails.
+ */
+void Sender::SendSlab(const SlabDescriptor& descriptor, const OverflowBuffer::Entry& entry) {
+    char frame[SLAB_DESCRIPTOR_SIZE];
+    EncodeSlabDescriptor(descriptor, frame);
+
+    OverflowBuffer::Entry slabEntry = entry;
+    slabEntry.slab = descriptor;
+    try {
+        SendSerialized(frame, sizeof(frame), slabEntry);
+    } catch (...) {
+        slabs_->Release(descriptor); // Nobody else will ever see this slab
+        throw;
+    }
+}
+
+/**
+ * @brief Sends one encoded message, or buffers it under the overflow policy if the channel is full.
+ *
+ * In a buffering mode anything already buffered is sent first, so messages
+ * leave in the order they were sent.
+ *
+ * @throws std::runtime_error if the message cannot be sent, or the
+ *         `BlockWithDeadline` deadline passes without room.
+ */
+void Sender::SendSerialized(const char* data, size_t size, const OverflowBuffer::Entry& entry) {
+    try {
+        if (overflow_.mode == OverflowMode::Block) {
+            if (!TrySend(data, size, entry.priority, nullptr)) {
+                throw std::runtime_error("Failed to send message");
+            }
+            ++stats_.sent;
+            return;
+        }
+
+        if (DrainPending(&EXPIRED) && TrySend(data, size, entry.priority, &EXPIRED)) {
+            ++stats_.sent;
+            return;
+        }
+        Buffer(data, size, entry);
+    } catch (...) {
+        ForgetDictionary();
+        throw;
+    }
+}
+
+/**
+ * @brief Hands one message to the queue or ring.
+ *
+ * Tries once without waiting first; only if the channel is full is the wait
+ * timed, so the stats segment sees how often senders hit a full channel and
+ * how long they were held up, at one relaxed increment per message otherwise.
+ *
+ * @param deadline Absolute `CLOCK_REALTIME` time to wait for room until;
+ *                 null waits indefinitely and `&EXPIRED` does not wait at all.
+ * @return False if there was no room before the deadline.
+ * @throws std::runtime_error on any other send failure.
+ */
+bool Sender::TrySend(const char* data, size_t size, unsigned priority, const timespec* deadline) {
+    if (AttemptSend(data, size, priority, &EXPIRED)) {
+        CountSent(size);
+        return true;
+    }
+    stats::Add(Stat::SendFull);
+    if (deadline == &EXPIRED) {
+        return false;
+    }
+
+    const auto blockedSince = std::chrono::steady_clock::now();
+    const bool sent = AttemptSend(data, size, priority, deadline);
+    stats::Add(Stat::SendBlockedNs, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - blockedSince).count()));
+    if (sent) {
+        CountSent(size);
+    }
+    return sent;
+}
+
+/**
+ * @brief One send attempt on the queue or ring, without any accounting. See `TrySend`.
+ */
+bool Sender::AttemptSend(const char* data, size_t size, unsigned priority, const timespec* deadline) {
+    return transport_->Send(data, size, priority, deadline);
+}
+
+void Sender::CountSent(size_t size) {
+    stats::Add(Stat::MessagesSent);
+    stats::Add(Stat::BytesSent, size);
+}
+
+/**
+ * @brief Hands up to `DRAIN_BATCH` of the oldest buffered messages to the transport at once, without waiting.
+ *
+ * @return True if all of them were sent.
+ */
+bool Sender::SendPendingBatch() {
+    OutgoingMessage messages[DRAIN_BATCH] {};
+    const size_t count = std::min(pending_.Size(), DRAIN_BATCH);
+    for (size_t i = 0; i < count; ++i) {
+        messages[i] = OutgoingMessage { pending_.DataAt(i), pending_.At(i).size, pending_.At(i).priority };
+    }
+
+    const size_t sent = transport_->SendBatch(messages, count);
+    for (size_t i = 0; i < sent; ++i) {
+        CountSent(messages[i].size);
+        pending_.PopFront();
+        ++stats_.sent;
+    }
+    stats_.buffered = pending_.Size();
+    if (sent < count) {
+        stats::Add(Stat::SendFull);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends buffered messages, oldest first, until the buffer is empty or the channel is full.
+ *
+ * @param deadline See `TrySend`.
+ * @return True if the buffer is now empty.
+ */
+bool Sender::DrainPending(const timespec* deadline) {
+    const bool hadPending = !pending_.Empty();
+    while (!pending_.Empty()) {
+        if (deadline == &EXPIRED && pending_.Size() > 1) {
+            if (!SendPendingBatch()) {
+                return false;
+            }
+            continue;
+        }
+
+        const OverflowBuffer::Entry& front = pending_.Front();
+        if (!TrySend(pending_.FrontData(), front.size, front.priority, deadline)) {
+            return false;
+        }
+        pending_.PopFront();
+        stats_.buffered = pending_.Size();
+        ++stats_.sent;
+    }
+
+    if (hadPending) {
+        Notify(BackpressureEvent::Relieved);
+    }
+    return true;
+}
+
+/**
+ * @brief Stores a message the channel had no room for, applying the overflow policy.
+ *
+ * With the string dictionary, a buffered message that defines entries is
+ * never dropped or overwritten, since messages buffered after it may refer to
+ * them; the new message is dropped instead. Nor does a coded record coalesce,
+ * as that would move it ahead of definitions it may refer to.
+ */
+void Sender::Buffer(const char* data, size_t size, const OverflowBuffer::Entry& entry) {
+    // A newer record supersedes a buffered one with the same key, in its place in line
+    if (entry.key && !entry.coded) {
+        OverflowBuffer::Entry* existing = pending_.Find(*entry.key);
+        if (existing && !existing->defines) {
+            if (existing->slab && slabs_) {
+                slabs_->Release(*existing->slab);
+            }
+            pending_.Overwrite(*existing, data, size, entry);
+            ++stats_.coalesced;
+            Notify(BackpressureEvent::Coalesced);
+            return;
+        }
+    }
+
+    if (pending_.Full()) {
+        switch (overflow_.mode) {
+        case OverflowMode::BlockWithDeadline: {
+            const timespec deadline = deadlineAfter(overflow_.deadline);
+            if (!TrySend(pending_.FrontData(), pending_.Front().size, pending_.Front().priority, &deadline)) {
+                ++stats_.deadlineMisses;
+                if (entry.slab && slabs_) {
+                    slabs_->Release(*entry.slab);
+                }
+                throw std::runtime_error("Failed to send message: deadline exceeded while the queue is full");
+            }
+            pending_.PopFront();
+            ++stats_.sent;
+            break;
+        }
+        case OverflowMode::DropNewest:
+            Discard(entry);
+            return;
+        default:
+            if (pending_.Front().defines) {
+                Discard(entry);
+                return;
+            }
+            Discard(pending_.PopFront());
+            break;
+        }
+    }
+
+    const bool wasEmpty = pending_.Empty();
+    pending_.Push(data, size, entry);
+    stats_.buffered = pending_.Size();
+    stats_.peakBuffered = std::max(stats_.peakBuffered, stats_.buffered);
+    if (wasEmpty) {
+        Notify(BackpressureEvent::Congested);
+    }
+}
+
+/**
+ * @brief Counts and reports a message dropped by the overflow policy, releasing its slab.
+ *
+ * If it defined dictionary entries, later records must not refer to them.
+ */
+void Sender::Discard(const OverflowBuffer::Entry& entry) {
+    if (entry.slab && slabs_) {
+        slabs_->Release(*entry.slab);
+    }
+    if (entry.defines) {
+        ForgetDictionary();
+    }
+    stats_.buffered = pending_.Size();
+    ++stats_.dropped;
+    Notify(BackpressureEvent::Dropped);
+}
+
+void Sender::Notify(BackpressureEvent event) {
+    if (onBackpressure_) {
+        onBackpressure_(event, pending_.Size());
+    }
+}
+
+/**
+ * @brief Returns the record's coalescing key under `CoalesceByKey`, and nothing otherwise.
+ */
+std::optional<uint64_t> Sender::CoalescingKey(const T_IPCData& data) const {
+    if (overflow_.mode != OverflowMode::CoalesceByKey) {
+        return std::nullopt;
+    }
+    return overflow_.key(data);
+}
@@ -0,0 +1,180 @@
+#ifndef SENDER_H
+#define SENDER_H
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <mqueue.h>
+#include "batch_frame.h"
+#include "constants.h"
+#include "control_segment.h"
+#include "ipc_data.pb.h"
+#include "overflow_buffer.h"
+#include "slab_pool.h"
+#include "string_dictionary.h"
+#include "t_ipc_data.h"
+#include "transport.h"
+
+// Which channel a Sender writes to
+using SenderTransport = TransportKind;
+
+// How a Sender encodes each record
+enum class WireCodec {
+    Protobuf, // IPCData protobuf (default)
+    Flat      // Fixed-layout flat frame, see flat_codec.h
+};
+
+// When records queued with Sender::Enqueue are flushed as one batch message
+struct BatchPolicy {
+    size_t maxBytes = MAX_MESSAGE_SIZE;          // Flush before the next record would overflow this
+    std::chrono::microseconds maxDelay { 1000 }; // Flush once the oldest queued record is this old
+};
+
+// What a Sender does when the queue or ring is full
+enum class OverflowMode {
+    Block,             // Wait for room, like a blocking mq_send (default; nothing is buffered)
+    BlockWithDeadline, // Buffer; once the buffer is full, wait up to `deadline` for room, then fail the send
+    DropOldest,        // Buffer; once the buffer is full, discard the oldest buffered message
+    DropNewest,        // Buffer; once the buffer is full, discard the message being sent
+    CoalesceByKey      // Buffer, replacing any buffered record with the same key; once full, discard the oldest
+};
+
+OverflowMode ParseOverflowMode(const std::string& name);
+
+struct OverflowPolicy {
+    OverflowMode mode = OverflowMode::Block;
+    size_t capacity = 64;                          // Messages buffered in-process while the channel is full
+    std::chrono::milliseconds deadline { 10 };     // BlockWithDeadline: longest a send waits for room
+    std::function<uint64_t(const T_IPCData&)> key; // CoalesceByKey: records with equal keys supersede each other
+};
+
+// Reported to the backpressure handler as the overflow buffer changes
+enum class BackpressureEvent {
+    Congested, // The channel was full and the first message was buffered
+    Relieved,  // Every buffered message has been sent
+    Dropped,   // A message was discarded by the overflow policy
+    Coalesced  // A buffered record was replaced by a newer one with the same key
+};
+
+using BackpressureHandler = std::function<void(BackpressureEvent event, size_t buffered)>;
+
+struct SenderStats {
+    uint64_t sent = 0;           // Messages handed to the queue or ring
+    uint64_t buffered = 0;       // Messages waiting in the overflow buffer right now
+    uint64_t peakBuffered = 0;
+    uint64_t dropped = 0;
+    uint64_t coalesced = 0;
+    uint64_t deadlineMisses = 0;
+};
+
+/**
+ * @brief Long-lived producer handle for sending `T_IPCData` messages.
+ *
+ * Opens the channel (see `Transport`) once, and serializes every
+ * message into a recycled protobuf message and a preallocated byte buffer,
+ * so the steady-state `Send` costs one syscall and no heap allocation.
+ * Records larger than one message are encoded into the receiver's slab pool
+ * and sent as a slab descriptor instead. Each message carries a queue
+ * priority (0 to `PRIORITY_LEVELS - 1`), given explicitly or looked up from
+ * the record's type, so urgent records overtake bulk traffic in the queue.
+ *
+ * With the string dictionary enabled, repeated strings in bulk (priority 0)
+ * protobuf records are sent as small entry ids; see `StringDictionaryEncoder`.
+ *
+ * By default a send blocks while the channel is full. With any other
+ * `OverflowMode` it never waits on the channel: messages that do not fit are
+ * kept in a bounded in-process buffer and sent, in order, by later calls.
+ */
+class Sender {
+public:
+    // Constructors
+    explicit Sender(SenderTransport transport = SenderTransport::MQueue, const std::string& name = "");
+    ~Sender();
+
+    Sender(const Sender&) = delete;
+    Sender& operator=(const Sender&) = delete;
+
+    // Methods
+    void Send(const T_IPCData& data);
+    void Send(const T_IPCData& data, unsigned priority);
+    void SendRaw(const char* data, size_t size, unsigned priority = 0);
+    void SetCodec(WireCodec codec);
+    void SetTracing(bool enabled);
+    void SetSlabPoolName(const std::string& name);
+    void SetStringDictionary(bool enabled, const std::string& controlName = CONTROL_SEGMENT_NAME);
+
+    // Priorities
+    void SetTypePriority(IPCData::Type type, unsigned priority);
+    unsigned PriorityOf(const T_IPCData& data) const;
+
+    // Overflow handling
+    void SetOverflowPolicy(const OverflowPolicy& policy);
+    void SetBackpressureHandler(BackpressureHandler handler);
+    const SenderStats& Stats() const { return stats_; }
+
+    // Batching
+    void SetBatchPolicy(const BatchPolicy& policy);
+    void Enqueue(const T_IPCData& data);
+    void Enqueue(const T_IPCData& data, unsigned priority);
+    bool FlushIfDue();
+    void Flush();
+
+private:
+    // Members
+    std::unique_ptr<Transport> transport_;
+    std::unique_ptr<SlabPool> slabs_; // Mapped on the first record too large for one message; re-mapped if replaced
+    std::string slabPoolName_;
+    std::chrono::steady_clock::time_point slabsChecked_;
+    WireCodec codec_;
+    IPCData proto_;            // Recycled so string fields keep their capacity between sends
+    std::vector<char> buffer_; // Serialization buffer, sized once to the queue's message size (at most MAX_MESSAGE_SIZE)
+    BatchPolicy batchPolicy_;
+    BatchEncoder batch_;
+    std::chrono::steady_clock::time_point batchStarted_;
+    unsigned batchPriority_;   // Priority the current batch will be sent at
+    bool batchCoded_;          // Some record in the current batch uses the string dictionary
+    bool batchDefines_;        // Some record in the current batch defines dictionary entries
+    std::array<unsigned, IPCData::Type_ARRAYSIZE> typePriorities_;
+    OverflowPolicy overflow_;
+    OverflowBuffer pending_;   // Messages waiting for room while `overflow_.mode` is not Block
+    BackpressureHandler onBackpressure_;
+    SenderStats stats_;
+    bool tracing_;
+    uint64_t sequence_;        // Last sequence number stamped on a record
+    std::unique_ptr<StringDictionaryEncoder> dictionary_; // Null unless the dictionary is enabled
+    std::unique_ptr<ControlSegment> control_;             // Receiver's reset requests; re-attached periodically
+    std::string controlName_;
+    uint64_t receiverId_;
+    uint32_t dictionaryResets_; // Last reset request count acted on
+    bool measuredCoded_;        // The record last passed to `Measure` uses the dictionary
+    bool measuredDefines_;      // ... and defines entries
+    std::chrono::steady_clock::time_point controlChecked_;
+
+    // Helper methods
+    size_t Measure(const T_IPCData& data, unsigned priority);
+    void EncodeString();
+    void CheckDictionaryReset();
+    void ForgetDictionary();
+    void EncodeMeasured(const T_IPCData& data, char* out, size_t size);
+    void SendNow(const T_IPCData& data, unsigned priority);
+    void SendLarge(const T_IPCData& data, size_t size, unsigned priority);
+    char* AcquireSlab(size_t size, SlabDescriptor& descriptor);
+    bool ReattachSlabs();
+    void SendSlab(const SlabDescriptor& descriptor, const OverflowBuffer::Entry& entry);
+    void SendSerialized(const char* data, size_t size, const OverflowBuffer::Entry& entry);
+    bool TrySend(const char* data, size_t size, unsigned priority, const timespec* deadline);
+    bool AttemptSend(const char* data, size_t size, unsigned priority, const timespec* deadline);
+    void CountSent(size_t size);
+    bool SendPendingBatch();
+    bool DrainPending(const timespec* deadline);
+    void Buffer(const char* data, size_t size, const OverflowBuffer::Entry& entry);
+    void Discard(const OverflowBuffer::Entry& entry);
+    void Notify(BackpressureEvent event);
+    std::optional<uint64_t> CoalescingKey(const T_IPCData& data) const;
+};
+
+#endif // SENDER_H
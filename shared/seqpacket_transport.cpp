@@ -0,0 +1,310 @@
+#include "seqpacket_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "stats_segment.h"
+
+namespace {
+    // Most messages handed to one sendmmsg/recvmmsg call
+    constexpr size_t BATCH_LIMIT = 64;
+
+    // Most ready descriptors taken from epoll per receive
+    constexpr int MAX_EVENTS = 16;
+
+    /**
+     * @brief Fills in the abstract-namespace address for a queue name.
+     *
+     * @return The address length to pass to bind/connect.
+     * @throws std::length_error if the name does not fit.
+     */
+    socklen_t abstractAddress(const std::string& name, sockaddr_un& address) {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (name.size() + 1 > sizeof(address.sun_path)) {
+            throw std::length_error("Socket name too long: " + name);
+        }
+        // A leading NUL selects the abstract namespace; the rest of the path is the name
+        std::memcpy(address.sun_path + 1, name.data(), name.size());
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+    }
+
+    /**
+     * @brief Milliseconds for poll() to wait until the deadline: -1 for none, 0 once it has passed (rounded up otherwise).
+     */
+    int pollTimeout(const timespec* deadline) {
+        if (!deadline) {
+            return -1;
+        }
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        const long long remainingNs = (deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+        return remainingNs > 0 ? static_cast<int>((remainingNs + 999999) / 1000000) : 0;
+    }
+
+    std::string errorText(const char* call) {
+        return std::string(call) + ": " + std::strerror(errno);
+    }
+}
+
+/**
+ * @brief Connects a sender to the receiver listening on `name`.
+ *
+ * @return A connected, blocking SOCK_SEQPACKET socket.
+ * @throws std::runtime_error if nothing is listening.
+ */
+int ConnectSeqPacket(const std::string& name) {
+    sockaddr_un address;
+    const socklen_t length = abstractAddress(name, address);
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(errorText("socket"));
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), length) != 0) {
+        const std::string error = errorText("connect");
+        close(fd);
+        throw std::runtime_error("No receiver listening on socket @" + name + " (" + error + ")");
+    }
+    return fd;
+}
+
+/**
+ * @brief Binds and listens on `name` for senders.
+ *
+ * @return A non-blocking listening SOCK_SEQPACKET socket.
+ * @throws std::runtime_error if another receiver already holds the name.
+ */
+int ListenSeqPacket(const std::string& name) {
+    sockaddr_un address;
+    const socklen_t length = abstractAddress(name, address);
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(errorText("socket"));
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), length) != 0 || listen(fd, SOMAXCONN) != 0) {
+        const std::string error = errorText("bind");
+        close(fd);
+        throw std::runtime_error("Failed to listen on socket @" + name + " (" + error + ")");
+    }
+    return fd;
+}
+
+/**
+ * @brief Sends one message on a connected SEQPACKET socket, waiting for room until the deadline.
+ *
+ * @param deadline As for `Transport::Send`.
+ * @return False if the socket buffer stayed full until the deadline.
+ * @throws std::runtime_error on any other failure, e.g. the receiver has gone.
+ */
+bool SendSeqPacket(int fd, const char* data, size_t size, const timespec* deadline) {
+    if (size == 0) {
+        data = &SEQPACKET_EMPTY_MESSAGE;
+        size = 1;
+    }
+    for (;;) {
+        if (send(fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL) >= 0) {
+            return true;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN) {
+            throw std::runtime_error("Failed to send message (" + errorText("send") + ")");
+        }
+        if (!WaitSeqPacketWritable(fd, deadline)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Waits until a connected SEQPACKET socket has room for a message, or the deadline passes.
+ *
+ * @param deadline As for `Transport::Send`.
+ * @return False if the deadline passed first; true once there is room or the wait was interrupted.
+ */
+bool WaitSeqPacketWritable(int fd, const timespec* deadline) {
+    const int timeoutMs = pollTimeout(deadline);
+    struct pollfd writable { fd, POLLOUT, 0 };
+    return timeoutMs != 0 && poll(&writable, 1, timeoutMs) != 0;
+}
+
+/**
+ * @brief Constructor: a sender connects to the receiver, which must already be listening; a receiver listens.
+ *
+ * @throws std::runtime_error if the socket cannot be connected or bound.
+ */
+SeqPacketTransport::SeqPacketTransport(const std::string& name, TransportRole role)
+    : name_(name), role_(role), socket_(-1), epoll_(-1), headers_(BATCH_LIMIT), vectors_(BATCH_LIMIT) {
+    if (role == TransportRole::Sender) {
+        socket_ = ConnectSeqPacket(name_);
+        return;
+    }
+
+    socket_ = ListenSeqPacket(name_);
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event listening {};
+    listening.events = EPOLLIN;
+    listening.data.fd = socket_;
+    if (epoll_ < 0 || epoll_ctl(epoll_, EPOLL_CTL_ADD, socket_, &listening) != 0) {
+        const std::string error = errorText("epoll");
+        if (epoll_ >= 0) {
+            close(epoll_);
+        }
+        close(socket_);
+        throw std::runtime_error(error);
+    }
+}
+
+SeqPacketTransport::~SeqPacketTransport() {
+    for (int connection : connections_) {
+        close(connection);
+    }
+    if (epoll_ >= 0) {
+        close(epoll_);
+    }
+    close(socket_);
+}
+
+bool SeqPacketTransport::Send(const char* data, size_t size, unsigned /*priority*/, const timespec* deadline) {
+    return SendSeqPacket(socket_, data, size, deadline);
+}
+
+/**
+ * @brief Sends up to `BATCH_LIMIT` messages per `sendmmsg`, stopping at the first that does not fit.
+ */
+size_t SeqPacketTransport::SendBatch(const OutgoingMessage* messages, size_t count) {
+    size_t sent = 0;
+    while (sent < count) {
+        const size_t chunk = std::min(count - sent, BATCH_LIMIT);
+        for (size_t i = 0; i < chunk; ++i) {
+            const OutgoingMessage& message = messages[sent + i];
+            vectors_[i].iov_base = const_cast<char*>(message.size ? message.data : &SEQPACKET_EMPTY_MESSAGE);
+            vectors_[i].iov_len = message.size ? message.size : 1;
+            headers_[i] = mmsghdr {};
+            headers_[i].msg_hdr.msg_iov = &vectors_[i];
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int result = sendmmsg(socket_, headers_.data(), static_cast<unsigned>(chunk), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return sent;
+            }
+            throw std::runtime_error("Failed to send message (" + errorText("sendmmsg") + ")");
+        }
+        sent += static_cast<size_t>(result);
+        if (static_cast<size_t>(result) < chunk) {
+            break; // The socket buffer filled up part way
+        }
+    }
+    return sent;
+}
+
+bool SeqPacketTransport::WaitForData(int timeoutMs) {
+    // An epoll descriptor is itself readable while any descriptor in it is ready
+    struct pollfd ready { role_ == TransportRole::Receiver ? epoll_ : socket_, POLLIN, 0 };
+    return poll(&ready, 1, timeoutMs) > 0;
+}
+
+/**
+ * @brief Accepts any new senders, then drains every ready connection with `recvmmsg` until the slots run out.
+ */
+size_t SeqPacketTransport::ReceiveBatch(ReceiveSlot* slots, size_t count) {
+    if (role_ != TransportRole::Receiver) {
+        return 0;
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    const int ready = epoll_wait(epoll_, events, MAX_EVENTS, 0);
+    size_t received = 0;
+    for (int i = 0; i < ready && received < count; ++i) {
+        if (events[i].data.fd == socket_) {
+            Accept();
+        } else {
+            received += ReceiveFrom(events[i].data.fd, slots + received, count - received);
+        }
+    }
+    return received;
+}
+
+std::string SeqPacketTransport::Describe() const {
+    return "SEQPACKET socket @" + name_;
+}
+
+
+
+/* --- Private Helper Methods --- */
+
+void SeqPacketTransport::Accept() {
+    int connection;
+    while ((connection = accept4(socket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        struct epoll_event readable {};
+        readable.events = EPOLLIN;
+        readable.data.fd = connection;
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, connection, &readable) != 0) {
+            close(connection);
+            throw std::runtime_error(errorText("epoll_ctl"));
+        }
+        connections_.push_back(connection);
+    }
+}
+
+void SeqPacketTransport::Close(int connection) {
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, connection, nullptr);
+    close(connection);
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), connection), connections_.end());
+}
+
+/**
+ * @brief Receives what one connection has ready into the slots; closes it once its sender has gone.
+ *
+ * A message that did not fit its slot is dropped and counted as
+ * `Stat::MessagesTruncated`; the messages after it move up into its place.
+ */
+size_t SeqPacketTransport::ReceiveFrom(int connection, ReceiveSlot* slots, size_t count) {
+    const size_t chunk = std::min(count, BATCH_LIMIT);
+    for (size_t i = 0; i < chunk; ++i) {
+        vectors_[i].iov_base = slots[i].buffer;
+        vectors_[i].iov_len = slots[i].capacity;
+        headers_[i] = mmsghdr {};
+        headers_[i].msg_hdr.msg_iov = &vectors_[i];
+        headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int result = recvmmsg(connection, headers_.data(), static_cast<unsigned>(chunk), MSG_DONTWAIT, nullptr);
+    if (result < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+            return 0;
+        }
+        Close(connection); // e.g. ECONNRESET
+        return 0;
+    }
+
+    size_t kept = 0;
+    for (int i = 0; i < result; ++i) {
+        // Zero bytes is end-of-file (empty messages travel as one byte), and so is everything after it
+        const size_t size = headers_[i].msg_len;
+        if (size == 0) {
+            Close(connection);
+            return kept;
+        }
+        if ((headers_[i].msg_hdr.msg_flags & MSG_TRUNC) || size > slots[kept].capacity) {
+            stats::Add(Stat::MessagesTruncated);
+            continue;
+        }
+        if (kept != static_cast<size_t>(i)) {
+            std::memcpy(slots[kept].buffer, slots[i].buffer, size);
+        }
+        const bool empty = size == 1 && slots[kept].buffer[0] == SEQPACKET_EMPTY_MESSAGE;
+        slots[kept].size = empty ? 0 : size;
+        slots[kept].priority = 0;
+        ++kept;
+    }
+    return kept;
+}
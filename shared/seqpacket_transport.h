@@ -0,0 +1,68 @@
+#ifndef SEQPACKET_TRANSPORT_H
+#define SEQPACKET_TRANSPORT_H
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "transport.h"
+
+/*
+    AF_UNIX SOCK_SEQPACKET sockets, bound in the abstract namespace under the
+    queue name (so nothing is left on the filesystem and there is nothing to
+    unlink). A zero-length datagram cannot be told apart from end-of-file, so
+    an empty message travels as the single byte SEQPACKET_EMPTY_MESSAGE, which
+    is neither a valid protobuf record nor any frame marker.
+*/
+constexpr char SEQPACKET_EMPTY_MESSAGE = '\0';
+
+int ConnectSeqPacket(const std::string& name);
+int ListenSeqPacket(const std::string& name);
+bool SendSeqPacket(int fd, const char* data, size_t size, const timespec* deadline);
+bool WaitSeqPacketWritable(int fd, const timespec* deadline);
+
+/**
+ * @brief Unix SEQPACKET socket backend, batching with `sendmmsg` and `recvmmsg`.
+ *
+ * The receiver listens and accepts any number of senders, multiplexing them
+ * with epoll; each sender connects once. Messages from one sender arrive in
+ * order. There are no priorities: every message is received at priority 0.
+ */
+class SeqPacketTransport : public Transport {
+public:
+    // Constructors
+    SeqPacketTransport(const std::string& name, TransportRole role);
+    ~SeqPacketTransport() override;
+
+    SeqPacketTransport(const SeqPacketTransport&) = delete;
+    SeqPacketTransport& operator=(const SeqPacketTransport&) = delete;
+
+    // Methods
+    bool Send(const char* data, size_t size, unsigned priority, const timespec* deadline) override;
+    size_t SendBatch(const OutgoingMessage* messages, size_t count) override;
+    bool WaitForData(int timeoutMs) override;
+    size_t ReceiveBatch(ReceiveSlot* slots, size_t count) override;
+
+    // Getters
+    TransportKind Kind() const override { return TransportKind::SeqPacket; }
+    std::string Describe() const override;
+
+private:
+    // Members
+    std::string name_;
+    TransportRole role_;
+    int socket_;                  // Connected socket (sender) or listening socket (receiver)
+    int epoll_;                   // Receiver only: the listening socket and every connection
+    std::vector<int> connections_;
+    std::vector<mmsghdr> headers_; // Scratch for sendmmsg/recvmmsg, one per message in a batch
+    std::vector<iovec> vectors_;
+
+    // Helper methods
+    void Accept();
+    void Close(int connection);
+    size_t ReceiveFrom(int connection, ReceiveSlot* slots, size_t count);
+};
+
+#endif // SEQPACKET_TRANSPORT_H
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <stdexcept>
+#include "sharded_sender.h"
+
+/**
+ * @brief Parses a `--partition` value: "round-robin", "type" or "int".
+ *
+ * @throws std::invalid_argument for any other value.
+ */
+PartitionKey ParsePartitionKey(const std::string& name) {
+    if (name == "round-robin") return PartitionKey::RoundRobin;
+    if (name == "type")        return PartitionKey::Type;
+    if (name == "int")         return PartitionKey::Int;
+    throw std::invalid_argument("Unknown partition key '" + name + "' (expected round-robin, type or int)");
+}
+
+/**
+ * @brief Returns a built-in partitioner.
+ *
+ * Hashing partitioners send records without the key field to shard 0.
+ */
+Partitioner MakePartitioner(PartitionKey key) {
+    switch (key) {
+    case PartitionKey::Type:
+        return [](const T_IPCData& data, size_t shardCount) {
+            auto type = data.GetTheType();
+            return type ? (static_cast<size_t>(*type) + 1) % shardCount : 0;
+        };
+    case PartitionKey::Int:
+        return [](const T_IPCData& data, size_t shardCount) {
+            auto value = data.GetTheInt();
+            return value ? std::hash<int>()(*value) % shardCount : 0;
+        };
+    case PartitionKey::RoundRobin:
+    default:
+        return [next = size_t(0)](const T_IPCData&, size_t shardCount) mutable {
+            return next++ % shardCount;
+        };
+    }
+}
+
+/**
+ * @brief Returns the queue name for one shard, e.g. "/ipc_queue.3".
+ */
+std::string ShardQueueName(const std::string& baseName, size_t shard) {
+    return baseName + "." + std::to_string(shard);
+}
+
+/**
+ * @brief Constructor that opens one `Sender` per shard.
+ *
+ * @param transport Which channel to send on; only message queues are sharded.
+ * @param shardCount Number of shards (1 uses `baseName` itself).
+ * @param partitioner Picks the shard for each record.
+ * @param baseName Queue name the shard names derive from; empty selects `QUEUE_NAME`.
+ * @throws std::invalid_argument if the shard count is out of range or a ring is sharded.
+ * @throws std::runtime_error if a queue cannot be opened.
+ */
+ShardedSender::ShardedSender(SenderTransport transport, size_t shardCount, Partitioner partitioner,
+                             const std::string& baseName)
+    : partitioner_(std::move(partitioner)) {
+    if (shardCount < 1 || shardCount > MAX_SHARDS) {
+        throw std::invalid_argument("Shard count must be between 1 and MAX_SHARDS.");
+    }
+    if (shardCount > 1 && transport != SenderTransport::MQueue) {
+        throw std::invalid_argument("Only the message queue transport can be sharded.");
+    }
+
+    if (shardCount == 1) {
+        shards_.push_back(std::make_unique<Sender>(transport, baseName));
+        return;
+    }
+
+    const std::string base = baseName.empty() ? QUEUE_NAME : baseName;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        shards_.push_back(std::make_unique<Sender>(transport, ShardQueueName(base, shard)));
+    }
+}
+
+/**
+ * @brief Sends a record immediately on its shard. See `Sender::Send`.
+ */
+void ShardedSender::Send(const T_IPCData& data) {
+    ShardFor(data).Send(data);
+}
+
+void ShardedSender::Send(const T_IPCData& data, unsigned priority) {
+    ShardFor(data).Send(data, priority);
+}
+
+/**
+ * @brief Sends an encoded message as-is on the given shard (modulo the shard count). See `Sender::SendRaw`.
+ *
+ * Raw messages are not partitioned, since that would mean decoding them.
+ */
+void ShardedSender::SendRaw(const char* data, size_t size, unsigned priority, size_t shard) {
+    shards_[shard % shards_.size()]->SendRaw(data, size, priority);
+}
+
+/**
+ * @brief Queues a record into its shard's batch. See `Sender::Enqueue`.
+ */
+void ShardedSender::Enqueue(const T_IPCData& data) {
+    ShardFor(data).Enqueue(data);
+}
+
+void ShardedSender::Enqueue(const T_IPCData& data, unsigned priority) {
+    ShardFor(data).Enqueue(data, priority);
+}
+
+/**
+ * @brief Sends every shard's batch that is due. See `Sender::FlushIfDue`.
+ *
+ * @return True if any batch was sent.
+ */
+bool ShardedSender::FlushIfDue() {
+    bool flushed = false;
+    for (auto& shard : shards_) {
+        flushed |= shard->FlushIfDue();
+    }
+    return flushed;
+}
+
+void ShardedSender::Flush() {
+    for (auto& shard : shards_) {
+        shard->Flush();
+    }
+}
+
+void ShardedSender::SetCodec(WireCodec codec) {
+    for (auto& shard : shards_) {
+        shard->SetCodec(codec);
+    }
+}
+
+/**
+ * @brief Enables tracing on every shard. Sequence numbers are per shard.
+ */
+void ShardedSender::SetTracing(bool enabled) {
+    for (auto& shard : shards_) {
+        shard->SetTracing(enabled);
+    }
+}
+
+void ShardedSender::SetStringDictionary(bool enabled) {
+    for (auto& shard : shards_) {
+        shard->SetStringDictionary(enabled);
+    }
+}
+
+void ShardedSender::SetBatchPolicy(const BatchPolicy& policy) {
+    for (auto& shard : shards_) {
+        shard->SetBatchPolicy(policy);
+    }
+}
+
+void ShardedSender::SetTypePriority(IPCData::Type type, unsigned priority) {
+    for (auto& shard : shards_) {
+        shard->SetTypePriority(type, priority);
+    }
+}
+
+/**
+ * @brief Applies the overflow policy to every shard; each shard buffers up to `policy.capacity` messages.
+ */
+void ShardedSender::SetOverflowPolicy(const OverflowPolicy& policy) {
+    for (auto& shard : shards_) {
+        shard->SetOverflowPolicy(policy);
+    }
+}
+
+/**
+ * @brief Installs the backpressure handler on every shard. `buffered` is the reporting shard's count.
+ */
+void ShardedSender::SetBackpressureHandler(const BackpressureHandler& handler) {
+    for (auto& shard : shards_) {
+        shard->SetBackpressureHandler(handler);
+    }
+}
+
+/**
+ * @brief Returns the send statistics summed over all shards (`peakBuffered` is the largest shard's peak).
+ */
+SenderStats ShardedSender::Stats() const {
+    SenderStats total;
+    for (const auto& shard : shards_) {
+        const SenderStats& stats = shard->Stats();
+        total.sent += stats.sent;
+        total.buffered += stats.buffered;
+        total.peakBuffered = std::max(total.peakBuffered, stats.peakBuffered);
+        total.dropped += stats.dropped;
+        total.coalesced += stats.coalesced;
+        total.deadlineMisses += stats.deadlineMisses;
+    }
+    return total;
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+Sender& ShardedSender::ShardFor(const T_IPCData& data) {
+    if (shards_.size() == 1) {
+        return *shards_[0];
+    }
+    return *shards_[partitioner_(data, shards_.size()) % shards_.size()];
+}
@@ -0,0 +1,75 @@
+#ifndef SHARDED_SENDER_H
+#define SHARDED_SENDER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sender.h"
+
+/*
+    Sharded mode: N independent message queues, QUEUE_NAME.0 ... QUEUE_NAME.N-1,
+    so producers and consumers stop contending on one kernel queue. The
+    receiver publishes N in the control segment and serves every shard on its
+    own thread; the sender picks a shard per record with a partitioner.
+*/
+
+// Picks the shard (in [0, shardCount)) a record is sent on
+using Partitioner = std::function<size_t(const T_IPCData& data, size_t shardCount)>;
+
+// Built-in partitioners
+enum class PartitionKey {
+    RoundRobin, // Spread records evenly; no ordering between shards
+    Type,       // Hash `the_type`, so each type stays in order on one shard
+    Int         // Hash `the_int`, so each int value stays in order on one shard
+};
+
+PartitionKey ParsePartitionKey(const std::string& name);
+Partitioner MakePartitioner(PartitionKey key);
+std::string ShardQueueName(const std::string& baseName, size_t shard);
+
+/**
+ * @brief Producer that spreads records over sharded queues, one `Sender` per shard.
+ *
+ * With a single shard it is exactly a `Sender` on the base name, so callers
+ * can use it unconditionally.
+ */
+class ShardedSender {
+public:
+    // Constructors
+    ShardedSender(SenderTransport transport, size_t shardCount, Partitioner partitioner,
+                  const std::string& baseName = "");
+
+    // Methods
+    void Send(const T_IPCData& data);
+    void Send(const T_IPCData& data, unsigned priority);
+    void SendRaw(const char* data, size_t size, unsigned priority, size_t shard);
+    void Enqueue(const T_IPCData& data);
+    void Enqueue(const T_IPCData& data, unsigned priority);
+    bool FlushIfDue();
+    void Flush();
+
+    // Settings, applied to every shard
+    void SetCodec(WireCodec codec);
+    void SetTracing(bool enabled);
+    void SetStringDictionary(bool enabled);
+    void SetBatchPolicy(const BatchPolicy& policy);
+    void SetTypePriority(IPCData::Type type, unsigned priority);
+    void SetOverflowPolicy(const OverflowPolicy& policy);
+    void SetBackpressureHandler(const BackpressureHandler& handler);
+
+    // Getters
+    size_t ShardCount() const { return shards_.size(); }
+    SenderStats Stats() const;
+
+private:
+    // Members
+    std::vector<std::unique_ptr<Sender>> shards_;
+    Partitioner partitioner_;
+
+    // Helper methods
+    Sender& ShardFor(const T_IPCData& data);
+};
+
+#endif // SHARDED_SENDER_H
@@ -0,0 +1,245 @@
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "shm_ring.h"
+
+namespace {
+    // Marks a segment whose header has been fully initialized by the creator
+    constexpr uint32_t SHM_RING_MAGIC = 0x49504352; // "IPCR"
+
+    long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+        // Not FUTEX_PRIVATE_FLAG: the word lives in memory shared between processes
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+    }
+}
+
+/**
+ * @brief Constructor that maps (and optionally creates) the ring segment.
+ *
+ * The creator (normally `main_rx`) removes any leftover segment, sizes a fresh
+ * one for `SHM_RING_SLOTS` slots and initializes the header. Other processes
+ * attach to the existing segment and validate it.
+ *
+ * @param name POSIX shared-memory name, e.g. `SHM_RING_NAME`.
+ * @param create True to create a fresh segment, false to attach to an existing one.
+ * @throws std::runtime_error if the segment cannot be opened, sized, mapped or validated.
+ */
+ShmRing::ShmRing(const std::string& name, bool create)
+    : header_(nullptr), slots_(nullptr), mappedSize_(0), fd_(-1), cachedHead_(0), cachedTail_(0) {
+    if (create) {
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, QUEUE_PERMISSIONS);
+    } else {
+        fd_ = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd_ == -1) {
+        throw std::runtime_error("Failed to open shared memory ring");
+    }
+
+    if (create) {
+        mappedSize_ = sizeof(Header) + SHM_RING_SLOTS * sizeof(Slot);
+        if (ftruncate(fd_, static_cast<off_t>(mappedSize_)) == -1) {
+            close(fd_);
+            throw std::runtime_error("Failed to size shared memory ring");
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            close(fd_);
+            throw std::runtime_error("Shared memory ring is not initialized");
+        }
+        mappedSize_ = static_cast<size_t>(st.st_size);
+    }
+
+    void* addr = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map shared memory ring");
+    }
+
+    header_ = static_cast<Header*>(addr);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(addr) + sizeof(Header));
+
+    if (create) {
+        // ftruncate zero-fills, so the indices and futex words already start at 0
+        header_->slotCount = SHM_RING_SLOTS;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = SHM_RING_MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->magic != SHM_RING_MAGIC ||
+            mappedSize_ < sizeof(Header) + header_->slotCount * sizeof(Slot)) {
+            munmap(addr, mappedSize_);
+            close(fd_);
+            throw std::runtime_error("Shared memory ring is not initialized");
+        }
+    }
+
+    cachedHead_ = header_->head.load(std::memory_order_acquire);
+    cachedTail_ = header_->tail.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the segment. The segment itself persists until `Unlink` is called.
+ */
+ShmRing::~ShmRing() {
+    munmap(header_, mappedSize_);
+    close(fd_);
+}
+
+/**
+ * @brief Copies one message into the next free slot without blocking.
+ *
+ * @param data Pointer to the serialized message.
+ * @param size Size of the message in bytes (at most `MAX_MESSAGE_SIZE`).
+ * @return True if the message was queued, false if the ring is full.
+ * @throws std::length_error if the message does not fit in a slot.
+ */
+bool ShmRing::TryPush(const char* data, size_t size) {
+    if (size > MAX_MESSAGE_SIZE) {
+        throw std::length_error("Message exceeds shared memory ring slot size.");
+    }
+
+    const uint64_t head = header_->head.load(std::memory_order_relaxed);
+    if (head - cachedTail_ >= header_->slotCount) {
+        cachedTail_ = header_->tail.load(std::memory_order_acquire);
+        if (head - cachedTail_ >= header_->slotCount) {
+            return false;
+        }
+    }
+
+    Slot& slot = slots_[head % header_->slotCount];
+    slot.size = static_cast<uint32_t>(size);
+    std::memcpy(slot.data, data, size);
+    header_->head.store(head + 1, std::memory_order_release);
+
+    Wake(header_->readerParked, header_->readerFutex);
+    return true;
+}
+
+/**
+ * @brief Copies one message into the ring, parking while it is full.
+ *
+ * Mirrors the blocking behaviour of `mq_send`.
+ *
+ * @param data Pointer to the serialized message.
+ * @param size Size of the message in bytes.
+ * @param timeoutMs Maximum time to wait per park, or -1 to wait indefinitely.
+ * @return True if the message was queued, false on timeout or signal.
+ */
+bool ShmRing::Push(const char* data, size_t size, int timeoutMs) {
+    while (!TryPush(data, size)) {
+        if (!Park(header_->writerParked, header_->writerFutex, false, timeoutMs)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Copies the oldest message out of the ring without blocking.
+ *
+ * Mirrors `mq_receive` on a non-blocking queue.
+ *
+ * @param buffer Destination buffer.
+ * @param capacity Size of the destination buffer in bytes.
+ * @return The message size in bytes, or -1 if the ring is empty.
+ * @throws std::length_error if the message does not fit in the buffer.
+ */
+ssize_t ShmRing::TryPop(char* buffer, size_t capacity) {
+    const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (tail == cachedHead_) {
+        cachedHead_ = header_->head.load(std::memory_order_acquire);
+        if (tail == cachedHead_) {
+            return -1;
+        }
+    }
+
+    const Slot& slot = slots_[tail % header_->slotCount];
+    if (slot.size > capacity) {
+        throw std::length_error("Receive buffer is smaller than the shared memory ring message.");
+    }
+    const ssize_t size = slot.size;
+    std::memcpy(buffer, slot.data, slot.size);
+    header_->tail.store(tail + 1, std::memory_order_release);
+
+    Wake(header_->writerParked, header_->writerFutex);
+    return size;
+}
+
+/**
+ * @brief Waits until at least one message is available.
+ *
+ * Returns immediately when the ring is non-empty; otherwise parks on the
+ * reader futex, which the writer only signals while the reader is parked.
+ *
+ * @param timeoutMs Maximum time to wait, or -1 to wait indefinitely.
+ * @return True if a message is available.
+ */
+bool ShmRing::WaitForData(int timeoutMs) {
+    if (header_->tail.load(std::memory_order_relaxed) != header_->head.load(std::memory_order_acquire)) {
+        return true;
+    }
+    Park(header_->readerParked, header_->readerFutex, true, timeoutMs);
+    return header_->tail.load(std::memory_order_relaxed) != header_->head.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Removes the named ring segment from the system.
+ */
+void ShmRing::Unlink(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Parks the calling side on its futex until the other side signals progress.
+ *
+ * The parked flag is published before the ring state is re-checked, and the
+ * other side checks the flag after publishing its index, so a wakeup cannot
+ * be lost between the check and the wait.
+ *
+ * @return False if the wait timed out or was interrupted, true otherwise.
+ */
+bool ShmRing::Park(std::atomic<uint32_t>& parked, std::atomic<uint32_t>& futexWord, bool reader, int timeoutMs) {
+    const uint32_t sequence = futexWord.load(std::memory_order_acquire);
+    parked.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint64_t head = header_->head.load(std::memory_order_acquire);
+    const uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    const bool ready = reader ? (head != tail) : (head - tail < header_->slotCount);
+    if (ready) {
+        parked.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    timespec timeout { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+    long rc = futex(&futexWord, FUTEX_WAIT, sequence, timeoutMs < 0 ? nullptr : &timeout);
+    parked.store(0, std::memory_order_relaxed);
+
+    return !(rc == -1 && (errno == ETIMEDOUT || errno == EINTR));
+}
+
+/**
+ * @brief Wakes the other side if, and only if, it is parked.
+ */
+void ShmRing::Wake(std::atomic<uint32_t>& parked, std::atomic<uint32_t>& futexWord) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_relaxed)) {
+        futexWord.fetch_add(1, std::memory_order_release);
+        futex(&futexWord, FUTEX_WAKE, 1, nullptr);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include "constants.h"
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring in POSIX shared memory.
+ *
+ * Carries serialized `T_IPCData` bytes between `main_tx` and `main_rx` without
+ * a syscall on the fast path. Each side only touches its own cache line except
+ * when it has to park on a futex, so the other side is woken only when needed.
+ */
+class ShmRing {
+public:
+    // Constructors
+    ShmRing(const std::string& name, bool create);
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Producer side
+    bool TryPush(const char* data, size_t size);
+    bool Push(const char* data, size_t size, int timeoutMs = -1);
+
+    // Consumer side
+    ssize_t TryPop(char* buffer, size_t capacity);
+    bool WaitForData(int timeoutMs);
+
+    static void Unlink(const std::string& name);
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot {
+        uint32_t size;
+        char data[MAX_MESSAGE_SIZE];
+    };
+
+    // Layout of the mapped segment; head and tail live on separate cache lines
+    struct Header {
+        uint32_t magic;
+        uint32_t slotCount;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;   // Next slot the writer fills
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;   // Next slot the reader drains
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> readerParked;
+        std::atomic<uint32_t> readerFutex;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> writerParked;
+        std::atomic<uint32_t> writerFutex;
+    };
+
+    Header* header_;
+    Slot* slots_;
+    size_t mappedSize_;
+    int fd_;
+
+    // Local copies of the other side's index, refreshed only when the ring looks full/empty
+    uint64_t cachedHead_;
+    uint64_t cachedTail_;
+
+    // Helper methods
+    bool Park(std::atomic<uint32_t>& parked, std::atomic<uint32_t>& futexWord, bool reader, int timeoutMs);
+    static void Wake(std::atomic<uint32_t>& parked, std::atomic<uint32_t>& futexWord);
+};
+
+#endif // SHM_RING_H
@@ -0,0 +1,255 @@
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "slab_pool.h"
+
+namespace {
+    // Marks a segment whose header has been fully initialized by the creator
+    constexpr uint32_t SLAB_POOL_MAGIC = 0x49504353; // "IPCS"
+}
+
+/**
+ * @brief Writes a descriptor as `SLAB_DESCRIPTOR_SIZE` bytes at `out`.
+ */
+void EncodeSlabDescriptor(const SlabDescriptor& descriptor, char* out) {
+    out[0] = static_cast<char>(SLAB_DESCRIPTOR_MARKER);
+    std::memcpy(out + 1, &descriptor.slab, sizeof(uint32_t));
+    std::memcpy(out + 5, &descriptor.offset, sizeof(uint32_t));
+    std::memcpy(out + 9, &descriptor.length, sizeof(uint32_t));
+    std::memcpy(out + 13, &descriptor.generation, sizeof(uint32_t));
+}
+
+/**
+ * @brief Reads a descriptor written by `EncodeSlabDescriptor`.
+ *
+ * @throws std::runtime_error if the buffer is not exactly one descriptor.
+ */
+SlabDescriptor DecodeSlabDescriptor(const char* buffer, size_t size) {
+    if (size != SLAB_DESCRIPTOR_SIZE || !IsSlabDescriptor(buffer, size)) {
+        throw std::runtime_error("Failed to parse slab descriptor.");
+    }
+    SlabDescriptor descriptor;
+    std::memcpy(&descriptor.slab, buffer + 1, sizeof(uint32_t));
+    std::memcpy(&descriptor.offset, buffer + 5, sizeof(uint32_t));
+    std::memcpy(&descriptor.length, buffer + 9, sizeof(uint32_t));
+    std::memcpy(&descriptor.generation, buffer + 13, sizeof(uint32_t));
+    return descriptor;
+}
+
+/**
+ * @brief Constructor that maps (and optionally creates) the slab pool.
+ *
+ * The creator (normally `main_rx`) removes any leftover segment, so slabs
+ * held by a previous run are not leaked, and sizes a fresh one for
+ * `SLAB_COUNT` slabs of `SLAB_SIZE` bytes. Other processes attach and validate it.
+ *
+ * @param name POSIX shared-memory name, e.g. `SLAB_POOL_NAME`.
+ * @param create True to create a fresh segment, false to attach to an existing one.
+ * @throws std::runtime_error if the segment cannot be opened, sized, mapped or validated.
+ */
+SlabPool::SlabPool(const std::string& name, bool create)
+    : header_(nullptr), states_(nullptr), data_(nullptr), mappedSize_(0), fd_(-1) {
+    if (create) {
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, QUEUE_PERMISSIONS);
+    } else {
+        fd_ = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd_ == -1) {
+        throw std::runtime_error("Failed to open slab pool");
+    }
+
+    if (create) {
+        mappedSize_ = sizeof(Header) + SLAB_COUNT * (sizeof(SlabState) + SLAB_SIZE);
+        if (ftruncate(fd_, static_cast<off_t>(mappedSize_)) == -1) {
+            close(fd_);
+            throw std::runtime_error("Failed to size slab pool");
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            close(fd_);
+            throw std::runtime_error("Slab pool is not initialized");
+        }
+        mappedSize_ = static_cast<size_t>(st.st_size);
+    }
+
+    void* addr = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map slab pool");
+    }
+    header_ = static_cast<Header*>(addr);
+
+    if (create) {
+        // ftruncate zero-fills, so every slab starts free at generation 0
+        header_->slabCount = SLAB_COUNT;
+        header_->slabSize = SLAB_SIZE;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = SLAB_POOL_MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->magic != SLAB_POOL_MAGIC ||
+            mappedSize_ < sizeof(Header) + header_->slabCount * (sizeof(SlabState) + header_->slabSize)) {
+            munmap(addr, mappedSize_);
+            close(fd_);
+            throw std::runtime_error("Slab pool is not initialized");
+        }
+    }
+
+    states_ = reinterpret_cast<SlabState*>(static_cast<char*>(addr) + sizeof(Header));
+    data_ = reinterpret_cast<char*>(states_ + header_->slabCount);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the segment. The segment itself persists until `Unlink` is called.
+ */
+SlabPool::~SlabPool() {
+    munmap(header_, mappedSize_);
+    close(fd_);
+}
+
+/**
+ * @brief Claims a free slab for a record of `length` bytes.
+ *
+ * The caller writes the record at the returned address and then sends
+ * `descriptor`; if it cannot send it, it must `Release` the descriptor itself.
+ *
+ * @param length Size of the record in bytes.
+ * @param descriptor Filled in with the claimed slab.
+ * @return Where to write the record, or null if every slab is in use.
+ * @throws std::length_error if the record does not fit in one slab.
+ */
+char* SlabPool::TryAcquire(size_t length, SlabDescriptor& descriptor) {
+    if (length > header_->slabSize) {
+        throw std::length_error("Record exceeds SLAB_SIZE.");
+    }
+
+    const uint32_t start = header_->cursor.load(std::memory_order_relaxed);
+    for (uint32_t attempt = 0; attempt < header_->slabCount; ++attempt) {
+        const uint32_t slab = (start + attempt) % header_->slabCount;
+        uint32_t expected = 0;
+        if (states_[slab].busy.load(std::memory_order_relaxed) != 0 ||
+            !states_[slab].busy.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+            continue;
+        }
+
+        header_->cursor.store(slab + 1, std::memory_order_relaxed);
+        descriptor.slab = slab;
+        descriptor.offset = 0;
+        descriptor.length = static_cast<uint32_t>(length);
+        descriptor.generation = states_[slab].generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        return data_ + static_cast<size_t>(slab) * header_->slabSize;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Returns the record a descriptor refers to, in place in the mapped slab.
+ *
+ * The view stays valid until the descriptor is released.
+ *
+ * @throws std::runtime_error if the descriptor is out of range, or its slab has
+ *         been released or reused since it was sent.
+ */
+std::string_view SlabPool::Resolve(const SlabDescriptor& descriptor) const {
+    if (!Matches(descriptor)) {
+        throw std::runtime_error("Stale or invalid slab descriptor.");
+    }
+    const char* slab = data_ + static_cast<size_t>(descriptor.slab) * header_->slabSize;
+    return std::string_view(slab + descriptor.offset, descriptor.length);
+}
+
+/**
+ * @brief Returns a slab to the pool. Releasing a stale descriptor does nothing.
+ */
+void SlabPool::Release(const SlabDescriptor& descriptor) {
+    if (Matches(descriptor)) {
+        states_[descriptor.slab].busy.store(0, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Returns how many slabs are currently claimed.
+ */
+size_t SlabPool::InUse() const {
+    size_t count = 0;
+    for (uint32_t slab = 0; slab < header_->slabCount; ++slab) {
+        count += states_[slab].busy.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+/**
+ * @brief Returns true if `name` no longer refers to the segment this pool maps.
+ *
+ * A restarted receiver unlinks the pool and creates a new one under the same
+ * name; descriptors written into the old mapping can never be resolved.
+ */
+bool SlabPool::Replaced(const std::string& name) const {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        return true;
+    }
+    struct stat current;
+    struct stat mapped;
+    const bool same = fstat(fd, &current) == 0 && fstat(fd_, &mapped) == 0 &&
+                      current.st_dev == mapped.st_dev && current.st_ino == mapped.st_ino;
+    close(fd);
+    return !same;
+}
+
+/**
+ * @brief Removes the named segment. Processes that still have it mapped keep working.
+ */
+void SlabPool::Unlink(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+bool SlabPool::Matches(const SlabDescriptor& descriptor) const {
+    return descriptor.slab < header_->slabCount &&
+           static_cast<uint64_t>(descriptor.offset) + descriptor.length <= header_->slabSize &&
+           states_[descriptor.slab].busy.load(std::memory_order_acquire) != 0 &&
+           states_[descriptor.slab].generation.load(std::memory_order_relaxed) == descriptor.generation;
+}
+
+/**
+ * @brief Constructor that resolves `record` if it is a slab descriptor.
+ *
+ * @param pool The receiver's slab pool; may be null if none is mapped.
+ * @param record One received record.
+ * @throws std::runtime_error if `record` is a descriptor but there is no pool,
+ *         or the descriptor is malformed or stale.
+ */
+SlabRecord::SlabRecord(SlabPool* pool, std::string_view record) : pool_(nullptr), descriptor_{}, view_(record) {
+    if (!IsSlabDescriptor(record.data(), record.size())) {
+        return;
+    }
+    if (!pool) {
+        throw std::runtime_error("Received a slab descriptor but no slab pool is mapped.");
+    }
+
+    descriptor_ = DecodeSlabDescriptor(record.data(), record.size());
+    view_ = pool->Resolve(descriptor_);
+    pool_ = pool;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Releases the slab, if the record was in one.
+ */
+SlabRecord::~SlabRecord() {
+    if (pool_) {
+        pool_->Release(descriptor_);
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "constants.h"
+
+/*
+    Slab descriptor: stands in for a record too large for one queue message.
+
+        [SLAB_DESCRIPTOR_MARKER][u32 slab][u32 offset][u32 length][u32 generation]
+
+    The record itself sits in the shared slab pool at `offset` bytes into slab
+    `slab`. Like the batch and flat markers, 0x17 is a protobuf tag with wire
+    type 7, so it can never start a serialized IPCData.
+*/
+constexpr uint8_t SLAB_DESCRIPTOR_MARKER = 0x17;
+constexpr size_t SLAB_DESCRIPTOR_SIZE = 1 + 4 * sizeof(uint32_t);
+
+struct SlabDescriptor {
+    uint32_t slab;
+    uint32_t offset;     // Byte offset of the record within the slab
+    uint32_t length;     // Record size in bytes
+    uint32_t generation; // Slab generation when it was acquired; detects stale descriptors
+};
+
+/**
+ * @brief Returns true if a received record is a slab descriptor rather than an encoded record.
+ */
+inline bool IsSlabDescriptor(const char* buffer, size_t size) {
+    return size > 0 && static_cast<uint8_t>(buffer[0]) == SLAB_DESCRIPTOR_MARKER;
+}
+
+void EncodeSlabDescriptor(const SlabDescriptor& descriptor, char* out);
+SlabDescriptor DecodeSlabDescriptor(const char* buffer, size_t size);
+
+/**
+ * @brief Pool of fixed-size slabs in POSIX shared memory for records larger than one message.
+ *
+ * The receiver creates the pool once and every sender maps it once, so a large
+ * record costs no `shm_open` and no copy: the sender encodes it straight into a
+ * free slab and queues only a descriptor, and the receiver decodes it straight
+ * from its own mapping and then releases the slab. Slabs are claimed with a CAS
+ * on their state word, so any number of senders can share one pool.
+ */
+class SlabPool {
+public:
+    // Constructors
+    SlabPool(const std::string& name, bool create);
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // Producer side
+    char* TryAcquire(size_t length, SlabDescriptor& descriptor);
+
+    // Consumer side
+    std::string_view Resolve(const SlabDescriptor& descriptor) const;
+    void Release(const SlabDescriptor& descriptor);
+
+    static void Unlink(const std::string& name);
+
+    // Getters
+    size_t InUse() const;
+    bool Replaced(const std::string& name) const;
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Per-slab state, one cache line each so senders claiming neighbouring slabs do not contend
+    struct alignas(CACHE_LINE_SIZE) SlabState {
+        std::atomic<uint32_t> busy;       // 1 from TryAcquire until Release
+        std::atomic<uint32_t> generation; // Bumped on every acquire
+    };
+
+    // Layout of the mapped segment; the slab data follows the state array
+    struct Header {
+        uint32_t magic;
+        uint32_t slabCount;
+        uint32_t slabSize;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> cursor; // Where the next acquire starts looking
+    };
+
+    Header* header_;
+    SlabState* states_;
+    char* data_;
+    size_t mappedSize_;
+    int fd_;
+
+    // Helper methods
+    bool Matches(const SlabDescriptor& descriptor) const;
+};
+
+/**
+ * @brief Scoped access to the bytes of one received record, resolving slab descriptors.
+ *
+ * For an ordinary record `View` is the record itself. For a slab descriptor it
+ * is the record in the mapped slab, and the slab is released when the
+ * `SlabRecord` goes out of scope, so decode the record before then.
+ */
+class SlabRecord {
+public:
+    // Constructors
+    SlabRecord(SlabPool* pool, std::string_view record);
+    ~SlabRecord();
+
+    SlabRecord(const SlabRecord&) = delete;
+    SlabRecord& operator=(const SlabRecord&) = delete;
+
+    // Getters
+    std::string_view View() const { return view_; }
+
+private:
+    SlabPool* pool_;           // Null unless a slab has to be released
+    SlabDescriptor descriptor_;
+    std::string_view view_;
+};
+
+#endif // SLAB_POOL_H
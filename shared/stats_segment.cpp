@@ -0,0 +1,203 @@
+#include "stats_segment.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "constants.h"
+
+namespace {
+    // Marks a segment whose block has been fully initialized by the creator
+    constexpr uint32_t STATS_MAGIC = 0x49505353; // "IPSS"
+    constexpr uint32_t STATS_VERSION = 4;
+
+    // Where POSIX shared memory objects appear on Linux
+    constexpr const char* SHM_DIRECTORY = "/dev/shm";
+
+    const char* const STAT_NAMES[STAT_COUNT] = {
+        "messages_sent",
+        "bytes_sent",
+        "send_full",
+        "send_blocked_ns",
+        "messages_received",
+        "bytes_received",
+        "records_received",
+        "parse_failures",
+        "enum_rejections",
+        "messages_lost",
+        "messages_truncated",
+        "queue_depth",
+        "queue_capacity"
+    };
+
+    const char* const STAT_HELP[STAT_COUNT] = {
+        "Messages handed to the queue or ring.",
+        "Bytes handed to the queue or ring.",
+        "Send attempts that found the queue or ring full.",
+        "Nanoseconds spent waiting for room in a full queue or ring.",
+        "Messages taken off the queue or ring.",
+        "Bytes taken off the queue or ring.",
+        "Records handled; a batch message carries several.",
+        "Messages that failed to parse as IPCData.",
+        "Messages rejected for an out-of-range the_type.",
+        "Broadcast messages overwritten before the subscriber read them.",
+        "Socket messages dropped for being larger than the receive buffer.",
+        "Messages waiting in the receive queues when last sampled.",
+        "Total depth of the receive queues."
+    };
+}
+
+std::atomic<StatsSegment*> stats::current { nullptr };
+
+/**
+ * @brief Constructor that maps (and optionally creates) a stats segment.
+ *
+ * @param name POSIX shared-memory name, normally from `StatsSegmentName`.
+ * @param create True to create a fresh segment with zeroed counters (replacing
+ *               any leftover), false to attach read-only to an existing one.
+ * @param role Short label shown by `ipc_stat`, e.g. "rx"; only used when creating.
+ * @throws std::runtime_error if the segment cannot be opened, sized, mapped or validated.
+ */
+StatsSegment::StatsSegment(const std::string& name, bool create, const std::string& role)
+    : block_(nullptr), fd_(-1) {
+    if (create) {
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, QUEUE_PERMISSIONS);
+    } else {
+        fd_ = shm_open(name.c_str(), O_RDONLY, 0);
+    }
+    if (fd_ == -1) {
+        throw std::runtime_error("Failed to open stats segment " + name);
+    }
+
+    struct stat st;
+    if ((create && ftruncate(fd_, sizeof(Block)) == -1) ||
+        (!create && (fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Block)))) {
+        close(fd_);
+        throw std::runtime_error("Stats segment " + name + " is not initialized");
+    }
+
+    void* addr = mmap(nullptr, sizeof(Block), create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map stats segment " + name);
+    }
+    block_ = static_cast<Block*>(addr);
+
+    if (create) {
+        // A fresh mapping is zero-filled, so the counters already start at zero
+        block_->version = STATS_VERSION;
+        block_->pid = static_cast<uint32_t>(getpid());
+        std::strncpy(block_->role, role.c_str(), sizeof(block_->role) - 1);
+        std::atomic_thread_fence(std::memory_order_release);
+        block_->magic = STATS_MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block_->magic != STATS_MAGIC || block_->version != STATS_VERSION) {
+            munmap(addr, sizeof(Block));
+            close(fd_);
+            throw std::runtime_error("Stats segment " + name + " is not initialized");
+        }
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unpublishes the segment if it is the process-wide one, then unmaps it
+ * (the segment itself is left in place; see `Unlink`).
+ */
+StatsSegment::~StatsSegment() {
+    StatsSegment* self = this;
+    stats::current.compare_exchange_strong(self, nullptr);
+    munmap(block_, sizeof(Block));
+    close(fd_);
+}
+
+/**
+ * @brief Removes a stats segment by name.
+ */
+void StatsSegment::Unlink(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+/**
+ * @brief Returns the names of all stats segments on this host, in name order.
+ */
+std::vector<std::string> StatsSegment::List() {
+    const std::string prefix = std::string(STATS_SEGMENT_PREFIX + 1) + "."; // Without the leading '/'
+    std::vector<std::string> names;
+    if (DIR* directory = opendir(SHM_DIRECTORY)) {
+        while (dirent* entry = readdir(directory)) {
+            if (std::strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0) {
+                names.push_back("/" + std::string(entry->d_name));
+            }
+        }
+        closedir(directory);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * @brief Returns false if the process that created the segment has exited without removing it.
+ */
+bool StatsSegment::Alive() const {
+    return kill(Pid(), 0) == 0 || errno == EPERM;
+}
+
+/**
+ * @brief Returns the snake_case name of a counter, as used by `ipc_stat`.
+ */
+const char* StatsSegment::Name(Stat stat) {
+    return STAT_NAMES[static_cast<size_t>(stat)];
+}
+
+/**
+ * @brief Returns a one-line description of a counter, used as its Prometheus `# HELP` text.
+ */
+const char* StatsSegment::Help(Stat stat) {
+    return STAT_HELP[static_cast<size_t>(stat)];
+}
+
+/**
+ * @brief Returns true for counters that hold a sampled value rather than a running total.
+ */
+bool StatsSegment::IsGauge(Stat stat) {
+    return stat == Stat::QueueDepth || stat == Stat::QueueCapacity;
+}
+
+/**
+ * @brief Returns the stats segment name for a process, e.g. "/ipc_stats.rx.1234".
+ */
+std::string StatsSegmentName(const std::string& role, pid_t pid) {
+    return std::string(STATS_SEGMENT_PREFIX) + "." + role + "." + std::to_string(pid);
+}
+
+/**
+ * @brief Formats the counters of several segments in the Prometheus text exposition format.
+ *
+ * Each counter becomes one metric, `ipc_<name>_total` for running totals and
+ * `ipc_<name>` for gauges, with one sample per segment labelled by its role and pid.
+ */
+std::string FormatPrometheus(const std::vector<const StatsSegment*>& segments) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < STAT_COUNT; ++i) {
+        const Stat stat = static_cast<Stat>(i);
+        const bool gauge = StatsSegment::IsGauge(stat);
+        const std::string metric = std::string("ipc_") + StatsSegment::Name(stat) + (gauge ? "" : "_total");
+        oss << "# HELP " << metric << ' ' << StatsSegment::Help(stat) << '\n'
+            << "# TYPE " << metric << (gauge ? " gauge" : " counter") << '\n';
+        for (const StatsSegment* segment : segments) {
+            oss << metric << "{role=\"" << segment->Role() << "\",pid=\"" << segment->Pid() << "\"} "
+                << segment->Get(stat) << '\n';
+        }
+    }
+    return oss.str();
+}
@@ -0,0 +1,115 @@
+#ifndef STATS_SEGMENT_H
+#define STATS_SEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Counters published in a stats segment
+enum class Stat : uint32_t {
+    MessagesSent,      // Messages handed to the queue or ring
+    BytesSent,
+    SendFull,          // Send attempts that found the queue or ring full (EAGAIN)
+    SendBlockedNs,     // Time spent waiting for room after finding it full
+    MessagesReceived,  // Messages taken off the queue or ring
+    BytesReceived,
+    RecordsReceived,   // Records handled (a batch message carries several)
+    ParseFailures,     // Messages that failed to parse as IPCData
+    EnumRejections,    // Messages rejected for an out-of-range `the_type`
+    MessagesLost,      // Broadcast messages overwritten before this subscriber read them
+    MessagesTruncated, // Socket messages dropped for being larger than the receive buffer
+    QueueDepth,        // Gauge: messages waiting in the receive queues when last sampled
+    QueueCapacity,     // Gauge: total depth of the receive queues
+    COUNT
+};
+
+constexpr size_t STAT_COUNT = static_cast<size_t>(Stat::COUNT);
+
+/**
+ * @brief Small shared-memory block of live counters that a process publishes for `ipc_stat`.
+ *
+ * Each process creates its own segment, named after its role and pid (see
+ * `StatsSegmentName`), and removes it on exit. Updating a counter is one
+ * relaxed atomic add on the mapped block; readers attach read-only and may
+ * see counters mid-update relative to each other, never torn values. Each
+ * counter has a cache line to itself, so threads updating different
+ * counters (e.g. the sender and the receive pool) do not contend.
+ */
+class StatsSegment {
+public:
+    // Constructors
+    StatsSegment(const std::string& name, bool create, const std::string& role = "");
+    ~StatsSegment();
+
+    StatsSegment(const StatsSegment&) = delete;
+    StatsSegment& operator=(const StatsSegment&) = delete;
+
+    // Methods
+    void Add(Stat stat, uint64_t value = 1) { Counter(stat).fetch_add(value, std::memory_order_relaxed); }
+    void Set(Stat stat, uint64_t value) { Counter(stat).store(value, std::memory_order_relaxed); }
+    static void Unlink(const std::string& name);
+    static std::vector<std::string> List();
+
+    // Getters
+    uint64_t Get(Stat stat) const { return Counter(stat).load(std::memory_order_relaxed); }
+    pid_t Pid() const { return static_cast<pid_t>(block_->pid); }
+    std::string Role() const { return block_->role; }
+    bool Alive() const;
+    static const char* Name(Stat stat);
+    static const char* Help(Stat stat);
+    static bool IsGauge(Stat stat);
+
+private:
+    // One counter per cache line
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value;
+    };
+
+    // Layout of the mapped segment
+    struct Block {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t pid;
+        char role[20];
+        Slot counters[STAT_COUNT];
+    };
+
+    Block* block_;
+    int fd_;
+
+    // Helper methods
+    std::atomic<uint64_t>& Counter(Stat stat) const { return block_->counters[static_cast<size_t>(stat)].value; }
+};
+
+std::string StatsSegmentName(const std::string& role, pid_t pid);
+std::string FormatPrometheus(const std::vector<const StatsSegment*>& segments);
+
+/*
+    Process-wide stats segment.
+
+    Library code (the sender, the parsers) reports through `stats::Add`, which
+    is a no-op until the application publishes a segment, so tests and tools
+    that never create one pay only a predictable branch.
+*/
+namespace stats {
+    extern std::atomic<StatsSegment*> current;
+
+    inline void Publish(StatsSegment* segment) { current.store(segment, std::memory_order_release); }
+
+    inline void Add(Stat stat, uint64_t value = 1) {
+        if (StatsSegment* segment = current.load(std::memory_order_relaxed)) {
+            segment->Add(stat, value);
+        }
+    }
+
+    inline void Set(Stat stat, uint64_t value) {
+        if (StatsSegment* segment = current.load(std::memory_order_relaxed)) {
+            segment->Set(stat, value);
+        }
+    }
+}
+
+#endif // STATS_SEGMENT_H
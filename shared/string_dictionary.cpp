@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include "string_dictionary.h"
+
+namespace {
+    // Shortest shared prefix worth a reference; below this the ref and prefix fields cost more than they save
+    constexpr size_t MIN_PREFIX_LENGTH = 6;
+
+    void checkCapacity(size_t capacity) {
+        if (capacity < 2) {
+            throw std::invalid_argument("String dictionary capacity must be at least 2.");
+        }
+    }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param stream Identifies this dictionary to the receiver, normally from
+ *               `ControlSegment::AllocateDictionaryStream`; 0 picks a random id,
+ *               which another sender may also pick (the decoder then rejects
+ *               both senders' records rather than mixing their entries up).
+ * @param capacity Entries kept; must match the receiver's decoder.
+ * @throws std::invalid_argument if `capacity` is below 2.
+ */
+StringDictionaryEncoder::StringDictionaryEncoder(uint32_t stream, size_t capacity)
+    : stream_(stream), epoch_(1), nextId_(0), entries_(capacity) {
+    checkCapacity(capacity);
+    if (stream_ == 0) {
+        std::random_device random;
+        stream_ = std::uniform_int_distribution<uint32_t>(1, STRING_DICTIONARY_MAX_STREAM)(random);
+    }
+    index_.reserve(capacity);
+}
+
+/**
+ * @brief Decides how to send `text` and updates the dictionary as if it had been sent.
+ *
+ * Strings longer than `STRING_DICTIONARY_MAX_LENGTH` are never stored and
+ * come back as a plain literal.
+ *
+ * @param text The record's string.
+ * @return The coding; `literal` points into `text`.
+ */
+StringCoding StringDictionaryEncoder::Encode(std::string_view text) {
+    StringCoding coding;
+    if (text.size() > STRING_DICTIONARY_MAX_LENGTH) {
+        coding.literal = text;
+        return coding;
+    }
+
+    auto hit = index_.find(text);
+    if (hit != index_.end()) {
+        coding.ref = hit->second;
+        return coding;
+    }
+
+    if (nextId_ == std::numeric_limits<uint32_t>::max()) {
+        Reset();
+    }
+
+    // Send only the suffix if the new string extends a long prefix of the last one defined
+    coding.literal = text;
+    if (lastDefined_) {
+        const std::string& previous = entries_[*lastDefined_ % entries_.size()];
+        const size_t limit = std::min(previous.size(), text.size());
+        const size_t common = static_cast<size_t>(std::mismatch(text.begin(), text.begin() + limit, previous.begin()).first - text.begin());
+        if (common >= MIN_PREFIX_LENGTH) {
+            coding.ref = *lastDefined_;
+            coding.prefix = static_cast<uint32_t>(common);
+            coding.literal = text.substr(common);
+        }
+    }
+
+    // Define it in the oldest slot, which also retires the entry `capacity` ids back
+    const uint32_t id = nextId_++;
+    std::string& slot = entries_[id % entries_.size()];
+    if (id >= entries_.size()) {
+        index_.erase(slot);
+    }
+    slot.assign(text.data(), text.size());
+    index_.emplace(slot, id);
+    lastDefined_ = id;
+    coding.define = id;
+    return coding;
+}
+
+/**
+ * @brief Forgets every entry and starts a new epoch.
+ *
+ * Call whenever the receiver may have missed a message from this stream
+ * (a dropped or failed send) or asked for a reset.
+ */
+void StringDictionaryEncoder::Reset() {
+    index_.clear();
+    for (std::string& entry : entries_) {
+        entry.clear();
+    }
+    nextId_ = 0;
+    lastDefined_.reset();
+    ++epoch_;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param onMissing Called when a record refers to an entry that is not in the
+ *                  table, so the sender can be asked to reset; may be empty.
+ * @param capacity Entries kept per stream; must match the senders' encoders.
+ * @throws std::invalid_argument if `capacity` is below 2.
+ */
+StringDictionaryDecoder::StringDictionaryDecoder(ResetRequest onMissing, size_t capacity)
+    : onMissing_(std::move(onMissing)), capacity_(capacity), clock_(0), missing_(0) {
+    checkCapacity(capacity);
+    scratch_.reserve(STRING_DICTIONARY_MAX_LENGTH);
+}
+
+/**
+ * @brief Rebuilds the string of a dictionary-coded record and points `view` at it.
+ *
+ * Records without dictionary fields are left untouched. A definition is
+ * stored before returning, so the view's string stays valid until the next
+ * call on this decoder.
+ *
+ * @param view A parsed record; updated in place.
+ * @throws std::runtime_error if the record refers to an entry the table does
+ *         not have (the record cannot be decoded), its fields are inconsistent,
+ *         or its stream is shared by two senders (see `ReportConflict`).
+ */
+void StringDictionaryDecoder::Resolve(IPCDataView& view) {
+    const std::optional<uint32_t> ref = view.GetStringRef();
+    const std::optional<uint32_t> define = view.GetStringDefine();
+    if (!ref && !define) {
+        return;
+    }
+    auto streamId = view.GetDictStream();
+    if (!streamId) {
+        throw std::runtime_error("Dictionary-coded IPCData message has no dict_stream.");
+    }
+    Stream& stream = StreamFor(*streamId, view.GetDictEpoch().value_or(0));
+    if (stream.conflicted) {
+        throw std::runtime_error("String dictionary stream " + std::to_string(*streamId) + " is used by more than one sender.");
+    }
+
+    std::string_view text = view.GetTheString().value_or(std::string_view());
+    if (ref) {
+        const Entry* entry = Find(stream, *ref);
+        if (!entry) {
+            ReportMissing(stream, *ref);
+        }
+        if (auto prefix = view.GetStringPrefix()) {
+            if (*prefix > entry->text.size()) {
+                throw std::runtime_error("String dictionary prefix is longer than its entry.");
+            }
+            scratch_.assign(entry->text, 0, *prefix);
+            scratch_.append(text);
+            text = scratch_;
+        } else {
+            text = entry->text;
+        }
+    }
+
+    if (define) {
+        if (text.size() > STRING_DICTIONARY_MAX_LENGTH) {
+            throw std::runtime_error("String dictionary entry exceeds STRING_DICTIONARY_MAX_LENGTH.");
+        }
+        Entry& slot = stream.entries[*define % capacity_];
+        if (slot.valid && slot.id == *define) {
+            ReportConflict(stream, *define);
+        }
+        slot.text.assign(text.data(), text.size());
+        slot.id = *define;
+        slot.valid = true;
+        text = slot.text;
+    }
+
+    view.SetTheString(text);
+}
+
+/* -----------------------------------------
+   Private Helper Methods
+   ----------------------------------------- */
+
+/**
+ * @brief Returns the table for a stream, clearing it when the sender has moved to a new epoch.
+ *
+ * An unknown stream replaces the least recently used one once `MAX_STREAMS` are tracked.
+ */
+StringDictionaryDecoder::Stream& StringDictionaryDecoder::StreamFor(uint32_t streamId, uint32_t epoch) {
+    ++clock_;
+    auto found = std::find_if(streams_.begin(), streams_.end(), [&](const Stream& s) { return s.stream == streamId; });
+    if (found == streams_.end()) {
+        if (streams_.size() < MAX_STREAMS) {
+            streams_.emplace_back();
+            found = streams_.end() - 1;
+            found->entries.resize(capacity_);
+        } else {
+            found = std::min_element(streams_.begin(), streams_.end(),
+                                     [](const Stream& a, const Stream& b) { return a.lastUsed < b.lastUsed; });
+        }
+        found->stream = streamId;
+        found->epoch = epoch + 1; // Forces the reset below
+    }
+
+    // Messages of one stream arrive in order, so any change of epoch means the sender started over
+    if (found->epoch != epoch) {
+        found->epoch = epoch;
+        found->resetRequested = false;
+        found->conflicted = false;
+        for (Entry& entry : found->entries) {
+            entry.valid = false;
+        }
+    }
+    found->lastUsed = clock_;
+    return *found;
+}
+
+const StringDictionaryDecoder::Entry* StringDictionaryDecoder::Find(const Stream& stream, uint32_t id) const {
+    const Entry& entry = stream.entries[id % capacity_];
+    return entry.valid && entry.id == id ? &entry : nullptr;
+}
+
+/**
+ * @brief Rejects a stream whose entry was defined a second time in one epoch, and throws.
+ *
+ * One encoder never defines an id twice per epoch, so the stream id must be
+ * shared by two senders whose entries cannot be told apart. Every record of
+ * the stream is rejected until its epoch changes.
+ */
+void StringDictionaryDecoder::ReportConflict(Stream& stream, uint32_t id) {
+    stream.conflicted = true;
+    for (Entry& entry : stream.entries) {
+        entry.valid = false;
+    }
+    if (!stream.resetRequested && onMissing_) {
+        stream.resetRequested = true;
+        onMissing_();
+    }
+    throw std::runtime_error("String dictionary entry " + std::to_string(id) + " of stream " +
+                             std::to_string(stream.stream) + " was defined twice; two senders share the stream id.");
+}
+
+/**
+ * @brief Counts a reference to a missing entry, asks for a reset once per epoch, and throws.
+ */
+void StringDictionaryDecoder::ReportMissing(Stream& stream, uint32_t id) {
+    ++missing_;
+    if (!stream.resetRequested && onMissing_) {
+        stream.resetRequested = true;
+        onMissing_();
+    }
+    throw std::runtime_error("IPCData message refers to unknown string dictionary entry " + std::to_string(id) + ".");
+}
@@ -0,0 +1,121 @@
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "constants.h"
+#include "ipc_data_view.h"
+
+// How one string is sent against a StringDictionaryEncoder; maps onto IPCData's dictionary fields
+struct StringCoding {
+    std::optional<uint32_t> ref;    // The string (or its first `prefix` bytes) is this entry
+    uint32_t prefix = 0;            // With `ref`: bytes of the entry to use, followed by `literal`; 0 = the whole entry
+    std::string_view literal;       // Sent as the_string: the whole string, or the suffix after the prefix
+    std::optional<uint32_t> define; // The receiver stores the resolved string as this entry
+};
+
+/**
+ * @brief Sender half of the per-stream string dictionary.
+ *
+ * The first time a string is sent it is defined as the next entry id and
+ * sent in full (or as a suffix of the previously defined string, when the two
+ * share a long prefix, as consecutive timestamps do). Later sends of the same
+ * string carry only the id. Ids are never reused within an epoch, and only the
+ * last `capacity` ids stay usable on both sides, so the receiver's copy needs
+ * no eviction messages: a string that drops out of the window is simply
+ * defined again. `Reset` starts a new epoch with an empty dictionary.
+ *
+ * The receiver must see every message of the stream, in order; see
+ * `StringDictionaryDecoder`.
+ */
+class StringDictionaryEncoder {
+public:
+    // Constructors
+    explicit StringDictionaryEncoder(uint32_t stream = 0, size_t capacity = STRING_DICTIONARY_ENTRIES);
+
+    StringDictionaryEncoder(const StringDictionaryEncoder&) = delete;
+    StringDictionaryEncoder& operator=(const StringDictionaryEncoder&) = delete;
+
+    // Methods
+    StringCoding Encode(std::string_view text);
+    void Reset();
+
+    // Getters
+    uint32_t Stream() const { return stream_; }
+    uint32_t Epoch() const { return epoch_; }
+
+private:
+    // Members
+    uint32_t stream_;
+    uint32_t epoch_;
+    uint32_t nextId_;
+    std::optional<uint32_t> lastDefined_; // Prefix candidate for the next new string
+    std::vector<std::string> entries_;    // Entry `id` lives in slot `id % capacity`
+    std::unordered_map<std::string_view, uint32_t> index_; // Keys point into `entries_`
+};
+
+/**
+ * @brief Receiver half of the string dictionary: a copy of each sender stream's table.
+ *
+ * `Resolve` rebuilds a dictionary-coded record's string and points the view
+ * at it. A string that is a whole entry is read straight from the table, so
+ * hot strings cost no copy and no allocation. Tables are kept for up to
+ * `MAX_STREAMS` streams and follow the sender's epoch; a record from a new
+ * epoch clears its stream's table.
+ *
+ * Not thread-safe; use one decoder per in-order receive path.
+ */
+class StringDictionaryDecoder {
+public:
+    // Called when a record refers to an entry this decoder does not have (at most once per stream epoch)
+    using ResetRequest = std::function<void()>;
+
+    static constexpr size_t MAX_STREAMS = 16;
+
+    // Constructors
+    explicit StringDictionaryDecoder(ResetRequest onMissing = nullptr, size_t capacity = STRING_DICTIONARY_ENTRIES);
+
+    // Methods
+    void Resolve(IPCDataView& view);
+
+    // Getters
+    uint64_t Missing() const { return missing_; }
+
+private:
+    struct Entry {
+        uint32_t id = 0;
+        bool valid = false;
+        std::string text;
+    };
+
+    struct Stream {
+        uint32_t stream = 0;
+        uint32_t epoch = 0;
+        bool resetRequested = false;
+        bool conflicted = false; // Two senders defined entries under this stream id in this epoch
+        uint64_t lastUsed = 0;
+        std::vector<Entry> entries;
+    };
+
+    // Members
+    ResetRequest onMissing_;
+    size_t capacity_;
+    std::vector<Stream> streams_;
+    std::string scratch_;  // Prefix + suffix strings are assembled here
+    uint64_t clock_;       // Orders stream use, to evict the least recently used stream
+    uint64_t missing_;
+
+    // Helper methods
+    Stream& StreamFor(uint32_t stream, uint32_t epoch);
+    const Entry* Find(const Stream& stream, uint32_t id) const;
+    [[noreturn]] void ReportMissing(Stream& stream, uint32_t id);
+    [[noreturn]] void ReportConflict(Stream& stream, uint32_t id);
+};
+
+#endif // STRING_DICTIONARY_H
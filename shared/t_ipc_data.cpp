@@ -2,15 +2,25 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include "t_ipc_data.h"
+#include "flat_codec.h"
+#include "stats_segment.h"
+
+namespace {
+    // A batch of records should share cache lines, not spill across them
+    static_assert(sizeof(T_IPCData) <= 64, "T_IPCData should fit in one cache line");
+    static_assert(std::is_nothrow_move_constructible_v<T_IPCData>, "Moving a T_IPCData must not allocate");
+}
 
 /**
  * @brief Default constructor.
  * 
- * Initializes all fields to unset (nullopt).
+ * Initializes all fields to unset.
  */
 T_IPCData::T_IPCData()
-    : theInt_(std::nullopt), theFloat_(std::nullopt), theString_(std::nullopt), theType_(std::nullopt) { }
+    : sendTimeNs_(0), sequence_(0), theInt_(0), theFloat_(0.0f), theType_(0), present_(0) { }
 
 /**
  * @brief Constructor from a serialized string.
@@ -20,19 +30,68 @@ T_IPCData::T_IPCData()
  * @param serializedMessage A string representing the serialized data.
  * @throws std::runtime_error if deserialization fails.
  */
-T_IPCData::T_IPCData(const std::string& serializedMessage) {
-    IPCData proto = FromProtobuf(serializedMessage);
+T_IPCData::T_IPCData(const std::string& serializedMessage)
+    : T_IPCData(serializedMessage.data(), serializedMessage.size()) { }
+
+/**
+ * @brief Constructor from a serialized buffer.
+ * 
+ * Parses directly from the caller's buffer (e.g. a receive buffer), so no
+ * intermediate `std::string` copy of the message is needed. The codec is
+ * detected from the first byte: flat frames (see `flat_codec.h`) start with
+ * a marker that no protobuf message can start with.
+ * 
+ * @param data Pointer to the serialized data.
+ * @param size Number of serialized bytes.
+ * @throws std::runtime_error if deserialization fails, or the message refers to
+ *         a string dictionary entry (decode those through `StringDictionaryDecoder`).
+ */
+T_IPCData::T_IPCData(const char* data, size_t size) : T_IPCData() {
+    if (flat::IsFlatFrame(data, size)) {
+        *this = T_IPCData(IPCDataView(data, size));
+        return;
+    }
+
+    const IPCData& proto = FromProtobuf(data, size);
+    if (proto.has_string_ref()) {
+        throw std::runtime_error("IPCData message refers to a string dictionary entry; resolve it with a StringDictionaryDecoder.");
+    }
+
+    if (proto.has_the_int())      { theInt_ = proto.the_int();                            present_ |= HAS_INT; }
+    if (proto.has_the_float())    { theFloat_ = proto.the_float();                        present_ |= HAS_FLOAT; }
+    if (proto.has_the_string())   { theString_.assign(proto.the_string());                present_ |= HAS_STRING; }
+    if (proto.has_the_type())     { theType_ = static_cast<uint8_t>(proto.the_type());    present_ |= HAS_TYPE; }
+    if (proto.has_send_time_ns()) { sendTimeNs_ = proto.send_time_ns();                   present_ |= HAS_SEND_TIME; }
+    if (proto.has_sequence())     { sequence_ = proto.sequence();                         present_ |= HAS_SEQUENCE; }
+}
+
+/**
+ * @brief Constructor from an in-place view of a serialized message.
+ * 
+ * Copies the view's fields into an owning object, e.g. when a record must
+ * outlive the receive buffer it was parsed from.
+ * 
+ * @param view A parsed `IPCDataView`.
+ * @throws std::runtime_error if the view still refers to an unresolved string dictionary entry.
+ */
+T_IPCData::T_IPCData(const IPCDataView& view) : T_IPCData() {
+    if (view.GetStringRef()) {
+        throw std::runtime_error("IPCData message refers to a string dictionary entry; resolve it with a StringDictionaryDecoder.");
+    }
 
-    theInt_    = proto.has_the_int()    ? std::optional<int>(proto.the_int())            : std::nullopt;
-    theFloat_  = proto.has_the_float()  ? std::optional<float>(proto.the_float())        : std::nullopt;
-    theString_ = proto.has_the_string() ? std::optional<std::string>(proto.the_string()) : std::nullopt;
-    theType_   = proto.has_the_type()   ? std::optional<IPCData::Type>(proto.the_type()) : std::nullopt;
+    if (auto value = view.GetTheInt())     { theInt_ = *value;                        present_ |= HAS_INT; }
+    if (auto value = view.GetTheFloat())   { theFloat_ = *value;                      present_ |= HAS_FLOAT; }
+    if (auto value = view.GetTheString())  { theString_.assign(*value);               present_ |= HAS_STRING; }
+    if (auto value = view.GetTheType())    { theType_ = static_cast<uint8_t>(*value); present_ |= HAS_TYPE; }
+    if (auto value = view.GetSendTimeNs()) { sendTimeNs_ = *value;                    present_ |= HAS_SEND_TIME; }
+    if (auto value = view.GetSequence())   { sequence_ = *value;                      present_ |= HAS_SEQUENCE; }
 }
 
 /**
  * @brief Constructor from individual fields.
  * 
- * Initializes the object with the provided values.
+ * Initializes the object with the provided values. The string is moved in,
+ * so passing a temporary costs no extra copy.
  * 
  * @param theInt Optional integer value.
  * @param theFloat Optional floating-point value.
@@ -43,7 +102,12 @@ T_IPCData::T_IPCData(std::optional<int> theInt,
                      std::optional<float> theFloat,
                      std::optional<std::string> theString,
                      std::optional<IPCData::Type> theType)
-    : theInt_(theInt), theFloat_(theFloat), theString_(theString), theType_(theType) { }
+    : T_IPCData() {
+    if (theInt)    { theInt_ = *theInt;                         present_ |= HAS_INT; }
+    if (theFloat)  { theFloat_ = *theFloat;                     present_ |= HAS_FLOAT; }
+    if (theString) { theString_ = std::move(*theString);        present_ |= HAS_STRING; }
+    if (theType)   { theType_ = static_cast<uint8_t>(*theType); present_ |= HAS_TYPE; }
+}
 
 /**
  * @brief Serializes the object into a string.
@@ -59,25 +123,139 @@ std::string T_IPCData::Serialize() const {
     return serialized;
 }
 
+/**
+ * @brief Serializes the object into a string using the flat wire format.
+ */
+std::string T_IPCData::SerializeFlat() const {
+    std::string serialized(flat::EncodedSize(*this), '\0');
+    flat::Encode(*this, serialized.data(), serialized.size());
+    return serialized;
+}
+
+/**
+ * @brief Copies the object into an existing Protobuf message.
+ * 
+ * Clears the message first, then sets only the fields that are present.
+ * Reusing the same message across calls lets Protobuf keep the string
+ * field's capacity, so the steady state does not allocate.
+ * 
+ * @param proto The Protobuf message to overwrite.
+ */
+void T_IPCData::FillProtobuf(IPCData& proto) const {
+    proto.Clear();
+
+    if (Has(HAS_INT))    proto.set_the_int(theInt_);
+    if (Has(HAS_FLOAT))  proto.set_the_float(theFloat_);
+    if (Has(HAS_STRING)) proto.set_the_string(theString_);
+    if (Has(HAS_TYPE))   proto.set_the_type(static_cast<IPCData::Type>(theType_));
+
+    if (Has(HAS_SEND_TIME)) proto.set_send_time_ns(sendTimeNs_);
+    if (Has(HAS_SEQUENCE))  proto.set_sequence(sequence_);
+}
+
+/**
+ * @brief Attaches latency-tracing fields to the object.
+ * 
+ * Normally stamped by `Sender` at send time; exposed so relayed or replayed
+ * records can carry their original values.
+ * 
+ * @param sendTimeNs `CLOCK_MONOTONIC` send time in nanoseconds.
+ * @param sequence Per-sender message sequence number.
+ */
+void T_IPCData::SetTrace(uint64_t sendTimeNs, uint64_t sequence) {
+    sendTimeNs_ = sendTimeNs;
+    sequence_ = sequence;
+    present_ |= HAS_SEND_TIME | HAS_SEQUENCE;
+}
+
 /**
  * @brief Converts the object into a human-readable string.
  */
 std::string T_IPCData::ToString() const {
     std::ostringstream oss;
 
-    oss << "  Int:    " << (theInt_    ? std::to_string(*theInt_)                    : "Not set") << '\n';
-    oss << "  Float:  " << (theFloat_  ? std::to_string(*theFloat_)                  : "Not set") << '\n';
-    oss << "  String: " << (theString_ ? *theString_                                 : "Not set") << '\n';
-    oss << "  Type:   " << (theType_   ? std::to_string(static_cast<int>(*theType_)) : "Not set") << '\n';
+    oss << "  Int:    " << (Has(HAS_INT)    ? std::to_string(theInt_)                    : "Not set") << '\n';
+    oss << "  Float:  " << (Has(HAS_FLOAT)  ? std::to_string(theFloat_)                  : "Not set") << '\n';
+    oss << "  String: " << (Has(HAS_STRING) ? theString_                                 : "Not set") << '\n';
+    oss << "  Type:   " << (Has(HAS_TYPE)   ? std::to_string(static_cast<int>(theType_)) : "Not set") << '\n';
+
+    // Tracing fields are only shown when the sender stamped them
+    if (Has(HAS_SEQUENCE)) oss << "  Seq:    " << sequence_ << '\n';
 
     return oss.str();
 }
 
 // Getters
-std::optional<int> T_IPCData::GetTheInt() const { return theInt_; }
-std::optional<float> T_IPCData::GetTheFloat() const { return theFloat_; }
-std::optional<std::string> T_IPCData::GetTheString() const { return theString_; }
-std::optional<IPCData::Type> T_IPCData::GetTheType() const { return theType_; }
+std::optional<int> T_IPCData::GetTheInt() const {
+    return Has(HAS_INT) ? std::optional<int>(theInt_) : std::nullopt;
+}
+std::optional<float> T_IPCData::GetTheFloat() const {
+    return Has(HAS_FLOAT) ? std::optional<float>(theFloat_) : std::nullopt;
+}
+std::optional<std::string_view> T_IPCData::GetTheString() const {
+    return Has(HAS_STRING) ? std::optional<std::string_view>(theString_) : std::nullopt;
+}
+std::optional<IPCData::Type> T_IPCData::GetTheType() const {
+    return Has(HAS_TYPE) ? std::optional<IPCData::Type>(static_cast<IPCData::Type>(theType_)) : std::nullopt;
+}
+std::optional<uint64_t> T_IPCData::GetSendTimeNs() const {
+    return Has(HAS_SEND_TIME) ? std::optional<uint64_t>(sendTimeNs_) : std::nullopt;
+}
+std::optional<uint64_t> T_IPCData::GetSequence() const {
+    return Has(HAS_SEQUENCE) ? std::optional<uint64_t>(sequence_) : std::nullopt;
+}
+
+/* -----------------------------------------
+   Builder
+   ----------------------------------------- */
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheInt(int value) {
+    data_.theInt_ = value;
+    data_.present_ |= HAS_INT;
+    return *this;
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheFloat(float value) {
+    data_.theFloat_ = value;
+    data_.present_ |= HAS_FLOAT;
+    return *this;
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheString(std::string_view value) {
+    data_.theString_.assign(value.data(), value.size());
+    data_.present_ |= HAS_STRING;
+    return *this;
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheString(const char* value) {
+    return SetTheString(std::string_view(value));
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheString(std::string&& value) {
+    data_.theString_ = std::move(value);
+    data_.present_ |= HAS_STRING;
+    return *this;
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTheType(IPCData::Type value) {
+    data_.theType_ = static_cast<uint8_t>(value);
+    data_.present_ |= HAS_TYPE;
+    return *this;
+}
+
+T_IPCData::Builder& T_IPCData::Builder::SetTrace(uint64_t sendTimeNs, uint64_t sequence) {
+    data_.SetTrace(sendTimeNs, sequence);
+    return *this;
+}
+
+/**
+ * @brief Moves the built record out; the builder is left empty and may be reused.
+ */
+T_IPCData T_IPCData::Builder::Build() {
+    T_IPCData built = std::move(data_);
+    data_ = T_IPCData();
+    return built;
+}
 
 /* -----------------------------------------
    Private Helper Methods
@@ -85,27 +263,26 @@ std::optional<IPCData::Type> T_IPCData::GetTheType() const { return theType_; }
 
 IPCData T_IPCData::ToProtobuf() const {
     IPCData proto;
-
-    if (theInt_.has_value())    proto.set_the_int(theInt_.value());
-    if (theFloat_.has_value())  proto.set_the_float(theFloat_.value());
-    if (theString_.has_value()) proto.set_the_string(theString_.value());
-    if (theType_.has_value())   proto.set_the_type(theType_.value());
-
+    FillProtobuf(proto);
     return proto;
 }
 
 /**
  * @brief Creates a Protobuf object from serialized data.
  * 
- * Converts a serialized string into a Protobuf object for internal use.
+ * Parses into a per-thread recycled Protobuf object, so once its string field
+ * has grown to the largest value seen, parsing no longer allocates. The
+ * returned reference is only valid until the next call on the same thread.
  * 
- * @param serializedMessage A string representing the serialized data.
+ * @param data Pointer to the serialized data.
+ * @param size Number of serialized bytes.
  * @return A Protobuf object containing the deserialized data.
  * @throws std::runtime_error if parsing fails or the data is invalid.
  */
-IPCData T_IPCData::FromProtobuf(const std::string& serializedMessage) {
-    IPCData proto;
-    if (!proto.ParseFromString(serializedMessage)) {
+const IPCData& T_IPCData::FromProtobuf(const char* data, size_t size) {
+    thread_local IPCData proto;
+    if (!proto.ParseFromArray(data, static_cast<int>(size))) {
+        stats::Add(Stat::ParseFailures);
         throw std::runtime_error("Failed to parse IPCData message.");
     }
 
@@ -113,6 +290,7 @@ IPCData T_IPCData::FromProtobuf(const std::string& serializedMessage) {
     if (proto.has_the_type()) {
         int enumValue = proto.the_type();
         if (enumValue < IPCData::TYPE1 || enumValue > IPCData::TYPE3) {
+            stats::Add(Stat::EnumRejections);
             throw std::out_of_range("Enum value for 'theType' in IPCData is out of range.");
         }
     }
@@ -1,15 +1,22 @@
 #ifndef T_IPC_DATA_H
 #define T_IPC_DATA_H
 
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include "ipc_data.pb.h"
+#include "ipc_data_view.h"
 
 class T_IPCData {
 public:
+    class Builder;
+
     // Constructors
     T_IPCData();
     T_IPCData(const std::string& serializedMessage);
+    T_IPCData(const char* data, size_t size);
+    explicit T_IPCData(const IPCDataView& view);
     T_IPCData(std::optional<int> theInt,
               std::optional<float> theFloat,
               std::optional<std::string> theString,
@@ -18,23 +25,64 @@ public:
     // Methods
     std::string ToString() const;
     std::string Serialize() const;
+    std::string SerializeFlat() const;
+    void FillProtobuf(IPCData& proto) const;
+    void SetTrace(uint64_t sendTimeNs, uint64_t sequence);
 
     // Getters
     std::optional<int> GetTheInt() const;
     std::optional<float> GetTheFloat() const;
-    std::optional<std::string> GetTheString() const;
+    std::optional<std::string_view> GetTheString() const;
     std::optional<IPCData::Type> GetTheType() const;
+    std::optional<uint64_t> GetSendTimeNs() const;
+    std::optional<uint64_t> GetSequence() const;
 
 private:
+    // Presence bits, one per optional field
+    enum Field : uint8_t {
+        HAS_INT       = 1 << 0,
+        HAS_FLOAT     = 1 << 1,
+        HAS_STRING    = 1 << 2,
+        HAS_TYPE      = 1 << 3,
+        HAS_SEND_TIME = 1 << 4,
+        HAS_SEQUENCE  = 1 << 5
+    };
+
     // Members
-    std::optional<int> theInt_;
-    std::optional<float> theFloat_;
-    std::optional<std::string> theString_;
-    std::optional<IPCData::Type> theType_;
+    std::string theString_;  // Short strings live inline (SSO), so setting one never allocates
+    uint64_t sendTimeNs_;
+    uint64_t sequence_;
+    int32_t theInt_;
+    float theFloat_;
+    uint8_t theType_;
+    uint8_t present_;        // `Field` bits
 
     // Helper methods
+    bool Has(Field field) const { return (present_ & field) != 0; }
     IPCData ToProtobuf() const;
-    static IPCData FromProtobuf(const std::string& serializedMessage);
+    static const IPCData& FromProtobuf(const char* data, size_t size);
+};
+
+/**
+ * @brief Fluent construction of a `T_IPCData`, setting only the fields that are present.
+ *
+ * `Build` moves the record out, so a string set here is copied (or moved) once.
+ */
+class T_IPCData::Builder {
+public:
+    // Methods
+    Builder& SetTheInt(int value);
+    Builder& SetTheFloat(float value);
+    Builder& SetTheString(std::string_view value);
+    Builder& SetTheString(const char* value);
+    Builder& SetTheString(std::string&& value);
+    Builder& SetTheType(IPCData::Type value);
+    Builder& SetTrace(uint64_t sendTimeNs, uint64_t sequence);
+    T_IPCData Build();
+
+private:
+    // Members
+    T_IPCData data_;
 };
 
 #endif // T_IPC_DATA_H
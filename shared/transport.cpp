@@ -0,0 +1,297 @@
+#include "transport.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <poll.h>
+#include <stdexcept>
+#include "broadcast_ring.h"
+#include "io_uring_transport.h"
+#include "seqpacket_transport.h"
+#include "shm_ring.h"
+#include "stats_segment.h"
+
+namespace {
+    // An already-expired deadline: sends fail at once instead of waiting for room
+    constexpr timespec EXPIRED { 0, 0 };
+
+    int millisecondsUntil(const timespec& deadline) {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        const long long remaining = (deadline.tv_sec - now.tv_sec) * 1000LL + (deadline.tv_nsec - now.tv_nsec) / 1000000;
+        return remaining > 0 ? static_cast<int>(remaining) : 0;
+    }
+
+    /**
+     * @brief POSIX message queue backend.
+     *
+     * A sender creates the queue if it does not exist yet, sized as the
+     * receiver would by default; a receiver opens it through a
+     * `QueueProvisioner`, attaching to a compatible queue left by a previous run.
+     */
+    class MQueueTransport : public Transport {
+    public:
+        MQueueTransport(const std::string& name, TransportRole role, const QueueProvisioner* provisioner) : name_(name) {
+            const QueueProvisioner defaults { QueueWorkload() };
+            if (role == TransportRole::Receiver) {
+                const QueueProvisioner& planned = provisioner ? *provisioner : defaults;
+                QueueOpenResult result = planned.Open(name_, O_RDONLY | O_NONBLOCK);
+                mq_ = result.mq;
+                description_ = planned.Describe(name_, result);
+                return;
+            }
+
+            // O_WRONLY == Write only
+            // O_CREAT == Create the queue if it doesn't already exist, sized as the receiver would by default
+            struct mq_attr attr {};
+            attr.mq_maxmsg = defaults.Depth();
+            attr.mq_msgsize = defaults.MessageSize();
+            mq_ = mq_open(name_.c_str(), O_WRONLY | O_CREAT, QUEUE_PERMISSIONS, &attr);
+            if (mq_ == (mqd_t)-1) {
+                throw std::runtime_error("Failed to open message queue");
+            }
+            description_ = "Queue " + name_;
+        }
+        ~MQueueTransport() override { mq_close(mq_); }
+
+        bool Send(const char* data, size_t size, unsigned priority, const timespec* deadline) override {
+            const int result = deadline ? mq_timedsend(mq_, data, size, priority, deadline)
+                                        : mq_send(mq_, data, size, priority);
+            if (result == 0) {
+                return true;
+            }
+            if (errno == ETIMEDOUT || errno == EAGAIN) {
+                return false;
+            }
+            throw std::runtime_error("Failed to send message");
+        }
+
+        bool WaitForData(int timeoutMs) override {
+            // On Linux a message queue descriptor is a file descriptor, so it can be polled
+            struct pollfd ready { mq_, POLLIN, 0 };
+            return poll(&ready, 1, timeoutMs) > 0;
+        }
+
+        size_t ReceiveBatch(ReceiveSlot* slots, size_t count) override {
+            size_t received = 0;
+            while (received < count) {
+                ReceiveSlot& slot = slots[received];
+                const ssize_t size = mq_receive(mq_, slot.buffer, slot.capacity, &slot.priority);
+
+                /*
+                    >= 0 rather than > 0 because a message with empty values is STILL a valid message,
+                    but will come over blank.
+                */
+                if (size >= 0) {
+                    slot.size = static_cast<size_t>(size);
+                    ++received;
+                } else if (errno == EAGAIN) {
+                    break; // Queue is empty
+                } else {
+                    throw std::runtime_error(std::string("mq_receive: ") + std::strerror(errno));
+                }
+            }
+            return received;
+        }
+
+        TransportKind Kind() const override { return TransportKind::MQueue; }
+        std::string Describe() const override { return description_; }
+
+        size_t MessageSize() const override {
+            struct mq_attr attr;
+            if (mq_getattr(mq_, &attr) == 0 && attr.mq_msgsize > 0 && attr.mq_msgsize < MAX_MESSAGE_SIZE) {
+                return static_cast<size_t>(attr.mq_msgsize);
+            }
+            return MAX_MESSAGE_SIZE;
+        }
+
+        bool Depth(uint64_t& pending, uint64_t& capacity) const override {
+            struct mq_attr attr;
+            if (mq_getattr(mq_, &attr) != 0) {
+                return false;
+            }
+            pending = static_cast<uint64_t>(attr.mq_curmsgs);
+            capacity = static_cast<uint64_t>(attr.mq_maxmsg);
+            return true;
+        }
+
+        void Remove() override { mq_unlink(name_.c_str()); }
+
+    private:
+        std::string name_;
+        mqd_t mq_;
+        std::string description_;
+    };
+
+    /**
+     * @brief Shared-memory SPSC ring backend; the receiver creates the ring and one sender attaches to it.
+     */
+    class ShmRingTransport : public Transport {
+    public:
+        ShmRingTransport(const std::string& name, TransportRole role)
+            : name_(name), ring_(name, role == TransportRole::Receiver) { }
+
+        bool Send(const char* data, size_t size, unsigned /*priority*/, const timespec* deadline) override {
+            if (!deadline) {
+                return ring_.Push(data, size);
+            }
+            const int remainingMs = millisecondsUntil(*deadline);
+            return ring_.TryPush(data, size) || (remainingMs > 0 && ring_.Push(data, size, remainingMs));
+        }
+
+        bool WaitForData(int timeoutMs) override { return ring_.WaitForData(timeoutMs); }
+
+        size_t ReceiveBatch(ReceiveSlot* slots, size_t count) override {
+            size_t received = 0;
+            ssize_t size;
+            while (received < count && (size = ring_.TryPop(slots[received].buffer, slots[received].capacity)) >= 0) {
+                slots[received].size = static_cast<size_t>(size);
+                slots[received].priority = 0;
+                ++received;
+            }
+            return received;
+        }
+
+        TransportKind Kind() const override { return TransportKind::ShmRing; }
+        std::string Describe() const override { return "Ring " + name_; }
+        void Remove() override { ShmRing::Unlink(name_); }
+
+    private:
+        std::string name_;
+        ShmRing ring_;
+    };
+
+    /**
+     * @brief Broadcast ring backend; the sender publishes the ring and every receiver subscribes to it.
+     *
+     * Publishing never waits and ignores priorities. A subscriber that is
+     * overrun skips what it missed and reports it as `Stat::MessagesLost`,
+     * and is `Closed` once the publisher has removed the ring.
+     */
+    class BroadcastTransport : public Transport {
+    public:
+        BroadcastTransport(const std::string& name, TransportRole role)
+            : name_(name), publisher_(role == TransportRole::Sender), ring_(name, publisher_), reported_(0) { }
+
+        ~BroadcastTransport() override {
+            if (publisher_) {
+                BroadcastRing::Unlink(name_);
+            }
+        }
+
+        // Publishing never waits, so there is no deadline to honour
+        bool Send(const char* data, size_t size, unsigned /*priority*/, const timespec* /*deadline*/) override {
+            ring_.Publish(data, size);
+            return true;
+        }
+
+        size_t SendBatch(const OutgoingMessage* messages, size_t count) override {
+            for (size_t i = 0; i < count; ++i) {
+                ring_.Publish(messages[i].data, messages[i].size);
+            }
+            return count;
+        }
+
+        bool WaitForData(int timeoutMs) override { return ring_.WaitForData(timeoutMs); }
+
+        size_t ReceiveBatch(ReceiveSlot* slots, size_t count) override {
+            size_t received = 0;
+            ssize_t size;
+            while (received < count && (size = ring_.TryRead(slots[received].buffer, slots[received].capacity)) >= 0) {
+                slots[received].size = static_cast<size_t>(size);
+                slots[received].priority = 0;
+                ++received;
+            }
+            if (ring_.Lost() != reported_) {
+                stats::Add(Stat::MessagesLost, ring_.Lost() - reported_);
+                reported_ = ring_.Lost();
+            }
+            return received;
+        }
+
+        TransportKind Kind() const override { return TransportKind::Broadcast; }
+        std::string Describe() const override { return "Broadcast ring " + name_; }
+        uint64_t Lost() const override { return ring_.Lost(); }
+        bool Closed() const override { return !publisher_ && ring_.Orphaned(); }
+
+        // The publisher owns the ring's name; subscribers leave it for the others
+        void Remove() override { }
+
+    private:
+        std::string name_;
+        bool publisher_;
+        BroadcastRing ring_;
+        uint64_t reported_; // Lost messages already added to the stats segment
+    };
+}
+
+/**
+ * @brief Parses a `--transport` value: "mq", "shm", "seqpacket", "uring" or "broadcast".
+ *
+ * @throws std::invalid_argument for any other value.
+ */
+TransportKind ParseTransportKind(const std::string& name) {
+    if (name == "mq") return TransportKind::MQueue;
+    if (name == "shm") return TransportKind::ShmRing;
+    if (name == "seqpacket") return TransportKind::SeqPacket;
+    if (name == "uring") return TransportKind::IoUring;
+    if (name == "broadcast") return TransportKind::Broadcast;
+    throw std::invalid_argument("Unknown transport '" + name + "' (expected mq, shm, seqpacket, uring or broadcast)");
+}
+
+/**
+ * @brief Returns the `--transport` value that selects a kind.
+ */
+const char* TransportKindName(TransportKind kind) {
+    switch (kind) {
+    case TransportKind::ShmRing:   return "shm";
+    case TransportKind::SeqPacket: return "seqpacket";
+    case TransportKind::IoUring:   return "uring";
+    case TransportKind::Broadcast: return "broadcast";
+    case TransportKind::MQueue:
+    default:                       return "mq";
+    }
+}
+
+/**
+ * @brief Sends messages in order without waiting, one `Send` each; backends that can batch override this.
+ *
+ * @return How many messages, from the front, were sent before the channel was full.
+ */
+size_t Transport::SendBatch(const OutgoingMessage* messages, size_t count) {
+    size_t sent = 0;
+    while (sent < count && Send(messages[sent].data, messages[sent].size, messages[sent].priority, &EXPIRED)) {
+        ++sent;
+    }
+    return sent;
+}
+
+/**
+ * @brief Opens one end of a channel.
+ *
+ * @param kind The mechanism.
+ * @param name Queue, ring or socket name; empty selects `SHM_RING_NAME` for
+ *             the ring, `BROADCAST_RING_NAME` for the broadcast ring and
+ *             `QUEUE_NAME` otherwise.
+ * @param role Which end to open.
+ * @param provisioner Sizes a receiver's message queue; the default plan if null.
+ * @throws std::runtime_error if the channel cannot be opened, e.g. a socket or
+ *         ring sender started before its receiver, or a broadcast subscriber
+ *         started before its publisher.
+ */
+std::unique_ptr<Transport> OpenTransport(TransportKind kind, const std::string& name, TransportRole role,
+                                         const QueueProvisioner* provisioner) {
+    switch (kind) {
+    case TransportKind::ShmRing:
+        return std::make_unique<ShmRingTransport>(name.empty() ? SHM_RING_NAME : name, role);
+    case TransportKind::SeqPacket:
+        return std::make_unique<SeqPacketTransport>(name.empty() ? QUEUE_NAME : name, role);
+    case TransportKind::IoUring:
+        return std::make_unique<IoUringTransport>(name.empty() ? QUEUE_NAME : name, role);
+    case TransportKind::Broadcast:
+        return std::make_unique<BroadcastTransport>(name.empty() ? BROADCAST_RING_NAME : name, role);
+    case TransportKind::MQueue:
+    default:
+        return std::make_unique<MQueueTransport>(name.empty() ? QUEUE_NAME : name, role, provisioner);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include "constants.h"
+#include "queue_provisioner.h"
+
+// The mechanisms a Transport can carry messages over
+enum class TransportKind {
+    MQueue,    // POSIX message queue (QUEUE_NAME); the only one with message priorities
+    ShmRing,   // Shared-memory SPSC ring (SHM_RING_NAME); single sender
+    SeqPacket, // AF_UNIX SOCK_SEQPACKET socket (abstract QUEUE_NAME) with sendmmsg/recvmmsg
+    IoUring,   // The same socket, with batched sends and multishot receives through io_uring
+    Broadcast  // Shared-memory broadcast ring (BROADCAST_RING_NAME); one publisher, any number of subscribers
+};
+
+TransportKind ParseTransportKind(const std::string& name);
+const char* TransportKindName(TransportKind kind);
+
+// Which end of the channel a Transport is opened as
+enum class TransportRole {
+    Sender,  // Attaches to (or, for a message queue or broadcast ring, creates) the channel
+    Receiver // Creates the channel and accepts senders (attaches as a subscriber to a broadcast ring)
+};
+
+// One message handed to `Transport::SendBatch`
+struct OutgoingMessage {
+    const char* data;
+    size_t size;
+    unsigned priority;
+};
+
+// One caller-owned buffer filled by `Transport::ReceiveBatch`
+struct ReceiveSlot {
+    char* buffer;
+    size_t capacity;
+    size_t size;       // Set on receive
+    unsigned priority; // Set on receive; always 0 except on a message queue
+};
+
+/**
+ * @brief One end of a message channel, independent of the mechanism behind it.
+ *
+ * Messages keep their boundaries and arrive in the order each sender sent
+ * them. Sending can hand over a whole batch at once, and receiving drains
+ * everything that is ready into the caller's buffers, so backends that can
+ * batch syscalls (`sendmmsg`/`recvmmsg`, one io_uring submission) do.
+ * Open one with `OpenTransport`.
+ */
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    // Sending. `deadline` is an absolute CLOCK_REALTIME time, as for `mq_timedsend`: null waits
+    // indefinitely and one already past does not wait. Send returns false if there was no room
+    // in time; SendBatch never waits, and returns how many messages (from the front) it sent.
+    // Only a message queue orders by priority; every other backend ignores it.
+    virtual bool Send(const char* data, size_t size, unsigned priority, const timespec* deadline) = 0;
+    virtual size_t SendBatch(const OutgoingMessage* messages, size_t count);
+
+    // Receiving. WaitForData returns false on timeout or when interrupted by a signal (-1 waits
+    // indefinitely); ReceiveBatch never waits, and returns how many slots it filled.
+    virtual bool WaitForData(int timeoutMs) = 0;
+    virtual size_t ReceiveBatch(ReceiveSlot* slots, size_t count) = 0;
+
+    // Getters
+    virtual TransportKind Kind() const = 0;
+    virtual size_t MessageSize() const { return MAX_MESSAGE_SIZE; }
+    virtual std::string Describe() const = 0;
+    virtual bool Depth(uint64_t& /*pending*/, uint64_t& /*capacity*/) const { return false; }
+    virtual uint64_t Lost() const { return 0; } // Messages a broadcast subscriber was overrun on
+    virtual bool Closed() const { return false; } // Nothing more can arrive (a broadcast subscriber whose publisher has gone)
+
+    // Removes the channel's name so the next run starts afresh (no-op for sockets, which vanish on close)
+    virtual void Remove() { }
+};
+
+std::unique_ptr<Transport> OpenTransport(TransportKind kind, const std::string& name, TransportRole role,
+                                         const QueueProvisioner* provisioner = nullptr);
+
+#endif // TRANSPORT_H
@@ -1,26 +1,112 @@
 #include "util.h"
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
+#include <stdexcept>
 
 namespace util {
+    namespace {
+        // Length of "YYYY-MM-DD HH:MM:SS"
+        constexpr size_t PREFIX_LENGTH = 19;
+
+        /**
+         * @brief Per-thread cache of the rendered date/time prefix for one second.
+         */
+        struct PrefixCache {
+            time_t second = -1;
+            char prefix[PREFIX_LENGTH];
+        };
+        thread_local PrefixCache prefixCache;
+
+        /**
+         * @brief Writes `value` as exactly `width` zero-padded decimal digits.
+         */
+        void writeDigits(char* out, unsigned long value, int width) {
+            for (int i = width - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+
+        /**
+         * @brief Renders "YYYY-MM-DD HH:MM:SS" for a second in local time.
+         */
+        void renderPrefix(time_t second, char* out) {
+            std::tm local {};
+            localtime_r(&second, &local); // Reentrant; std::localtime shares one static buffer
+
+            writeDigits(out, static_cast<unsigned long>(local.tm_year + 1900), 4);
+            out[4] = '-';
+            writeDigits(out + 5, static_cast<unsigned long>(local.tm_mon + 1), 2);
+            out[7] = '-';
+            writeDigits(out + 8, static_cast<unsigned long>(local.tm_mday), 2);
+            out[10] = ' ';
+            writeDigits(out + 11, static_cast<unsigned long>(local.tm_hour), 2);
+            out[13] = ':';
+            writeDigits(out + 14, static_cast<unsigned long>(local.tm_min), 2);
+            out[16] = ':';
+            writeDigits(out + 17, static_cast<unsigned long>(local.tm_sec), 2);
+        }
+    }
+
+    size_t formatTimestamp(const timespec& time, char* buffer, size_t capacity, TimestampPrecision precision) {
+        int digits = 3;
+        unsigned long fraction = static_cast<unsigned long>(time.tv_nsec) / 1000000;
+        if (precision == TimestampPrecision::Microseconds) {
+            digits = 6;
+            fraction = static_cast<unsigned long>(time.tv_nsec) / 1000;
+        } else if (precision == TimestampPrecision::Nanoseconds) {
+            digits = 9;
+            fraction = static_cast<unsigned long>(time.tv_nsec);
+        }
+
+        const size_t length = PREFIX_LENGTH + 1 + digits;
+        if (capacity < length + 1) {
+            throw std::length_error("Timestamp buffer is too small.");
+        }
+
+        // Only go through localtime_r when the second changes
+        if (prefixCache.second != time.tv_sec) {
+            renderPrefix(time.tv_sec, prefixCache.prefix);
+            prefixCache.second = time.tv_sec;
+        }
+
+        std::memcpy(buffer, prefixCache.prefix, PREFIX_LENGTH);
+        buffer[PREFIX_LENGTH] = '.';
+        writeDigits(buffer + PREFIX_LENGTH + 1, fraction, digits);
+        buffer[length] = '\0';
+        return length;
+    }
+
+    Timestamp currentTimestamp(TimestampPrecision precision, TimestampClock clock) {
+        timespec now;
+        clock_gettime(clock == TimestampClock::RealtimeCoarse ? CLOCK_REALTIME_COARSE : CLOCK_REALTIME, &now);
+
+        Timestamp timestamp;
+        timestamp.size = formatTimestamp(now, timestamp.chars.data(), timestamp.chars.size(), precision);
+        return timestamp;
+    }
+
     std::string getCurrentDateTimeWithMilliseconds() {
-        // Get the current time as a time_point
-        auto now = std::chrono::system_clock::now();
+        return std::string(currentTimestamp().View());
+    }
 
-        // Convert to a time_t for formatting
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+    uint64_t monotonicNanoseconds() {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+    }
 
-        // Convert to milliseconds since the epoch
-        auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    std::string getOption(int argc, char* argv[], const std::string& name, const std::string& defaultValue) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
 
-        // Format the time to include date and time
-        std::ostringstream oss;
-        oss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S");
-        
-        // Add milliseconds to the formatted string
-        oss << '.' << std::setfill('0') << std::setw(3) << milliseconds.count();
+            if (arg == name) {
+                return "true";
+            }
+            if (arg.size() > name.size() && arg.compare(0, name.size(), name) == 0 && arg[name.size()] == '=') {
+                return arg.substr(name.size() + 1);
+            }
+        }
 
-        return oss.str();
+        return defaultValue;
     }
 }
@@ -1,18 +1,104 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <string>
+#include <string_view>
 
 namespace util {
+    // Digits shown after the seconds by the timestamp formatter
+    enum class TimestampPrecision {
+        Milliseconds, // "YYYY-MM-DD HH:MM:SS.mmm"
+        Microseconds, // "YYYY-MM-DD HH:MM:SS.uuuuuu"
+        Nanoseconds   // "YYYY-MM-DD HH:MM:SS.nnnnnnnnn"
+    };
+
+    // Which realtime clock the timestamp formatter reads
+    enum class TimestampClock {
+        Realtime,      // CLOCK_REALTIME: exact, typically a vDSO call
+        RealtimeCoarse // CLOCK_REALTIME_COARSE: cheaper, but only advances once per scheduler tick (~1-4 ms)
+    };
+
+    // Large enough for the longest timestamp (nanoseconds) plus a terminating null
+    constexpr size_t TIMESTAMP_BUFFER_SIZE = 32;
+
+    /**
+     * @brief A formatted local timestamp held in a fixed-size array (no heap allocation).
+     */
+    struct Timestamp {
+        std::array<char, TIMESTAMP_BUFFER_SIZE> chars;
+        size_t size;
+
+        std::string_view View() const { return std::string_view(chars.data(), size); }
+        const char* CStr() const { return chars.data(); }
+    };
+
+    /**
+     * @brief Formats a point in time as local "YYYY-MM-DD HH:MM:SS" plus a fractional suffix.
+     * 
+     * The date/time prefix is rendered with `localtime_r` at most once per second
+     * per thread and cached; calls within the same second only render the suffix.
+     * Safe to call from any number of threads and never allocates.
+     * 
+     * @param time The point in time to format (as returned by `clock_gettime`).
+     * @param buffer Destination; null-terminated on return.
+     * @param capacity Size of `buffer` in bytes, including room for the null.
+     * @param precision How many fractional digits to show.
+     * @return The number of characters written, excluding the null.
+     * @throws std::length_error if `buffer` is too small.
+     */
+    size_t formatTimestamp(const timespec& time, char* buffer, size_t capacity,
+                           TimestampPrecision precision = TimestampPrecision::Milliseconds);
+
+    /**
+     * @brief Reads the clock and formats the current local time into a fixed-size array.
+     * 
+     * @param precision How many fractional digits to show.
+     * @param clock Which realtime clock to read.
+     * @return The formatted timestamp.
+     */
+    Timestamp currentTimestamp(TimestampPrecision precision = TimestampPrecision::Milliseconds,
+                               TimestampClock clock = TimestampClock::Realtime);
+
     /**
      * @brief Gets the current date and time down to milliseconds as a string.
      * 
      * This function retrieves the current system date and time formatted as:
      * "YYYY-MM-DD HH:MM:SS.mmm".
      * 
+     * Hot paths should prefer `currentTimestamp`, which returns the same text
+     * without allocating a `std::string`.
+     * 
      * @return A string representation of the current date and time, including milliseconds.
      */
     std::string getCurrentDateTimeWithMilliseconds();
+
+    /**
+     * @brief Reads `CLOCK_MONOTONIC` in nanoseconds.
+     * 
+     * The clock is system-wide, so values taken in different processes on the
+     * same machine can be subtracted to measure transit time.
+     * 
+     * @return Nanoseconds since an unspecified fixed point (typically boot).
+     */
+    uint64_t monotonicNanoseconds();
+
+    /**
+     * @brief Looks up a command-line option of the form "--name=value".
+     * 
+     * A bare "--name" (without a value) is reported as "true" so boolean
+     * switches can share the same lookup.
+     * 
+     * @param argc Argument count as passed to `main`.
+     * @param argv Argument vector as passed to `main`.
+     * @param name Option name including the leading dashes, e.g. "--transport".
+     * @param defaultValue Value returned when the option is absent.
+     * @return The option value, or `defaultValue` if the option is absent.
+     */
+    std::string getOption(int argc, char* argv[], const std::string& name, const std::string& defaultValue);
 }
 
 #endif // UTIL_H
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "batch_frame.h"
+#include "t_ipc_data.h"
+
+/**
+ * @brief Tests that records packed into a batch come back out intact and in order.
+ */
+TEST(BatchFrameTests, EncodeDecode_RoundTripsRecords) {
+    // Arrange: Pack three serialized records, including an empty one
+    std::vector<std::string> records {
+        T_IPCData { 47, 1701.0f, "Make it so", IPCData::TYPE3 }.Serialize(),
+        T_IPCData {}.Serialize(),
+        T_IPCData { std::nullopt, 13.37f, std::nullopt, IPCData::TYPE1 }.Serialize()
+    };
+    BatchEncoder encoder;
+    for (const std::string& record : records) {
+        encoder.Append(record.data(), record.size());
+    }
+
+    // Act: Iterate the batch
+    std::vector<std::string> decoded;
+    for (std::string_view record : BatchView(encoder.Data(), encoder.Size())) {
+        decoded.emplace_back(record);
+    }
+
+    // Assert: Ensure the batch is recognized and every record matches
+    EXPECT_TRUE(IsBatchFrame(encoder.Data(), encoder.Size()));
+    EXPECT_EQ(encoder.Count(), records.size());
+    EXPECT_EQ(decoded, records);
+    EXPECT_EQ(T_IPCData { decoded[0] }.GetTheString().value(), "Make it so");
+}
+
+/**
+ * @brief Tests that a single serialized record is never mistaken for a batch.
+ */
+TEST(BatchFrameTests, IsBatchFrame_RejectsPlainRecords) {
+    // Arrange: Serialize records with each field as the first one present
+    std::string intFirst = T_IPCData { 1, std::nullopt, std::nullopt, std::nullopt }.Serialize();
+    std::string floatFirst = T_IPCData { std::nullopt, 1.0f, std::nullopt, std::nullopt }.Serialize();
+    std::string stringFirst = T_IPCData { std::nullopt, std::nullopt, "x", std::nullopt }.Serialize();
+    std::string typeFirst = T_IPCData { std::nullopt, std::nullopt, std::nullopt, IPCData::TYPE2 }.Serialize();
+
+    // Act & Assert: Ensure none of them look like a batch
+    EXPECT_FALSE(IsBatchFrame(intFirst.data(), intFirst.size()));
+    EXPECT_FALSE(IsBatchFrame(floatFirst.data(), floatFirst.size()));
+    EXPECT_FALSE(IsBatchFrame(stringFirst.data(), stringFirst.size()));
+    EXPECT_FALSE(IsBatchFrame(typeFirst.data(), typeFirst.size()));
+    EXPECT_FALSE(IsBatchFrame("", 0));
+}
+
+/**
+ * @brief Tests that the encoder refuses records once the batch is full.
+ */
+TEST(BatchFrameTests, Fits_StopsAtCapacity) {
+    // Arrange: A tiny batch with room for the marker plus one 8-byte record
+    BatchEncoder encoder(1 + 1 + 8);
+    std::string record(8, 'x');
+
+    // Act & Assert: Ensure the first record fits and the second does not
+    EXPECT_TRUE(encoder.Fits(record.size()));
+    encoder.Append(record.data(), record.size());
+    EXPECT_FALSE(encoder.Fits(record.size()));
+    EXPECT_THROW(encoder.Append(record.data(), record.size()), std::length_error);
+}
+
+/**
+ * @brief Tests that a truncated batch is reported instead of read past its end.
+ */
+TEST(BatchFrameTests, Decode_RejectsTruncatedRecord) {
+    // Arrange: A batch whose length prefix claims more bytes than are present
+    const char truncated[] = { static_cast<char>(BATCH_FRAME_MARKER), 10, 'a', 'b' };
+
+    // Act & Assert: Expect iteration to throw
+    EXPECT_THROW(
+        for (std::string_view record : BatchView(truncated, sizeof(truncated))) { (void)record; },
+        std::runtime_error
+    );
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "broadcast_ring.h"
+
+/**
+ * @brief Builds a segment name that is unique to this test process.
+ */
+static std::string TestBroadcastName() {
+    return "/ipc_broadcast_test." + std::to_string(getpid());
+}
+
+/**
+ * @brief Reads everything a subscriber has not seen yet.
+ */
+static std::vector<std::string> ReadAvailable(BroadcastRing& subscriber) {
+    std::vector<std::string> messages;
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t size;
+    while ((size = subscriber.TryRead(buffer, sizeof(buffer))) >= 0) {
+        messages.emplace_back(buffer, static_cast<size_t>(size));
+    }
+    return messages;
+}
+
+/**
+ * @brief Tests that every subscriber receives every message, in order, independently of the others.
+ */
+TEST(BroadcastRingTests, Publish_EverySubscriberReadsEveryMessage) {
+    // Arrange: A publisher and two subscribers
+    BroadcastRing publisher(TestBroadcastName(), true);
+    BroadcastRing first(TestBroadcastName(), false);
+    BroadcastRing second(TestBroadcastName(), false);
+
+    // Act: Publish three messages, including an empty one; the first subscriber reads before the last is published
+    publisher.Publish("one", 3);
+    publisher.Publish("", 0);
+    std::vector<std::string> firstReads = ReadAvailable(first);
+    publisher.Publish("three", 5);
+    std::vector<std::string> firstRest = ReadAvailable(first);
+    firstReads.insert(firstReads.end(), firstRest.begin(), firstRest.end());
+    std::vector<std::string> secondReads = ReadAvailable(second);
+
+    // Assert: Ensure both subscribers saw the same messages in order, and neither lost any
+    const std::vector<std::string> expected { "one", "", "three" };
+    EXPECT_EQ(firstReads, expected);
+    EXPECT_EQ(secondReads, expected);
+    EXPECT_EQ(first.Lost(), 0u);
+    EXPECT_EQ(second.Lost(), 0u);
+    EXPECT_EQ(publisher.Published(), 3u);
+
+    BroadcastRing::Unlink(TestBroadcastName());
+}
+
+/**
+ * @brief Tests that a subscriber lapped by the publisher counts what it missed and resumes with the oldest message left.
+ */
+TEST(BroadcastRingTests, TryRead_OverrunSubscriberSkipsAhead) {
+    // Arrange: A publisher and a subscriber that does not read
+    BroadcastRing publisher(TestBroadcastName(), true);
+    BroadcastRing subscriber(TestBroadcastName(), false);
+    const size_t slots = publisher.SlotCount();
+
+    // Act: Publish ten messages more than the ring holds, then read
+    for (size_t i = 0; i < slots + 10; ++i) {
+        const std::string message = std::to_string(i);
+        publisher.Publish(message.data(), message.size());
+    }
+    std::vector<std::string> reads = ReadAvailable(subscriber);
+
+    // Assert: Ensure the ten oldest were lost and the rest arrived in order
+    EXPECT_EQ(subscriber.Lost(), 10u);
+    EXPECT_EQ(subscriber.Overruns(), 1u);
+    ASSERT_EQ(reads.size(), slots);
+    EXPECT_EQ(reads.front(), "10");
+    EXPECT_EQ(reads.back(), std::to_string(slots + 9));
+
+    BroadcastRing::Unlink(TestBroadcastName());
+}
+
+/**
+ * @brief Tests that a subscriber lapped by a publisher on another thread never returns a torn message.
+ */
+TEST(BroadcastRingTests, TryRead_NeverReturnsTornMessages) {
+    // Arrange: A publisher thread and a subscriber; every payload starts with its message number and fills the rest from it
+    BroadcastRing publisher(TestBroadcastName(), true);
+    BroadcastRing subscriber(TestBroadcastName(), false);
+    const uint64_t total = 50 * publisher.SlotCount();
+    auto fill = [](uint64_t number, char* payload) {
+        const size_t size = sizeof(number) + number % 256;
+        std::memcpy(payload, &number, sizeof(number));
+        for (size_t i = sizeof(number); i < size; ++i) {
+            payload[i] = static_cast<char>(number * 31 + i);
+        }
+        return size;
+    };
+    std::atomic<bool> done { false };
+
+    // Act: Publish as fast as possible while the subscriber reads, pausing now and then so it gets lapped
+    std::thread writer([&] {
+        char payload[MAX_MESSAGE_SIZE];
+        for (uint64_t number = 0; number < total; ++number) {
+            publisher.Publish(payload, fill(number, payload));
+        }
+        done.store(true, std::memory_order_release);
+    });
+    uint64_t received = 0, torn = 0, outOfOrder = 0;
+    int64_t last = -1;
+    char buffer[MAX_MESSAGE_SIZE], expected[MAX_MESSAGE_SIZE];
+    for (bool finished = false; !finished;) {
+        finished = done.load(std::memory_order_acquire);
+        ssize_t size;
+        while ((size = subscriber.TryRead(buffer, sizeof(buffer))) >= 0) {
+            uint64_t number = 0;
+            std::memcpy(&number, buffer, sizeof(number));
+            const size_t expectedSize = fill(number, expected);
+            if (static_cast<size_t>(size) != expectedSize || std::memcmp(buffer, expected, expectedSize) != 0) {
+                ++torn;
+            }
+            if (static_cast<int64_t>(number) <= last) {
+                ++outOfOrder;
+            }
+            last = static_cast<int64_t>(number);
+            if (++received % 256 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    writer.join();
+
+    // Assert: Ensure every message read was whole and newer than the last, and everything was either read or counted lost
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(outOfOrder, 0u);
+    EXPECT_GT(subscriber.Lost(), 0u);
+    EXPECT_EQ(received + subscriber.Lost(), total);
+
+    BroadcastRing::Unlink(TestBroadcastName());
+}
+
+/**
+ * @brief Tests that a subscriber notices when its ring is removed or replaced by a new publisher.
+ */
+TEST(BroadcastRingTests, Orphaned_AfterPublisherRemovesTheRing) {
+    // Arrange: A publisher with two subscribers
+    BroadcastRing publisher(TestBroadcastName(), true);
+    BroadcastRing removed(TestBroadcastName(), false);
+    EXPECT_FALSE(removed.Orphaned());
+
+    // Act: Remove the ring as an exiting publisher does, then start a new publisher and subscriber
+    BroadcastRing::Unlink(TestBroadcastName());
+    const bool afterUnlink = removed.Orphaned();
+    BroadcastRing replacement(TestBroadcastName(), true);
+    BroadcastRing current(TestBroadcastName(), false);
+
+    // Assert: Ensure only the subscriber of the removed ring is orphaned
+    EXPECT_TRUE(afterUnlink);
+    EXPECT_FALSE(current.Orphaned());
+    EXPECT_FALSE(replacement.Orphaned());
+
+    BroadcastRing::Unlink(TestBroadcastName());
+}
+
+/**
+ * @brief Tests that a parked subscriber is woken by the next publish.
+ */
+TEST(BroadcastRingTests, WaitForData_WakesOnPublish) {
+    // Arrange: A publisher and a subscriber with nothing to read
+    BroadcastRing publisher(TestBroadcastName(), true);
+    BroadcastRing subscriber(TestBroadcastName(), false);
+    ASSERT_FALSE(subscriber.WaitForData(0));
+
+    // Act: Publish from another thread while the subscriber waits
+    std::thread writer([&publisher] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        publisher.Publish("wake", 4);
+    });
+    const bool woken = subscriber.WaitForData(2000);
+    writer.join();
+
+    // Assert: Ensure the wait ended with the message ready
+    EXPECT_TRUE(woken);
+    EXPECT_EQ(ReadAvailable(subscriber), std::vector<std::string> { "wake" });
+
+    BroadcastRing::Unlink(TestBroadcastName());
+}
+
+/**
+ * @brief Tests that subscribing fails when no publisher has created the ring.
+ */
+TEST(BroadcastRingTests, Subscribe_NeedsPublisher) {
+    // Arrange: Make sure no ring exists under the name
+    BroadcastRing::Unlink(TestBroadcastName());
+
+    // Act & Assert: Ensure subscribing throws
+    EXPECT_THROW(BroadcastRing(TestBroadcastName(), false), std::runtime_error);
+}
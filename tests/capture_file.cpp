@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <mqueue.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "capture_file.h"
+#include "sender.h"
+#include "test_queue.h"
+
+/**
+ * @brief Returns a capture path unique to this test process, with any leftover files removed.
+ */
+static std::string TestCapturePath() {
+    const std::string path = "/tmp/ipc_capture_test." + std::to_string(getpid());
+    unlink(path.c_str());
+    unlink((path + ".idx").c_str());
+    return path;
+}
+
+static void RemoveCapture(const std::string& path) {
+    unlink(path.c_str());
+    unlink((path + ".idx").c_str());
+}
+
+/**
+ * @brief Tests that frames read back exactly as written, across several growth steps, and the file is trimmed on close.
+ */
+TEST(CaptureFileTests, RoundTrip_GrowsAndTrims) {
+    // Arrange: A writer with a tiny chunk size so the file has to grow many times
+    const std::string path = TestCapturePath();
+    uint64_t bytes = 0;
+
+    // Act: Write frames of varying sizes, including empty ones
+    {
+        CaptureWriter writer(path, 4096);
+        for (int i = 0; i < 500; ++i) {
+            const std::string frame(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26));
+            writer.Append(frame.data(), frame.size(), static_cast<unsigned>(i % 4), static_cast<uint16_t>(i % 3), 1000u + i);
+        }
+        EXPECT_EQ(writer.Frames(), 500u);
+        bytes = writer.Bytes();
+    }
+
+    // Assert: Ensure every frame and its metadata come back in order
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(static_cast<uint64_t>(st.st_size), bytes);
+
+    CaptureReader reader(path);
+    EXPECT_EQ(reader.Frames(), 500u);
+    EXPECT_EQ(reader.FirstTimestamp(), 1000u);
+    CaptureFrame frame;
+    int count = 0;
+    while (reader.Next(frame)) {
+        EXPECT_EQ(frame.data, std::string(static_cast<size_t>(count % 37), static_cast<char>('a' + count % 26)));
+        EXPECT_EQ(frame.priority, static_cast<unsigned>(count % 4));
+        EXPECT_EQ(frame.shard, count % 3);
+        EXPECT_EQ(frame.timestampNs, 1000u + count);
+        ++count;
+    }
+    EXPECT_EQ(count, 500);
+
+    RemoveCapture(path);
+}
+
+/**
+ * @brief Tests that seeking by time lands on the first frame at or after the target, with and without the index.
+ */
+TEST(CaptureFileTests, Seek_FindsFirstFrameAtOrAfter) {
+    // Arrange: Three index intervals of frames, one microsecond apart
+    const std::string path = TestCapturePath();
+    const uint64_t frames = 3 * CAPTURE_INDEX_INTERVAL;
+    {
+        CaptureWriter writer(path);
+        for (uint64_t i = 0; i < frames; ++i) {
+            writer.Append(reinterpret_cast<const char*>(&i), sizeof(i), 0, 0, i * 1000);
+        }
+    }
+
+    // Act & Assert: Seek into the middle, to an exact frame, and past the end
+    CaptureReader reader(path);
+    EXPECT_EQ(reader.Index().size(), 3u);
+    CaptureFrame frame;
+
+    reader.Seek(1500 * 1000 + 1);
+    ASSERT_TRUE(reader.Next(frame));
+    EXPECT_EQ(frame.timestampNs, 1501u * 1000);
+
+    reader.Seek(2048 * 1000);
+    ASSERT_TRUE(reader.Next(frame));
+    EXPECT_EQ(frame.timestampNs, 2048u * 1000);
+
+    reader.Seek(frames * 1000);
+    EXPECT_FALSE(reader.Next(frame));
+
+    // Without the index the same seek scans from the start
+    unlink((path + ".idx").c_str());
+    CaptureReader unindexed(path);
+    EXPECT_TRUE(unindexed.Index().empty());
+    unindexed.Seek(1500 * 1000 + 1);
+    ASSERT_TRUE(unindexed.Next(frame));
+    EXPECT_EQ(frame.timestampNs, 1501u * 1000);
+
+    RemoveCapture(path);
+}
+
+/**
+ * @brief Tests that a replayed frame is sent byte for byte, at its captured priority.
+ */
+TEST(CaptureFileTests, SendRaw_SendsFramesAsIs) {
+    // Arrange: A receive queue unique to this test process, and a captured frame
+    const std::string name = "/ipc_replay_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    const std::string captured = T_IPCData { 47, 1701.0f, "Make it so", IPCData::TYPE3 }.Serialize();
+
+    // Act: Send it raw at priority 2 and receive it
+    sender.SendRaw(captured.data(), captured.size(), 2);
+    char buffer[MAX_MESSAGE_SIZE];
+    unsigned priority = 0;
+    ssize_t size = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, &priority);
+
+    // Assert: Ensure the bytes and priority are unchanged
+    ASSERT_GE(size, 0);
+    EXPECT_EQ(std::string(buffer, static_cast<size_t>(size)), captured);
+    EXPECT_EQ(priority, 2u);
+    EXPECT_THROW(sender.SendRaw(captured.data(), captured.size(), PRIORITY_LEVELS), std::out_of_range);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "batch_frame.h"
+#include "columnar_batch.h"
+#include "t_ipc_data.h"
+
+static const SimdLevel ALL_LEVELS[] = { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2 };
+
+/**
+ * @brief Builds a batch of `rows` random records with every presence combination.
+ */
+static ColumnarBatch RandomBatch(size_t rows, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> ints(-1000000, 1000000);
+    std::uniform_real_distribution<float> floats(-1000.0f, 1000.0f);
+    ColumnarBatch batch;
+    for (size_t row = 0; row < rows; ++row) {
+        const uint32_t present = gen();
+        T_IPCData::Builder builder;
+        if (present & 1) builder.SetTheInt(ints(gen));
+        if (present & 2) builder.SetTheFloat(floats(gen));
+        if (present & 4) builder.SetTheString(std::string(row % 7, 's'));
+        if (present & 8) builder.SetTheType(static_cast<IPCData::Type>(gen() % TYPE_COUNT));
+        const std::string serialized = builder.Build().Serialize();
+        batch.Append(IPCDataView(serialized.data(), serialized.size()));
+    }
+    return batch;
+}
+
+/**
+ * @brief Tests that columns, presence and strings match the records they were decoded from.
+ */
+TEST(ColumnarBatchTests, AppendMessage_DecodesBatchIntoColumns) {
+    // Arrange: A batch envelope with a full record, an empty one, and a flat one with a string
+    T_IPCData full { -47, 1701.5f, "Make it so", IPCData::TYPE3 };
+    T_IPCData empty {};
+    T_IPCData flat { std::nullopt, std::nullopt, "Engage", std::nullopt };
+    BatchEncoder encoder;
+    for (const std::string& record : { full.Serialize(), empty.Serialize(), flat.SerializeFlat() }) {
+        encoder.Append(record.data(), record.size());
+    }
+
+    // Act: Decode the envelope
+    ColumnarBatch batch;
+    EXPECT_EQ(batch.AppendMessage(encoder.Data(), encoder.Size()), 3u);
+
+    // Assert: Ensure every value and presence bit landed in its row
+    ASSERT_EQ(batch.Rows(), 3u);
+    EXPECT_EQ(batch.Ints()[0], -47);
+    EXPECT_FLOAT_EQ(batch.Floats()[0], 1701.5f);
+    EXPECT_EQ(batch.Types()[0], IPCData::TYPE3);
+    EXPECT_EQ(batch.String(0), "Make it so");
+    for (auto column : { ColumnarBatch::Column::Int, ColumnarBatch::Column::Float, ColumnarBatch::Column::Type }) {
+        EXPECT_TRUE(batch.Has(column, 0));
+        EXPECT_FALSE(batch.Has(column, 1));
+        EXPECT_FALSE(batch.Has(column, 2));
+    }
+    EXPECT_FALSE(batch.String(1).has_value());
+    EXPECT_EQ(batch.String(2), "Engage");
+
+    // And that Clear empties the batch for the next window
+    batch.Clear();
+    EXPECT_TRUE(batch.Empty());
+    EXPECT_EQ(batch.Summarize().ints.count, 0u);
+}
+
+/**
+ * @brief Tests that every SIMD level agrees with the scalar kernels, for batch sizes that leave vector tails.
+ */
+TEST(ColumnarBatchTests, Summarize_AllLevelsMatchScalar) {
+    for (size_t rows : { 1u, 7u, 31u, 64u, 1000u, 4099u }) {
+        // Arrange: A random batch
+        ColumnarBatch batch = RandomBatch(rows, static_cast<uint32_t>(rows));
+
+        // Act: Summarize it with the scalar kernels, the reference
+        const BatchSummary expected = batch.Summarize(SimdLevel::Scalar);
+
+        // Assert: Ensure every level produces the same aggregates
+        for (SimdLevel level : ALL_LEVELS) {
+            SCOPED_TRACE(std::string(SimdLevelName(level)) + " rows=" + std::to_string(rows));
+            const BatchSummary actual = batch.Summarize(level);
+            EXPECT_EQ(actual.rows, rows);
+            EXPECT_EQ(actual.ints.count, expected.ints.count);
+            EXPECT_EQ(actual.ints.sum, expected.ints.sum);
+            EXPECT_EQ(actual.ints.min, expected.ints.min);
+            EXPECT_EQ(actual.ints.max, expected.ints.max);
+            EXPECT_EQ(actual.floats.count, expected.floats.count);
+            EXPECT_NEAR(actual.floats.sum, expected.floats.sum, 1e-6 * rows * 1000.0);
+            EXPECT_EQ(actual.floats.min, expected.floats.min);
+            EXPECT_EQ(actual.floats.max, expected.floats.max);
+            EXPECT_EQ(actual.strings, expected.strings);
+            EXPECT_EQ(actual.types, expected.types);
+        }
+    }
+}
+
+/**
+ * @brief Tests that values in rows without a presence bit never reach an aggregate.
+ */
+TEST(ColumnarBatchTests, Kernels_IgnoreAbsentRows) {
+    // Arrange: 100 rows of extreme values, where only rows 3, 64 and 99 are present
+    std::vector<int32_t> ints(100, std::numeric_limits<int32_t>::min());
+    std::vector<float> floats(100, 1e30f);
+    std::vector<uint8_t> types(100, 1);
+    std::vector<uint64_t> presence(2, 0);
+    for (size_t row : { 3u, 64u, 99u }) {
+        ints[row] = static_cast<int32_t>(row);
+        floats[row] = static_cast<float>(row) / 2;
+        types[row] = static_cast<uint8_t>(row % 3);
+        presence[row / 64] |= uint64_t(1) << (row % 64);
+    }
+
+    for (SimdLevel level : ALL_LEVELS) {
+        SCOPED_TRACE(SimdLevelName(level));
+
+        // Act: Run each kernel
+        IntSummary intSummary = SummarizeInts(ints.data(), presence.data(), ints.size(), level);
+        FloatSummary floatSummary = SummarizeFloats(floats.data(), presence.data(), floats.size(), level);
+        uint64_t bins[TYPE_COUNT] = {};
+        CountByValue(types.data(), presence.data(), types.size(), bins, TYPE_COUNT, level);
+
+        // Assert: Ensure only the present rows were counted
+        EXPECT_EQ(intSummary.count, 3u);
+        EXPECT_EQ(intSummary.sum, 3 + 64 + 99);
+        EXPECT_EQ(intSummary.min, 3);
+        EXPECT_EQ(intSummary.max, 99);
+        EXPECT_DOUBLE_EQ(floatSummary.sum, 83.0);
+        EXPECT_EQ(floatSummary.max, 49.5f);
+        EXPECT_EQ(bins[0], 2u); // Rows 3 and 99
+        EXPECT_EQ(bins[1], 1u); // Row 64
+        EXPECT_EQ(bins[2], 0u);
+    }
+}
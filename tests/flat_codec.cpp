@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <google/protobuf/descriptor.h>
+#include "flat_codec.h"
+
+/**
+ * @brief Tests that the flat schema covers exactly the fields declared in ipc_data.proto.
+ *
+ * Field numbers and types are checked at compile time; this catches a field
+ * added to the proto without a matching flat slot. Only the string dictionary
+ * fields are allowed to be protobuf-only.
+ */
+TEST(FlatCodecTests, Schema_MatchesProtoDescriptor) {
+    // Arrange: Look up the generated descriptor
+    const google::protobuf::Descriptor* descriptor = IPCData::descriptor();
+
+    // Act & Assert: Ensure the record field counts agree and each flat field exists in the proto
+    size_t recordFields = 0;
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        recordFields += descriptor->field(i)->number() < flat::FIRST_PROTOBUF_ONLY_FIELD ? 1 : 0;
+    }
+    ASSERT_EQ(recordFields, flat::FIELD_COUNT);
+    std::apply([&](auto... fields) {
+        ([&](auto field) {
+            EXPECT_NE(descriptor->FindFieldByNumber(decltype(field)::number), nullptr);
+        }(fields), ...);
+    }, flat::Schema{});
+}
+
+/**
+ * @brief Tests a flat round trip with every field set.
+ */
+TEST(FlatCodecTests, RoundTrip_AllFieldsSet) {
+    // Arrange: Create the original data object
+    T_IPCData originalDataObject { std::numeric_limits<int>::min(), 1701.0f, "Make it so", IPCData::TYPE3 };
+
+    // Act: Encode flat and construct a new object from the frame
+    std::string serializedMessage = originalDataObject.SerializeFlat();
+    T_IPCData newDataObject { serializedMessage };
+
+    // Assert: Ensure the frame is flat and the new object matches the original
+    EXPECT_TRUE(flat::IsFlatFrame(serializedMessage.data(), serializedMessage.size()));
+    EXPECT_EQ(serializedMessage.size(), flat::FIXED_SIZE + 10);
+    EXPECT_EQ(newDataObject.GetTheInt().value(), std::numeric_limits<int>::min());
+    EXPECT_FLOAT_EQ(newDataObject.GetTheFloat().value(), 1701.0f);
+    EXPECT_EQ(newDataObject.GetTheString().value(), "Make it so");
+    EXPECT_EQ(newDataObject.GetTheType().value(), IPCData::TYPE3);
+}
+
+/**
+ * @brief Tests a flat round trip with unset fields, including an empty-but-set string.
+ */
+TEST(FlatCodecTests, RoundTrip_UnsetFields) {
+    // Arrange: Create the original data object with some unset fields
+    T_IPCData originalDataObject { std::nullopt, 13.37f, std::string(), std::nullopt };
+
+    // Act: Encode flat and view the frame in place
+    std::string serializedMessage = originalDataObject.SerializeFlat();
+    IPCDataView view { serializedMessage };
+
+    // Assert: Ensure presence is preserved exactly
+    EXPECT_FALSE(view.GetTheInt().has_value());
+    EXPECT_FLOAT_EQ(view.GetTheFloat().value(), 13.37f);
+    EXPECT_EQ(view.GetTheString().value(), "");
+    EXPECT_FALSE(view.GetTheType().has_value());
+}
+
+/**
+ * @brief Tests that malformed flat frames are rejected.
+ */
+TEST(FlatCodecTests, Decode_RejectsMalformedFrames) {
+    // Arrange: A valid frame, then truncated, padded and enum-corrupted copies
+    std::string valid = T_IPCData { 1, 2.0f, "three", IPCData::TYPE2 }.SerializeFlat();
+    std::string truncated = valid.substr(0, valid.size() - 1);
+    std::string padded = valid + "x";
+    std::string badEnum = valid;
+    badEnum[flat::OFFSET<std::tuple_element_t<3, flat::Schema>>] = 99;
+
+    // Act & Assert: Expect each to throw
+    EXPECT_THROW(T_IPCData { truncated }, std::runtime_error);
+    EXPECT_THROW(T_IPCData { padded }, std::runtime_error);
+    EXPECT_THROW(T_IPCData { badEnum }, std::out_of_range);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "ipc_data_view.h"
+#include "t_ipc_data.h"
+
+/*
+    Counts every heap allocation made by the test binary, so the tests below
+    can assert that the steady-state receive path does not allocate.
+*/
+static std::atomic<size_t> allocationCount { 0 };
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+/**
+ * @brief Tests that the view exposes the same field values as the owning parse.
+ */
+TEST(IPCDataViewTests, Parse_MatchesTIPCData) {
+    // Arrange: Serialize a fully populated object
+    T_IPCData original { -47, 1701.5f, "Make it so", IPCData::TYPE3 };
+    std::string serializedMessage = original.Serialize();
+
+    // Act: Parse it in place
+    IPCDataView view { serializedMessage };
+
+    // Assert: Ensure every field matches and the string points into the buffer
+    EXPECT_EQ(view.GetTheInt().value(), -47);
+    EXPECT_FLOAT_EQ(view.GetTheFloat().value(), 1701.5f);
+    EXPECT_EQ(view.GetTheString().value(), "Make it so");
+    EXPECT_EQ(view.GetTheType().value(), IPCData::TYPE3);
+    EXPECT_GE(view.GetTheString()->data(), serializedMessage.data());
+    EXPECT_LT(view.GetTheString()->data(), serializedMessage.data() + serializedMessage.size());
+}
+
+/**
+ * @brief Tests that unset fields stay unset, including after re-parsing a reused view.
+ */
+TEST(IPCDataViewTests, Parse_ResetsFieldsBetweenMessages) {
+    // Arrange: A full message followed by an empty one
+    std::string full = T_IPCData { 1, 2.0f, "three", IPCData::TYPE2 }.Serialize();
+    std::string empty = T_IPCData {}.Serialize();
+    IPCDataView view { full };
+
+    // Act: Reuse the view for the empty message
+    view.Parse(empty.data(), empty.size());
+
+    // Assert: Ensure nothing from the first message is still reported
+    EXPECT_FALSE(view.GetTheInt().has_value());
+    EXPECT_FALSE(view.GetTheFloat().has_value());
+    EXPECT_FALSE(view.GetTheString().has_value());
+    EXPECT_FALSE(view.GetTheType().has_value());
+}
+
+/**
+ * @brief Tests that the view rejects out-of-range enums and truncated input like T_IPCData does.
+ */
+TEST(IPCDataViewTests, Parse_RejectsInvalidInput) {
+    // Arrange: An out-of-range enum and a truncated string field
+    IPCData proto;
+    proto.set_the_type(static_cast<IPCData::Type>(999));
+    std::string invalidEnum;
+    ASSERT_TRUE(proto.SerializeToString(&invalidEnum));
+    std::string truncated = T_IPCData { std::nullopt, std::nullopt, "truncated", std::nullopt }.Serialize();
+    truncated.pop_back();
+
+    // Act & Assert: Expect both to throw the same exceptions as T_IPCData
+    EXPECT_THROW(IPCDataView { invalidEnum }, std::out_of_range);
+    EXPECT_THROW(IPCDataView { truncated }, std::runtime_error);
+    EXPECT_THROW(T_IPCData { truncated }, std::runtime_error);
+}
+
+/**
+ * @brief Tests that parsing into a reused view never touches the heap.
+ */
+TEST(IPCDataViewTests, Parse_DoesNotAllocate) {
+    // Arrange: A message whose string is too long for the small-string buffer
+    std::string serializedMessage = T_IPCData { 47, 1701.0f, "2024-01-01 12:34:56.789", IPCData::TYPE2 }.Serialize();
+    IPCDataView view;
+
+    // Act: Parse it many times
+    size_t before = allocationCount.load();
+    int total = 0;
+    for (int i = 0; i < 1000; ++i) {
+        view.Parse(serializedMessage.data(), serializedMessage.size());
+        total += view.GetTheInt().value() + static_cast<int>(view.GetTheString()->size());
+    }
+    size_t allocations = allocationCount.load() - before;
+
+    // Assert: Ensure no allocations were made
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(total, 1000 * (47 + 23));
+}
+
+/**
+ * @brief Tests that the buffer constructor recycles its Protobuf object once warmed up.
+ */
+TEST(IPCDataViewTests, BufferConstructor_SteadyStateDoesNotAllocate) {
+    // Arrange: A message whose string fits in the small-string buffer, and one warm-up parse
+    std::string serializedMessage = T_IPCData { 47, 1701.0f, "short", IPCData::TYPE2 }.Serialize();
+    T_IPCData warmUp { serializedMessage.data(), serializedMessage.size() };
+
+    // Act: Parse it many times
+    size_t before = allocationCount.load();
+    for (int i = 0; i < 1000; ++i) {
+        T_IPCData data { serializedMessage.data(), serializedMessage.size() };
+        EXPECT_EQ(data.GetTheInt().value(), 47);
+    }
+    size_t allocations = allocationCount.load() - before;
+
+    // Assert: Ensure no allocations were made
+    EXPECT_EQ(allocations, 0u);
+}
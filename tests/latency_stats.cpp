@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "latency_stats.h"
+
+/**
+ * @brief Tests that every bucket's upper bound maps back to that bucket and bounds stay within ~3%.
+ */
+TEST(LatencyHistogramTests, BucketIndex_IsMonotonicWithBoundedError) {
+    // Arrange & Act & Assert: Walk every bucket
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        const uint64_t upper = LatencyHistogram::BucketUpperBound(i);
+        ASSERT_EQ(LatencyHistogram::BucketIndex(upper), i);
+        if (i > 0) {
+            const uint64_t lower = LatencyHistogram::BucketUpperBound(i - 1) + 1;
+            ASSERT_EQ(LatencyHistogram::BucketIndex(lower), i);
+            EXPECT_LE(static_cast<double>(upper - lower), lower / static_cast<double>(LatencyHistogram::SUB_BUCKET_COUNT));
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+/**
+ * @brief Tests percentiles over a uniform spread of values.
+ */
+TEST(LatencyHistogramTests, Percentile_UniformValues) {
+    // Arrange: Record 1..100000
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.Record(value);
+    }
+
+    // Act & Assert: Ensure each percentile is within the bucket error and never understated
+    EXPECT_EQ(histogram.Count(), 100000u);
+    EXPECT_EQ(histogram.Min(), 1u);
+    EXPECT_EQ(histogram.Max(), 100000u);
+    EXPECT_GE(histogram.Percentile(50), 50000u);
+    EXPECT_LE(histogram.Percentile(50), 50000u * 33 / 32);
+    EXPECT_GE(histogram.Percentile(99.9), 99900u);
+    EXPECT_EQ(histogram.Percentile(100), 100000u);
+}
+
+/**
+ * @brief Tests that merging combines counts and extremes, and reset empties the histogram.
+ */
+TEST(LatencyHistogramTests, MergeAndReset) {
+    // Arrange: Two histograms with disjoint values
+    LatencyHistogram low, high;
+    low.Record(10);
+    high.Record(1000000);
+
+    // Act: Merge, then reset the source
+    low.Merge(high);
+    high.Reset();
+
+    // Assert: Ensure the merged histogram spans both and the reset one is empty
+    EXPECT_EQ(low.Count(), 2u);
+    EXPECT_EQ(low.Min(), 10u);
+    EXPECT_EQ(low.Max(), 1000000u);
+    EXPECT_EQ(low.Percentile(50), 10u);
+    EXPECT_EQ(high.Count(), 0u);
+    EXPECT_EQ(high.Percentile(99), 0u);
+}
+
+/**
+ * @brief Tests gap, reorder, duplicate and restart detection.
+ */
+TEST(SequenceTrackerTests, Observe_ClassifiesAnomalies) {
+    // Arrange: A tracker over 1, 2, 5 (3 and 4 missing)
+    SequenceTracker tracker;
+    tracker.Observe(1);
+    tracker.Observe(2);
+    tracker.Observe(5);
+    EXPECT_EQ(tracker.Missing(), 2u);
+
+    // Act: 3 arrives late, 5 arrives twice, then the sender restarts at 1
+    tracker.Observe(3);
+    tracker.Observe(5);
+    tracker.Observe(1000);
+    tracker.Observe(1);
+
+    // Assert: Ensure each anomaly is counted once
+    EXPECT_EQ(tracker.Reordered(), 1u);
+    EXPECT_EQ(tracker.Duplicates(), 1u);
+    EXPECT_EQ(tracker.Missing(), 1u + 994u);
+    EXPECT_EQ(tracker.Restarts(), 1u);
+
+    tracker.ResetCounters();
+    tracker.Observe(2);
+    EXPECT_EQ(tracker.Missing(), 0u);
+    EXPECT_EQ(tracker.Reordered(), 0u);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include "load_generator.h"
+
+/**
+ * @brief Tests that each arrival pattern keeps the requested mean rate, with the expected spacing.
+ */
+TEST(LoadGeneratorTests, ArrivalSchedule_KeepsTheRate) {
+    // Arrange: 1000 records/s, i.e. a 1 ms mean gap
+    ArrivalSchedule uniform(1000.0, ArrivalPattern::Uniform, 1, 7);
+    ArrivalSchedule poisson(1000.0, ArrivalPattern::Poisson, 1, 7);
+    ArrivalSchedule burst(1000.0, ArrivalPattern::Burst, 4, 7);
+
+    // Act & Assert: Uniform arrivals are exactly 1 ms apart
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(uniform.Next(), std::chrono::milliseconds(i));
+    }
+
+    // Bursts of 4 are due together, 4 ms apart
+    for (int i = 0; i < 12; ++i) {
+        EXPECT_EQ(burst.Next(), std::chrono::milliseconds(i / 4 * 4));
+    }
+
+    // Poisson arrivals only move forward, and 10000 of them take about 10 s
+    std::chrono::nanoseconds previous { 0 }, due { 0 };
+    for (int i = 0; i < 10000; ++i) {
+        due = poisson.Next();
+        ASSERT_GE(due, previous);
+        previous = due;
+    }
+    EXPECT_NEAR(std::chrono::duration<double>(due).count(), 10.0, 0.5);
+
+    EXPECT_THROW(ArrivalSchedule(0.0, ArrivalPattern::Uniform, 1, 1), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that arrival pattern names parse to their patterns and that unknown names are rejected.
+ */
+TEST(LoadGeneratorTests, ParseArrivalPattern_RejectsUnknownNames) {
+    // Act & Assert: Ensure every documented name parses, and a typo does not fall back to uniform
+    EXPECT_EQ(ParseArrivalPattern("uniform"), ArrivalPattern::Uniform);
+    EXPECT_EQ(ParseArrivalPattern("poisson"), ArrivalPattern::Poisson);
+    EXPECT_EQ(ParseArrivalPattern("burst"), ArrivalPattern::Burst);
+    EXPECT_THROW(ParseArrivalPattern("bursty"), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that the record pool honours the field presence probabilities and string lengths.
+ */
+TEST(LoadGeneratorTests, MakeRecordPool_FollowsTheProfile) {
+    // Arrange: Ints always, floats never, strings half the time with lengths 5..9
+    LoadProfile profile;
+    profile.presence = { 1.0, 0.0, 0.5, 1.0 };
+    profile.stringMin = 5;
+    profile.stringMax = 9;
+    profile.poolSize = 2000;
+
+    // Act: Generate the pool
+    const std::vector<T_IPCData> pool = MakeRecordPool(profile);
+
+    // Assert: Ensure every record matches the profile
+    ASSERT_EQ(pool.size(), 2000u);
+    size_t strings = 0;
+    for (const T_IPCData& data : pool) {
+        EXPECT_TRUE(data.GetTheInt().has_value());
+        EXPECT_FALSE(data.GetTheFloat().has_value());
+        EXPECT_TRUE(data.GetTheType().has_value());
+        if (auto text = data.GetTheString()) {
+            ++strings;
+            EXPECT_GE(text->size(), 5u);
+            EXPECT_LE(text->size(), 9u);
+        }
+    }
+    EXPECT_NEAR(static_cast<double>(strings), 1000.0, 150.0);
+
+    profile.stringMin = 10;
+    EXPECT_THROW(MakeRecordPool(profile), std::invalid_argument);
+}
+
+/**
+ * @brief Tests a short run: every producer thread sends, failures are counted, and the schedule decides how many are offered.
+ *
+ * A late record is sent at once rather than skipped, so the count does not
+ * depend on how fast the machine is; only the time bounds do, and those hold
+ * however late the producers run.
+ */
+TEST(LoadGeneratorTests, Run_SendsAtTheTargetRate) {
+    // Arrange: 2000 records/s from two threads for 250 ms, where every tenth send fails
+    LoadProfile profile;
+    profile.rate = 2000.0;
+    profile.threads = 2;
+    profile.duration = std::chrono::milliseconds(250);
+    profile.poolSize = 64;
+    LoadGenerator generator(profile);
+    std::atomic<uint64_t> calls[2] = { { 0 }, { 0 } };
+
+    // Act: Run against a send function that only counts
+    const LoadReport report = generator.Run(
+        [&](size_t thread, const T_IPCData&) {
+            if (calls[thread].fetch_add(1) % 10 == 9) {
+                throw std::runtime_error("queue full");
+            }
+        },
+        [] { return false; });
+
+    // Assert: Ensure each thread offered its 250 scheduled records, errors were counted, and the run ended on time
+    EXPECT_EQ(calls[0].load(), 250u);
+    EXPECT_EQ(calls[1].load(), 250u);
+    EXPECT_EQ(report.sent, 450u);
+    EXPECT_EQ(report.errors, 50u);
+    EXPECT_EQ(report.latency.Count(), 500u);
+    EXPECT_GE(report.seconds, 0.249);
+    EXPECT_LE(report.seconds, 0.25);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include "log_sink.h"
+
+/**
+ * @brief Reads exactly `size` bytes from a descriptor, polling if it is non-blocking.
+ */
+static std::string ReadExactly(int fd, size_t size) {
+    std::string data(size, '\0');
+    size_t received = 0;
+    while (received < size) {
+        ssize_t count = read(fd, data.data() + received, size - received);
+        if (count > 0) {
+            received += static_cast<size_t>(count);
+        } else {
+            usleep(1000);
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Tests that every queued line reaches the descriptor intact and in order.
+ */
+TEST(LogSinkTests, Write_PreservesContentAndOrder) {
+    // Arrange: A pipe with the sink on its write end
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string expected;
+
+    // Act: Queue many lines from this thread, then wait for them to be written
+    {
+        LogSink sink(fds[1]);
+        EXPECT_EQ(sink.Format(), LogFormat::Compact);
+        for (int i = 0; i < 1000; ++i) {
+            std::string line = "line " + std::to_string(i) + "\n";
+            expected += line;
+            EXPECT_TRUE(sink.Write(line));
+        }
+        sink.Flush();
+    }
+
+    // Assert: Ensure the output is exactly the concatenation of the lines
+    EXPECT_EQ(ReadExactly(fds[0], expected.size()), expected);
+    EXPECT_EQ(ReadExactly(fds[0], 0), "");
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/**
+ * @brief Tests that the Drop policy discards lines instead of waiting on a stalled output.
+ */
+TEST(LogSinkTests, Write_DropPolicyNeverBlocks) {
+    // Arrange: Fill a pipe so the writer thread stalls, and give the sink room for two lines
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    size_t filler = 0;
+    char chunk[4096] = {};
+    ssize_t count;
+    while ((count = write(fds[1], chunk, sizeof(chunk))) > 0) {
+        filler += static_cast<size_t>(count);
+    }
+    fcntl(fds[1], F_SETFL, 0);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    const std::string line(31, 'x');
+
+    LogSink sink(fds[1], LogOverflowPolicy::Drop, 2 * (line.size() + 1));
+
+    // Act: Queue more lines than fit while the output is stalled
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+        accepted += sink.Write(line + "\n") ? 1 : 0;
+    }
+
+    // Drain the pipe so the writer can finish
+    ReadExactly(fds[0], filler);
+    std::string written = ReadExactly(fds[0], accepted * (line.size() + 1));
+    sink.Flush();
+
+    // Assert: Ensure only what fit was kept, and everything else was counted as dropped
+    EXPECT_EQ(accepted, 2);
+    EXPECT_EQ(sink.Dropped(), 8u);
+    EXPECT_EQ(written, line + "\n" + line + "\n");
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/**
+ * @brief Tests that the human layout matches T_IPCData::ToString, with and without tracing fields.
+ */
+TEST(LogSinkTests, AppendRecord_HumanMatchesToString) {
+    // Arrange: A full record, an empty one, and a traced one
+    T_IPCData full { -47, 1701.5f, "Make it so", IPCData::TYPE3 };
+    T_IPCData empty {};
+    T_IPCData traced { 1, std::nullopt, std::nullopt, std::nullopt };
+    traced.SetTrace(123456789, 42);
+
+    // Act & Assert: Ensure each one renders identically
+    for (const T_IPCData* data : { &full, &empty, &traced }) {
+        LogLine line;
+        AppendRecord(line, *data, LogFormat::Human);
+        EXPECT_EQ(line.View(), data->ToString());
+    }
+}
+
+/**
+ * @brief Tests the compact layout, including escaping that keeps a record on one line.
+ */
+TEST(LogSinkTests, AppendRecord_CompactIsOneLine) {
+    // Arrange: A record whose string contains a quote and a newline
+    T_IPCData data { 47, 0.25f, "say \"hi\"\nbye", IPCData::TYPE2 };
+
+    // Act: Render it
+    LogLine line;
+    AppendRecord(line, data, LogFormat::Compact);
+
+    // Assert: Ensure the fields are key=value pairs and the string is escaped
+    EXPECT_EQ(line.View(), " int=47 float=0.250000 string=\"say \\\"hi\\\"\\nbye\" type=1");
+    EXPECT_FALSE(line.Truncated());
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "mpmc_queue.h"
+
+/**
+ * @brief Tests FIFO order and that pushes fail once the queue is full.
+ */
+TEST(MpmcQueueTests, PushPop_FifoAndBounded) {
+    // Arrange: A four-slot queue
+    MpmcQueue<int> queue(4);
+
+    // Act: Fill it, then try one more
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.TryPush([i](int& slot) { slot = i; }));
+    }
+    bool overflowed = !queue.TryPush([](int& slot) { slot = 99; });
+
+    // Assert: Ensure the extra push failed and elements come out in order
+    EXPECT_TRUE(overflowed);
+    for (int i = 0; i < 4; ++i) {
+        int value = -1;
+        ASSERT_TRUE(queue.TryPop([&](int& slot) { value = slot; }));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.TryPop([](int&) { }));
+    EXPECT_THROW(MpmcQueue<int>(6), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that concurrent producers and consumers transfer every element exactly once.
+ */
+TEST(MpmcQueueTests, Concurrent_EveryElementOnce) {
+    // Arrange: Two producers and two consumers over a small queue
+    constexpr int PER_PRODUCER = 50000;
+    MpmcQueue<int> queue(64);
+    std::atomic<int> consumed { 0 };
+    std::atomic<long long> sum { 0 };
+    std::vector<std::thread> threads;
+
+    // Act: Push 1..N from each producer while the consumers pop until everything arrived
+    for (int p = 0; p < 2; ++p) {
+        threads.emplace_back([&] {
+            for (int i = 1; i <= PER_PRODUCER; ++i) {
+                while (!queue.TryPush([i](int& slot) { slot = i; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            while (consumed.load() < 2 * PER_PRODUCER) {
+                int value = 0;
+                if (queue.TryPop([&](int& slot) { value = slot; })) {
+                    sum += value;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Assert: Ensure the totals match exactly
+    EXPECT_EQ(consumed.load(), 2 * PER_PRODUCER);
+    EXPECT_EQ(sum.load(), 2LL * PER_PRODUCER * (PER_PRODUCER + 1) / 2);
+}
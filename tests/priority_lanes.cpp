@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <mqueue.h>
+#include <unistd.h>
+#include "priority_lanes.h"
+#include "sender.h"
+#include "test_queue.h"
+
+/**
+ * @brief Queues one single-byte message tagged with its own priority.
+ */
+static void Receive(PriorityLanes& lanes, unsigned priority) {
+    char* buffer = lanes.FreeBuffer();
+    ASSERT_NE(buffer, nullptr);
+    buffer[0] = static_cast<char>('0' + priority);
+    lanes.Commit(1, priority);
+}
+
+/**
+ * @brief Dispatches everything queued and returns the priorities in dispatch order.
+ */
+static std::string DispatchAll(PriorityLanes& lanes) {
+    std::string order;
+    while (lanes.Dispatch([&](const char* data, size_t size, unsigned priority) {
+        EXPECT_EQ(size, 1u);
+        EXPECT_EQ(data[0], static_cast<char>('0' + priority));
+        order += data[0];
+    })) { }
+    return order;
+}
+
+/**
+ * @brief Tests that strict priority serves the most urgent lane first and keeps each lane in order.
+ */
+TEST(PriorityLanesTests, Dispatch_ServesHighestLaneFirst) {
+    // Arrange: Strict priority (no starvation limit), messages arriving low to high
+    PriorityLanes lanes(8, 0);
+    for (unsigned priority : { 0u, 1u, 3u, 0u, 3u, 9u }) {
+        Receive(lanes, std::min(priority, static_cast<unsigned>(PRIORITY_LEVELS - 1)));
+    }
+
+    const size_t buffered = lanes.Buffered();
+
+    // Act: Dispatch everything
+    std::string order = DispatchAll(lanes);
+
+    // Assert: Ensure lanes are served top-down and buffers are recycled
+    EXPECT_EQ(buffered, 6u);
+    EXPECT_EQ(order, "333100");
+    EXPECT_TRUE(lanes.Empty());
+    EXPECT_EQ(lanes.Dispatched(3), 3u);
+    EXPECT_EQ(lanes.Promoted(), 0u);
+}
+
+/**
+ * @brief Tests that a waiting bulk lane is served after at most `starvationLimit` urgent dispatches.
+ */
+TEST(PriorityLanesTests, Dispatch_GuaranteesMinimumShare) {
+    // Arrange: A steady stream of urgent traffic with one bulk message waiting
+    PriorityLanes lanes(16, 2);
+    Receive(lanes, 0);
+    for (int i = 0; i < 7; ++i) {
+        Receive(lanes, 3);
+    }
+
+    // Act: Dispatch everything
+    std::string order = DispatchAll(lanes);
+
+    // Assert: Ensure the bulk message got the third turn instead of the last
+    EXPECT_EQ(order, "33033333");
+    EXPECT_EQ(lanes.Promoted(), 1u);
+}
+
+/**
+ * @brief Tests that the sender maps types to queue priorities and sends urgent records ahead of a batch.
+ */
+TEST(PriorityLanesTests, Sender_SendsAtMappedPriority) {
+    // Arrange: A receive queue and a batching sender with TYPE3 mapped to the top priority
+    const std::string name = "/ipc_priority_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetTypePriority(IPCData::TYPE3, PRIORITY_LEVELS - 1);
+    sender.SetBatchPolicy(BatchPolicy { MAX_MESSAGE_SIZE, std::chrono::seconds(10) });
+
+    // Act: Batch two bulk records, then enqueue an urgent one and flush
+    sender.Enqueue(T_IPCData { 1, std::nullopt, std::nullopt, IPCData::TYPE1 });
+    sender.Enqueue(T_IPCData { 2, std::nullopt, std::nullopt, std::nullopt });
+    sender.Enqueue(T_IPCData { 3, std::nullopt, std::nullopt, IPCData::TYPE3 });
+    sender.Flush();
+
+    char buffer[MAX_MESSAGE_SIZE];
+    unsigned firstPriority = 0;
+    unsigned secondPriority = 0;
+    ssize_t firstSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, &firstPriority);
+    T_IPCData first { buffer, static_cast<size_t>(firstSize) };
+    ssize_t secondSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, &secondPriority);
+
+    // Assert: Ensure the urgent record came out first on its own, then the bulk batch
+    EXPECT_EQ(first.GetTheInt(), 3);
+    EXPECT_EQ(firstPriority, static_cast<unsigned>(PRIORITY_LEVELS - 1));
+    EXPECT_TRUE(IsBatchFrame(buffer, secondSize));
+    EXPECT_EQ(secondPriority, 0u);
+    EXPECT_THROW(sender.Send(first, PRIORITY_LEVELS), std::out_of_range);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <mqueue.h>
+#include <unistd.h>
+#include "batch_frame.h"
+#include "queue_provisioner.h"
+#include "sender.h"
+#include "slab_pool.h"
+#include "test_queue.h"
+
+/**
+ * @brief Returns a queue name unique to this test process, with any leftover queue removed.
+ */
+static std::string TestQueueName() {
+    const std::string name = "/ipc_provision_test." + std::to_string(getpid());
+    mq_unlink(name.c_str());
+    return name;
+}
+
+/**
+ * @brief Tests that the plan covers bursts and stalls, and names the kernel limit that capped it.
+ */
+TEST(QueueProvisionerTests, Plan_CapsAndNamesTheLimit) {
+    // Arrange: A workload needing 100 messages of headroom, and two sets of limits
+    QueueWorkload workload;
+    workload.messagesPerSecond = 10000;
+    workload.stallMs = 10;
+    workload.burstMessages = 40;
+    workload.maxRecordSize = 200;
+    workload.queueCount = 2;
+
+    MqueueLimits sysctl;
+    sysctl.maxDepth = 10;
+    sysctl.maxMessageSize = 8192;
+
+    MqueueLimits rlimit;
+    rlimit.maxDepth = 65536;
+    rlimit.maxMessageSize = 8192;
+    rlimit.byteBudget = 20000;
+    rlimit.privileged = true;
+
+    // Act: Plan for each
+    QueueProvisioner bySysctl(workload, sysctl);
+    QueueProvisioner byRlimit(workload, rlimit);
+    workload.maxRecordSize = 1 << 20;
+    QueueProvisioner uncapped(workload, MqueueLimits { 65536, 1 << 20, UINT64_MAX, true });
+    workload.maxRecordSize = 1;
+    QueueProvisioner tiny(workload, MqueueLimits { 65536, 1 << 20, UINT64_MAX, true });
+
+    // Assert: Ensure the requested size, the caps and the reasons
+    EXPECT_EQ(bySysctl.RequestedDepth(), 100);
+    EXPECT_EQ(bySysctl.Depth(), 10);
+    EXPECT_EQ(bySysctl.MessageSize(), 200);
+    EXPECT_NE(bySysctl.Describe().find("capped by fs.mqueue.msg_max"), std::string::npos);
+
+    EXPECT_EQ(byRlimit.Depth(), 10000 / (200 + 96)); // Each of the two queues gets half the budget
+    EXPECT_NE(byRlimit.Describe().find("capped by RLIMIT_MSGQUEUE"), std::string::npos);
+
+    EXPECT_FALSE(uncapped.Capped());
+    EXPECT_EQ(uncapped.Depth(), 100);
+    EXPECT_EQ(uncapped.MessageSize(), MAX_MESSAGE_SIZE); // Larger records go through the slab pool
+    EXPECT_EQ(tiny.MessageSize(), static_cast<long>(SLAB_DESCRIPTOR_SIZE)); // Room for a slab descriptor
+}
+
+/**
+ * @brief Tests that reopening a queue attaches to it and keeps the messages still in it.
+ */
+TEST(QueueProvisionerTests, Open_AttachesAndKeepsPendingMessages) {
+    // Arrange: A provisioned queue with three messages left in it by a "previous run"
+    const std::string name = TestQueueName();
+    QueueProvisioner provisioner { QueueWorkload() };
+    QueueOpenResult first = provisioner.Open(name, O_RDONLY | O_NONBLOCK);
+    ASSERT_EQ(first.origin, QueueOrigin::Created);
+    {
+        Sender sender(SenderTransport::MQueue, name);
+        for (int i = 0; i < 3; ++i) {
+            sender.Send(T_IPCData { i, std::nullopt, std::nullopt, std::nullopt });
+        }
+    }
+    mq_close(first.mq);
+
+    // Act: Open it again, as a restarted receiver would
+    QueueOpenResult second = provisioner.Open(name, O_RDONLY | O_NONBLOCK);
+
+    // Assert: Ensure it was attached to, with the messages in order
+    EXPECT_EQ(second.origin, QueueOrigin::Attached);
+    EXPECT_EQ(second.attr.mq_curmsgs, 3);
+    char buffer[MAX_MESSAGE_SIZE];
+    for (int i = 0; i < 3; ++i) {
+        ssize_t size = mq_receive(second.mq, buffer, sizeof(buffer), nullptr);
+        ASSERT_GT(size, 0);
+        EXPECT_EQ(T_IPCData(buffer, static_cast<size_t>(size)).GetTheInt(), i);
+    }
+
+    mq_close(second.mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a smaller queue another process created is attached to as it is, not recreated.
+ */
+TEST(QueueProvisionerTests, Open_AttachesToSmallerQueue) {
+    // Arrange: An empty two-message queue, as a sender that started first would leave it
+    const std::string name = TestQueueName();
+    mqd_t existing = OpenTestQueue(name, 2, MAX_MESSAGE_SIZE, O_WRONLY);
+    ASSERT_NE(existing, (mqd_t)-1);
+
+    // Act: Open it with a provisioner planning a deeper queue
+    QueueProvisioner provisioner { QueueWorkload() };
+    QueueOpenResult result = provisioner.Open(name, O_RDONLY | O_NONBLOCK);
+
+    // Assert: Ensure the same queue was kept and its actual depth reported
+    EXPECT_EQ(result.origin, QueueOrigin::Attached);
+    EXPECT_EQ(result.attr.mq_maxmsg, 2);
+    ASSERT_EQ(mq_send(existing, "x", 1, 0), 0);
+    char buffer[MAX_MESSAGE_SIZE];
+    EXPECT_EQ(mq_receive(result.mq, buffer, sizeof(buffer), nullptr), 1);
+    EXPECT_NE(provisioner.Describe(name, result).find("smaller than the planned"), std::string::npos);
+
+    mq_close(existing);
+    mq_close(result.mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a queue whose messages do not fit the receive buffer is refused and left in place.
+ */
+TEST(QueueProvisionerTests, Open_RejectsUnreceivableQueue) {
+    // Arrange: A leftover queue with messages larger than MAX_MESSAGE_SIZE, holding one message
+    const std::string name = TestQueueName();
+    mqd_t leftover = OpenTestQueue(name, 2, MAX_MESSAGE_SIZE * 2, O_WRONLY);
+    ASSERT_NE(leftover, (mqd_t)-1);
+    ASSERT_EQ(mq_send(leftover, "x", 1, 0), 0);
+    mq_close(leftover);
+
+    // Act & Assert: Ensure opening it with the provisioner fails
+    QueueProvisioner provisioner { QueueWorkload() };
+    EXPECT_THROW(provisioner.Open(name, O_RDONLY | O_NONBLOCK), std::runtime_error);
+
+    // Assert: Ensure the queue and its message are still there
+    mqd_t reopened = mq_open(name.c_str(), O_RDONLY);
+    ASSERT_NE(reopened, (mqd_t)-1);
+    struct mq_attr attr {};
+    mq_getattr(reopened, &attr);
+    EXPECT_EQ(attr.mq_curmsgs, 1);
+
+    mq_close(reopened);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a sender keeps its batches within a queue provisioned with smaller messages.
+ */
+TEST(QueueProvisionerTests, Sender_AdoptsProvisionedMessageSize) {
+    // Arrange: A queue provisioned for 128-byte messages and a batching sender on it
+    const std::string name = TestQueueName();
+    QueueWorkload workload;
+    workload.maxRecordSize = 128;
+    QueueProvisioner provisioner(workload);
+    QueueOpenResult queue = provisioner.Open(name, O_RDONLY | O_NONBLOCK);
+    Sender sender(SenderTransport::MQueue, name);
+    BatchPolicy policy;
+    policy.maxDelay = std::chrono::seconds(60);
+    sender.SetBatchPolicy(policy);
+
+    // Act: Queue more records than fit in one 128-byte message
+    for (int i = 0; i < 9; ++i) {
+        sender.Enqueue(T_IPCData { i, 1.5f, "RandomString", IPCData::TYPE2 });
+    }
+    sender.Flush();
+
+    // Assert: Ensure every message fits and every record arrived in order
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t size;
+    int expected = 0;
+    while ((size = mq_receive(queue.mq, buffer, sizeof(buffer), nullptr)) > 0) {
+        EXPECT_LE(size, 128);
+        ASSERT_TRUE(IsBatchFrame(buffer, static_cast<size_t>(size)));
+        for (std::string_view record : BatchView(buffer, static_cast<size_t>(size))) {
+            EXPECT_EQ(T_IPCData(record.data(), record.size()).GetTheInt(), expected++);
+        }
+    }
+    EXPECT_EQ(expected, 9);
+
+    mq_close(queue.mq);
+    mq_unlink(name.c_str());
+}
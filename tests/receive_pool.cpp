@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch_frame.h"
+#include "receive_pool.h"
+#include "string_dictionary.h"
+
+/**
+ * @brief Tests that every submitted record, single or batched, is decoded and handled exactly once.
+ */
+TEST(ReceivePoolTests, Submit_HandlesEveryRecordOnce) {
+    // Arrange: A four-worker pool that sums the_int
+    std::atomic<long long> sum { 0 };
+    std::atomic<int> handled { 0 };
+    ReceivePoolOptions options;
+    options.workers = 4;
+    options.queueDepth = 8;
+    ReceivePool pool([&](const T_IPCData& data, unsigned) { sum += data.GetTheInt().value(); ++handled; }, nullptr, options);
+
+    // Act: Submit single records and batches of ten, then wait for the pool
+    long long expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        std::string record = T_IPCData { i, std::nullopt, std::nullopt, std::nullopt }.Serialize();
+        pool.Submit(record.data(), record.size());
+        expected += i;
+    }
+    for (int b = 0; b < 100; ++b) {
+        BatchEncoder batch;
+        for (int i = 0; i < 10; ++i) {
+            std::string record = T_IPCData { b * 10 + i, std::nullopt, std::nullopt, std::nullopt }.Serialize();
+            batch.Append(record.data(), record.size());
+            expected += b * 10 + i;
+        }
+        pool.Submit(batch.Data(), batch.Size());
+    }
+    pool.Drain();
+
+    // Assert: Ensure the totals match
+    EXPECT_EQ(pool.WorkerCount(), 4u);
+    EXPECT_EQ(handled.load(), 2000);
+    EXPECT_EQ(sum.load(), expected);
+}
+
+/**
+ * @brief Tests that ByType ordering keeps records of each type in submission order.
+ */
+TEST(ReceivePoolTests, OrderByType_PreservesPerTypeOrder) {
+    // Arrange: A pool that appends the_int to a per-type list
+    std::mutex mutex;
+    std::map<int, std::vector<int>> seen;
+    ReceivePoolOptions options;
+    options.workers = 3;
+    options.queueDepth = 4;
+    options.ordering = RecordOrdering::ByType;
+    ReceivePool pool([&](const T_IPCData& data, unsigned) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen[data.GetTheType() ? static_cast<int>(*data.GetTheType()) : -1].push_back(data.GetTheInt().value());
+    }, nullptr, options);
+
+    // Act: Interleave records of every type, plus untyped ones
+    for (int i = 0; i < 3000; ++i) {
+        std::optional<IPCData::Type> type;
+        if (i % 4 != 3) {
+            type = static_cast<IPCData::Type>(i % 4);
+        }
+        std::string record = T_IPCData { i, std::nullopt, std::nullopt, type }.Serialize();
+        pool.Submit(record.data(), record.size());
+    }
+    pool.Drain();
+
+    // Assert: Ensure each type's records arrived in increasing order and none were stolen
+    ASSERT_EQ(seen.size(), 4u);
+    for (const auto& [type, values] : seen) {
+        EXPECT_EQ(values.size(), 750u);
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end())) << "type " << type;
+    }
+    EXPECT_EQ(pool.Stolen(), 0u);
+}
+
+/**
+ * @brief Tests that undecodable records and handler exceptions reach the error handler.
+ */
+TEST(ReceivePoolTests, Submit_ReportsErrors) {
+    // Arrange: A pool whose handler rejects negative ints
+    std::atomic<int> errors { 0 };
+    ReceivePoolOptions options;
+    options.workers = 2;
+    ReceivePool pool([](const T_IPCData& data, unsigned) {
+        if (data.GetTheInt().value_or(0) < 0) throw std::runtime_error("negative");
+    }, [&](const std::exception&) { ++errors; }, options);
+
+    // Act: Submit a garbage record, a rejected record and a malformed batch
+    const char garbage[] = { '\x08', '\x80' };
+    pool.Submit(garbage, sizeof(garbage));
+    std::string rejected = T_IPCData { -1, std::nullopt, std::nullopt, std::nullopt }.Serialize();
+    pool.Submit(rejected.data(), rejected.size());
+    const char badBatch[] = { static_cast<char>(BATCH_FRAME_MARKER), '\x05', 'x' };
+    pool.Submit(badBatch, sizeof(badBatch));
+    pool.Drain();
+
+    // Assert: Ensure all three failures were reported
+    EXPECT_EQ(errors.load(), 3);
+}
+
+/**
+ * @brief Tests that dictionary-coded records are resolved in arrival order before the workers decode them.
+ */
+TEST(ReceivePoolTests, Submit_ResolvesDictionaryCodedRecords) {
+    // Arrange: A pool with a dictionary decoder, and a definition followed by two references to it
+    StringDictionaryDecoder decoder;
+    std::mutex mutex;
+    std::vector<std::string> strings;
+    std::atomic<int> errors { 0 };
+    ReceivePoolOptions options;
+    options.workers = 2;
+    options.dictionary = &decoder;
+    ReceivePool pool([&](const T_IPCData& data, unsigned) {
+        std::lock_guard<std::mutex> lock(mutex);
+        strings.emplace_back(data.GetTheString().value_or("<unset>"));
+    }, [&](const std::exception&) { ++errors; }, options);
+    IPCData proto;
+    proto.set_the_string("RandomString");
+    proto.set_string_define(0);
+    proto.set_dict_stream(5);
+    proto.set_dict_epoch(1);
+    const std::string definition = proto.SerializeAsString();
+    proto.clear_the_string();
+    proto.clear_string_define();
+    proto.set_string_ref(0);
+    const std::string reference = proto.SerializeAsString();
+
+    // Act: Submit the definition alone, then both references in one batch
+    pool.Submit(definition.data(), definition.size());
+    BatchEncoder batch;
+    batch.Append(reference.data(), reference.size());
+    batch.Append(reference.data(), reference.size());
+    pool.Submit(batch.Data(), batch.Size());
+    pool.Drain();
+
+    // Assert: Ensure every record reached a worker with its string resolved
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(strings, (std::vector<std::string> { "RandomString", "RandomString", "RandomString" }));
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mqueue.h>
+#include <unistd.h>
+#include "rpc.h"
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Returns a request queue name unique to this test process, with any leftover queue removed.
+ */
+static std::string TestQueueName() {
+    const std::string name = "/ipc_rpc_test." + std::to_string(getpid());
+    mq_unlink(name.c_str());
+    return name;
+}
+
+/**
+ * @brief Tests that a call returns the server's reply to that call.
+ */
+TEST(RpcTests, Call_ReturnsTheReply) {
+    // Arrange: A server on its own thread that replies with the request's int doubled
+    const std::string name = TestQueueName();
+    RpcServer server(name, QueueProvisioner { QueueWorkload() });
+    RpcClient client(name);
+    std::atomic<bool> done { false };
+    std::thread serving([&] {
+        while (!done) {
+            if (std::optional<RpcRequest> request = server.Receive(10ms)) {
+                server.Reply(*request, T_IPCData { *request->data.GetTheInt() * 2, std::nullopt, std::nullopt, std::nullopt });
+            }
+        }
+    });
+
+    // Act: Make a few calls
+    std::vector<int> replies;
+    for (int i = 1; i <= 3; ++i) {
+        replies.push_back(*client.Call(T_IPCData { i, std::nullopt, std::nullopt, std::nullopt }, 1s).GetTheInt());
+    }
+    done = true;
+    serving.join();
+
+    // Assert: Ensure each reply matches its call and nothing is left outstanding
+    EXPECT_EQ(replies, (std::vector<int> { 2, 4, 6 }));
+    EXPECT_EQ(client.InFlight(), 0u);
+    EXPECT_EQ(server.Outstanding(), 0u);
+
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that pipelined requests answered out of order are matched to their ids.
+ */
+TEST(RpcTests, Pipelined_RepliesMatchedOutOfOrder) {
+    // Arrange: Three requests in flight, all taken by the server
+    const std::string name = TestQueueName();
+    RpcServer server(name, QueueProvisioner { QueueWorkload() });
+    RpcClient client(name);
+    ASSERT_GE(client.MaxInFlight(), 3u);
+    std::vector<uint64_t> ids;
+    std::vector<RpcRequest> requests;
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(client.Send(T_IPCData { i, std::nullopt, std::nullopt, std::nullopt }, 1s));
+        requests.push_back(*server.Receive(1s));
+    }
+    EXPECT_EQ(server.Outstanding(), 3u);
+
+    // Act: Answer them in reverse order, then wait for the first one sent
+    for (int i = 2; i >= 0; --i) {
+        server.Reply(requests[i], requests[i].data);
+    }
+    std::optional<T_IPCData> first = client.Wait(ids[0], 1s);
+
+    // Assert: Ensure the first reply is its own, and the others were kept for later
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->GetTheInt(), 0);
+    EXPECT_EQ(client.Wait(ids[2], 1s)->GetTheInt(), 2);
+    std::optional<RpcReply> any = client.WaitAny(1s);
+    ASSERT_TRUE(any.has_value());
+    EXPECT_EQ(any->id, ids[1]);
+    EXPECT_EQ(any->data.GetTheInt(), 1);
+    EXPECT_EQ(server.Outstanding(), 0u);
+    EXPECT_THROW(server.Reply(requests[0], requests[0].data), std::invalid_argument);
+
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a call nobody answers times out, and that its late reply is discarded.
+ */
+TEST(RpcTests, Call_TimesOutAndDiscardsLateReply) {
+    // Arrange: A server that takes the request but does not answer yet
+    const std::string name = TestQueueName();
+    RpcServer server(name, QueueProvisioner { QueueWorkload() });
+    RpcClient client(name);
+
+    // Act: Call with a short timeout, then answer late and make another call
+    EXPECT_THROW(client.Call(T_IPCData { 1, std::nullopt, std::nullopt, std::nullopt }, 20ms), std::runtime_error);
+    std::optional<RpcRequest> late = server.Receive(1s);
+    ASSERT_TRUE(late.has_value());
+    server.Reply(*late, late->data);
+    const uint64_t id = client.Send(T_IPCData { 2, std::nullopt, std::nullopt, std::nullopt }, 1s);
+    std::optional<RpcRequest> next = server.Receive(1s);
+    ASSERT_TRUE(next.has_value());
+    server.Reply(*next, next->data);
+    std::optional<T_IPCData> reply = client.Wait(id, 1s);
+
+    // Assert: Ensure the second call got its own reply and the late one was counted
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->GetTheInt(), 2);
+    EXPECT_EQ(client.LateReplies(), 1u);
+    EXPECT_EQ(client.InFlight(), 0u);
+
+    mq_unlink(name.c_str());
+}
@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <mqueue.h>
+#include <unistd.h>
+#include "ipc_data_view.h"
+#include "sender.h"
+#include "slab_pool.h"
+#include "test_queue.h"
+#include "util.h"
+
+/**
+ * @brief Tests that consecutive sends over one Sender arrive intact and in order.
+ *
+ * The second message is shorter than the first, so this also verifies that
+ * the recycled serialization state does not leak fields between messages.
+ */
+TEST(SenderTests, Send_ReusesQueueAcrossMessages) {
+    // Arrange: Create the receive queue and a sender attached to it
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+
+    // Act: Send a full message followed by a sparse one
+    sender.Send(T_IPCData { 47, 1701.0f, "Make it so", IPCData::TYPE3 });
+    sender.Send(T_IPCData { std::nullopt, 13.37f, std::nullopt, std::nullopt });
+
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t firstSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    T_IPCData first { std::string(buffer, firstSize) };
+    ssize_t secondSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    T_IPCData second { std::string(buffer, secondSize) };
+
+    // Assert: Ensure both messages match what was sent
+    EXPECT_EQ(first.GetTheInt().value(), 47);
+    EXPECT_EQ(first.GetTheString().value(), "Make it so");
+    EXPECT_EQ(first.GetTheType().value(), IPCData::TYPE3);
+    EXPECT_FALSE(second.GetTheInt().has_value());
+    EXPECT_FLOAT_EQ(second.GetTheFloat().value(), 13.37f);
+    EXPECT_FALSE(second.GetTheString().has_value());
+    EXPECT_FALSE(second.GetTheType().has_value());
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a message larger than MAX_MESSAGE_SIZE is rejected when there is no slab pool.
+ */
+TEST(SenderTests, Send_RejectsOversizedMessage) {
+    // Arrange: Create the receive queue, a sender pointed at a slab pool that does not exist, and an oversized message
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetSlabPoolName("/ipc_missing_slabs." + std::to_string(getpid()));
+    T_IPCData oversized { std::nullopt, std::nullopt, std::string(MAX_MESSAGE_SIZE, 'x'), std::nullopt };
+
+    // Act & Assert: Expect the send to throw
+    EXPECT_THROW(sender.Send(oversized), std::length_error);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that a broadcast sender rejects a message larger than a ring slot instead of sending it through a slab pool.
+ */
+TEST(SenderTests, Send_BroadcastRejectsOversizedMessage) {
+    // Arrange: A slab pool that a sender could use, a broadcast sender pointed at it, and an oversized message
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    const std::string poolName = "/ipc_sender_slabs." + std::to_string(getpid());
+    SlabPool pool(poolName, true);
+    Sender sender(SenderTransport::Broadcast, name);
+    sender.SetSlabPoolName(poolName);
+    T_IPCData oversized { std::nullopt, std::nullopt, std::string(MAX_MESSAGE_SIZE, 'x'), std::nullopt };
+
+    // Act & Assert: Expect both the direct and the batched send to throw without claiming a slab
+    EXPECT_THROW(sender.Send(oversized), std::length_error);
+    EXPECT_THROW(sender.Enqueue(oversized), std::length_error);
+    EXPECT_EQ(pool.InUse(), 0u);
+
+    SlabPool::Unlink(poolName);
+}
+
+/**
+ * @brief Tests that overflow mode names parse to their modes and that unknown names are rejected.
+ */
+TEST(SenderTests, ParseOverflowMode_RejectsUnknownNames) {
+    // Act & Assert: Ensure every documented name parses, and a typo does not fall back to a mode
+    EXPECT_EQ(ParseOverflowMode("block"), OverflowMode::Block);
+    EXPECT_EQ(ParseOverflowMode("deadline"), OverflowMode::BlockWithDeadline);
+    EXPECT_EQ(ParseOverflowMode("drop-oldest"), OverflowMode::DropOldest);
+    EXPECT_EQ(ParseOverflowMode("drop-newest"), OverflowMode::DropNewest);
+    EXPECT_EQ(ParseOverflowMode("coalesce"), OverflowMode::CoalesceByKey);
+    EXPECT_THROW(ParseOverflowMode("drop-newst"), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that enqueued records are packed into one batch message on flush.
+ */
+TEST(SenderTests, Enqueue_PacksRecordsIntoOneMessage) {
+    // Arrange: Create the receive queue and a batching sender with a long deadline
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    BatchPolicy policy;
+    policy.maxDelay = std::chrono::seconds(60);
+    sender.SetBatchPolicy(policy);
+
+    // Act: Queue several records, then flush once
+    for (int i = 0; i < 20; ++i) {
+        sender.Enqueue(T_IPCData { i, 1.5f, "RandomString", IPCData::TYPE2 });
+    }
+    sender.Flush();
+
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t size = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+
+    // Assert: Ensure exactly one batch message carried every record in order
+    ASSERT_TRUE(IsBatchFrame(buffer, size));
+    int expected = 0;
+    for (std::string_view record : BatchView(buffer, size)) {
+        EXPECT_EQ(T_IPCData { std::string(record) }.GetTheInt().value(), expected++);
+    }
+    EXPECT_EQ(expected, 20);
+    EXPECT_EQ(mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr), -1);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Tests that tracing stamps consecutive sequence numbers and a send time in both codecs.
+ */
+TEST(SenderTests, SetTracing_StampsSequenceAndSendTime) {
+    // Arrange: Create the receive queue and a tracing sender
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetTracing(true);
+    const uint64_t before = util::monotonicNanoseconds();
+
+    // Act: Send one protobuf record and one flat record
+    sender.Send(T_IPCData { 47, std::nullopt, std::nullopt, std::nullopt });
+    sender.SetCodec(WireCodec::Flat);
+    sender.Send(T_IPCData { 48, std::nullopt, std::nullopt, std::nullopt });
+    const uint64_t after = util::monotonicNanoseconds();
+
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t firstSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    T_IPCData first { buffer, static_cast<size_t>(firstSize) };
+    ssize_t secondSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    IPCDataView second { buffer, static_cast<size_t>(secondSize) };
+
+    // Assert: Ensure both records carry the original data plus tracing fields
+    EXPECT_EQ(first.GetTheInt().value(), 47);
+    EXPECT_EQ(first.GetSequence().value(), 1u);
+    EXPECT_GE(first.GetSendTimeNs().value(), before);
+    EXPECT_EQ(second.GetTheInt().value(), 48);
+    EXPECT_EQ(second.GetSequence().value(), 2u);
+    EXPECT_LE(second.GetSendTimeNs().value(), after);
+    EXPECT_GE(second.GetSendTimeNs().value(), first.GetSendTimeNs().value());
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
+
+/**
+ * @brief Receives every queued message and returns the int field of each, in order.
+ */
+static std::vector<int> ReceiveInts(mqd_t mq) {
+    std::vector<int> values;
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t size;
+    while ((size = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr)) >= 0) {
+        values.push_back(T_IPCData { buffer, static_cast<size_t>(size) }.GetTheInt().value());
+    }
+    return values;
+}
+
+/**
+ * @brief Tests that a full queue never blocks the sender under the drop policies, and what each one keeps.
+ */
+TEST(SenderTests, SetOverflowPolicy_DropsWithoutBlocking) {
+    for (OverflowMode mode : { OverflowMode::DropOldest, OverflowMode::DropNewest }) {
+        // Arrange: A two-slot queue and a sender that buffers two more messages
+        const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+        mqd_t mq = OpenTestQueue(name, 2);
+        ASSERT_NE(mq, (mqd_t)-1);
+        Sender sender(SenderTransport::MQueue, name);
+        OverflowPolicy policy;
+        policy.mode = mode;
+        policy.capacity = 2;
+        sender.SetOverflowPolicy(policy);
+        std::vector<BackpressureEvent> events;
+        sender.SetBackpressureHandler([&](BackpressureEvent event, size_t) { events.push_back(event); });
+
+        // Act: Send six records into room for four, then let the receiver catch up and retry
+        for (int i = 1; i <= 6; ++i) {
+            sender.Send(T_IPCData { i, std::nullopt, std::nullopt, std::nullopt });
+        }
+        std::vector<int> received = ReceiveInts(mq);
+        EXPECT_TRUE(sender.FlushIfDue());
+        std::vector<int> retried = ReceiveInts(mq);
+        received.insert(received.end(), retried.begin(), retried.end());
+
+        // Assert: Ensure the oldest or newest records were dropped, in order, with events and counters to match
+        const std::vector<int> expected = mode == OverflowMode::DropOldest ? std::vector<int> { 1, 2, 5, 6 }
+                                                                           : std::vector<int> { 1, 2, 3, 4 };
+        EXPECT_EQ(received, expected);
+        EXPECT_EQ(sender.Stats().sent, 4u);
+        EXPECT_EQ(sender.Stats().dropped, 2u);
+        EXPECT_EQ(sender.Stats().peakBuffered, 2u);
+        EXPECT_EQ(sender.Stats().buffered, 0u);
+        EXPECT_EQ(events, (std::vector<BackpressureEvent> { BackpressureEvent::Congested, BackpressureEvent::Dropped,
+                                                            BackpressureEvent::Dropped, BackpressureEvent::Relieved }));
+
+        mq_close(mq);
+        mq_unlink(name.c_str());
+    }
+}
+
+/**
+ * @brief Tests that a newer buffered record replaces an older one with the same key, keeping its place.
+ */
+TEST(SenderTests, SetOverflowPolicy_CoalescesByKey) {
+    // Arrange: A one-slot queue, already full, and a sender that coalesces by type
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name, 1);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    OverflowPolicy policy;
+    policy.mode = OverflowMode::CoalesceByKey;
+    policy.key = [](const T_IPCData& data) { return static_cast<uint64_t>(data.GetTheType().value_or(IPCData::TYPE1)); };
+    sender.SetOverflowPolicy(policy);
+    sender.Send(T_IPCData { 1, std::nullopt, std::nullopt, IPCData::TYPE1 });
+
+    // Act: Buffer two updates of TYPE2 around one of TYPE3, then drain one message at a time
+    sender.Send(T_IPCData { 2, std::nullopt, std::nullopt, IPCData::TYPE2 });
+    sender.Send(T_IPCData { 3, std::nullopt, std::nullopt, IPCData::TYPE3 });
+    sender.Send(T_IPCData { 4, std::nullopt, std::nullopt, IPCData::TYPE2 });
+    std::vector<int> received;
+    for (int i = 0; i < 3; ++i) {
+        std::vector<int> batch = ReceiveInts(mq);
+        received.insert(received.end(), batch.begin(), batch.end());
+        sender.FlushIfDue();
+    }
+
+    // Assert: Ensure only the latest TYPE2 value was sent, in the first TYPE2's position
+    EXPECT_EQ(received, (std::vector<int> { 1, 4, 3 }));
+    EXPECT_EQ(sender.Stats().coalesced, 1u);
+    EXPECT_EQ(sender.Stats().dropped, 0u);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+    EXPECT_THROW(sender.SetOverflowPolicy(OverflowPolicy { OverflowMode::CoalesceByKey, 4, {}, nullptr }), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that a send waits no longer than the deadline when both the queue and the buffer are full.
+ */
+TEST(SenderTests, SetOverflowPolicy_BlockWithDeadlineFailsInTime) {
+    // Arrange: A full one-slot queue and a one-message buffer with a short deadline
+    const std::string name = "/ipc_sender_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name, 1);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    OverflowPolicy policy;
+    policy.mode = OverflowMode::BlockWithDeadline;
+    policy.capacity = 1;
+    policy.deadline = std::chrono::milliseconds(20);
+    sender.SetOverflowPolicy(policy);
+    sender.Send(T_IPCData { 1, std::nullopt, std::nullopt, std::nullopt });
+    sender.Send(T_IPCData { 2, std::nullopt, std::nullopt, std::nullopt });
+
+    // Act: Send a third record while nobody is receiving
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(sender.Send(T_IPCData { 3, std::nullopt, std::nullopt, std::nullopt }), std::runtime_error);
+    const auto waited = std::chrono::steady_clock::now() - start;
+
+    // Assert: Ensure it waited for the deadline but not much longer, and the buffered record survived
+    EXPECT_GE(waited, std::chrono::milliseconds(15));
+    EXPECT_LT(waited, std::chrono::seconds(1));
+    EXPECT_EQ(sender.Stats().deadlineMisses, 1u);
+    EXPECT_EQ(ReceiveInts(mq), (std::vector<int> { 1 }));
+    sender.FlushIfDue();
+    EXPECT_EQ(ReceiveInts(mq), (std::vector<int> { 2 }));
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <mqueue.h>
+#include <unistd.h>
+#include "control_segment.h"
+#include "sharded_sender.h"
+#include "test_queue.h"
+
+/**
+ * @brief Tests that partition key names parse to their keys and that unknown names are rejected.
+ */
+TEST(ShardingTests, ParsePartitionKey_RejectsUnknownNames) {
+    // Act & Assert: Ensure every documented name parses, and a typo does not fall back to round-robin
+    EXPECT_EQ(ParsePartitionKey("round-robin"), PartitionKey::RoundRobin);
+    EXPECT_EQ(ParsePartitionKey("type"), PartitionKey::Type);
+    EXPECT_EQ(ParsePartitionKey("int"), PartitionKey::Int);
+    EXPECT_THROW(ParsePartitionKey("ints"), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that round-robin visits every shard and key partitioners are stable per key.
+ */
+TEST(ShardingTests, MakePartitioner_SpreadsAndKeepsKeysTogether) {
+    // Arrange: One partitioner of each kind
+    Partitioner roundRobin = MakePartitioner(PartitionKey::RoundRobin);
+    Partitioner byType = MakePartitioner(PartitionKey::Type);
+    Partitioner byInt = MakePartitioner(PartitionKey::Int);
+    T_IPCData data { 47, std::nullopt, std::nullopt, IPCData::TYPE2 };
+
+    // Act: Route the same record repeatedly
+    std::set<size_t> visited;
+    std::set<size_t> typeShards;
+    std::set<size_t> intShards;
+    for (int i = 0; i < 8; ++i) {
+        visited.insert(roundRobin(data, 4));
+        typeShards.insert(byType(data, 4));
+        intShards.insert(byInt(data, 4));
+    }
+
+    // Assert: Ensure round-robin used every shard and the keyed ones always chose the same shard
+    EXPECT_EQ(visited.size(), 4u);
+    ASSERT_EQ(typeShards.size(), 1u);
+    ASSERT_EQ(intShards.size(), 1u);
+    EXPECT_LT(*typeShards.begin(), 4u);
+    EXPECT_LT(*intShards.begin(), 4u);
+}
+
+/**
+ * @brief Tests that a shard count set by the creator is seen by an attached process.
+ */
+TEST(ShardingTests, ControlSegment_PublishesShardCount) {
+    // Arrange: Create a segment unique to this test process
+    const std::string name = "/ipc_control_test." + std::to_string(getpid());
+    ControlSegment created(name, true);
+    EXPECT_EQ(created.ShardCount(), 1u);
+
+    // Act: Publish a shard count and attach a second mapping
+    created.SetShardCount(3);
+    ControlSegment attached(name, false);
+
+    // Assert: Ensure the count is shared and invalid counts are rejected
+    EXPECT_EQ(attached.ShardCount(), 3u);
+    EXPECT_THROW(created.SetShardCount(0), std::out_of_range);
+    EXPECT_THROW(created.SetShardCount(MAX_SHARDS + 1), std::out_of_range);
+
+    ControlSegment::Unlink(name);
+    EXPECT_THROW(ControlSegment(name, false), std::runtime_error);
+}
+
+/**
+ * @brief Tests that each record arrives on the shard its partitioner picked.
+ */
+TEST(ShardingTests, ShardedSender_RoutesToPartitionedQueue) {
+    // Arrange: Two shard queues and a sender that routes on the int field
+    const std::string base = "/ipc_sharding_test." + std::to_string(getpid());
+    mqd_t queues[2] = { OpenTestQueue(ShardQueueName(base, 0)), OpenTestQueue(ShardQueueName(base, 1)) };
+    ASSERT_NE(queues[0], (mqd_t)-1);
+    ASSERT_NE(queues[1], (mqd_t)-1);
+    auto byParity = [](const T_IPCData& data, size_t shardCount) {
+        return static_cast<size_t>(data.GetTheInt().value_or(0)) % shardCount;
+    };
+    ShardedSender sender(SenderTransport::MQueue, 2, byParity, base);
+
+    // Act: Send two even and one odd record
+    sender.Send(T_IPCData { 2, std::nullopt, std::nullopt, std::nullopt });
+    sender.Send(T_IPCData { 3, std::nullopt, std::nullopt, std::nullopt });
+    sender.Send(T_IPCData { 4, std::nullopt, std::nullopt, std::nullopt });
+
+    // Assert: Ensure the evens are on shard 0, in order, and the odd one is on shard 1
+    char buffer[MAX_MESSAGE_SIZE];
+    std::vector<int> received[2];
+    for (int shard = 0; shard < 2; ++shard) {
+        ssize_t size;
+        while ((size = mq_receive(queues[shard], buffer, MAX_MESSAGE_SIZE, nullptr)) >= 0) {
+            received[shard].push_back(*T_IPCData { std::string(buffer, size) }.GetTheInt());
+        }
+    }
+    EXPECT_EQ(received[0], (std::vector<int> { 2, 4 }));
+    EXPECT_EQ(received[1], (std::vector<int> { 3 }));
+    EXPECT_EQ(sender.ShardCount(), 2u);
+
+    for (int shard = 0; shard < 2; ++shard) {
+        mq_close(queues[shard]);
+        mq_unlink(ShardQueueName(base, shard).c_str());
+    }
+}
+
+/**
+ * @brief Tests that the shared-memory ring cannot be sharded.
+ */
+TEST(ShardingTests, ShardedSender_RejectsShardedRing) {
+    // Act & Assert: Ensure asking for several ring shards is an error
+    EXPECT_THROW(ShardedSender(SenderTransport::ShmRing, 2, MakePartitioner(PartitionKey::RoundRobin)), std::invalid_argument);
+}
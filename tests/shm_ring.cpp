@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "shm_ring.h"
+
+/**
+ * @brief Builds a segment name that is unique to this test process.
+ */
+static std::string TestRingName() {
+    return "/ipc_ring_test." + std::to_string(getpid());
+}
+
+/**
+ * @brief Tests that messages come out of the ring in the order they went in.
+ */
+TEST(ShmRingTests, PushPop_PreservesOrderAndContent) {
+    // Arrange: Create a fresh ring and queue two messages
+    ShmRing ring(TestRingName(), true);
+    ASSERT_TRUE(ring.TryPush("first", 5));
+    ASSERT_TRUE(ring.TryPush("second message", 14));
+
+    // Act: Drain both messages
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t firstSize = ring.TryPop(buffer, sizeof(buffer));
+    std::string first(buffer, firstSize);
+    ssize_t secondSize = ring.TryPop(buffer, sizeof(buffer));
+    std::string second(buffer, secondSize);
+
+    // Assert: Ensure both messages match and the ring is empty again
+    EXPECT_EQ(first, "first");
+    EXPECT_EQ(second, "second message");
+    EXPECT_EQ(ring.TryPop(buffer, sizeof(buffer)), -1);
+
+    ShmRing::Unlink(TestRingName());
+}
+
+/**
+ * @brief Tests that an empty message is carried as a valid zero-length message.
+ */
+TEST(ShmRingTests, PushPop_EmptyMessage) {
+    // Arrange: Create a fresh ring and queue an empty message
+    ShmRing ring(TestRingName(), true);
+    ASSERT_TRUE(ring.TryPush("", 0));
+
+    // Act & Assert: Ensure the message is received with size 0
+    char buffer[MAX_MESSAGE_SIZE];
+    EXPECT_EQ(ring.TryPop(buffer, sizeof(buffer)), 0);
+
+    ShmRing::Unlink(TestRingName());
+}
+
+/**
+ * @brief Tests that TryPush reports a full ring instead of overwriting unread slots.
+ */
+TEST(ShmRingTests, TryPush_FailsWhenFull) {
+    // Arrange: Fill every slot in the ring
+    ShmRing ring(TestRingName(), true);
+    for (int i = 0; i < SHM_RING_SLOTS; ++i) {
+        ASSERT_TRUE(ring.TryPush("x", 1));
+    }
+
+    // Act & Assert: Ensure the next push fails until a slot is drained
+    EXPECT_FALSE(ring.TryPush("y", 1));
+    char buffer[MAX_MESSAGE_SIZE];
+    EXPECT_EQ(ring.TryPop(buffer, sizeof(buffer)), 1);
+    EXPECT_TRUE(ring.TryPush("y", 1));
+
+    ShmRing::Unlink(TestRingName());
+}
+
+/**
+ * @brief Tests that messages larger than a slot are rejected.
+ */
+TEST(ShmRingTests, TryPush_RejectsOversizedMessage) {
+    // Arrange: Create a fresh ring and a message one byte too large
+    ShmRing ring(TestRingName(), true);
+    std::string oversized(MAX_MESSAGE_SIZE + 1, 'x');
+
+    // Act & Assert: Expect the push to throw
+    EXPECT_THROW(ring.TryPush(oversized.data(), oversized.size()), std::length_error);
+
+    ShmRing::Unlink(TestRingName());
+}
+
+/**
+ * @brief Tests that a parked reader is woken by a writer attached to the same segment.
+ */
+TEST(ShmRingTests, WaitForData_WakesParkedReader) {
+    // Arrange: Create the reader's ring and attach a writer from another thread
+    ShmRing reader(TestRingName(), true);
+    std::thread writerThread([] {
+        ShmRing writer(TestRingName(), false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writer.Push("wake", 4);
+    });
+
+    // Act: Park until the writer publishes
+    bool ready = reader.WaitForData(5000);
+    writerThread.join();
+
+    // Assert: Ensure the reader saw the message
+    char buffer[MAX_MESSAGE_SIZE];
+    EXPECT_TRUE(ready);
+    EXPECT_EQ(reader.TryPop(buffer, sizeof(buffer)), 4);
+
+    ShmRing::Unlink(TestRingName());
+}
+
+/**
+ * @brief Tests that attaching to a missing segment fails loudly.
+ */
+TEST(ShmRingTests, Attach_FailsWithoutSegment) {
+    // Arrange: Ensure no segment exists
+    ShmRing::Unlink(TestRingName());
+
+    // Act & Assert: Expect attaching to throw
+    EXPECT_THROW(ShmRing ring(TestRingName(), false), std::runtime_error);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mqueue.h>
+#include <unistd.h>
+#include "sender.h"
+#include "slab_pool.h"
+#include "test_queue.h"
+
+/**
+ * @brief Tests that a slab is usable once per acquire and rejects descriptors after release.
+ */
+TEST(SlabPoolTests, Acquire_ResolvesUntilReleased) {
+    // Arrange: A pool unique to this test process, plus a second mapping of it
+    const std::string name = "/ipc_slab_test." + std::to_string(getpid());
+    SlabPool writer(name, true);
+    SlabPool reader(name, false);
+
+    // Act: Write a record into a slab and pass its descriptor through the wire encoding
+    SlabDescriptor descriptor;
+    char* slab = writer.TryAcquire(5, descriptor);
+    ASSERT_NE(slab, nullptr);
+    std::memcpy(slab, "hello", 5);
+    char frame[SLAB_DESCRIPTOR_SIZE];
+    EncodeSlabDescriptor(descriptor, frame);
+    SlabDescriptor received = DecodeSlabDescriptor(frame, sizeof(frame));
+
+    // Assert: Ensure the other mapping sees the bytes in place, and only until release
+    EXPECT_TRUE(IsSlabDescriptor(frame, sizeof(frame)));
+    EXPECT_EQ(reader.Resolve(received), "hello");
+    EXPECT_EQ(reader.InUse(), 1u);
+    reader.Release(received);
+    EXPECT_EQ(writer.InUse(), 0u);
+    EXPECT_THROW(reader.Resolve(received), std::runtime_error);
+    EXPECT_THROW(writer.TryAcquire(SLAB_SIZE + 1, descriptor), std::length_error);
+
+    SlabPool::Unlink(name);
+}
+
+/**
+ * @brief Tests that acquiring fails without blocking once every slab is in flight.
+ */
+TEST(SlabPoolTests, Acquire_ReturnsNullWhenExhausted) {
+    // Arrange: A fresh pool
+    const std::string name = "/ipc_slab_test." + std::to_string(getpid());
+    SlabPool pool(name, true);
+
+    // Act: Claim every slab, then one more
+    std::vector<SlabDescriptor> claimed(SLAB_COUNT);
+    for (SlabDescriptor& descriptor : claimed) {
+        ASSERT_NE(pool.TryAcquire(1, descriptor), nullptr);
+    }
+    SlabDescriptor extra;
+
+    // Assert: Ensure the extra claim fails, and a released slab comes back with a new generation
+    EXPECT_EQ(pool.TryAcquire(1, extra), nullptr);
+    pool.Release(claimed[3]);
+    ASSERT_NE(pool.TryAcquire(1, extra), nullptr);
+    EXPECT_EQ(extra.slab, claimed[3].slab);
+    EXPECT_NE(extra.generation, claimed[3].generation);
+
+    SlabPool::Unlink(name);
+}
+
+/**
+ * @brief Tests that a record larger than MAX_MESSAGE_SIZE is sent as a descriptor and decoded from the slab.
+ */
+TEST(SlabPoolTests, Sender_SendsLargeRecordThroughSlab) {
+    // Arrange: A receive queue, a slab pool and a sender using both
+    const std::string name = "/ipc_slab_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    SlabPool pool(name, true);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetSlabPoolName(name);
+    T_IPCData large { 47, std::nullopt, std::string(4 * MAX_MESSAGE_SIZE, 'x'), IPCData::TYPE3 };
+
+    // Act: Send a small and a large record in batching mode, then flush
+    sender.SetBatchPolicy(BatchPolicy { MAX_MESSAGE_SIZE, std::chrono::seconds(10) });
+    sender.Enqueue(T_IPCData { 1, std::nullopt, std::nullopt, std::nullopt });
+    sender.Enqueue(large);
+
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t batchSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    ssize_t descriptorSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+
+    // Assert: Ensure the batch came first, then a descriptor that decodes to the large record
+    EXPECT_GT(batchSize, 0);
+    ASSERT_EQ(descriptorSize, static_cast<ssize_t>(SLAB_DESCRIPTOR_SIZE));
+    EXPECT_EQ(pool.InUse(), 1u);
+    {
+        SlabRecord record(&pool, std::string_view(buffer, descriptorSize));
+        T_IPCData decoded { record.View().data(), record.View().size() };
+        EXPECT_EQ(decoded.GetTheInt(), 47);
+        EXPECT_EQ(decoded.GetTheString(), large.GetTheString());
+        EXPECT_EQ(decoded.GetTheType(), IPCData::TYPE3);
+    }
+    EXPECT_EQ(pool.InUse(), 0u);
+    EXPECT_THROW(SlabRecord(nullptr, std::string_view(buffer, descriptorSize)), std::runtime_error);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+    SlabPool::Unlink(name);
+}
+
+/**
+ * @brief Tests that a long-running sender maps the new pool after the receiver recreates it.
+ */
+TEST(SlabPoolTests, Sender_ReattachesToRecreatedPool) {
+    // Arrange: A sender that has already sent a large record through the first pool
+    const std::string name = "/ipc_slab_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    auto first = std::make_unique<SlabPool>(name, true);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetSlabPoolName(name);
+    T_IPCData large { 47, std::nullopt, std::string(4 * MAX_MESSAGE_SIZE, 'x'), IPCData::TYPE3 };
+    sender.Send(large);
+    char buffer[MAX_MESSAGE_SIZE];
+    ASSERT_EQ(mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr), static_cast<ssize_t>(SLAB_DESCRIPTOR_SIZE));
+
+    // Act: Recreate the pool as a restarted receiver would, wait out the recheck interval, and send again
+    first.reset();
+    SlabPool second(name, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    sender.Send(large);
+    ssize_t descriptorSize = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+
+    // Assert: Ensure the new descriptor resolves in the new pool
+    ASSERT_EQ(descriptorSize, static_cast<ssize_t>(SLAB_DESCRIPTOR_SIZE));
+    EXPECT_EQ(second.InUse(), 1u);
+    {
+        SlabRecord record(&second, std::string_view(buffer, descriptorSize));
+        EXPECT_EQ(T_IPCData(record.View().data(), record.View().size()).GetTheInt(), 47);
+    }
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+    SlabPool::Unlink(name);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <mqueue.h>
+#include <string>
+#include <unistd.h>
+#include "constants.h"
+#include "sender.h"
+#include "stats_segment.h"
+#include "test_queue.h"
+
+/**
+ * @brief Tests that counters added through a created segment are seen by a reader attached to it.
+ */
+TEST(StatsSegmentTests, Attach_SeesCountersAndIsListed) {
+    // Arrange: A segment for this process
+    const std::string name = StatsSegmentName("test", getpid());
+    StatsSegment writer(name, true, "test");
+
+    // Act: Count into it and attach a reader
+    writer.Add(Stat::MessagesSent);
+    writer.Add(Stat::BytesSent, 100);
+    writer.Set(Stat::QueueDepth, 7);
+    StatsSegment reader(name, false);
+
+    // Assert: Ensure the reader sees the values, the owner and the listing
+    EXPECT_EQ(reader.Get(Stat::MessagesSent), 1u);
+    EXPECT_EQ(reader.Get(Stat::BytesSent), 100u);
+    EXPECT_EQ(reader.Get(Stat::QueueDepth), 7u);
+    EXPECT_EQ(reader.Get(Stat::ParseFailures), 0u);
+    EXPECT_EQ(reader.Role(), "test");
+    EXPECT_EQ(reader.Pid(), getpid());
+    EXPECT_TRUE(reader.Alive());
+    const std::vector<std::string> names = StatsSegment::List();
+    EXPECT_NE(std::find(names.begin(), names.end(), name), names.end());
+
+    StatsSegment::Unlink(name);
+}
+
+/**
+ * @brief Tests that a published segment counts messages sent and parse failures, and formats them for Prometheus.
+ */
+TEST(StatsSegmentTests, Publish_CountsSendsAndParseFailures) {
+    // Arrange: A published segment and a queue to send on
+    const std::string name = StatsSegmentName("test", getpid());
+    StatsSegment segment(name, true, "test");
+    stats::Publish(&segment);
+    const std::string queueName = "/ipc_stats_test." + std::to_string(getpid());
+    mqd_t mq = OpenTestQueue(queueName);
+    ASSERT_NE(mq, (mqd_t)-1);
+
+    // Act: Send three records, then parse a message that is not IPCData
+    {
+        Sender sender(SenderTransport::MQueue, queueName);
+        for (int i = 0; i < 3; ++i) {
+            sender.Send(T_IPCData { i, std::nullopt, std::nullopt, std::nullopt });
+        }
+    }
+    const char garbage[] = { '\xff', '\xff', '\xff' };
+    EXPECT_THROW(T_IPCData(garbage, sizeof(garbage)), std::runtime_error);
+    const std::string text = FormatPrometheus({ &segment });
+
+    // Assert: Ensure the counts, and that the sample lines carry the labels
+    EXPECT_EQ(segment.Get(Stat::MessagesSent), 3u);
+    EXPECT_GT(segment.Get(Stat::BytesSent), 0u);
+    EXPECT_EQ(segment.Get(Stat::SendFull), 0u);
+    EXPECT_EQ(segment.Get(Stat::ParseFailures), 1u);
+    const std::string pid = std::to_string(getpid());
+    EXPECT_NE(text.find("# TYPE ipc_messages_sent_total counter"), std::string::npos);
+    EXPECT_NE(text.find("ipc_messages_sent_total{role=\"test\",pid=\"" + pid + "\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE ipc_queue_depth gauge"), std::string::npos);
+
+    stats::Publish(nullptr);
+    mq_close(mq);
+    mq_unlink(queueName.c_str());
+    StatsSegment::Unlink(name);
+}
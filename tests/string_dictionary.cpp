@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <mqueue.h>
+#include <unistd.h>
+#include "control_segment.h"
+#include "sender.h"
+#include "string_dictionary.h"
+#include "test_queue.h"
+
+/**
+ * @brief Receives one message from a test queue.
+ */
+static std::string ReceiveOne(mqd_t mq) {
+    char buffer[MAX_MESSAGE_SIZE];
+    ssize_t size = mq_receive(mq, buffer, MAX_MESSAGE_SIZE, nullptr);
+    return size >= 0 ? std::string(buffer, size) : std::string();
+}
+
+/**
+ * @brief Tests when the encoder sends a definition, a reference, or a prefix reference.
+ */
+TEST(StringDictionaryTests, Encode_CodesRepeatsAndPrefixes) {
+    // Arrange: A small dictionary so entries retire quickly
+    StringDictionaryEncoder encoder(7, 4);
+
+    // Act & Assert: The first use of a string defines it, the next refers to it
+    StringCoding first = encoder.Encode("RandomString");
+    EXPECT_FALSE(first.ref.has_value());
+    EXPECT_EQ(first.define, 0u);
+    EXPECT_EQ(first.literal, "RandomString");
+
+    StringCoding again = encoder.Encode("RandomString");
+    EXPECT_EQ(again.ref, 0u);
+    EXPECT_FALSE(again.define.has_value());
+    EXPECT_TRUE(again.literal.empty());
+
+    // A timestamp that shares a long prefix with the previous definition sends only its suffix
+    encoder.Encode("2024-05-01 12:34:56.789");
+    StringCoding next = encoder.Encode("2024-05-01 12:34:57.012");
+    EXPECT_EQ(next.ref, 1u);
+    EXPECT_EQ(next.prefix, 18u);
+    EXPECT_EQ(next.literal, "7.012");
+    EXPECT_EQ(next.define, 2u);
+
+    // Long strings are never stored
+    const std::string longText(STRING_DICTIONARY_MAX_LENGTH + 1, 'x');
+    StringCoding big = encoder.Encode(longText);
+    EXPECT_FALSE(big.ref.has_value());
+    EXPECT_FALSE(big.define.has_value());
+
+    // Once four newer strings were defined, entry 0 has retired and is defined again
+    encoder.Encode("w");
+    encoder.Encode("x");
+    StringCoding retired = encoder.Encode("RandomString");
+    EXPECT_FALSE(retired.ref.has_value());
+    EXPECT_EQ(retired.define, 5u);
+
+    // A reset starts a new epoch from id 0
+    encoder.Reset();
+    EXPECT_EQ(encoder.Epoch(), 2u);
+    EXPECT_EQ(encoder.Encode("RandomString").define, 0u);
+}
+
+/**
+ * @brief Tests that records sent with the dictionary decode to the original strings, in fewer bytes.
+ */
+TEST(StringDictionaryTests, Sender_RoundTripsThroughDecoder) {
+    // Arrange: Two queues, one sender with the dictionary and one without, and a repetitive workload
+    const std::string codedName = "/ipc_dict_test." + std::to_string(getpid());
+    const std::string plainName = "/ipc_dict_plain_test." + std::to_string(getpid());
+    mqd_t codedQueue = OpenTestQueue(codedName);
+    mqd_t plainQueue = OpenTestQueue(plainName);
+    ASSERT_NE(codedQueue, (mqd_t)-1);
+    ASSERT_NE(plainQueue, (mqd_t)-1);
+    Sender coded(SenderTransport::MQueue, codedName);
+    coded.SetStringDictionary(true, "/ipc_missing_control." + std::to_string(getpid()));
+    Sender plain(SenderTransport::MQueue, plainName);
+
+    std::vector<std::string> strings;
+    for (int i = 0; i < 20; ++i) {
+        strings.push_back("RandomString");
+        strings.push_back("sensor/left-wheel/temperature");
+        strings.push_back("2024-05-01 12:34:56." + std::to_string(100 + i * 7));
+    }
+
+    // Act: Send each record through both senders, receive it, and decode the coded copy
+    StringDictionaryDecoder decoder;
+    size_t codedBytes = 0, plainBytes = 0;
+    for (const std::string& text : strings) {
+        T_IPCData data { 47, std::nullopt, text, IPCData::TYPE1 };
+        coded.Send(data);
+        plain.Send(data);
+        const std::string codedMessage = ReceiveOne(codedQueue);
+        codedBytes += codedMessage.size();
+        plainBytes += ReceiveOne(plainQueue).size();
+
+        IPCDataView view(codedMessage);
+        decoder.Resolve(view);
+        T_IPCData received { view };
+
+        // Assert: Ensure every record decodes to what was sent
+        EXPECT_EQ(received.GetTheString(), text);
+        EXPECT_EQ(received.GetTheInt(), 47);
+    }
+
+    // A coded record cannot be decoded without the dictionary, and the coded stream is much smaller
+    coded.Send(T_IPCData { std::nullopt, std::nullopt, "RandomString", std::nullopt });
+    EXPECT_THROW(T_IPCData { ReceiveOne(codedQueue) }, std::runtime_error);
+    EXPECT_LT(codedBytes, plainBytes * 6 / 10);
+    EXPECT_EQ(decoder.Missing(), 0u);
+
+    mq_close(codedQueue);
+    mq_close(plainQueue);
+    mq_unlink(codedName.c_str());
+    mq_unlink(plainName.c_str());
+}
+
+/**
+ * @brief Tests that the dropping overflow policies never lose a definition that a delivered record refers to.
+ */
+TEST(StringDictionaryTests, Sender_OverflowKeepsDefinitions) {
+    for (OverflowMode mode : { OverflowMode::DropOldest, OverflowMode::CoalesceByKey }) {
+        // Arrange: A two-slot queue, and a dictionary sender that buffers four more and drops or coalesces the rest
+        const std::string name = "/ipc_dict_overflow_test." + std::to_string(getpid());
+        mqd_t mq = OpenTestQueue(name, 2);
+        ASSERT_NE(mq, (mqd_t)-1);
+        Sender sender(SenderTransport::MQueue, name);
+        sender.SetStringDictionary(true, "/ipc_missing_control." + std::to_string(getpid()));
+        OverflowPolicy policy;
+        policy.mode = mode;
+        policy.capacity = 4;
+        policy.key = [](const T_IPCData& data) { return static_cast<uint64_t>(*data.GetTheInt() % 4); };
+        sender.SetOverflowPolicy(policy);
+
+        // Act: Send records cycling through three strings into room for six, then one more; drain and decode everything
+        for (int i = 0; i < 7; ++i) {
+            sender.Send(T_IPCData { i, std::nullopt, "sensor/" + std::to_string(i % 3), std::nullopt });
+        }
+        StringDictionaryDecoder decoder;
+        std::vector<int> received;
+        for (int round = 0; round < 10; ++round) {
+            std::string message;
+            while (!(message = ReceiveOne(mq)).empty()) {
+                IPCDataView view(message);
+                ASSERT_NO_THROW(decoder.Resolve(view));
+                T_IPCData data { view };
+                received.push_back(*data.GetTheInt());
+
+                // Assert: Ensure every record that arrived decodes to the string it was sent with
+                EXPECT_EQ(data.GetTheString(), "sensor/" + std::to_string(*data.GetTheInt() % 3));
+            }
+            sender.FlushIfDue();
+        }
+
+        // One record was dropped or coalesced, none went missing, and everything buffered was sent
+        EXPECT_EQ(received.size(), 6u);
+        EXPECT_EQ(sender.Stats().dropped + sender.Stats().coalesced, 1u);
+        EXPECT_EQ(decoder.Missing(), 0u);
+        EXPECT_EQ(sender.Stats().buffered, 0u);
+
+        mq_close(mq);
+        mq_unlink(name.c_str());
+    }
+}
+
+/**
+ * @brief Tests that an unknown entry fails the record and asks for a reset once per epoch.
+ */
+TEST(StringDictionaryTests, Resolve_MissingEntryRequestsResetOnce) {
+    // Arrange: A decoder that counts reset requests, and references it never saw defined
+    int resets = 0;
+    StringDictionaryDecoder decoder([&] { ++resets; });
+    IPCData proto;
+    proto.set_string_ref(3);
+    proto.set_dict_stream(9);
+    proto.set_dict_epoch(1);
+    const std::string orphan = proto.SerializeAsString();
+
+    // Act & Assert: Both references fail, but only the first asks for a reset
+    IPCDataView first(orphan);
+    EXPECT_THROW(decoder.Resolve(first), std::runtime_error);
+    IPCDataView second(orphan);
+    EXPECT_THROW(decoder.Resolve(second), std::runtime_error);
+    EXPECT_EQ(resets, 1);
+    EXPECT_EQ(decoder.Missing(), 2u);
+
+    // The sender's next epoch defines the entry and is decoded normally
+    proto.Clear();
+    proto.set_the_string("RandomString");
+    proto.set_string_define(0);
+    proto.set_dict_stream(9);
+    proto.set_dict_epoch(2);
+    const std::string definition = proto.SerializeAsString();
+    IPCDataView defined(definition);
+    decoder.Resolve(defined);
+    EXPECT_EQ(defined.GetTheString(), "RandomString");
+    EXPECT_EQ(resets, 1);
+}
+
+/**
+ * @brief Tests that a stream id shared by two senders is rejected instead of mixing up their entries.
+ */
+TEST(StringDictionaryTests, Resolve_RejectsStreamSharedByTwoSenders) {
+    // Arrange: Two senders' first definitions, both entry 0 of stream 9 in epoch 1, and a reference to it
+    int resets = 0;
+    StringDictionaryDecoder decoder([&] { ++resets; });
+    auto record = [](const char* text, bool define) {
+        IPCData proto;
+        if (define) {
+            proto.set_the_string(text);
+            proto.set_string_define(0);
+        } else {
+            proto.set_string_ref(0);
+        }
+        proto.set_dict_stream(9);
+        proto.set_dict_epoch(1);
+        return proto.SerializeAsString();
+    };
+    const std::string first = record("FirstSender", true);
+    const std::string second = record("SecondSender", true);
+    const std::string reference = record(nullptr, false);
+
+    // Act & Assert: The first definition is accepted; the second, and any later reference, is rejected
+    IPCDataView firstView(first);
+    decoder.Resolve(firstView);
+    EXPECT_EQ(firstView.GetTheString(), "FirstSender");
+    IPCDataView secondView(second);
+    EXPECT_THROW(decoder.Resolve(secondView), std::runtime_error);
+    IPCDataView referenceView(reference);
+    EXPECT_THROW(decoder.Resolve(referenceView), std::runtime_error);
+    EXPECT_EQ(resets, 1);
+}
+
+/**
+ * @brief Tests that senders of one receiver get distinct stream ids from its control segment.
+ */
+TEST(StringDictionaryTests, Sender_GetsDistinctStreamFromControlSegment) {
+    // Arrange: A control segment and a queue unique to this test process, and two senders using both
+    const std::string controlName = "/ipc_dict_control_test." + std::to_string(getpid());
+    const std::string name = "/ipc_dict_stream_test." + std::to_string(getpid());
+    ControlSegment control(controlName, true);
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender first(SenderTransport::MQueue, name);
+    Sender second(SenderTransport::MQueue, name);
+    first.SetStringDictionary(true, controlName);
+    second.SetStringDictionary(true, controlName);
+
+    // Act: Send one string from each
+    first.Send(T_IPCData { std::nullopt, std::nullopt, "RandomString", std::nullopt });
+    second.Send(T_IPCData { std::nullopt, std::nullopt, "RandomString", std::nullopt });
+    const std::string fromFirst = ReceiveOne(mq);
+    const std::string fromSecond = ReceiveOne(mq);
+
+    // Assert: Ensure both defined entry 0, in different streams
+    IPCDataView firstView(fromFirst), secondView(fromSecond);
+    EXPECT_EQ(firstView.GetStringDefine(), 0u);
+    EXPECT_EQ(secondView.GetStringDefine(), 0u);
+    ASSERT_TRUE(firstView.GetDictStream() && secondView.GetDictStream());
+    EXPECT_NE(*firstView.GetDictStream(), *secondView.GetDictStream());
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+    ControlSegment::Unlink(controlName);
+}
+
+/**
+ * @brief Tests that a reset requested through the control segment makes the sender start a new epoch.
+ */
+TEST(StringDictionaryTests, Sender_FollowsResetRequests) {
+    // Arrange: A control segment and a queue unique to this test process, and a sender using both
+    const std::string controlName = "/ipc_dict_control_test." + std::to_string(getpid());
+    const std::string name = "/ipc_dict_reset_test." + std::to_string(getpid());
+    ControlSegment control(controlName, true);
+    mqd_t mq = OpenTestQueue(name);
+    ASSERT_NE(mq, (mqd_t)-1);
+    Sender sender(SenderTransport::MQueue, name);
+    sender.SetStringDictionary(true, controlName);
+    const T_IPCData data { std::nullopt, std::nullopt, "RandomString", std::nullopt };
+
+    // Act: Send the same string before and after a reset request
+    sender.Send(data);
+    sender.Send(data);
+    control.RequestDictionaryReset();
+    sender.Send(data);
+    const std::string defined = ReceiveOne(mq);
+    const std::string referenced = ReceiveOne(mq);
+    const std::string redefined = ReceiveOne(mq);
+
+    // Assert: Ensure the string was defined, referenced, then defined again in the next epoch
+    IPCDataView first(defined), second(referenced), third(redefined);
+    EXPECT_EQ(first.GetStringDefine(), 0u);
+    EXPECT_EQ(second.GetStringRef(), 0u);
+    EXPECT_EQ(third.GetStringDefine(), 0u);
+    EXPECT_EQ(third.GetDictEpoch(), *first.GetDictEpoch() + 1);
+
+    mq_close(mq);
+    mq_unlink(name.c_str());
+    ControlSegment::Unlink(controlName);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 #include "t_ipc_data.h"
 
 /**
@@ -218,4 +219,48 @@ TEST(TIPCDataTests, HandleInvalidEnum) {
         T_IPCData data { serializedMessage },
         std::out_of_range
     );
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Tests that the builder sets exactly the fields it was given, and round-trips.
+ */
+TEST(TIPCDataTests, Builder_SetsOnlyGivenFields) {
+    // Arrange: Build a record with a string and a type, plus tracing fields
+    T_IPCData data = T_IPCData::Builder()
+        .SetTheString("Engage")
+        .SetTheType(IPCData::TYPE2)
+        .SetTrace(1000, 7)
+        .Build();
+
+    // Act: Round-trip it through protobuf
+    T_IPCData decoded { data.Serialize() };
+
+    // Assert: Ensure only the set fields are present, before and after
+    for (const T_IPCData* record : { &data, &decoded }) {
+        EXPECT_FALSE(record->GetTheInt().has_value());
+        EXPECT_FALSE(record->GetTheFloat().has_value());
+        EXPECT_EQ(record->GetTheString(), "Engage");
+        EXPECT_EQ(record->GetTheType(), IPCData::TYPE2);
+        EXPECT_EQ(record->GetSendTimeNs(), 1000u);
+        EXPECT_EQ(record->GetSequence(), 7u);
+    }
+}
+
+/**
+ * @brief Tests that moving a record hands over its string instead of copying it.
+ */
+TEST(TIPCDataTests, Move_KeepsStringStorage) {
+    // Arrange: A string too long for the small-string buffer, moved in
+    std::string text(200, 'x');
+    const char* storage = text.data();
+    T_IPCData data = T_IPCData::Builder().SetTheString(std::move(text)).Build();
+
+    // Act: Move the record twice
+    T_IPCData moved = std::move(data);
+    std::vector<T_IPCData> batch;
+    batch.push_back(std::move(moved));
+
+    // Assert: Ensure the same buffer backs the string, and getters do not copy it
+    EXPECT_EQ(batch[0].GetTheString()->data(), storage);
+    EXPECT_EQ(batch[0].GetTheString()->size(), 200u);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_QUEUE_H
+#define TEST_QUEUE_H
+
+#include <string>
+#include <fcntl.h>
+#include <mqueue.h>
+#include "constants.h"
+
+/**
+ * @brief Opens a fresh receive queue under `name`, removing any leftover queue first.
+ *
+ * The defaults give a non-blocking queue of `QUEUE_MIN_DEPTH` messages of
+ * `MAX_MESSAGE_SIZE` bytes, which is what a test receiver normally wants.
+ */
+inline mqd_t OpenTestQueue(const std::string& name, long maxMessages = QUEUE_MIN_DEPTH,
+                           long messageSize = MAX_MESSAGE_SIZE, int flags = O_RDONLY | O_NONBLOCK) {
+    mq_unlink(name.c_str());
+    struct mq_attr attr {};
+    attr.mq_maxmsg = maxMessages;
+    attr.mq_msgsize = messageSize;
+    return mq_open(name.c_str(), O_CREAT | flags, QUEUE_PERMISSIONS, &attr);
+}
+
+#endif // TEST_QUEUE_H
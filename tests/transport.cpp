@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "stats_segment.h"
+#include "transport.h"
+
+namespace {
+    const TransportKind ALL_KINDS[] = { TransportKind::MQueue, TransportKind::ShmRing, TransportKind::SeqPacket, TransportKind::IoUring,
+                                        TransportKind::Broadcast };
+
+    /**
+     * @brief Builds a channel name unique to this test process and transport.
+     */
+    std::string TestChannelName(TransportKind kind) {
+        return std::string("/ipc_transport_test.") + TransportKindName(kind) + "." + std::to_string(getpid());
+    }
+
+    /**
+     * @brief Opens both ends of a channel, starting with the one that creates it (the publisher, for a broadcast ring).
+     */
+    void OpenChannel(TransportKind kind, const std::string& name, std::unique_ptr<Transport>& receiver, std::unique_ptr<Transport>& sender) {
+        if (kind == TransportKind::Broadcast) {
+            sender = OpenTransport(kind, name, TransportRole::Sender);
+            receiver = OpenTransport(kind, name, TransportRole::Receiver);
+        } else {
+            receiver = OpenTransport(kind, name, TransportRole::Receiver);
+            sender = OpenTransport(kind, name, TransportRole::Sender);
+        }
+    }
+
+    /**
+     * @brief Receives until `expected` messages have arrived or a second has passed, returning their contents in order.
+     */
+    std::vector<std::string> ReceiveAll(Transport& receiver, size_t expected) {
+        std::vector<std::string> messages;
+        std::vector<char> buffers(16 * MAX_MESSAGE_SIZE);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (messages.size() < expected && std::chrono::steady_clock::now() < deadline) {
+            receiver.WaitForData(10);
+            ReceiveSlot slots[16];
+            for (size_t i = 0; i < 16; ++i) {
+                slots[i] = ReceiveSlot { buffers.data() + i * MAX_MESSAGE_SIZE, MAX_MESSAGE_SIZE, 0, 0 };
+            }
+            const size_t received = receiver.ReceiveBatch(slots, 16);
+            for (size_t i = 0; i < received; ++i) {
+                messages.emplace_back(slots[i].buffer, slots[i].size);
+            }
+        }
+        return messages;
+    }
+}
+
+/**
+ * @brief Tests that every transport delivers a batch, including an empty message, intact and in order.
+ */
+TEST(TransportTests, SendBatch_EveryKindDeliversInOrder) {
+    for (TransportKind kind : ALL_KINDS) {
+        SCOPED_TRACE(TransportKindName(kind));
+
+        // Arrange: A receiver and a sender on the same channel
+        const std::string name = TestChannelName(kind);
+        std::unique_ptr<Transport> receiver, sender;
+        OpenChannel(kind, name, receiver, sender);
+        const OutgoingMessage batch[] = { { "first", 5, 0 }, { "", 0, 0 }, { "third", 5, 0 } };
+
+        // Act: Send the batch, then one more message on its own
+        const size_t sent = sender->SendBatch(batch, 3);
+        const bool sentAlone = sender->Send("fourth", 6, 0, nullptr);
+        std::vector<std::string> received = ReceiveAll(*receiver, 4);
+
+        // Assert: Ensure everything arrived, in order, with the empty message still empty
+        EXPECT_EQ(sent, 3u);
+        EXPECT_TRUE(sentAlone);
+        EXPECT_EQ(received, (std::vector<std::string> { "first", "", "third", "fourth" }));
+
+        sender.reset();
+        receiver->Remove();
+    }
+}
+
+/**
+ * @brief Tests that a batch stops at the first message that does not fit, and that exactly the ones before it arrive.
+ */
+TEST(TransportTests, SendBatch_StopsWhenChannelIsFull) {
+    for (TransportKind kind : ALL_KINDS) {
+        if (kind == TransportKind::Broadcast) {
+            continue; // Never full: the publisher overwrites instead (see ReceiveBatch_BroadcastReportsLostMessages)
+        }
+        SCOPED_TRACE(TransportKindName(kind));
+
+        // Arrange: A receiver that is not draining, and more numbered messages than any channel holds
+        const std::string name = TestChannelName(kind);
+        std::unique_ptr<Transport> receiver = OpenTransport(kind, name, TransportRole::Receiver);
+        std::unique_ptr<Transport> sender = OpenTransport(kind, name, TransportRole::Sender);
+        std::vector<std::string> numbers;
+        std::vector<OutgoingMessage> batch;
+        for (int i = 0; i < 4 * SHM_RING_SLOTS; ++i) {
+            numbers.push_back(std::to_string(i) + std::string(200, '.'));
+        }
+        for (const std::string& number : numbers) {
+            batch.push_back(OutgoingMessage { number.data(), number.size(), 0 });
+        }
+
+        // Act: Send until the channel is full, then receive everything
+        const size_t sent = sender->SendBatch(batch.data(), batch.size());
+        std::vector<std::string> received = ReceiveAll(*receiver, sent);
+
+        // Assert: Ensure part of the batch was sent, and exactly that part arrived in order
+        EXPECT_GT(sent, 0u);
+        EXPECT_LT(sent, batch.size());
+        ASSERT_EQ(received.size(), sent);
+        EXPECT_EQ(received.front(), numbers.front());
+        EXPECT_EQ(received.back(), numbers[sent - 1]);
+
+        sender.reset();
+        receiver->Remove();
+    }
+}
+
+/**
+ * @brief Tests that a broadcast subscriber that is lapped receives the newest messages and reports the rest as lost.
+ */
+TEST(TransportTests, ReceiveBatch_BroadcastReportsLostMessages) {
+    // Arrange: A subscriber counting into a published stats segment, and ten more messages than the ring holds
+    const std::string statsName = StatsSegmentName("test", getpid());
+    StatsSegment segment(statsName, true, "test");
+    stats::Publish(&segment);
+    const std::string name = TestChannelName(TransportKind::Broadcast);
+    std::unique_ptr<Transport> receiver, sender;
+    OpenChannel(TransportKind::Broadcast, name, receiver, sender);
+    std::vector<std::string> numbers;
+    std::vector<OutgoingMessage> batch;
+    for (int i = 0; i < BROADCAST_RING_SLOTS + 10; ++i) {
+        numbers.push_back(std::to_string(i));
+    }
+    for (const std::string& number : numbers) {
+        batch.push_back(OutgoingMessage { number.data(), number.size(), 0 });
+    }
+
+    // Act: Publish everything before the subscriber reads, then receive
+    const size_t sent = sender->SendBatch(batch.data(), batch.size());
+    std::vector<std::string> received = ReceiveAll(*receiver, BROADCAST_RING_SLOTS);
+
+    // Assert: Ensure the oldest ten were lost, counted by the transport and the stats segment, and the rest arrived in order
+    EXPECT_EQ(sent, batch.size());
+    ASSERT_EQ(received.size(), static_cast<size_t>(BROADCAST_RING_SLOTS));
+    EXPECT_EQ(received.front(), numbers[10]);
+    EXPECT_EQ(received.back(), numbers.back());
+    EXPECT_EQ(receiver->Lost(), 10u);
+    EXPECT_EQ(segment.Get(Stat::MessagesLost), 10u);
+    EXPECT_FALSE(receiver->Closed());
+
+    // Act: Close the publisher, which removes the ring
+    sender.reset();
+
+    // Assert: Ensure the subscriber sees that nothing more can arrive
+    EXPECT_TRUE(receiver->Closed());
+
+    stats::Publish(nullptr);
+    StatsSegment::Unlink(statsName);
+}
+
+/**
+ * @brief Tests that the socket receivers drop and count a message larger than its slot, and keep receiving.
+ */
+TEST(TransportTests, ReceiveBatch_SocketsDropOversizedMessages) {
+    for (TransportKind kind : { TransportKind::SeqPacket, TransportKind::IoUring }) {
+        SCOPED_TRACE(TransportKindName(kind));
+
+        // Arrange: A receiver counting into a published stats segment, and a sender on the same channel
+        const std::string statsName = StatsSegmentName("test", getpid());
+        StatsSegment segment(statsName, true, "test");
+        stats::Publish(&segment);
+        const std::string name = TestChannelName(kind);
+        std::unique_ptr<Transport> receiver = OpenTransport(kind, name, TransportRole::Receiver);
+        std::unique_ptr<Transport> sender = OpenTransport(kind, name, TransportRole::Sender);
+        const OutgoingMessage batch[] = { { "first", 5, 0 }, { "much too long", 13, 0 }, { "third", 5, 0 } };
+
+        // Act: Send the batch, then receive it into slots of eight bytes
+        ASSERT_EQ(sender->SendBatch(batch, 3), 3u);
+        std::vector<std::string> received;
+        char buffers[4][8];
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (received.size() < 2 && std::chrono::steady_clock::now() < deadline) {
+            receiver->WaitForData(10);
+            ReceiveSlot slots[4];
+            for (size_t i = 0; i < 4; ++i) {
+                slots[i] = ReceiveSlot { buffers[i], sizeof(buffers[i]), 0, 0 };
+            }
+            const size_t count = receiver->ReceiveBatch(slots, 4);
+            for (size_t i = 0; i < count; ++i) {
+                received.emplace_back(slots[i].buffer, slots[i].size);
+            }
+        }
+
+        // Assert: Ensure the oversized message was counted and the ones around it arrived
+        EXPECT_EQ(received, (std::vector<std::string> { "first", "third" }));
+        EXPECT_EQ(segment.Get(Stat::MessagesTruncated), 1u);
+
+        stats::Publish(nullptr);
+        StatsSegment::Unlink(statsName);
+        sender.reset();
+        receiver->Remove();
+    }
+}
+
+/**
+ * @brief Tests that socket senders fail to open when no receiver is listening.
+ */
+TEST(TransportTests, Open_SocketSenderNeedsReceiver) {
+    // Act & Assert: Ensure both socket transports refuse to open a sender
+    EXPECT_THROW(OpenTransport(TransportKind::SeqPacket, TestChannelName(TransportKind::SeqPacket), TransportRole::Sender), std::runtime_error);
+    EXPECT_THROW(OpenTransport(TransportKind::IoUring, TestChannelName(TransportKind::IoUring), TransportRole::Sender), std::runtime_error);
+}
+
+/**
+ * @brief Tests that transport names parse to their kinds and back, and that unknown names are rejected.
+ */
+TEST(TransportTests, ParseTransportKind_RoundTripsNames) {
+    // Act & Assert: Ensure every kind's name parses back to it
+    for (TransportKind kind : ALL_KINDS) {
+        EXPECT_EQ(ParseTransportKind(TransportKindName(kind)), kind);
+    }
+    EXPECT_THROW(ParseTransportKind("pipe"), std::invalid_argument);
+}
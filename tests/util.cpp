@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util.h"
+
+/**
+ * @brief Switches the process to UTC for the duration of a test, so formatted times are predictable.
+ */
+class UtilTimestampTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* tz = std::getenv("TZ");
+        hadTz_ = tz != nullptr;
+        if (hadTz_) savedTz_ = tz;
+        setenv("TZ", "UTC", 1);
+        tzset();
+    }
+    void TearDown() override {
+        if (hadTz_) setenv("TZ", savedTz_.c_str(), 1); else unsetenv("TZ");
+        tzset();
+    }
+
+private:
+    bool hadTz_ = false;
+    std::string savedTz_;
+};
+
+/**
+ * @brief Tests each precision against a known instant.
+ */
+TEST_F(UtilTimestampTests, FormatTimestamp_KnownInstant) {
+    // Arrange: 2024-02-29 23:59:58 UTC plus 7,654,321 ns
+    timespec time { 1709251198, 7654321 };
+    char buffer[util::TIMESTAMP_BUFFER_SIZE];
+
+    // Act & Assert: Ensure each precision truncates the fraction
+    EXPECT_EQ(util::formatTimestamp(time, buffer, sizeof(buffer)), 23u);
+    EXPECT_STREQ(buffer, "2024-02-29 23:59:58.007");
+    util::formatTimestamp(time, buffer, sizeof(buffer), util::TimestampPrecision::Microseconds);
+    EXPECT_STREQ(buffer, "2024-02-29 23:59:58.007654");
+    util::formatTimestamp(time, buffer, sizeof(buffer), util::TimestampPrecision::Nanoseconds);
+    EXPECT_STREQ(buffer, "2024-02-29 23:59:58.007654321");
+
+    // The cached prefix must be re-rendered when the second changes
+    time.tv_sec += 2;
+    util::formatTimestamp(time, buffer, sizeof(buffer));
+    EXPECT_STREQ(buffer, "2024-03-01 00:00:00.007");
+}
+
+/**
+ * @brief Tests that the formatter matches the previous put_time-based output.
+ */
+TEST_F(UtilTimestampTests, CurrentTimestamp_MatchesPutTime) {
+    // Arrange: Read the clock once
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    // Act: Format it both ways
+    char buffer[util::TIMESTAMP_BUFFER_SIZE];
+    util::formatTimestamp(now, buffer, sizeof(buffer));
+    std::tm local {};
+    localtime_r(&now.tv_sec, &local);
+    std::ostringstream expected;
+    expected << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << now.tv_nsec / 1000000;
+
+    // Assert: Ensure they agree, and the clock-reading entry points produce the same shape
+    EXPECT_EQ(std::string(buffer), expected.str());
+    EXPECT_EQ(util::getCurrentDateTimeWithMilliseconds().size(), 23u);
+    EXPECT_EQ(util::currentTimestamp(util::TimestampPrecision::Nanoseconds, util::TimestampClock::RealtimeCoarse).View().size(), 29u);
+}
+
+/**
+ * @brief Tests that a too-small buffer is rejected rather than overrun.
+ */
+TEST_F(UtilTimestampTests, FormatTimestamp_RejectsSmallBuffer) {
+    // Arrange: Room for the text but not the terminating null
+    timespec time { 0, 0 };
+    char buffer[23];
+
+    // Act & Assert: Expect a length error
+    EXPECT_THROW(util::formatTimestamp(time, buffer, sizeof(buffer)), std::length_error);
+}
+
+/**
+ * @brief Tests that concurrent threads each get correct, independent results.
+ */
+TEST_F(UtilTimestampTests, FormatTimestamp_ThreadSafe) {
+    // Arrange: Each thread formats its own distinct second many times
+    std::vector<std::thread> threads;
+    std::vector<std::string> results(8);
+
+    // Act: Run the threads concurrently
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([t, &results] {
+            char buffer[util::TIMESTAMP_BUFFER_SIZE];
+            for (int i = 0; i < 10000; ++i) {
+                util::formatTimestamp(timespec { 86400L * t + (i % 2), 0 }, buffer, sizeof(buffer));
+            }
+            util::formatTimestamp(timespec { 86400L * t, 0 }, buffer, sizeof(buffer));
+            results[t] = buffer;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Assert: Ensure every thread saw its own day
+    for (int t = 0; t < 8; ++t) {
+        EXPECT_EQ(results[t], "1970-01-0" + std::to_string(t + 1) + " 00:00:00.000");
+    }
+}